@@ -25,7 +25,10 @@ if (TBB_USE_GLIBCXX_VERSION)
    add_definitions(-DTBB_USE_GLIBCXX_VERSION=${TBB_USE_GLIBCXX_VERSION})
 endif()
 
-set(HOOMD_COMMON_LIBS ${ADDITIONAL_LIBS})
+# the asynchronous trajectory writers use std::thread
+find_package(Threads REQUIRED)
+
+set(HOOMD_COMMON_LIBS ${ADDITIONAL_LIBS} ${CMAKE_THREAD_LIBS_INIT})
 
 if (ENABLE_TBB)
     list(APPEND HOOMD_COMMON_LIBS ${TBB_LIBRARY})
@@ -731,7 +731,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         {
         if (m_prof) m_prof->push("update " + std::string(name) + " table");
 
-        ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*m_pdata, access_mode::read);
 
         m_gpu_n_groups.resize(m_pdata->getN()+m_pdata->getNGhosts());
 
@@ -754,7 +754,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 for (unsigned int i = 0; i < group_size; ++i)
                     {
                     unsigned int tag = g.tag[i];
-                    unsigned int idx = h_rtag.data[tag];
+                    unsigned int idx = h_rtag[tag];
 
                     if (idx == NOT_LOCAL)
                         {
@@ -800,7 +800,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 for (unsigned int i = 0; i < group_size; ++i)
                     {
                     unsigned int tag1 = g.tag[i];
-                    unsigned int idx1 = h_rtag.data[tag1];
+                    unsigned int idx1 = h_rtag[tag1];
                     unsigned int num = h_n_groups.data[idx1]++;
 
                     members_t h;
@@ -827,7 +827,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                             continue;
                             }
                         unsigned int tag2 = g.tag[j];
-                        unsigned int idx2 = h_rtag.data[tag2];
+                        unsigned int idx2 = h_rtag[tag2];
                         h.idx[n++] = idx2;
                         }
 
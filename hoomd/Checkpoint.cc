@@ -0,0 +1,808 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file Checkpoint.cc
+    \brief Defines the CheckpointWriter and CheckpointReader classes
+*/
+
+#include "Checkpoint.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+namespace py = pybind11;
+
+//! Magic bytes at the start of every checkpoint file
+static const char checkpoint_magic[8] = {'H', 'O', 'O', 'M', 'D', 'C', 'K', 'P'};
+
+//! Version of the checkpoint format
+static const uint32_t checkpoint_version = 1;
+
+//! Returns the name of the file written by \a rank
+static string checkpoint_file_name(const string& fname, unsigned int rank)
+    {
+    if (rank == 0)
+        return fname;
+
+    ostringstream s;
+    s << fname << "." << rank;
+    return s.str();
+    }
+
+//! Save or load a bonded group snapshot
+template<class Archive, class Snapshot>
+static void checkpoint_bonded(Archive& ar, Snapshot& snapshot)
+    {
+    checkpoint_array(ar, snapshot.type_id);
+    checkpoint_array(ar, snapshot.val);
+    checkpoint_array(ar, snapshot.groups);
+    ar(snapshot.type_mapping);
+    snapshot.size = (unsigned int)snapshot.groups.size();
+    }
+
+//! Renumber the members of bonded groups from particle tags to snapshot indices
+/*! \returns false if a group references a particle that does not exist
+*/
+template<class Snapshot>
+static bool checkpoint_remap_bonded(Snapshot& snapshot, const map<unsigned int, unsigned int>& index)
+    {
+    for (unsigned int i = 0; i < snapshot.groups.size(); i++)
+        {
+        unsigned int n_members = sizeof(snapshot.groups[i].tag)/sizeof(unsigned int);
+        for (unsigned int j = 0; j < n_members; j++)
+            {
+            map<unsigned int, unsigned int>::const_iterator it = index.find(snapshot.groups[i].tag[j]);
+            if (it == index.end())
+                return false;
+            snapshot.groups[i].tag[j] = it->second;
+            }
+        }
+    return true;
+    }
+
+//! Copy particle \a i of \a data to index \a k of a snapshot
+static void checkpoint_set_particle(SnapshotParticleData<Scalar>& pdata, unsigned int k,
+                                    const CheckpointParticleData& data, unsigned int i)
+    {
+    const Scalar4& pos = data.pos[i];
+    const Scalar4& vel = data.vel[i];
+
+    pdata.pos[k] = vec3<Scalar>(pos);
+    pdata.type[k] = __scalar_as_int(pos.w);
+    pdata.vel[k] = vec3<Scalar>(vel);
+    pdata.mass[k] = vel.w;
+    pdata.accel[k] = vec3<Scalar>(data.accel[i]);
+    pdata.charge[k] = data.charge[i];
+    pdata.diameter[k] = data.diameter[i];
+    pdata.image[k] = data.image[i];
+    pdata.body[k] = data.body[i];
+    pdata.orientation[k] = quat<Scalar>(data.orientation[i]);
+    pdata.angmom[k] = quat<Scalar>(data.angmom[i]);
+    pdata.inertia[k] = vec3<Scalar>(data.inertia[i]);
+    }
+
+//! Write \a data to a file and sync it to disk
+/*! \returns 0 on success, or the errno of the failed call
+*/
+static int write_synced(const string& fname, const string& data)
+    {
+    int fd = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0)
+        return errno;
+
+    int err = 0;
+    const char *p = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0)
+        {
+        ssize_t n = ::write(fd, p, remaining);
+        if (n < 0)
+            {
+            if (errno == EINTR)
+                continue;
+            err = errno;
+            break;
+            }
+        p += n;
+        remaining -= n;
+        }
+
+    if (err == 0 && ::fsync(fd) != 0)
+        err = errno;
+    if (::close(fd) != 0 && err == 0)
+        err = errno;
+    return err;
+    }
+
+/*! \param pdata Particle data to copy the local particles from
+*/
+void CheckpointParticleData::take(std::shared_ptr<ParticleData> pdata)
+    {
+    unsigned int N = pdata->getN();
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_accel(pdata->getAccelerations(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+    pos.assign(h_pos.data, h_pos.data + N);
+    vel.assign(h_vel.data, h_vel.data + N);
+    accel.assign(h_accel.data, h_accel.data + N);
+    charge.assign(h_charge.data, h_charge.data + N);
+    diameter.assign(h_diameter.data, h_diameter.data + N);
+    image.assign(h_image.data, h_image.data + N);
+    body.assign(h_body.data, h_body.data + N);
+    orientation.assign(h_orientation.data, h_orientation.data + N);
+    angmom.assign(h_angmom.data, h_angmom.data + N);
+    inertia.assign(h_inertia.data, h_inertia.data + N);
+    tag.assign(h_tag.data, h_tag.data + N);
+    }
+
+/*! \param other Particles to append
+*/
+void CheckpointParticleData::append(const CheckpointParticleData& other)
+    {
+    pos.insert(pos.end(), other.pos.begin(), other.pos.end());
+    vel.insert(vel.end(), other.vel.begin(), other.vel.end());
+    accel.insert(accel.end(), other.accel.begin(), other.accel.end());
+    charge.insert(charge.end(), other.charge.begin(), other.charge.end());
+    diameter.insert(diameter.end(), other.diameter.begin(), other.diameter.end());
+    image.insert(image.end(), other.image.begin(), other.image.end());
+    body.insert(body.end(), other.body.begin(), other.body.end());
+    orientation.insert(orientation.end(), other.orientation.begin(), other.orientation.end());
+    angmom.insert(angmom.end(), other.angmom.begin(), other.angmom.end());
+    inertia.insert(inertia.end(), other.inertia.begin(), other.inertia.end());
+    tag.insert(tag.end(), other.tag.begin(), other.tag.end());
+    }
+
+/*! \param other Particles to take the particle from
+    \param i Index of the particle in \a other
+*/
+void CheckpointParticleData::appendParticle(const CheckpointParticleData& other, unsigned int i)
+    {
+    pos.push_back(other.pos[i]);
+    vel.push_back(other.vel[i]);
+    accel.push_back(other.accel[i]);
+    charge.push_back(other.charge[i]);
+    diameter.push_back(other.diameter[i]);
+    image.push_back(other.image[i]);
+    body.push_back(other.body[i]);
+    orientation.push_back(other.orientation[i]);
+    angmom.push_back(other.angmom[i]);
+    inertia.push_back(other.inertia[i]);
+    tag.push_back(other.tag[i]);
+    }
+
+/*! \returns true if all arrays have as many elements as there are tags
+*/
+bool CheckpointParticleData::validate() const
+    {
+    size_t N = tag.size();
+    return pos.size() == N && vel.size() == N && accel.size() == N && charge.size() == N && diameter.size() == N
+        && image.size() == N && body.size() == N && orientation.size() == N && angmom.size() == N
+        && inertia.size() == N;
+    }
+
+/*! \param sysdef System definition to save
+    \param fname File name of the checkpoint
+*/
+CheckpointWriter::CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname)
+    : Analyzer(sysdef), m_fname(fname)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointWriter: " << fname << endl;
+    }
+
+CheckpointWriter::~CheckpointWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CheckpointWriter" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    Every rank writes its file under a temporary name. The files are renamed to their final names only after all
+    ranks have written theirs.
+*/
+void CheckpointWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Checkpoint");
+
+    unsigned int rank = m_exec_conf->getRank();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+
+    // collect the bonded groups and the integrator variables on the root rank (this is a collective call)
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot
+        = m_sysdef->takeSnapshot<Scalar>(false, true, true, true, true, true, true, true);
+
+    CheckpointParticleData local;
+    local.take(m_pdata);
+
+    ostringstream s(ios_base::out | ios_base::binary);
+        {
+        cereal::BinaryOutputArchive ar(s);
+
+        uint32_t scalar_size = sizeof(Scalar);
+        uint64_t step = timestep;
+        ar(cereal::binary_data(checkpoint_magic, sizeof(checkpoint_magic)));
+        ar(checkpoint_version, scalar_size, n_ranks, rank, step);
+
+        if (rank == 0)
+            {
+            // box and origin
+            const BoxDim& box = m_pdata->getGlobalBox();
+            Scalar3 lo = box.getLo();
+            Scalar3 hi = box.getHi();
+            uchar3 periodic = box.getPeriodic();
+            Scalar xy = box.getTiltFactorXY();
+            Scalar xz = box.getTiltFactorXZ();
+            Scalar yz = box.getTiltFactorYZ();
+            Scalar3 origin = m_pdata->getOrigin();
+            int3 o_image = m_pdata->getOriginImage();
+
+            ar(snapshot->dimensions);
+            ar(cereal::binary_data(&lo, sizeof(Scalar3)));
+            ar(cereal::binary_data(&hi, sizeof(Scalar3)));
+            ar(cereal::binary_data(&periodic, sizeof(uchar3)));
+            ar(xy, xz, yz);
+            ar(cereal::binary_data(&origin, sizeof(Scalar3)));
+            ar(cereal::binary_data(&o_image, sizeof(int3)));
+
+            // type names
+            vector<string> type_mapping;
+            for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+                type_mapping.push_back(m_pdata->getNameByType(i));
+            ar(type_mapping);
+
+            // bonded groups
+            checkpoint_bonded(ar, snapshot->bond_data);
+            checkpoint_bonded(ar, snapshot->angle_data);
+            checkpoint_bonded(ar, snapshot->dihedral_data);
+            checkpoint_bonded(ar, snapshot->improper_data);
+            checkpoint_bonded(ar, snapshot->constraint_data);
+            checkpoint_bonded(ar, snapshot->pair_data);
+
+            // integrator variables
+            uint32_t n_integrators = (uint32_t)snapshot->integrator_data.size();
+            ar(n_integrators);
+            for (unsigned int i = 0; i < n_integrators; i++)
+                {
+                ar(snapshot->integrator_data[i].type);
+                checkpoint_array(ar, snapshot->integrator_data[i].variable);
+                }
+            }
+
+        ar(local);
+        }
+
+    string fname = checkpoint_file_name(m_fname, rank);
+    string tmp_name = fname + ".tmp";
+    int err = write_synced(tmp_name, s.str());
+    if (err != 0)
+        m_exec_conf->msg->error() << "dump.checkpoint: Unable to write " << tmp_name << ": " << strerror(err) << endl;
+
+    int ok = (err == 0);
+    #ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (ok)
+        {
+        if (::rename(tmp_name.c_str(), fname.c_str()) != 0)
+            {
+            m_exec_conf->msg->error() << "dump.checkpoint: Unable to rename " << tmp_name << " to " << fname << ": "
+                                      << strerror(errno) << endl;
+            ok = 0;
+            }
+
+        #ifdef ENABLE_MPI
+        MPI_Allreduce(MPI_IN_PLACE, &ok, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+        #endif
+        }
+    else
+        {
+        ::unlink(tmp_name.c_str());
+        }
+
+    if (m_prof)
+        m_prof->pop();
+
+    if (!ok)
+        throw runtime_error("Error writing checkpoint");
+
+    m_exec_conf->msg->notice(3) << "dump.checkpoint: Wrote checkpoint " << m_fname << " at step " << timestep << endl;
+    }
+
+/*! \param exec_conf The execution configuration
+    \param fname File name of the checkpoint (as written by rank 0)
+
+    The root rank reads the global section and its own particles first, so that all ranks learn how many ranks
+    wrote the checkpoint.
+*/
+CheckpointReader::CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                   const std::string& fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_timestep(0), m_n_saved_ranks(0), m_restore_order(false),
+      m_origin(make_scalar3(0,0,0)), m_o_image(make_int3(0,0,0))
+    {
+    unsigned int rank = m_exec_conf->getRank();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+
+    m_snapshot = std::shared_ptr< SnapshotSystemData<Scalar> >(new SnapshotSystemData<Scalar>());
+
+    bool ok = true;
+    if (rank == 0)
+        ok = readFile(0, m_local);
+    checkAll(ok);
+
+    #ifdef ENABLE_MPI
+    bcast(m_n_saved_ranks, 0, m_exec_conf->getMPICommunicator());
+    bcast(m_timestep, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    bool distributed = false;
+    if (m_n_saved_ranks == n_ranks)
+        {
+        // every rank reads its own file
+        if (rank != 0)
+            ok = readFile(rank, m_local);
+        checkAll(ok);
+
+        #ifdef ENABLE_MPI
+        if (n_ranks > 1)
+            distributed = buildDistributedSnapshot();
+        #endif
+        }
+
+    if (! distributed)
+        {
+        // the root rank reads the files of all ranks and assembles the snapshot
+        vector<CheckpointParticleData> locals;
+        if (rank == 0)
+            {
+            if (m_n_saved_ranks > 1)
+                m_exec_conf->msg->notice(2) << "read_checkpoint: Reading all " << m_n_saved_ranks << " files of "
+                                            << fname << " on the root rank" << endl;
+            locals.resize(m_n_saved_ranks);
+            locals[0] = m_local;
+            for (unsigned int r = 1; r < m_n_saved_ranks && ok; r++)
+                ok = readFile(r, locals[r]);
+            }
+        checkAll(ok);
+
+        m_restore_order = (m_n_saved_ranks == n_ranks);
+        if (! m_restore_order)
+            m_local = CheckpointParticleData();
+
+        if (rank == 0)
+            ok = buildSnapshot(locals);
+        checkAll(ok);
+        }
+    else
+        {
+        m_restore_order = true;
+        }
+
+    #ifdef ENABLE_MPI
+    bcast(m_restore_order, 0, m_exec_conf->getMPICommunicator());
+    bcast(m_origin, 0, m_exec_conf->getMPICommunicator());
+    bcast(m_o_image, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    m_exec_conf->msg->notice(2) << "read_checkpoint: " << fname << " at step " << m_timestep << endl;
+    }
+
+/*! \param rank Rank that wrote the file
+    \param local Particles read from the file
+    \returns true on success
+
+    The file of rank 0 sets the number of ranks and the time step, and its global section is read into the snapshot.
+    The files of the other ranks must agree with it.
+*/
+bool CheckpointReader::readFile(unsigned int rank, CheckpointParticleData& local)
+    {
+    string fname = checkpoint_file_name(m_fname, rank);
+
+    ifstream f(fname.c_str(), ios_base::in | ios_base::binary);
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "read_checkpoint: Unable to open " << fname << endl;
+        return false;
+        }
+
+    try
+        {
+        cereal::BinaryInputArchive ar(f);
+
+        char magic[sizeof(checkpoint_magic)];
+        uint32_t version = 0, scalar_size = 0, file_ranks = 0, file_rank = 0;
+        uint64_t step = 0;
+        ar(cereal::binary_data(magic, sizeof(magic)));
+        if (memcmp(magic, checkpoint_magic, sizeof(magic)) != 0)
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: " << fname << " is not a checkpoint file" << endl;
+            return false;
+            }
+
+        ar(version, scalar_size, file_ranks, file_rank, step);
+        if (version != checkpoint_version)
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: " << fname << " has unsupported version " << version
+                                      << endl;
+            return false;
+            }
+        if (scalar_size != sizeof(Scalar))
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: " << fname << " was written in "
+                                      << (scalar_size == 4 ? "single" : "double")
+                                      << " precision and cannot be read by this build" << endl;
+            return false;
+            }
+
+        if (rank == 0)
+            {
+            m_n_saved_ranks = file_ranks;
+            m_timestep = step;
+            }
+        if (file_ranks == 0 || file_rank >= file_ranks || file_rank != rank || file_ranks != m_n_saved_ranks
+            || step != m_timestep)
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: " << fname << " does not belong to the checkpoint "
+                                      << m_fname << " (rank " << file_rank << " of " << file_ranks << ", step "
+                                      << step << ")" << endl;
+            return false;
+            }
+
+        if (rank == 0)
+            {
+            // box and origin
+            Scalar3 lo, hi;
+            uchar3 periodic;
+            Scalar xy, xz, yz;
+            ar(m_snapshot->dimensions);
+            ar(cereal::binary_data(&lo, sizeof(Scalar3)));
+            ar(cereal::binary_data(&hi, sizeof(Scalar3)));
+            ar(cereal::binary_data(&periodic, sizeof(uchar3)));
+            ar(xy, xz, yz);
+            ar(cereal::binary_data(&m_origin, sizeof(Scalar3)));
+            ar(cereal::binary_data(&m_o_image, sizeof(int3)));
+
+            m_snapshot->global_box = BoxDim(lo, hi, periodic);
+            m_snapshot->global_box.setTiltFactors(xy, xz, yz);
+
+            // type names
+            ar(m_snapshot->particle_data.type_mapping);
+
+            // bonded groups
+            checkpoint_bonded(ar, m_snapshot->bond_data);
+            checkpoint_bonded(ar, m_snapshot->angle_data);
+            checkpoint_bonded(ar, m_snapshot->dihedral_data);
+            checkpoint_bonded(ar, m_snapshot->improper_data);
+            checkpoint_bonded(ar, m_snapshot->constraint_data);
+            checkpoint_bonded(ar, m_snapshot->pair_data);
+
+            // integrator variables
+            uint32_t n_integrators = 0;
+            ar(n_integrators);
+            m_snapshot->integrator_data.resize(n_integrators);
+            for (unsigned int i = 0; i < n_integrators; i++)
+                {
+                ar(m_snapshot->integrator_data[i].type);
+                checkpoint_array(ar, m_snapshot->integrator_data[i].variable);
+                }
+            }
+
+        ar(local);
+        }
+    catch (const std::exception& e)
+        {
+        m_exec_conf->msg->error() << "read_checkpoint: " << fname << " is truncated or corrupt" << endl;
+        return false;
+        }
+
+    if (!local.validate())
+        {
+        m_exec_conf->msg->error() << "read_checkpoint: " << fname << " has inconsistent particle data" << endl;
+        return false;
+        }
+
+    return true;
+    }
+
+/*! \param locals Particles of all ranks, in rank order
+    \returns true on success
+
+    Particles are placed in the snapshot in the order of their tags. When the tags are not contiguous (particles
+    were removed), the bonded groups and rigid bodies are renumbered to the snapshot indices, and the local order of
+    the particles cannot be restored.
+*/
+bool CheckpointReader::buildSnapshot(const vector<CheckpointParticleData>& locals)
+    {
+    CheckpointParticleData all;
+    for (unsigned int r = 0; r < locals.size(); r++)
+        all.append(locals[r]);
+
+    unsigned int N = (unsigned int)all.tag.size();
+
+    // sort the particles by tag
+    vector< pair<unsigned int, unsigned int> > order(N);
+    for (unsigned int i = 0; i < N; i++)
+        order[i] = make_pair(all.tag[i], i);
+    sort(order.begin(), order.end());
+
+    bool contiguous = true;
+    for (unsigned int k = 0; k < N; k++)
+        {
+        if (k > 0 && order[k].first == order[k-1].first)
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: Particle tag " << order[k].first
+                                      << " is stored more than once" << endl;
+            return false;
+            }
+        if (order[k].first != k)
+            contiguous = false;
+        }
+
+    SnapshotParticleData<Scalar>& pdata = m_snapshot->particle_data;
+    pdata.resize(N);
+    pdata.is_accel_set = true;
+
+    for (unsigned int k = 0; k < N; k++)
+        checkpoint_set_particle(pdata, k, all, order[k].second);
+
+    if (!contiguous)
+        {
+        m_exec_conf->msg->notice(2) << "read_checkpoint: Particle tags are not contiguous, renumbering particles"
+                                    << endl;
+
+        map<unsigned int, unsigned int> index;
+        for (unsigned int k = 0; k < N; k++)
+            index[order[k].first] = k;
+
+        for (unsigned int k = 0; k < N; k++)
+            {
+            if (pdata.body[k] < MIN_FLOPPY)
+                {
+                map<unsigned int, unsigned int>::iterator it = index.find(pdata.body[k]);
+                if (it == index.end())
+                    {
+                    m_exec_conf->msg->error() << "read_checkpoint: Body " << pdata.body[k] << " does not exist"
+                                              << endl;
+                    return false;
+                    }
+                pdata.body[k] = it->second;
+                }
+            }
+
+        if (!checkpoint_remap_bonded(m_snapshot->bond_data, index)
+            || !checkpoint_remap_bonded(m_snapshot->angle_data, index)
+            || !checkpoint_remap_bonded(m_snapshot->dihedral_data, index)
+            || !checkpoint_remap_bonded(m_snapshot->improper_data, index)
+            || !checkpoint_remap_bonded(m_snapshot->constraint_data, index)
+            || !checkpoint_remap_bonded(m_snapshot->pair_data, index))
+            {
+            m_exec_conf->msg->error() << "read_checkpoint: A bonded group references a particle that does not exist"
+                                      << endl;
+            return false;
+            }
+
+        m_restore_order = false;
+        }
+
+    return true;
+    }
+
+#ifdef ENABLE_MPI
+/*! \returns true if the snapshot was built, false if the particle tags are not contiguous
+
+    Rank r holds the tags [N*r/P, N*(r+1)/P) of the distributed snapshot, where N is the number of particles and P the
+    number of ranks. Every rank sends the particles of its file to the ranks that hold their tags, and places the
+    received particles at the index of their tag. The tags are contiguous if all of them are smaller than N and every
+    rank receives each of its tags exactly once. Otherwise, nothing is changed and the caller falls back to assembling
+    the snapshot on the root rank, which renumbers the particles.
+*/
+bool CheckpointReader::buildDistributedSnapshot()
+    {
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int rank = m_exec_conf->getRank();
+    uint64_t n_ranks = m_exec_conf->getNRanks();
+
+    unsigned int n_local = (unsigned int)m_local.tag.size();
+    unsigned int N = 0;
+    MPI_Allreduce(&n_local, &N, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+
+    int contiguous = 1;
+    for (unsigned int i = 0; i < n_local; i++)
+        {
+        if (m_local.tag[i] >= N)
+            {
+            contiguous = 0;
+            break;
+            }
+        }
+    MPI_Allreduce(MPI_IN_PLACE, &contiguous, 1, MPI_INT, MPI_LAND, mpi_comm);
+    if (! contiguous)
+        return false;
+
+    // send every particle to the rank that holds its tag
+    vector<CheckpointParticleData> send(n_ranks);
+    for (unsigned int i = 0; i < n_local; i++)
+        {
+        uint64_t tag = m_local.tag[i];
+        uint64_t dest = tag*n_ranks/N;
+        while (dest + 1 < n_ranks && N*(dest + 1)/n_ranks <= tag)
+            dest++;
+        while (N*dest/n_ranks > tag)
+            dest--;
+        send[dest].appendParticle(m_local, i);
+        }
+
+    vector<CheckpointParticleData> recv;
+    all_to_all_v(send, recv, mpi_comm);
+    send.clear();
+
+    CheckpointParticleData received;
+    for (unsigned int r = 0; r < recv.size(); r++)
+        received.append(recv[r]);
+    recv.clear();
+
+    // find the received particle of every tag of this rank
+    unsigned int first_tag = (unsigned int)(N*rank/n_ranks);
+    unsigned int n_own = (unsigned int)(N*(rank + 1)/n_ranks) - first_tag;
+    vector<unsigned int> index(n_own);
+    vector<bool> found(n_own, false);
+
+    if (received.tag.size() != n_own)
+        contiguous = 0;
+    for (unsigned int i = 0; i < received.tag.size() && contiguous; i++)
+        {
+        unsigned int k = received.tag[i] - first_tag;
+        if (received.tag[i] < first_tag || k >= n_own || found[k])
+            {
+            contiguous = 0;
+            break;
+            }
+        found[k] = true;
+        index[k] = i;
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, &contiguous, 1, MPI_INT, MPI_LAND, mpi_comm);
+    if (! contiguous)
+        return false;
+
+    SnapshotParticleData<Scalar>& pdata = m_snapshot->particle_data;
+    bcast(pdata.type_mapping, 0, mpi_comm);
+    pdata.resize(n_own);
+    pdata.is_accel_set = true;
+    pdata.is_distributed = true;
+
+    for (unsigned int k = 0; k < n_own; k++)
+        checkpoint_set_particle(pdata, k, received, index[k]);
+
+    return true;
+    }
+#endif
+
+/*! \param ok True if this rank succeeded
+
+    Throws on all ranks if any rank failed. The failing rank reports the error.
+*/
+void CheckpointReader::checkAll(bool ok)
+    {
+    int all_ok = ok;
+    #ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &all_ok, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (!all_ok)
+        throw runtime_error("Error reading checkpoint");
+    }
+
+/*! \param sysdef System initialized from the snapshot of this reader
+
+    The origin is always restored, because positions in the checkpoint are relative to it. The local arrays are
+    reordered to the saved order only when every rank holds exactly the particles it saved.
+*/
+void CheckpointReader::restoreLocalData(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setOrigin(m_origin, m_o_image);
+
+    unsigned int N = pdata->getN();
+    int match = m_restore_order && N == m_local.tag.size();
+    if (match)
+        {
+        RTagHandle rtag(*pdata, access_mode::read);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int tag = m_local.tag[i];
+            if (tag >= pdata->getNGlobal() || rtag[tag] >= N)
+                {
+                match = 0;
+                break;
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &match, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (!match)
+        {
+        m_exec_conf->msg->notice(2) << "read_checkpoint: The domain decomposition differs from the checkpoint, "
+                                    << "the local order of the particles is not restored" << endl;
+        m_local = CheckpointParticleData();
+        return;
+        }
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel(pdata->getAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter(pdata->getDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body(pdata->getBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom(pdata->getAngularMomentumArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia(pdata->getMomentsOfInertiaArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::overwrite);
+        RTagHandle rtag(*pdata, access_mode::readwrite);
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            h_pos.data[i] = m_local.pos[i];
+            h_vel.data[i] = m_local.vel[i];
+            h_accel.data[i] = m_local.accel[i];
+            h_charge.data[i] = m_local.charge[i];
+            h_diameter.data[i] = m_local.diameter[i];
+            h_image.data[i] = m_local.image[i];
+            h_body.data[i] = m_local.body[i];
+            h_orientation.data[i] = m_local.orientation[i];
+            h_angmom.data[i] = m_local.angmom[i];
+            h_inertia.data[i] = m_local.inertia[i];
+            h_tag.data[i] = m_local.tag[i];
+            rtag.set(m_local.tag[i], i);
+            }
+        }
+
+    pdata->notifyParticleSort();
+    m_local = CheckpointParticleData();
+    }
+
+void export_Checkpoint(py::module& m)
+    {
+    py::class_<CheckpointWriter, std::shared_ptr<CheckpointWriter> >(m, "CheckpointWriter", py::base<Analyzer>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::string >())
+    ;
+
+    py::class_< CheckpointReader, std::shared_ptr<CheckpointReader> >(m, "CheckpointReader")
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&>())
+    .def("getTimeStep", &CheckpointReader::getTimeStep)
+    .def("getSnapshot", &CheckpointReader::getSnapshot)
+    .def("clearSnapshot", &CheckpointReader::clearSnapshot)
+    .def("restoreLocalData", &CheckpointReader::restoreLocalData)
+    ;
+    }
@@ -0,0 +1,203 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file Checkpoint.h
+    \brief Declares the CheckpointWriter and CheckpointReader classes
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "Analyzer.h"
+#include "SnapshotSystemData.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdint.h>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Save a vector of plain data to a checkpoint as a single block of bytes
+template<class T>
+void checkpoint_array(cereal::BinaryOutputArchive& ar, std::vector<T>& v)
+    {
+    uint64_t n = v.size();
+    ar(n);
+    if (n > 0)
+        ar(cereal::binary_data(&v[0], n*sizeof(T)));
+    }
+
+//! Load a vector of plain data from a checkpoint
+template<class T>
+void checkpoint_array(cereal::BinaryInputArchive& ar, std::vector<T>& v)
+    {
+    uint64_t n = 0;
+    ar(n);
+    v.resize(n);
+    if (n > 0)
+        ar(cereal::binary_data(&v[0], n*sizeof(T)));
+    }
+
+//! Local particle data of one rank in a checkpoint
+/*! The arrays hold the local particles in the order of the ParticleData arrays, with the same packing of positions
+    and types, and velocities and masses. Positions and images are stored as they are, relative to the current
+    origin of the box (see ParticleData::translateOrigin()).
+*/
+struct CheckpointParticleData
+    {
+    std::vector<Scalar4> pos;           //!< Positions and types
+    std::vector<Scalar4> vel;           //!< Velocities and masses
+    std::vector<Scalar3> accel;         //!< Accelerations
+    std::vector<Scalar> charge;         //!< Charges
+    std::vector<Scalar> diameter;       //!< Diameters
+    std::vector<int3> image;            //!< Images
+    std::vector<unsigned int> body;     //!< Body ids
+    std::vector<Scalar4> orientation;   //!< Orientations
+    std::vector<Scalar4> angmom;        //!< Angular momenta
+    std::vector<Scalar3> inertia;       //!< Principal moments of inertia
+    std::vector<unsigned int> tag;      //!< Global tags
+
+    //! Copy the local particles out of the particle data
+    void take(std::shared_ptr<ParticleData> pdata);
+
+    //! Append the particles of another rank
+    void append(const CheckpointParticleData& other);
+
+    //! Append a single particle of another rank
+    void appendParticle(const CheckpointParticleData& other, unsigned int i);
+
+    //! Check that all arrays have the same length
+    bool validate() const;
+
+    //! Serialize the arrays
+    template<class Archive>
+    void serialize(Archive& ar)
+        {
+        checkpoint_array(ar, pos);
+        checkpoint_array(ar, vel);
+        checkpoint_array(ar, accel);
+        checkpoint_array(ar, charge);
+        checkpoint_array(ar, diameter);
+        checkpoint_array(ar, image);
+        checkpoint_array(ar, body);
+        checkpoint_array(ar, orientation);
+        checkpoint_array(ar, angmom);
+        checkpoint_array(ar, inertia);
+        checkpoint_array(ar, tag);
+        }
+    };
+
+//! Writes checkpoints of the system state for exact restarts
+/*! A checkpoint stores the state of the system in native precision, so that CheckpointReader restores it bit for
+    bit. Every rank writes its local particles, in the order of the ParticleData arrays, to its own file: rank 0
+    writes \a fname, and rank \a r writes \a fname.r. The file of rank 0 also holds the global part of the state:
+    the box and its origin, the type names, the bonds, angles, dihedrals, impropers, constraints and special pairs,
+    and the variables of all integrators registered with IntegratorData (thermostat and barostat state).
+
+    Each file starts with a header of the magic bytes "HOOMDCKP", the format version, the size of Scalar, the number
+    of ranks, the rank and the time step. All sections are written with cereal binary archives, and the
+    per-particle arrays as single blocks of bytes.
+
+    The files are written under a temporary name and renamed once all ranks have written theirs, so an interrupted
+    write leaves the previous checkpoint intact. Per-rank files are only replaced together, but the renames are not
+    atomic across ranks.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT CheckpointWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname);
+
+        //! Destructor
+        ~CheckpointWriter();
+
+        //! Write a checkpoint of the current state
+        void analyze(unsigned int timestep);
+
+    private:
+        std::string m_fname;    //!< The name of the file written by rank 0
+    };
+
+//! Reads a checkpoint written by CheckpointWriter
+/*! The snapshot holds each particle at the index of its tag, so that tags, bonded groups and random number streams
+    keep their identity. When the checkpoint was written by the same number of ranks, every rank reads its own file
+    and sends the particles to the rank that holds their range of tags in a distributed snapshot
+    (SnapshotParticleData::is_distributed), so the particles never pass through a single rank. When it was written by
+    a different number of ranks, or the tags are not contiguous, the root rank reads all files and assembles the
+    snapshot.
+
+    The snapshot restores all values exactly. After the system is initialized from it, restoreLocalData() restores
+    the origin of the box and, when every rank received the same particles it saved, the order of the particles in
+    the local arrays. That is the case when the checkpoint was written with the same number of ranks and domain
+    decomposition, and the particles had been migrated to their domains.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT CheckpointReader
+    {
+    public:
+        //! Read the checkpoint
+        CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& fname);
+
+        //! Returns the time step of the checkpoint
+        uint64_t getTimeStep() const
+            {
+            return m_timestep;
+            }
+
+        //! Returns the snapshot of the system
+        std::shared_ptr< SnapshotSystemData<Scalar> > getSnapshot() const
+            {
+            return m_snapshot;
+            }
+
+        //! Clears the snapshot object
+        void clearSnapshot()
+            {
+            m_snapshot.reset();
+            }
+
+        //! Restore the origin and the local order of the particles
+        void restoreLocalData(std::shared_ptr<SystemDefinition> sysdef);
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< The execution configuration
+        std::string m_fname;                                        //!< The name of the file of rank 0
+        uint64_t m_timestep;                                        //!< Time step of the checkpoint
+        unsigned int m_n_saved_ranks;                               //!< Number of ranks that wrote the checkpoint
+        std::shared_ptr< SnapshotSystemData<Scalar> > m_snapshot;   //!< The snapshot of the system
+        CheckpointParticleData m_local;                             //!< Particles saved by this rank
+        bool m_restore_order;                                       //!< True if the local order can be restored
+        Scalar3 m_origin;                                           //!< Origin of the box
+        int3 m_o_image;                                             //!< Image of the origin
+
+        //! Read the file written by a rank
+        bool readFile(unsigned int rank, CheckpointParticleData& local);
+
+        //! Assemble the snapshot from the particles of all ranks
+        bool buildSnapshot(const std::vector<CheckpointParticleData>& locals);
+
+        #ifdef ENABLE_MPI
+        //! Build a distributed snapshot from the particles of every rank
+        bool buildDistributedSnapshot();
+        #endif
+
+        //! Raise an error on all ranks if any rank failed
+        void checkAll(bool ok);
+    };
+
+//! Exports CheckpointWriter and CheckpointReader to python
+void export_Checkpoint(pybind11::module& m);
+
+#endif
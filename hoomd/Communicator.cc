@@ -15,6 +15,7 @@
 #include "HOOMDMPI.h"
 
 #include <algorithm>
+#include <cstring>
 #include <hoomd/extern/pybind/include/pybind11/stl.h>
 
 
@@ -62,7 +63,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<typename group_data::members_t> h_members(m_gdata->getMembersArray(), access_location::host, access_mode::read);
             ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_comm.m_pdata, access_mode::read);
 
             ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location:: host, access_mode::read);
 
@@ -88,7 +89,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 for (unsigned int i = 0; i < group_data::size; i++)
                     {
                     unsigned int tag = g.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (pidx == NOT_LOCAL)
                         {
@@ -360,7 +361,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
             ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_comm.m_pdata, access_mode::read);
             ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
 
             unsigned int ngroups = m_gdata->getN();
@@ -375,7 +376,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 for (unsigned int i = 0; i < group_data::size; ++i)
                     {
                     unsigned int tag = members.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (pidx != NOT_LOCAL && h_comm_flags.data[pidx])
                         {
@@ -404,7 +405,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                     for (unsigned int i = 0; i < group_data::size; ++i)
                         {
                         unsigned int tag = members.tag[i];
-                        unsigned int pidx = h_rtag.data[tag];
+                        unsigned int pidx = h_rtag[tag];
 
                         if (pidx != NOT_LOCAL && !h_comm_flags.data[pidx])
                             {
@@ -702,7 +703,7 @@ void Communicator::GroupCommunicator<group_data>::markGhostParticles(
         {
         ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
         ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*m_comm.m_pdata, access_mode::read);
         ArrayHandle<Scalar4> h_postype(m_comm.m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_plan(plans, access_location::host, access_mode::readwrite);
 
@@ -754,7 +755,7 @@ void Communicator::GroupCommunicator<group_data>::markGhostParticles(
                     for (unsigned int j = 0; j < group_data::size; ++j)
                         {
                         unsigned int tag_j = g.tag[j];
-                        unsigned int rtag_j = h_rtag.data[tag_j];
+                        unsigned int rtag_j = h_rtag[tag_j];
 
                         if (rtag_j != NOT_LOCAL)
                             {
@@ -808,7 +809,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
 
             {
             ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_comm.m_pdata, access_mode::read);
             ArrayHandle<unsigned int> h_plan(plans, access_location::host, access_mode::read);
 
             unsigned int ngroups_local = m_gdata->getN();
@@ -825,7 +826,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 for (unsigned int i = 0; i < group_data::size; ++i)
                     {
                     unsigned int tag = members.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (i==0 && pidx >= n_local)
                         {
@@ -1002,7 +1003,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
 
                 // access particle data
-                ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+                RTagHandle h_rtag(*m_comm.m_pdata, access_mode::read);
 
                 unsigned int max_local = m_comm.m_pdata->getN() + m_comm.m_pdata->getNGhosts();
 
@@ -1018,7 +1019,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                         {
                         unsigned int tag = el.tags.tag[j];
                         assert(tag <= m_comm.m_pdata->getMaximumTag());
-                        if (h_rtag.data[tag] >= max_local)
+                        if (h_rtag[tag] >= max_local)
                             {
                             has_nonlocal_members = true;
                             break;
@@ -1080,6 +1081,23 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_netvirial_copybuf(m_exec_conf),
             m_netvirial_recvbuf(m_exec_conf),
             m_plan(m_exec_conf),
+            m_single_stage(false),
+            m_ghosts_single_stage(false),
+            m_direct_copy_ghosts(m_exec_conf),
+            m_update_copybuf(m_exec_conf),
+            m_update_recvbuf(m_exec_conf),
+            m_update_reqs_flags(0),
+            m_update_reqs_valid(false),
+            m_compress_ghost_updates(false),
+            m_ghost_ref_valid(false),
+            m_ghost_ref_send(m_exec_conf),
+            m_ghost_ref_recv(m_exec_conf),
+            m_shared_ghost_updates(false),
+            m_node_comm(MPI_COMM_NULL),
+            m_shared_win(MPI_WIN_NULL),
+            m_shared_buf(NULL),
+            m_shared_capacity(0),
+            m_shared_parity(0),
             m_plan_reverse(m_exec_conf),
             m_tag_reverse(m_exec_conf),
             m_netforce_reverse_copybuf(m_exec_conf),
@@ -1087,9 +1105,13 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_r_ghost_max(Scalar(0.0)),
             m_r_extra_ghost_max(Scalar(0.0)),
             m_ghosts_added(0),
+            m_compute_time(0.0),
+            m_collective_time(0.0),
             m_has_ghost_particles(false),
             m_last_flags(0),
             m_comm_pending(false),
+            m_pending_recv_start(0),
+            m_pending_recv_count(0),
             m_bond_comm(*this, m_sysdef->getBondData()),
             m_angle_comm(*this, m_sysdef->getAngleData()),
             m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -1235,9 +1257,33 @@ Communicator::~Communicator()
     m_sysdef->getConstraintData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setConstraintsChanged>(this);
     m_sysdef->getPairData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setPairsChanged>(this);
 
+    freeUpdateRequests();
+    freeSharedWindow();
+    if (m_node_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&m_node_comm);
+
     MPI_Type_free(&m_mpi_pdata_element);
     }
 
+void Communicator::setSharedGhostUpdates(bool shared)
+    {
+    if (shared && m_node_comm == MPI_COMM_NULL)
+        {
+        // group the ranks that can share memory
+        int rank;
+        MPI_Comm_rank(m_mpi_comm, &rank);
+        MPI_Comm_split_type(m_mpi_comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_node_comm);
+
+        int node_size;
+        MPI_Comm_size(m_node_comm, &node_size);
+        m_exec_conf->msg->notice(4) << "Communicator: " << node_size << " ranks share memory with rank " << rank
+            << std::endl;
+        }
+
+    m_shared_ghost_updates = shared;
+    forceMigrate();
+    }
+
 void Communicator::initializeNeighborArrays()
     {
     Index3D di= m_decomposition->getDomainIndexer();
@@ -1328,6 +1374,84 @@ void Communicator::initializeNeighborArrays()
         h_adj_mask.data[n] = it->second;
         n++;
         }
+
+    // directions of the single-stage exchange, in the same order on every rank
+    m_direct_code.clear();
+    m_direct_mask.clear();
+    m_direct_send_rank.clear();
+    m_direct_recv_rank.clear();
+
+    int3 grid_pos = make_int3(mypos.x, mypos.y, mypos.z);
+    int3 dim = make_int3(di.getW(), di.getH(), di.getD());
+    for (unsigned int code = 0; code < NEIGH_MAX; ++code)
+        {
+        int3 d = make_int3((int)(code % 3) - 1, (int)((code/3) % 3) - 1, (int)(code/9) - 1);
+
+        // exclude ourselves, and directions without communication
+        if (!d.x && !d.y && !d.z) continue;
+        if ((d.x && dim.x == 1) || (d.y && dim.y == 1) || (d.z && dim.z == 1)) continue;
+
+        unsigned int mask = 0;
+        if (d.x == 1) mask |= send_east;
+        if (d.x == -1) mask |= send_west;
+        if (d.y == 1) mask |= send_north;
+        if (d.y == -1) mask |= send_south;
+        if (d.z == 1) mask |= send_up;
+        if (d.z == -1) mask |= send_down;
+
+        // we receive from the direction opposite to the one we send to
+        int3 send_pos = make_int3((grid_pos.x + d.x + dim.x) % dim.x, (grid_pos.y + d.y + dim.y) % dim.y,
+            (grid_pos.z + d.z + dim.z) % dim.z);
+        int3 recv_pos = make_int3((grid_pos.x - d.x + dim.x) % dim.x, (grid_pos.y - d.y + dim.y) % dim.y,
+            (grid_pos.z - d.z + dim.z) % dim.z);
+
+        m_direct_code.push_back(code);
+        m_direct_mask.push_back(mask);
+        m_direct_send_rank.push_back(h_cart_ranks.data[di(send_pos.x, send_pos.y, send_pos.z)]);
+        m_direct_recv_rank.push_back(h_cart_ranks.data[di(recv_pos.x, recv_pos.y, recv_pos.z)]);
+        }
+
+    // group the directions by neighbor rank, so that there is one message per neighbor. Within a group, the
+    // directions are ordered by their code, which is the same order the neighbor uses on its end
+    unsigned int n_dirs = m_direct_code.size();
+    m_direct_send_order.resize(n_dirs);
+    m_direct_recv_order.resize(n_dirs);
+    for (unsigned int i = 0; i < n_dirs; ++i)
+        {
+        m_direct_send_order[i] = i;
+        m_direct_recv_order[i] = i;
+        }
+
+    std::stable_sort(m_direct_send_order.begin(), m_direct_send_order.end(),
+        [this](unsigned int a, unsigned int b) { return m_direct_send_rank[a] < m_direct_send_rank[b]; });
+    std::stable_sort(m_direct_recv_order.begin(), m_direct_recv_order.end(),
+        [this](unsigned int a, unsigned int b) { return m_direct_recv_rank[a] < m_direct_recv_rank[b]; });
+
+    m_direct_send_neigh.clear();
+    m_direct_send_begin.clear();
+    m_direct_recv_neigh.clear();
+    m_direct_recv_begin.clear();
+    for (unsigned int k = 0; k < n_dirs; ++k)
+        {
+        unsigned int send_rank = m_direct_send_rank[m_direct_send_order[k]];
+        if (! k || send_rank != m_direct_send_neigh.back())
+            {
+            m_direct_send_neigh.push_back(send_rank);
+            m_direct_send_begin.push_back(k);
+            }
+
+        unsigned int recv_rank = m_direct_recv_rank[m_direct_recv_order[k]];
+        if (! k || recv_rank != m_direct_recv_neigh.back())
+            {
+            m_direct_recv_neigh.push_back(recv_rank);
+            m_direct_recv_begin.push_back(k);
+            }
+        }
+    m_direct_send_begin.push_back(n_dirs);
+    m_direct_recv_begin.push_back(n_dirs);
+
+    m_direct_send_offs.assign(n_dirs+1, 0);
+    m_direct_recv_offs.assign(n_dirs+1, 0);
     }
 
 //! Interface to the communication methods.
@@ -1348,6 +1472,10 @@ void Communicator::communicate(unsigned int timestep)
         {
         // do an obligatory update before determining whether to migrate
         beginUpdateGhosts(timestep);
+
+        // overlap the ghost update with computations on the local particles
+        m_local_compute_callbacks.emit(timestep);
+
         finishUpdateGhosts(timestep);
 
         // call subscribers after ghost update, but before distance check
@@ -1376,6 +1504,8 @@ void Communicator::communicate(unsigned int timestep)
         {
         beginUpdateGhosts(timestep);
 
+        m_local_compute_callbacks.emit(timestep);
+
         finishUpdateGhosts(timestep);
         }
 
@@ -1636,6 +1766,11 @@ void Communicator::exchangeGhosts()
         ghost_fractions_body[cur_type] = h_r_ghost_body.data[cur_type] / box_dist;
         }
 
+    // staggered cuts are tested in fractions of the global box
+    const bool staggered = m_decomposition->isStaggered();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 global_box_dist = global_box.getNearestPlaneDistance();
+
         {
         // scan all local atom positions if they are within r_ghost from a neighbor
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
@@ -1674,6 +1809,15 @@ void Communicator::exchangeGhosts()
 
             if (f.z < ghost_fraction.z)
                 h_plan.data[idx] |= send_down;
+
+            if (staggered)
+                {
+                Scalar3 global_ghost_fraction = h_r_ghost.data[type] / global_box_dist;
+                if (h_body.data[idx] < MIN_FLOPPY)
+                    global_ghost_fraction += h_r_ghost_body.data[type] / global_box_dist;
+
+                h_plan.data[idx] = getStaggeredPlan(global_box.makeFraction(pos), global_ghost_fraction, h_plan.data[idx]);
+                }
             }
         }
 
@@ -1708,9 +1852,19 @@ void Communicator::exchangeGhosts()
     // ghost particle flags
     CommFlags flags = getFlags();
 
+    // the persistent requests of the ghost update refer to the previous ghost lists
+    freeUpdateRequests();
+
+    // reverse net forces are sent back along the routes of the staged exchange
+    m_ghosts_single_stage = m_single_stage && !flags[comm_flag::reverse_net_force];
+
+    if (m_ghosts_single_stage)
+        exchangeGhostsSingleStage(flags);
+
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
-        if (! isCommunicating(dir) ) continue;
+        // in single-stage mode, the ghosts have already been sent to all neighbors
+        if (! isCommunicating(dir) || m_ghosts_single_stage) continue;
 
         m_num_copy_ghosts[dir] = 0;
 
@@ -2068,13 +2222,13 @@ void Communicator::exchangeGhosts()
             {
             // set reverse-lookup tag -> idx
             ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+            RTagHandle h_rtag(*m_pdata, access_mode::readwrite);
 
             for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
                 {
                 assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-                assert(h_rtag.data[h_tag.data[idx]] == NOT_LOCAL);
-                h_rtag.data[h_tag.data[idx]] = idx;
+                assert(h_rtag[h_tag.data[idx]] == NOT_LOCAL);
+                h_rtag.set(h_tag.data[idx], idx);
                 }
 
             }
@@ -2082,6 +2236,8 @@ void Communicator::exchangeGhosts()
 
     m_ghosts_added = m_pdata->getNGhosts();
 
+    storeGhostReferencePositions(flags);
+
     // exchange ghost constraints along with ghost particles
     m_constraint_comm.exchangeGhostGroups(m_plan, mask);
 
@@ -2338,168 +2494,374 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
 
     m_exec_conf->msg->notice(7) << "Communicator: update ghosts" << std::endl;
 
+    if (m_ghosts_single_stage)
+        {
+        beginUpdateGhostsSingleStage(getFlags());
+
+        if (m_prof)
+            m_prof->pop();
+        return;
+        }
+
     // update data in these arrays
 
     unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
 
+    // the transfer in the last direction is completed in finishUpdateGhosts()
+    unsigned int last_dir = 6;
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        if (isCommunicating(dir)) last_dir = dir;
+
+    // only non-permanent fields (position, velocity, orientation) need to be considered here
+    // charge, body, image and diameter are not updated between neighbor list builds
+    CommFlags flags = getFlags();
+    size_t sz = getUpdateRecordSize(flags);
+
+    // offset of the current direction in the reference positions of the sent ghosts
+    unsigned int ref_offset = 0;
+
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         if (! isCommunicating(dir) ) continue;
 
-        CommFlags flags = getFlags();
+        // pack all updated fields of a ghost into one record
+        m_update_copybuf.resize(sz*m_num_copy_ghosts[dir]);
+        m_update_recvbuf.resize(sz*m_num_recv_ghosts[dir]);
 
-        if (flags[comm_flag::position])
             {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            ArrayHandle<char> h_update_copybuf(m_update_copybuf, access_location::host, access_mode::overwrite);
+            packGhostUpdates(flags, h_copy_ghosts.data, m_num_copy_ghosts[dir], ref_offset, h_update_copybuf.data);
+            }
 
-            // copy positions of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+        ref_offset += m_num_copy_ghosts[dir];
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
 
-                // copy position into send buffer
-                h_pos_copybuf.data[ghost_idx] = h_pos.data[idx];
-                }
-            }
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
 
-        if (flags[comm_flag::velocity])
-            {
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
-            // copy velocity of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
-                {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+        unsigned int start_idx;
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+        if (m_prof)
+            m_prof->push("MPI send/recv");
 
-                // copy velocity into send buffer
-                h_velocity_copybuf.data[ghost_idx] = h_vel.data[idx];
+        start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+
+        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+
+        // a single message per direction carries all fields
+        m_reqs.clear();
+
+            {
+            ArrayHandle<char> h_update_copybuf(m_update_copybuf, access_location::host, access_mode::read);
+            ArrayHandle<char> h_update_recvbuf(m_update_recvbuf, access_location::host, access_mode::overwrite);
+
+            MPI_Request req;
+            if (m_num_copy_ghosts[dir])
+                {
+                MPI_Isend(h_update_copybuf.data, m_num_copy_ghosts[dir]*sz, MPI_BYTE, send_neighbor, 1, m_mpi_comm, &req);
+                m_reqs.push_back(req);
+                }
+            if (m_num_recv_ghosts[dir])
+                {
+                MPI_Irecv(h_update_recvbuf.data, m_num_recv_ghosts[dir]*sz, MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &req);
+                m_reqs.push_back(req);
                 }
             }
 
-        if (flags[comm_flag::orientation])
+        if (dir == last_dir)
             {
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            // leave the transfer pending, the ghosts of this direction are not forwarded any further
+            m_comm_pending = true;
+            m_pending_recv_start = start_idx;
+            m_pending_recv_count = m_num_recv_ghosts[dir];
+            }
+        else if (m_reqs.size())
+            {
+            m_stats.resize(m_reqs.size());
+            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+            }
 
-            // copy orientation of ghost particles
-            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+        if (m_prof)
+            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
+
+        if (dir != last_dir)
+            {
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                ArrayHandle<char> h_update_recvbuf(m_update_recvbuf, access_location::host, access_mode::read);
+                unpackGhostUpdates(flags, start_idx, m_num_recv_ghosts[dir], h_update_recvbuf.data);
+                }
 
-                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+            // wrap particle positions (only if copying positions)
+            if (flags[comm_flag::position])
+                wrapGhostPositions(start_idx, m_num_recv_ghosts[dir]);
+            }
 
-                // copy orientation into send buffer
-                h_orientation_copybuf.data[ghost_idx] = h_orientation.data[idx];
-                }
+        } // end dir loop
+
+        if (m_prof)
+            m_prof->pop();
+    }
+
+//! finish the update of ghost particles
+void Communicator::finishUpdateGhosts(unsigned int timestep)
+    {
+    if (! m_comm_pending)
+        return;
+
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
+
+    if (m_ghosts_single_stage)
+        {
+        // wait for the transfers from all neighbors
+        finishUpdateGhostsSingleStage(getFlags());
+        }
+    else
+        {
+        // wait for the transfer in the last direction
+        if (m_reqs.size())
+            {
+            m_stats.resize(m_reqs.size());
+            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
             }
 
+        ArrayHandle<char> h_update_recvbuf(m_update_recvbuf, access_location::host, access_mode::read);
+        unpackGhostUpdates(getFlags(), m_pending_recv_start, m_pending_recv_count, h_update_recvbuf.data);
+        }
 
-        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+    if (getFlags()[comm_flag::position])
+        wrapGhostPositions(m_pending_recv_start, m_pending_recv_count);
 
-        // we receive from the direction opposite to the one we send to
-        unsigned int recv_neighbor;
-        if (dir % 2 == 0)
-            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
-        else
-            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+    m_comm_pending = false;
 
+    if (m_prof)
+        m_prof->pop();
+    }
 
-        unsigned int start_idx;
+/*! \param start_idx First index of the received ghost particles
+    \param n_recv Number of received ghost particles
+ */
+void Communicator::wrapGhostPositions(unsigned int start_idx, unsigned int n_recv)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
 
-        if (m_prof)
-            m_prof->push("MPI send/recv");
+    const BoxDim shifted_box = getShiftedBox();
+    for (unsigned int idx = start_idx; idx < start_idx + n_recv; idx++)
+        {
+        Scalar4& pos = h_pos.data[idx];
 
-        start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+        // wrap particles received across a global boundary
+        int3 img = make_int3(0,0,0);
+        shifted_box.wrap(pos, img);
+        }
+    }
 
-        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+/*! \param flags The ghost communication flags
+    \returns The size of the record of one ghost in bytes
+ */
+size_t Communicator::getUpdateRecordSize(const CommFlags& flags) const
+    {
+    size_t sz = 0;
+    if (flags[comm_flag::position])
+        sz += (m_compress_ghost_updates && m_ghost_ref_valid) ? 3*sizeof(float) : sizeof(Scalar4);
+    if (flags[comm_flag::velocity])
+        sz += sizeof(Scalar4);
+    if (flags[comm_flag::orientation])
+        sz += sizeof(Scalar4);
+    return sz;
+    }
 
-        size_t sz = 0;
-        // only non-permanent fields (position, velocity, orientation) need to be considered here
-        // charge, body, image and diameter are not updated between neighbor list builds
-        if (flags[comm_flag::position])
-            {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+/*! \param flags The ghost communication flags
+    \param tags Tags of the ghosts to send
+    \param n_send Number of ghosts to send
+    \param ref_offset Index of the first ghost in m_ghost_ref_send
+    \param buf Buffer to store the records in
+
+    The fields are stored in the order position, velocity, orientation, omitting those that are not updated.
+    Compressed positions are stored as the minimum image displacement from the reference position, in single
+    precision. \a buf must hold at least getUpdateRecordSize(flags)*n_send bytes.
+ */
+void Communicator::packGhostUpdates(const CommFlags& flags, const unsigned int *tags, unsigned int n_send,
+    unsigned int ref_offset, char *buf)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    RTagHandle h_rtag(*m_pdata, access_mode::read);
+    ArrayHandle<Scalar3> h_ghost_ref_send(m_ghost_ref_send, access_location::host, access_mode::read);
 
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+    bool send_pos = flags[comm_flag::position];
+    bool send_vel = flags[comm_flag::velocity];
+    bool send_orientation = flags[comm_flag::orientation];
+    bool compress = m_compress_ghost_updates && m_ghost_ref_valid;
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+    const BoxDim& global_box = m_pdata->getGlobalBox();
 
-            sz += sizeof(Scalar4);
+    char *rec = buf;
+    for (unsigned int ghost_idx = 0; ghost_idx < n_send; ghost_idx++)
+        {
+        unsigned int idx = h_rtag[tags[ghost_idx]];
+        assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+        if (send_pos && compress)
+            {
+            // the particle may have been wrapped across the global boundary since the exchange
+            Scalar4 postype = h_pos.data[idx];
+            Scalar3 ref = h_ghost_ref_send.data[ref_offset + ghost_idx];
+            Scalar3 dr = global_box.minImage(make_scalar3(postype.x, postype.y, postype.z) - ref);
+
+            float disp[3] = {float(dr.x), float(dr.y), float(dr.z)};
+            memcpy(rec, disp, sizeof(disp));
+            rec += sizeof(disp);
+            }
+        else if (send_pos)
+            {
+            memcpy(rec, &h_pos.data[idx], sizeof(Scalar4));
+            rec += sizeof(Scalar4);
             }
 
-        if (flags[comm_flag::velocity])
+        if (send_vel)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            memcpy(rec, &h_vel.data[idx], sizeof(Scalar4));
+            rec += sizeof(Scalar4);
+            }
 
-            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+        if (send_orientation)
+            {
+            memcpy(rec, &h_orientation.data[idx], sizeof(Scalar4));
+            rec += sizeof(Scalar4);
+            }
+        }
+    }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+/*! \param flags The ghost communication flags
+    \param start_idx Index of the first ghost in the particle data
+    \param n_recv Number of received ghosts
+    \param buf Buffer holding the records
 
-            sz += sizeof(Scalar4);
+    Compressed positions are added to the reference positions of the ghosts, the particle type is left unchanged.
+ */
+void Communicator::unpackGhostUpdates(const CommFlags& flags, unsigned int start_idx, unsigned int n_recv,
+    const char *buf)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_ghost_ref_recv(m_ghost_ref_recv, access_location::host, access_mode::read);
+
+    bool recv_pos = flags[comm_flag::position];
+    bool recv_vel = flags[comm_flag::velocity];
+    bool recv_orientation = flags[comm_flag::orientation];
+    bool compress = m_compress_ghost_updates && m_ghost_ref_valid;
+
+    unsigned int n_local = m_pdata->getN();
+
+    const char *rec = buf;
+    for (unsigned int idx = start_idx; idx < start_idx + n_recv; idx++)
+        {
+        if (recv_pos && compress)
+            {
+            float disp[3];
+            memcpy(disp, rec, sizeof(disp));
+            rec += sizeof(disp);
+
+            Scalar3 ref = h_ghost_ref_recv.data[idx - n_local];
+            h_pos.data[idx].x = ref.x + Scalar(disp[0]);
+            h_pos.data[idx].y = ref.y + Scalar(disp[1]);
+            h_pos.data[idx].z = ref.z + Scalar(disp[2]);
+            }
+        else if (recv_pos)
+            {
+            memcpy(&h_pos.data[idx], rec, sizeof(Scalar4));
+            rec += sizeof(Scalar4);
             }
 
-        if (flags[comm_flag::orientation])
+        if (recv_vel)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            memcpy(&h_vel.data[idx], rec, sizeof(Scalar4));
+            rec += sizeof(Scalar4);
+            }
 
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+        if (recv_orientation)
+            {
+            memcpy(&h_orientation.data[idx], rec, sizeof(Scalar4));
+            rec += sizeof(Scalar4);
+            }
+        }
+    }
 
-            // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+/*! \param flags The ghost communication flags of the exchange
 
-            sz += sizeof(Scalar4);
+    Called at the end of the ghost exchange, when the positions of all sent and received ghosts are current. The
+    sent ghosts are recorded in the order of the send lists, i.e. by direction in the staged exchange and by
+    destination rank in the single-stage exchange.
+ */
+void Communicator::storeGhostReferencePositions(const CommFlags& flags)
+    {
+    m_ghost_ref_valid = m_compress_ghost_updates && flags[comm_flag::position];
+    if (! m_ghost_ref_valid)
+        return;
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    RTagHandle h_rtag(*m_pdata, access_mode::read);
+
+    // positions of the sent ghosts
+    if (m_ghosts_single_stage)
+        {
+        unsigned int n_send_tot = m_direct_send_offs.back();
+        m_ghost_ref_send.resize(n_send_tot);
+
+        ArrayHandle<Scalar3> h_ghost_ref_send(m_ghost_ref_send, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_copy_ghosts(m_direct_copy_ghosts, access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < n_send_tot; ++i)
+            {
+            Scalar4 postype = h_pos.data[h_rtag[h_copy_ghosts.data[i]]];
+            h_ghost_ref_send.data[i] = make_scalar3(postype.x, postype.y, postype.z);
             }
+        }
+    else
+        {
+        unsigned int n_send_tot = 0;
+        for (unsigned int dir = 0; dir < 6; ++dir)
+            if (isCommunicating(dir))
+                n_send_tot += m_num_copy_ghosts[dir];
 
-        if (m_prof)
-            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
+        m_ghost_ref_send.resize(n_send_tot);
 
+        ArrayHandle<Scalar3> h_ghost_ref_send(m_ghost_ref_send, access_location::host, access_mode::overwrite);
 
-        // wrap particle positions (only if copying positions)
-        if (flags[comm_flag::position])
+        unsigned int n = 0;
+        for (unsigned int dir = 0; dir < 6; ++dir)
             {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+            if (! isCommunicating(dir)) continue;
 
-            const BoxDim shifted_box = getShiftedBox();
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < m_num_copy_ghosts[dir]; ++i)
                 {
-                Scalar4& pos = h_pos.data[idx];
-
-                // wrap particles received across a global boundary
-                int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos, img);
+                Scalar4 postype = h_pos.data[h_rtag[h_copy_ghosts.data[i]]];
+                h_ghost_ref_send.data[n++] = make_scalar3(postype.x, postype.y, postype.z);
                 }
             }
+        }
 
-        } // end dir loop
+    // positions of the received ghosts
+    unsigned int n_local = m_pdata->getN();
+    m_ghost_ref_recv.resize(m_ghosts_added);
 
-        if (m_prof)
-            m_prof->pop();
+    ArrayHandle<Scalar3> h_ghost_ref_recv(m_ghost_ref_recv, access_location::host, access_mode::overwrite);
+    for (unsigned int i = 0; i < m_ghosts_added; ++i)
+        {
+        Scalar4 postype = h_pos.data[n_local + i];
+        h_ghost_ref_recv.data[i] = make_scalar3(postype.x, postype.y, postype.z);
+        }
     }
 
 void Communicator::updateNetForce(unsigned int timestep)
@@ -2534,6 +2896,15 @@ void Communicator::updateNetForce(unsigned int timestep)
 
     m_exec_conf->msg->notice(7) << oss.str() << std::endl;
 
+    if (m_ghosts_single_stage)
+        {
+        updateNetForceSingleStage(flags);
+
+        if (m_prof)
+            m_prof->pop();
+        return;
+        }
+
     // Set some global counters
     unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
     unsigned int num_tot_recv_ghosts_reverse = 0; // total number of ghosts received in reverse direction
@@ -2595,12 +2966,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_netforce_copybuf(m_netforce_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy net forces of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2616,12 +2987,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce_reverse_recvbuf(m_netforce_reverse_recvbuf, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_forward_ghosts_reverse(m_forward_ghosts_reverse[dir], access_location::host, access_mode::overwrite);
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy reverse net force of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_local_ghosts_reverse[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts_reverse.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts_reverse.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2642,12 +3013,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_nettorque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_nettorque_copybuf(m_nettorque_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy net torques of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2660,14 +3031,14 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar> h_netvirial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
             ArrayHandle<Scalar> h_netvirial_copybuf(m_netvirial_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_pdata, access_mode::read);
 
             unsigned int pitch = m_pdata->getNetVirial().getPitch();
 
             // copy net torques of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2743,12 +3114,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_netforce_reverse_recvbuf(m_netforce_reverse_recvbuf, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_tag_reverse(m_tag_reverse, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            RTagHandle h_rtag(*m_pdata, access_mode::read);
 
             unsigned int n_local_particles = m_pdata->getN();
             for(unsigned int i = 0; i < m_num_recv_forward_ghosts_reverse[dir] + m_num_recv_local_ghosts_reverse[dir]; i++)
                 {
-                unsigned int idx = h_rtag.data[h_tag_reverse.data[start_idx_reverse + i]];
+                unsigned int idx = h_rtag[h_tag_reverse.data[start_idx_reverse + i]];
                 if (idx < n_local_particles)
                     {
                     Scalar4 f = h_netforce_reverse_recvbuf.data[start_idx_reverse + i];
@@ -2823,23 +3194,745 @@ void Communicator::updateNetForce(unsigned int timestep)
     }
 
 
+/*! \param send_buf Send buffer, grouped by destination rank
+    \param recv_buf Receive buffer, grouped by source rank
+    \param size Size of one element in bytes
+    \param field Index of the field, used as the message tag
+    \param reqs The requests are appended to this vector
+    \param persistent If true, set up persistent requests that are started with MPI_Startall()
+    \param shared If true, only post empty notifications to ranks on the same node
+
+    The ghosts of all directions that lead to the same rank are sent in one message. Both ends order the
+    directions within a message by their code. Empty messages are skipped on both ends.
+
+    In \a shared mode, the data for ranks on the same node is exchanged through the shared memory window. An empty
+    notification is sent to every rank on the same node, even if no ghosts are sent to it, so that the neighbors
+    know that the data of the previous update has been read, too.
+ */
+void Communicator::postDirectMessages(const void *send_buf, void *recv_buf, size_t size, unsigned int field,
+    std::vector<MPI_Request>& reqs, bool persistent, bool shared)
+    {
+    MPI_Request req;
+    for (unsigned int j = 0; j < m_direct_send_neigh.size(); ++j)
+        {
+        if (shared && m_direct_send_node_rank[j] >= 0)
+            {
+            if (persistent)
+                MPI_Send_init(NULL, 0, MPI_BYTE, m_direct_send_neigh[j], field, m_mpi_comm, &req);
+            else
+                MPI_Isend(NULL, 0, MPI_BYTE, m_direct_send_neigh[j], field, m_mpi_comm, &req);
+            reqs.push_back(req);
+            continue;
+            }
+
+        unsigned int offs = m_direct_send_offs[m_direct_send_begin[j]];
+        unsigned int n_send = m_direct_send_offs[m_direct_send_begin[j+1]] - offs;
+        if (! n_send) continue;
+
+        char *buf = (char *) send_buf + offs*size;
+        if (persistent)
+            MPI_Send_init(buf, n_send*size, MPI_BYTE, m_direct_send_neigh[j], field, m_mpi_comm, &req);
+        else
+            MPI_Isend(buf, n_send*size, MPI_BYTE, m_direct_send_neigh[j], field, m_mpi_comm, &req);
+        reqs.push_back(req);
+        }
+
+    for (unsigned int j = 0; j < m_direct_recv_neigh.size(); ++j)
+        {
+        if (shared && m_direct_recv_node_rank[j] >= 0)
+            {
+            if (persistent)
+                MPI_Recv_init(NULL, 0, MPI_BYTE, m_direct_recv_neigh[j], field, m_mpi_comm, &req);
+            else
+                MPI_Irecv(NULL, 0, MPI_BYTE, m_direct_recv_neigh[j], field, m_mpi_comm, &req);
+            reqs.push_back(req);
+            continue;
+            }
+
+        unsigned int offs = m_direct_recv_offs[m_direct_recv_begin[j]];
+        unsigned int n_recv = m_direct_recv_offs[m_direct_recv_begin[j+1]] - offs;
+        if (! n_recv) continue;
+
+        char *buf = (char *) recv_buf + offs*size;
+        if (persistent)
+            MPI_Recv_init(buf, n_recv*size, MPI_BYTE, m_direct_recv_neigh[j], field, m_mpi_comm, &req);
+        else
+            MPI_Irecv(buf, n_recv*size, MPI_BYTE, m_direct_recv_neigh[j], field, m_mpi_comm, &req);
+        reqs.push_back(req);
+        }
+    }
+
+void Communicator::freeUpdateRequests()
+    {
+    for (unsigned int i = 0; i < m_update_reqs.size(); ++i)
+        MPI_Request_free(&m_update_reqs[i]);
+
+    m_update_reqs.clear();
+    m_update_reqs_valid = false;
+    }
+
+/*! \param sz Size of one ghost update record in bytes
+
+    Finds the neighbor ranks that are on the same node, (re)allocates the shared memory window if the records for
+    these ranks do not fit into the segment of any rank on the node, and exchanges the location of the records
+    with the neighbors on the node. Must be called by all ranks at the same time.
+
+    The segment of every rank holds two copies of its records, which are written in alternating updates. A
+    neighbor reads one copy while the next update is packed into the other one.
+ */
+void Communicator::setupSharedGhostUpdates(size_t sz)
+    {
+    MPI_Group world_group, node_group;
+    MPI_Comm_group(m_mpi_comm, &world_group);
+    MPI_Comm_group(m_node_comm, &node_group);
+
+    // find the neighbors on the same node
+    std::vector<int> send_neigh(m_direct_send_neigh.begin(), m_direct_send_neigh.end());
+    std::vector<int> recv_neigh(m_direct_recv_neigh.begin(), m_direct_recv_neigh.end());
+    m_direct_send_node_rank.resize(send_neigh.size());
+    m_direct_recv_node_rank.resize(recv_neigh.size());
+    if (send_neigh.size())
+        MPI_Group_translate_ranks(world_group, send_neigh.size(), &send_neigh.front(), node_group,
+            &m_direct_send_node_rank.front());
+    if (recv_neigh.size())
+        MPI_Group_translate_ranks(world_group, recv_neigh.size(), &recv_neigh.front(), node_group,
+            &m_direct_recv_node_rank.front());
+
+    MPI_Group_free(&world_group);
+    MPI_Group_free(&node_group);
+
+    for (unsigned int j = 0; j < m_direct_send_node_rank.size(); ++j)
+        if (m_direct_send_node_rank[j] == MPI_UNDEFINED)
+            m_direct_send_node_rank[j] = -1;
+    for (unsigned int j = 0; j < m_direct_recv_node_rank.size(); ++j)
+        if (m_direct_recv_node_rank[j] == MPI_UNDEFINED)
+            m_direct_recv_node_rank[j] = -1;
+
+    // lay out the records for the neighbors on the node contiguously
+    m_shared_send_offs.resize(m_direct_send_neigh.size());
+    size_t half = 0;
+    for (unsigned int j = 0; j < m_direct_send_neigh.size(); ++j)
+        {
+        m_shared_send_offs[j] = half;
+        if (m_direct_send_node_rank[j] >= 0)
+            half += sz*(m_direct_send_offs[m_direct_send_begin[j+1]] - m_direct_send_offs[m_direct_send_begin[j]]);
+        }
+
+    // grow the window if necessary, this is collective on the node
+    int realloc = (2*half > m_shared_capacity || m_shared_win == MPI_WIN_NULL) ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &realloc, 1, MPI_INT, MPI_LOR, m_node_comm);
+
+    if (realloc)
+        {
+        freeSharedWindow();
+
+        // leave room for fluctuations of the number of ghosts
+        MPI_Aint capacity = 2*(half + half/4);
+        MPI_Win_allocate_shared(capacity, 1, MPI_INFO_NULL, m_node_comm, &m_shared_buf, &m_shared_win);
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, m_shared_win);
+        m_shared_capacity = capacity;
+        }
+
+    // a new layout is always written starting with the first copy
+    m_shared_parity = 0;
+
+    // tell the neighbors on the node where to find their records
+    std::vector<unsigned long long> send_loc(2*m_direct_send_neigh.size());
+    std::vector<unsigned long long> recv_loc(2*m_direct_recv_neigh.size());
+    m_reqs.clear();
+    MPI_Request req;
+    for (unsigned int j = 0; j < m_direct_send_neigh.size(); ++j)
+        {
+        if (m_direct_send_node_rank[j] < 0) continue;
+        send_loc[2*j] = m_shared_send_offs[j];
+        send_loc[2*j+1] = m_shared_capacity/2;
+        MPI_Isend(&send_loc[2*j], 2*sizeof(unsigned long long), MPI_BYTE, m_direct_send_neigh[j], 11, m_mpi_comm,
+            &req);
+        m_reqs.push_back(req);
+        }
+    for (unsigned int j = 0; j < m_direct_recv_neigh.size(); ++j)
+        {
+        if (m_direct_recv_node_rank[j] < 0) continue;
+        MPI_Irecv(&recv_loc[2*j], 2*sizeof(unsigned long long), MPI_BYTE, m_direct_recv_neigh[j], 11, m_mpi_comm,
+            &req);
+        m_reqs.push_back(req);
+        }
+    m_stats.resize(m_reqs.size());
+    if (m_reqs.size())
+        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+
+    m_shared_recv_ptr.assign(m_direct_recv_neigh.size(), NULL);
+    m_shared_recv_half.assign(m_direct_recv_neigh.size(), 0);
+    for (unsigned int j = 0; j < m_direct_recv_neigh.size(); ++j)
+        {
+        if (m_direct_recv_node_rank[j] < 0) continue;
+
+        MPI_Aint size;
+        int disp_unit;
+        char *base;
+        MPI_Win_shared_query(m_shared_win, m_direct_recv_node_rank[j], &size, &disp_unit, &base);
+        m_shared_recv_ptr[j] = base + recv_loc[2*j];
+        m_shared_recv_half[j] = recv_loc[2*j+1];
+        }
+    }
+
+void Communicator::freeSharedWindow()
+    {
+    if (m_shared_win == MPI_WIN_NULL)
+        return;
+
+    MPI_Win_unlock_all(m_shared_win);
+    MPI_Win_free(&m_shared_win);
+    m_shared_buf = NULL;
+    m_shared_capacity = 0;
+    }
+
+/*! \param flags The ghost communication flags
+
+    Every local particle is sent directly to all neighbors along the directions contained in its plan, including
+    the neighbors across edges and corners, so that no ghosts need to be forwarded.
+ */
+void Communicator::exchangeGhostsSingleStage(const CommFlags& flags)
+    {
+    unsigned int n_dirs = m_direct_code.size();
+    unsigned int n_local = m_pdata->getN();
+
+    // count the ghosts to send along every direction
+    std::vector<unsigned int> n_send(n_dirs, 0);
+
+        {
+        ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::read);
+
+        for (unsigned int idx = 0; idx < n_local; idx++)
+            {
+            unsigned int plan = h_plan.data[idx];
+            if (! plan) continue;
+
+            for (unsigned int i = 0; i < n_dirs; ++i)
+                if ((plan & m_direct_mask[i]) == m_direct_mask[i])
+                    n_send[i]++;
+            }
+        }
+
+    // the send list is grouped by destination rank
+    std::vector<unsigned int> n_send_sorted(n_dirs);
+    std::vector<unsigned int> send_pos(n_dirs);
+    for (unsigned int k = 0; k < n_dirs; ++k)
+        {
+        unsigned int i = m_direct_send_order[k];
+        n_send_sorted[k] = n_send[i];
+        send_pos[i] = k;
+        m_direct_send_offs[k+1] = m_direct_send_offs[k] + n_send[i];
+        }
+
+    unsigned int n_send_tot = m_direct_send_offs[n_dirs];
+
+    // resize buffers
+    m_direct_copy_ghosts.resize(n_send_tot);
+    m_plan_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::position])
+        m_pos_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::charge])
+        m_charge_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::body])
+        m_body_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::image])
+        m_image_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::diameter])
+        m_diameter_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::velocity])
+        m_velocity_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::orientation])
+        m_orientation_copybuf.resize(n_send_tot);
+
+        {
+        // we fill all fields, but send only those that are requested by the CommFlags bitset
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::read);
+
+        ArrayHandle<unsigned int> h_copy_ghosts(m_direct_copy_ghosts, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_plan_copybuf(m_plan_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge_copybuf(m_charge_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter_copybuf(m_diameter_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body_copybuf(m_body_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image_copybuf(m_image_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
+
+        // next free slot in the send list of every direction
+        std::vector<unsigned int> n_copy(n_dirs);
+        for (unsigned int i = 0; i < n_dirs; ++i)
+            n_copy[i] = m_direct_send_offs[send_pos[i]];
+
+        for (unsigned int idx = 0; idx < n_local; idx++)
+            {
+            unsigned int plan = h_plan.data[idx];
+            if (! plan) continue;
+
+            for (unsigned int i = 0; i < n_dirs; ++i)
+                {
+                if ((plan & m_direct_mask[i]) != m_direct_mask[i]) continue;
+
+                unsigned int j = n_copy[i]++;
+                if (flags[comm_flag::position]) h_pos_copybuf.data[j] = h_pos.data[idx];
+                if (flags[comm_flag::charge]) h_charge_copybuf.data[j] = h_charge.data[idx];
+                if (flags[comm_flag::diameter]) h_diameter_copybuf.data[j] = h_diameter.data[idx];
+                if (flags[comm_flag::body]) h_body_copybuf.data[j] = h_body.data[idx];
+                if (flags[comm_flag::image]) h_image_copybuf.data[j] = h_image.data[idx];
+                if (flags[comm_flag::velocity]) h_velocity_copybuf.data[j] = h_vel.data[idx];
+                if (flags[comm_flag::orientation]) h_orientation_copybuf.data[j] = h_orientation.data[idx];
+                h_plan_copybuf.data[j] = plan;
+                h_copy_ghosts.data[j] = h_tag.data[idx];
+                }
+            }
+        }
+
+    if (m_prof)
+        m_prof->push("MPI send/recv");
+
+    // exchange the number of ghosts in every direction with all neighbor ranks at once
+    std::vector<unsigned int> n_recv_sorted(n_dirs, 0);
+
+    m_reqs.clear();
+    MPI_Request req;
+    for (unsigned int j = 0; j < m_direct_send_neigh.size(); ++j)
+        {
+        unsigned int begin = m_direct_send_begin[j];
+        unsigned int n = m_direct_send_begin[j+1] - begin;
+        MPI_Isend(&n_send_sorted[begin], n*sizeof(unsigned int), MPI_BYTE, m_direct_send_neigh[j], 0, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    for (unsigned int j = 0; j < m_direct_recv_neigh.size(); ++j)
+        {
+        unsigned int begin = m_direct_recv_begin[j];
+        unsigned int n = m_direct_recv_begin[j+1] - begin;
+        MPI_Irecv(&n_recv_sorted[begin], n*sizeof(unsigned int), MPI_BYTE, m_direct_recv_neigh[j], 0, m_mpi_comm, &req);
+        m_reqs.push_back(req);
+        }
+
+    m_stats.resize(m_reqs.size());
+    if (m_reqs.size())
+        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+
+    if (m_prof)
+        m_prof->pop();
+
+    // the received ghosts are grouped by source rank
+    for (unsigned int k = 0; k < n_dirs; ++k)
+        m_direct_recv_offs[k+1] = m_direct_recv_offs[k] + n_recv_sorted[k];
+
+    unsigned int n_recv_tot = m_direct_recv_offs[n_dirs];
+
+    // append ghosts at the end of particle data array
+    unsigned int start_idx = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // accommodate new ghost particles
+    m_pdata->addGhostParticles(n_recv_tot);
+
+    // resize plan array
+    m_plan.resize(m_pdata->getN() + m_pdata->getNGhosts());
+
+    if (m_prof)
+        m_prof->push("MPI send/recv");
+
+        {
+        ArrayHandle<unsigned int> h_copy_ghosts(m_direct_copy_ghosts, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_plan_copybuf(m_plan_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge_copybuf(m_charge_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter_copybuf(m_diameter_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body_copybuf(m_body_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image_copybuf(m_image_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+
+        ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
+
+        // all fields of all directions are in flight at the same time, write directly to the particle data arrays
+        m_reqs.clear();
+
+        postDirectMessages(h_plan_copybuf.data, h_plan.data + start_idx, sizeof(unsigned int), 1, m_reqs, false);
+        postDirectMessages(h_copy_ghosts.data, h_tag.data + start_idx, sizeof(unsigned int), 2, m_reqs, false);
+
+        if (flags[comm_flag::position])
+            postDirectMessages(h_pos_copybuf.data, h_pos.data + start_idx, sizeof(Scalar4), 3, m_reqs, false);
+
+        if (flags[comm_flag::charge])
+            postDirectMessages(h_charge_copybuf.data, h_charge.data + start_idx, sizeof(Scalar), 4, m_reqs, false);
+
+        if (flags[comm_flag::diameter])
+            postDirectMessages(h_diameter_copybuf.data, h_diameter.data + start_idx, sizeof(Scalar), 5, m_reqs, false);
+
+        if (flags[comm_flag::velocity])
+            postDirectMessages(h_velocity_copybuf.data, h_vel.data + start_idx, sizeof(Scalar4), 6, m_reqs, false);
+
+        if (flags[comm_flag::orientation])
+            postDirectMessages(h_orientation_copybuf.data, h_orientation.data + start_idx, sizeof(Scalar4), 7, m_reqs, false);
+
+        if (flags[comm_flag::body])
+            postDirectMessages(h_body_copybuf.data, h_body.data + start_idx, sizeof(unsigned int), 8, m_reqs, false);
+
+        if (flags[comm_flag::image])
+            postDirectMessages(h_image_copybuf.data, h_image.data + start_idx, sizeof(int3), 9, m_reqs, false);
+
+        m_stats.resize(m_reqs.size());
+        if (m_reqs.size())
+            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+        }
+
+    if (m_prof)
+        m_prof->pop();
+
+    // wrap particle positions
+    if (flags[comm_flag::position])
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+        const BoxDim shifted_box = getShiftedBox();
+
+        for (unsigned int idx = start_idx; idx < start_idx + n_recv_tot; idx++)
+            {
+            // wrap particles received across a global boundary
+            shifted_box.wrap(h_pos.data[idx], h_image.data[idx]);
+            }
+        }
+
+        {
+        // set reverse-lookup tag -> idx
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*m_pdata, access_mode::readwrite);
+
+        for (unsigned int idx = start_idx; idx < start_idx + n_recv_tot; idx++)
+            {
+            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+            assert(h_rtag[h_tag.data[idx]] == NOT_LOCAL);
+            h_rtag.set(h_tag.data[idx], idx);
+            }
+        }
+    }
+
+/*! \param flags The ghost communication flags
+
+    The persistent requests are set up after every ghost exchange, and for every new combination of updated
+    fields. All updated fields of a ghost are packed into one record, so that there is only a single message
+    per neighbor rank. The records are unpacked into the particle data in finishUpdateGhostsSingleStage().
+
+    With shared ghost updates, the records for ranks on the same node are packed into the shared memory
+    segment of this rank instead, and only an empty message notifies the neighbor that they are ready.
+ */
+void Communicator::beginUpdateGhostsSingleStage(const CommFlags& flags)
+    {
+    // only non-permanent fields (position, velocity, orientation) need to be considered here
+    CommFlags update_flags(0);
+    update_flags[comm_flag::position] = flags[comm_flag::position];
+    update_flags[comm_flag::velocity] = flags[comm_flag::velocity];
+    update_flags[comm_flag::orientation] = flags[comm_flag::orientation];
+
+    unsigned int n_send_tot = m_direct_send_offs.back();
+    unsigned int n_recv_tot = m_direct_recv_offs.back();
+    size_t sz = getUpdateRecordSize(update_flags);
+
+    if (! m_update_reqs_valid || update_flags != m_update_reqs_flags)
+        {
+        freeUpdateRequests();
+
+        // the buffers must not be reallocated as long as the requests refer to them
+        m_update_copybuf.resize(sz*n_send_tot);
+        m_update_recvbuf.resize(sz*n_recv_tot);
+
+        if (m_shared_ghost_updates)
+            setupSharedGhostUpdates(sz);
+
+        if (sz)
+            {
+            ArrayHandle<char> h_update_copybuf(m_update_copybuf, access_location::host, access_mode::read);
+            ArrayHandle<char> h_update_recvbuf(m_update_recvbuf, access_location::host, access_mode::read);
+            postDirectMessages(h_update_copybuf.data, h_update_recvbuf.data, sz, 10, m_update_reqs, true,
+                m_shared_ghost_updates);
+            }
+
+        m_update_reqs_flags = update_flags;
+        m_update_reqs_valid = true;
+        }
+
+        {
+        ArrayHandle<unsigned int> h_copy_ghosts(m_direct_copy_ghosts, access_location::host, access_mode::read);
+        ArrayHandle<char> h_update_copybuf(m_update_copybuf, access_location::host, access_mode::overwrite);
+
+        if (! m_shared_ghost_updates)
+            packGhostUpdates(update_flags, h_copy_ghosts.data, n_send_tot, 0, h_update_copybuf.data);
+        else
+            {
+            // the half of the segment that is not read by the neighbors at the moment
+            char *shared_buf = m_shared_buf + m_shared_parity*(m_shared_capacity/2);
+
+            for (unsigned int j = 0; j < m_direct_send_neigh.size(); ++j)
+                {
+                unsigned int offs = m_direct_send_offs[m_direct_send_begin[j]];
+                unsigned int n_send = m_direct_send_offs[m_direct_send_begin[j+1]] - offs;
+
+                char *buf = (m_direct_send_node_rank[j] >= 0) ? shared_buf + m_shared_send_offs[j]
+                                                              : h_update_copybuf.data + offs*sz;
+                packGhostUpdates(update_flags, h_copy_ghosts.data + offs, n_send, offs, buf);
+                }
+
+            // make the records visible to the other ranks on the node before notifying them
+            MPI_Win_sync(m_shared_win);
+            }
+        }
+
+    if (m_update_reqs.size())
+        MPI_Startall(m_update_reqs.size(), &m_update_reqs.front());
+
+    m_comm_pending = true;
+    m_pending_recv_start = m_pdata->getN();
+    m_pending_recv_count = n_recv_tot;
+    }
+
+/*! \param flags The ghost communication flags
+ */
+void Communicator::finishUpdateGhostsSingleStage(const CommFlags& flags)
+    {
+    if (m_update_reqs.size())
+        {
+        m_stats.resize(m_update_reqs.size());
+        MPI_Waitall(m_update_reqs.size(), &m_update_reqs.front(), &m_stats.front());
+        }
+
+    ArrayHandle<char> h_update_recvbuf(m_update_recvbuf, access_location::host, access_mode::read);
+
+    if (! m_shared_ghost_updates)
+        {
+        unpackGhostUpdates(m_update_reqs_flags, m_pending_recv_start, m_pending_recv_count, h_update_recvbuf.data);
+        return;
+        }
+
+    // the notifications have arrived, the records of the neighbors on this node are complete
+    MPI_Win_sync(m_shared_win);
+
+    size_t sz = getUpdateRecordSize(m_update_reqs_flags);
+    for (unsigned int j = 0; j < m_direct_recv_neigh.size(); ++j)
+        {
+        unsigned int offs = m_direct_recv_offs[m_direct_recv_begin[j]];
+        unsigned int n_recv = m_direct_recv_offs[m_direct_recv_begin[j+1]] - offs;
+
+        // read the records of ranks on the same node in place
+        const char *buf = (m_direct_recv_node_rank[j] >= 0)
+            ? m_shared_recv_ptr[j] + m_shared_parity*m_shared_recv_half[j]
+            : h_update_recvbuf.data + offs*sz;
+        unpackGhostUpdates(m_update_reqs_flags, m_pending_recv_start + offs, n_recv, buf);
+        }
+
+    m_shared_parity ^= 1;
+    }
+
+/*! \param flags The ghost communication flags
+ */
+void Communicator::updateNetForceSingleStage(const CommFlags& flags)
+    {
+    unsigned int n_send_tot = m_direct_send_offs.back();
+    unsigned int n_recv_tot = m_direct_recv_offs.back();
+    unsigned int start_idx = m_pdata->getN();
+
+    if (flags[comm_flag::net_force])
+        m_netforce_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::net_torque])
+        m_nettorque_copybuf.resize(n_send_tot);
+
+    if (flags[comm_flag::net_virial])
+        {
+        m_netvirial_copybuf.resize(6*n_send_tot);
+        m_netvirial_recvbuf.resize(6*n_recv_tot);
+        }
+
+    unsigned int pitch = m_pdata->getNetVirial().getPitch();
+
+        {
+        // copy data into send buffers
+        ArrayHandle<unsigned int> h_copy_ghosts(m_direct_copy_ghosts, access_location::host, access_mode::read);
+        RTagHandle h_rtag(*m_pdata, access_mode::read);
+
+        if (flags[comm_flag::net_force])
+            {
+            ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_netforce_copybuf(m_netforce_copybuf, access_location::host, access_mode::overwrite);
+
+            for (unsigned int ghost_idx = 0; ghost_idx < n_send_tot; ghost_idx++)
+                h_netforce_copybuf.data[ghost_idx] = h_netforce.data[h_rtag[h_copy_ghosts.data[ghost_idx]]];
+            }
+
+        if (flags[comm_flag::net_torque])
+            {
+            ArrayHandle<Scalar4> h_nettorque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_nettorque_copybuf(m_nettorque_copybuf, access_location::host, access_mode::overwrite);
+
+            for (unsigned int ghost_idx = 0; ghost_idx < n_send_tot; ghost_idx++)
+                h_nettorque_copybuf.data[ghost_idx] = h_nettorque.data[h_rtag[h_copy_ghosts.data[ghost_idx]]];
+            }
+
+        if (flags[comm_flag::net_virial])
+            {
+            ArrayHandle<Scalar> h_netvirial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_netvirial_copybuf(m_netvirial_copybuf, access_location::host, access_mode::overwrite);
+
+            for (unsigned int ghost_idx = 0; ghost_idx < n_send_tot; ghost_idx++)
+                {
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
+
+                // copy net virial into send buffer, transposing
+                for (unsigned int k = 0; k < 6; ++k)
+                    h_netvirial_copybuf.data[6*ghost_idx+k] = h_netvirial.data[k*pitch+idx];
+                }
+            }
+        }
+
+    if (m_prof)
+        m_prof->push("MPI send/recv");
+
+        {
+        ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_netforce_copybuf(m_netforce_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_nettorque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_nettorque_copybuf(m_nettorque_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_netvirial_copybuf(m_netvirial_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_netvirial_recvbuf(m_netvirial_recvbuf, access_location::host, access_mode::overwrite);
+
+        m_reqs.clear();
+
+        if (flags[comm_flag::net_force])
+            postDirectMessages(h_netforce_copybuf.data, h_netforce.data + start_idx, sizeof(Scalar4), 13, m_reqs, false);
+
+        if (flags[comm_flag::net_torque])
+            postDirectMessages(h_nettorque_copybuf.data, h_nettorque.data + start_idx, sizeof(Scalar4), 14, m_reqs, false);
+
+        if (flags[comm_flag::net_virial])
+            postDirectMessages(h_netvirial_copybuf.data, h_netvirial_recvbuf.data, 6*sizeof(Scalar), 15, m_reqs, false);
+
+        m_stats.resize(m_reqs.size());
+        if (m_reqs.size())
+            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+        }
+
+    if (m_prof)
+        m_prof->pop();
+
+    if (flags[comm_flag::net_virial])
+        {
+        // unpack virial
+        ArrayHandle<Scalar> h_netvirial_recvbuf(m_netvirial_recvbuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_netvirial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
+
+        for (unsigned int i = 0; i < n_recv_tot; ++i)
+            for (unsigned int k = 0; k < 6; ++k)
+                h_netvirial.data[k*pitch+start_idx+i] = h_netvirial_recvbuf.data[6*i+k];
+        }
+    }
+
 void Communicator::removeGhostParticleTags()
     {
     // wipe out reverse-lookup tag -> idx for old ghost atoms
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+    RTagHandle h_rtag(*m_pdata, access_mode::readwrite);
 
     m_exec_conf->msg->notice(9) << "Communicator: removing " << m_ghosts_added << " ghost particles " << std::endl;
 
     for (unsigned int i = 0; i < m_ghosts_added; i++)
         {
         unsigned int idx = m_pdata->getN() + i;
-        h_rtag.data[h_tag.data[idx]] = NOT_LOCAL;
+        h_rtag.set(h_tag.data[idx], NOT_LOCAL);
         }
 
     m_ghosts_added = 0;
     }
 
+/*! \param f Fractional coordinates of a local particle in the global box
+    \param ghost_fraction Ghost layer width of the particle as a fraction of the global box
+    \param plan Directions along which the particle is sent as a ghost across the faces of the local domain
+    \returns The plan including all directions along which the ghost needs to be forwarded
+
+    In a staggered decomposition, the ghost is forwarded along y in the slabs it is sent to along x, which have
+    different cuts than the local slab. Along z, it is forwarded in all columns it reaches along x and y. Since cuts
+    of neighboring slabs and columns are displaced by less than one domain, a ghost only needs to be forwarded to the
+    next domain. The resulting plan is also correct for the single-stage exchange, which sends the ghost directly.
+ */
+unsigned int Communicator::getStaggeredPlan(const Scalar3& f, const Scalar3& ghost_fraction, unsigned int plan) const
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    const uint3 grid_pos = m_decomposition->getGridPos();
+    const std::vector<Scalar>& frac_y = m_decomposition->getStaggeredFractions(1);
+    const std::vector<Scalar>& frac_z = m_decomposition->getStaggeredFractions(2);
+    const unsigned int nx = di.getW();
+    const unsigned int ny = di.getH();
+    const unsigned int nz = di.getD();
+
+    // slabs along x that the ghost is present in
+    unsigned int slabs[3];
+    unsigned int n_slabs = 0;
+    slabs[n_slabs++] = grid_pos.x;
+    if (plan & send_east) slabs[n_slabs++] = (grid_pos.x + 1) % nx;
+    if (plan & send_west) slabs[n_slabs++] = (grid_pos.x + nx - 1) % nx;
+
+    if (ny > 1)
+        {
+        for (unsigned int i = 0; i < n_slabs; ++i)
+            {
+            const Scalar *cum_frac = &frac_y[slabs[i]*(ny+1)];
+            if (f.y >= cum_frac[grid_pos.y+1] - ghost_fraction.y)
+                plan |= send_north;
+            if (f.y < cum_frac[grid_pos.y] + ghost_fraction.y)
+                plan |= send_south;
+            }
+        }
+
+    // rows along y within the slabs
+    unsigned int rows[3];
+    unsigned int n_rows = 0;
+    rows[n_rows++] = grid_pos.y;
+    if (plan & send_north) rows[n_rows++] = (grid_pos.y + 1) % ny;
+    if (plan & send_south) rows[n_rows++] = (grid_pos.y + ny - 1) % ny;
+
+    if (nz > 1)
+        {
+        for (unsigned int i = 0; i < n_slabs; ++i)
+            for (unsigned int j = 0; j < n_rows; ++j)
+                {
+                const Scalar *cum_frac = &frac_z[(rows[j]*nx + slabs[i])*(nz+1)];
+                if (f.z >= cum_frac[grid_pos.z+1] - ghost_fraction.z)
+                    plan |= send_up;
+                if (f.z < cum_frac[grid_pos.z] + ghost_fraction.z)
+                    plan |= send_down;
+                }
+        }
+
+    return plan;
+    }
+
 const BoxDim Communicator::getShiftedBox() const
     {
     // construct the shifted global box for applying global boundary conditions
@@ -2925,6 +4018,12 @@ const BoxDim Communicator::getShiftedBox() const
 void export_Communicator(py::module& m)
     {
     py::class_<Communicator, std::shared_ptr<Communicator> >(m,"Communicator")
-    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >());
+    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
+    .def("setSingleStage", &Communicator::setSingleStage)
+    .def("getSingleStage", &Communicator::getSingleStage)
+    .def("setCompressGhostUpdates", &Communicator::setCompressGhostUpdates)
+    .def("getCompressGhostUpdates", &Communicator::getCompressGhostUpdates)
+    .def("setSharedGhostUpdates", &Communicator::setSharedGhostUpdates)
+    .def("getSharedGhostUpdates", &Communicator::getSharedGhostUpdates);
     }
 #endif // ENABLE_MPI
@@ -32,6 +32,7 @@
 #endif
 
 #include "Autotuner.h"
+#include "ClockSource.h"
 
 /*! \ingroup hoomd_lib
     @{
@@ -238,6 +239,19 @@ class PYBIND11_EXPORT Communicator
             return m_compute_callbacks;
             }
 
+        //! Subscribe to list of *optional* call-backs for computation using only local particles
+        /*!
+         * Subscribe to a list of call-backs that are called after the ghost update has been started, but before
+         * it is finished, so that computations on the local particles can overlap with the communication.
+         * The ghost particle data must not be accessed in these call-backs.
+         *
+         * \return A Nano::Signal object reference to be used for connect and disconnect calls.
+         */
+        Nano::Signal<void (unsigned int timestep)>& getLocalComputeCallbackSignal()
+            {
+            return m_local_compute_callbacks;
+            }
+
         //! Get the ghost communication flags
         CommFlags getFlags() { return m_flags; }
 
@@ -265,11 +279,112 @@ class PYBIND11_EXPORT Communicator
             return m_r_ghost_max + m_r_extra_ghost_max;
             }
 
+        //! Add to the time this rank spent computing forces
+        /*! \param t Elapsed wall time in seconds
+         *
+         * Force computes contain blocking collectives (the distance check of the neighbor list, the distributed FFT
+         * of PPPM), in which a lightly loaded rank waits for the others. The caller subtracts the time recorded with
+         * addCollectiveTime() in the same interval, so that only the local work is counted. The time is accumulated
+         * until resetComputeTime() is called, and used for cost-based load balancing.
+         */
+        void addComputeTime(double t)
+            {
+            m_compute_time += t;
+            }
+
+        //! Get the time this rank spent computing forces since the last call to resetComputeTime()
+        double getComputeTime() const
+            {
+            return m_compute_time;
+            }
+
+        //! Reset the accumulated force computation time
+        void resetComputeTime()
+            {
+            m_compute_time = 0.0;
+            }
+
+        //! Add to the time this rank spent in blocking collective communication
+        /*! \param t Elapsed wall time in seconds
+         *
+         * Use CollectiveTimer to measure it.
+         */
+        void addCollectiveTime(double t)
+            {
+            m_collective_time += t;
+            }
+
+        //! Get the total time this rank spent in blocking collective communication
+        double getCollectiveTime() const
+            {
+            return m_collective_time;
+            }
+
         //! Set the ghost communication flags
         /*! \note Flags will be available after the next call to communicate().
          */
         void setFlags(const CommFlags& flags) { m_flags = flags; }
 
+        //! Enable or disable the single-stage ghost exchange
+        /*! \param single_stage If true, ghosts are sent directly to all (up to 26) neighboring domains
+         *
+         * By default, ghosts are exchanged across the six faces of the domain one after another, and ghosts
+         * in the edges and corners are forwarded in later stages. In single-stage mode, all messages of an
+         * exchange or update are posted at once, with one message per neighboring rank and field even if several
+         * directions lead to the same rank. The ghost update uses persistent requests.
+         *
+         * When reverse net forces are requested, the staged exchange is used regardless of this setting.
+         */
+        void setSingleStage(bool single_stage)
+            {
+            m_single_stage = single_stage;
+            forceMigrate();
+            }
+
+        //! Returns true if the single-stage ghost exchange is enabled
+        bool getSingleStage() const
+            {
+            return m_single_stage;
+            }
+
+        //! Enable or disable compressed ghost position updates
+        /*! \param compress If true, ghost position updates only carry the displacement since the last ghost exchange
+         *
+         * The displacement is sent in single precision, and the particle type is omitted, since it does not change
+         * between ghost exchanges. The receiver adds the displacement to the position it received in the last
+         * exchange. This reduces the size of a position update from sizeof(Scalar4) to 3*sizeof(float) per ghost.
+         * In double precision builds, the ghost positions are exact to single precision relative to the
+         * displacement, i.e. to about 1e-8 for typical neighbor list buffers.
+         */
+        void setCompressGhostUpdates(bool compress)
+            {
+            m_compress_ghost_updates = compress;
+            forceMigrate();
+            }
+
+        //! Returns true if compressed ghost position updates are enabled
+        bool getCompressGhostUpdates() const
+            {
+            return m_compress_ghost_updates;
+            }
+
+        //! Enable or disable shared memory ghost updates between ranks on the same node
+        /*! \param shared If true, ghost updates from ranks on the same node are read from an MPI-3 shared memory window
+         *
+         * Only takes effect in the single-stage ghost exchange. Every rank packs the update records for its
+         * neighbors on the same node into its own segment of a shared memory window, and the neighbors read them
+         * from there, instead of receiving them in a message. Neighbors on other nodes are sent messages as usual.
+         *
+         * \note This method is collective and must be called on all ranks.
+         */
+        void setSharedGhostUpdates(bool shared);
+
+        //! Returns true if shared memory ghost updates are enabled
+        bool getSharedGhostUpdates() const
+            {
+            return m_shared_ghost_updates;
+            }
+
         //@}
 
         //! \name communication methods
@@ -299,6 +414,13 @@ class PYBIND11_EXPORT Communicator
          * additional computation or communication during the update substep. To complete
          * the communication, call finishUpdateGhosts()
          *
+         * On the CPU, ghosts received in one direction may have to be forwarded in the next one, so only the
+         * transfer in the last direction is left pending when this method returns. With the single-stage
+         * exchange, the transfers to all neighbors are left pending.
+         *
+         * All updated fields (position, velocity, orientation) of a ghost are packed into one record, so that
+         * there is only a single message per neighbor and update.
+         *
          * \param timestep The time step
          *
          * \pre The ghost exchange list has been constructed in a previous time step, using exchangeGhosts().
@@ -310,11 +432,7 @@ class PYBIND11_EXPORT Communicator
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(unsigned int timestep)
-            {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
-            }
+        virtual void finishUpdateGhosts(unsigned int timestep);
 
         /*! Communicate the net particle force
          * \parm timestep The time step
@@ -456,6 +574,51 @@ class PYBIND11_EXPORT Communicator
         //! Helper function to update the shifted box for ghost particle PBC
         const BoxDim getShiftedBox() const;
 
+        //! Helper function to wrap received ghost particle positions into the shifted box
+        void wrapGhostPositions(unsigned int start_idx, unsigned int n_recv);
+
+        //! Add the directions along which a ghost needs to be forwarded through staggered domains to its plan
+        unsigned int getStaggeredPlan(const Scalar3& f, const Scalar3& ghost_fraction, unsigned int plan) const;
+
+        //! Size of one packed ghost update record in bytes
+        size_t getUpdateRecordSize(const CommFlags& flags) const;
+
+        //! Pack the updated fields of the given ghosts into a buffer, one record per ghost
+        void packGhostUpdates(const CommFlags& flags, const unsigned int *tags, unsigned int n_send,
+            unsigned int ref_offset, char *buf);
+
+        //! Record the ghost positions of the last exchange, relative to which compressed updates are sent
+        void storeGhostReferencePositions(const CommFlags& flags);
+
+        //! Unpack ghost update records from a buffer into the particle data
+        void unpackGhostUpdates(const CommFlags& flags, unsigned int start_idx, unsigned int n_recv,
+            const char *buf);
+
+        //! Send ghosts to all neighbors in a single stage
+        void exchangeGhostsSingleStage(const CommFlags& flags);
+
+        //! Start the single-stage ghost update
+        void beginUpdateGhostsSingleStage(const CommFlags& flags);
+
+        //! Complete the single-stage ghost update
+        void finishUpdateGhostsSingleStage(const CommFlags& flags);
+
+        //! Communicate the net force, torque and virial in a single stage
+        void updateNetForceSingleStage(const CommFlags& flags);
+
+        //! Post the messages of one ghost field to all neighbor ranks in the single-stage exchange
+        void postDirectMessages(const void *send_buf, void *recv_buf, size_t size, unsigned int field,
+            std::vector<MPI_Request>& reqs, bool persistent, bool shared=false);
+
+        //! Release the persistent requests of the single-stage ghost update
+        void freeUpdateRequests();
+
+        //! Set up the shared memory window and the record locations of the neighbors on the same node
+        void setupSharedGhostUpdates(size_t sz);
+
+        //! Release the shared memory window
+        void freeSharedWindow();
+
         std::shared_ptr<SystemDefinition> m_sysdef;                 //!< System definition
         std::shared_ptr<ParticleData> m_pdata;                      //!< Particle data
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
@@ -496,6 +659,46 @@ class PYBIND11_EXPORT Communicator
 
         GlobalVector<unsigned int> m_plan;          //!< Array of per-direction flags that determine the sending route
 
+        // Variables for the single-stage exchange with all neighbors
+        bool m_single_stage;                        //!< True if the single-stage ghost exchange is enabled
+        bool m_ghosts_single_stage;                 //!< True if the current ghost lists were built in a single stage
+        std::vector<unsigned int> m_direct_code;    //!< Direction code (used in message tags) of every neighbor direction
+        std::vector<unsigned int> m_direct_mask;    //!< Plan flags that a particle needs to be sent along every direction
+        std::vector<unsigned int> m_direct_send_rank; //!< Rank that ghosts are sent to along every direction
+        std::vector<unsigned int> m_direct_recv_rank; //!< Rank that ghosts are received from along every direction
+        std::vector<unsigned int> m_direct_send_order; //!< Directions, sorted by the rank they send to
+        std::vector<unsigned int> m_direct_recv_order; //!< Directions, sorted by the rank they receive from
+        std::vector<unsigned int> m_direct_send_neigh; //!< Unique ranks that ghosts are sent to
+        std::vector<unsigned int> m_direct_recv_neigh; //!< Unique ranks that ghosts are received from
+        std::vector<unsigned int> m_direct_send_begin; //!< First entry in m_direct_send_order for every rank sent to (plus total)
+        std::vector<unsigned int> m_direct_recv_begin; //!< First entry in m_direct_recv_order for every rank received from (plus total)
+        std::vector<unsigned int> m_direct_send_offs; //!< Offset of every entry of m_direct_send_order in the send list (plus total)
+        std::vector<unsigned int> m_direct_recv_offs; //!< Offset of every entry of m_direct_recv_order in the received ghosts (plus total)
+        GlobalVector<unsigned int> m_direct_copy_ghosts; //!< Tags of the ghosts to send, grouped by destination rank
+
+        GlobalVector<char> m_update_copybuf;         //!< Send buffer of packed ghost update records
+        GlobalVector<char> m_update_recvbuf;         //!< Receive buffer of packed ghost update records
+        std::vector<MPI_Request> m_update_reqs;      //!< Persistent requests of the single-stage ghost update
+        CommFlags m_update_reqs_flags;               //!< Fields the persistent requests were set up for
+        bool m_update_reqs_valid;                    //!< True if the persistent requests match the current ghost lists
+
+        bool m_compress_ghost_updates;               //!< True if ghost position updates are sent as displacements
+        bool m_ghost_ref_valid;                      //!< True if the reference positions of the last exchange are stored
+        GlobalVector<Scalar3> m_ghost_ref_send;      //!< Positions of the sent ghosts at the last exchange, in send list order
+        GlobalVector<Scalar3> m_ghost_ref_recv;      //!< Positions of the received ghosts at the last exchange
+
+        bool m_shared_ghost_updates;                 //!< True if ghost updates on the same node use shared memory
+        MPI_Comm m_node_comm;                        //!< Communicator of the ranks that share memory with this rank
+        MPI_Win m_shared_win;                        //!< Shared memory window of the ghost update records
+        char *m_shared_buf;                          //!< Segment of this rank in the shared memory window
+        size_t m_shared_capacity;                    //!< Size of the segment of this rank in bytes
+        unsigned int m_shared_parity;                //!< Copy of the records (0 or 1) that is written in the next update
+        std::vector<int> m_direct_send_node_rank;    //!< Rank in m_node_comm of every rank sent to (-1 if not on the node)
+        std::vector<int> m_direct_recv_node_rank;    //!< Rank in m_node_comm of every rank received from (-1 if not on the node)
+        std::vector<size_t> m_shared_send_offs;      //!< Offset of the records for every rank sent to in the segment
+        std::vector<const char *> m_shared_recv_ptr; //!< First copy of the records of every rank received from
+        std::vector<size_t> m_shared_recv_half;      //!< Offset between the copies of every rank received from
+
         // Variables needed for sending ghost particles backwards
         GlobalVector<unsigned int> m_plan_reverse;          //!< Array of flags that determine the reverse sending route for ghosts
         GlobalVector<unsigned int> m_tag_reverse;          //!< Array of flags that determine which ghost particles are being sent back. This has no analog normally because particles actually store their tags, but in this case we don't want to so we have to make a vector. This vector corresponds to the m_copy_ghosts_reverse copybuf (m_copy_ghosts writes directly to m_pdata->getTags())
@@ -520,6 +723,8 @@ class PYBIND11_EXPORT Communicator
         Scalar m_r_extra_ghost_max;              //!< Maximum extra ghost layer width
 
         unsigned int m_ghosts_added;             //!< Number of ghosts added
+        double m_compute_time;                   //!< Accumulated force computation time of this rank (in seconds)
+        double m_collective_time;                //!< Total time spent in blocking collectives (in seconds)
         bool m_has_ghost_particles;              //!< True if we have a current copy of ghost particles
 
         MPI_Datatype m_mpi_pdata_element;        //!< A datatype for the (non-packed) pdata_element struct
@@ -542,6 +747,9 @@ class PYBIND11_EXPORT Communicator
         Nano::Signal<void (unsigned int timestep)>
             m_compute_callbacks;   //!< List of functions that are called after ghost communication
 
+        Nano::Signal<void (unsigned int timestep)>
+            m_local_compute_callbacks;   //!< List of functions that are called while ghost communication is pending
+
         Nano::Signal<void (const GlobalArray<unsigned int>& )>
             m_comm_callbacks;   //!< List of functions that are called after the compute callbacks
 
@@ -549,6 +757,8 @@ class PYBIND11_EXPORT Communicator
         CommFlags m_last_flags;                       //!< Flags of last ghost exchange
 
         bool m_comm_pending;                     //!< If true, a communication is in process
+        unsigned int m_pending_recv_start;       //!< First particle index of the pending ghost update
+        unsigned int m_pending_recv_count;       //!< Number of ghosts received in the pending ghost update
         std::vector<MPI_Request> m_reqs; //!< Container for all MPI communication requests
         std::vector<MPI_Status> m_stats; //!< Container for all MPI communication statuses
 
@@ -665,6 +875,33 @@ class PYBIND11_EXPORT Communicator
 
     };
 
+//! Measures the time spent in a blocking collective call
+/*! The time from construction to destruction is added to the Communicator with addCollectiveTime(), so that it can be
+    excluded from the compute time used for cost-based load balancing. Nothing is recorded without a Communicator.
+
+    \ingroup communication
+*/
+class CollectiveTimer
+    {
+    public:
+        //! Start the measurement
+        CollectiveTimer(std::shared_ptr<Communicator> comm)
+            : m_comm(comm)
+            {
+            }
+
+        //! Record the elapsed time
+        ~CollectiveTimer()
+            {
+            if (m_comm)
+                m_comm->addCollectiveTime(double(m_clk.getTime())*1e-9);
+            }
+
+    private:
+        std::shared_ptr<Communicator> m_comm;   //!< Communicator to record the time on
+        ClockSource m_clk;                      //!< Clock started at construction
+    };
+
 
 //! Declaration of python export function
 void export_Communicator(pybind11::module& m);
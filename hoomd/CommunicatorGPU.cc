@@ -32,6 +32,13 @@ CommunicatorGPU::CommunicatorGPU(std::shared_ptr<SystemDefinition> sysdef,
       m_constraint_comm(*this, m_sysdef->getConstraintData()),
       m_pair_comm(*this, m_sysdef->getPairData())
     {
+    // the GPU kernels do not forward ghosts through staggered domains
+    if (decomposition->isStaggered())
+        {
+        m_exec_conf->msg->error() << "comm: staggered domain decomposition is not supported on the GPU" << std::endl;
+        throw std::runtime_error("Error initializing CommunicatorGPU");
+        }
+
     if (m_exec_conf->allConcurrentManagedAccess())
         {
         // inform the user to use a cuda-aware MPI
@@ -192,6 +192,11 @@ class PYBIND11_EXPORT Compute
                     }
                 }
             }
+        //! Peek to see if computation should be run without updating internal state
+        /*! Logger calls this to decide if a value shared between loggers at the same time step is still current.
+        */
+        virtual bool peekCompute(unsigned int timestep) const;
+
     protected:
         const std::shared_ptr<SystemDefinition> m_sysdef; //!< The system definition this compute is associated with
         const std::shared_ptr<ParticleData> m_pdata;      //!< The particle data this compute is associated with
@@ -208,9 +213,6 @@ class PYBIND11_EXPORT Compute
         //! Simple method for testing if the computation should be run or not
         virtual bool shouldCompute(unsigned int timestep);
 
-        //! Peek to see if computation should be run without updating internal state
-        virtual bool peekCompute(unsigned int timestep) const;
-
     private:
         //! The python export needs to be a friend to export shouldCompute()
         friend void export_Compute();
@@ -38,6 +38,16 @@ static void write_int(fstream &file, unsigned int val)
     file.write((char *)&val, sizeof(unsigned int));
     }
 
+//! simple helper function to append an integer to a buffer
+/*! \param buffer buffer to append to
+    \param val integer to append
+*/
+static void append_int(std::vector<char>& buffer, unsigned int val)
+    {
+    const char *bytes = (const char *)&val;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(unsigned int));
+    }
+
 //! simple helper function to read in integer
 /*! \param file file to read from
     \returns integer read
@@ -70,7 +80,8 @@ DCDDumpWriter::DCDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_start_timestep(0), m_period(period), m_group(group),
       m_num_frames_written(0), m_last_written_step(0), m_appending(false),
       m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false),
-      m_overwrite(overwrite), m_is_initialized(false)
+      m_overwrite(overwrite), m_is_initialized(false), m_buffer_frames(1), m_n_buffered(0), m_async(false),
+      m_io_stop(false), m_io_error(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing DCDDumpWriter: " << fname << " " << period << " " << overwrite << endl;
     }
@@ -78,7 +89,6 @@ DCDDumpWriter::DCDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
 //! Initializes the output file for writing
 void DCDDumpWriter::initFileIO(unsigned int timestep)
     {
-    m_staging_buffer = new float[m_pdata->getNGlobal()];
     m_is_initialized = true;
 
     m_nglobal = m_pdata->getNGlobal();
@@ -130,13 +140,62 @@ DCDDumpWriter::~DCDDumpWriter()
     {
     m_exec_conf->msg->notice(5) << "Destroying DCDDumpWriter" << endl;
 
+    // write out the remaining frames, errors can no longer be raised here
+    stopIOThread();
+    if (m_is_initialized && m_n_buffered > 0)
+        m_io_error = !write_frames(m_buffer) || m_io_error;
+    if (m_io_error)
+        m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frames - " << m_fname << endl;
+
     if (m_is_initialized)
         {
         m_file.close();
-        delete[] m_staging_buffer;
         }
     }
 
+/*! \param n Number of frames to buffer before writing them to the file (at least 1)
+
+    Frames that are already buffered are written at the next call to analyze() or flush().
+*/
+void DCDDumpWriter::setBufferFrames(unsigned int n)
+    {
+    if (n == 0)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: The number of buffered frames must be at least 1" << endl;
+        throw runtime_error("Error setting up DCD output");
+        }
+
+    m_buffer_frames = n;
+    }
+
+/*! \param b True to write frames from a background thread
+
+    Switching back to synchronous writes writes all buffered frames first.
+*/
+void DCDDumpWriter::setAsyncWrite(bool b)
+    {
+    if (m_async && !b)
+        {
+        flush();
+        stopIOThread();
+        }
+    m_async = b;
+    }
+
+/*! Frames that have been passed to analyze() are in the file when flush() returns.
+*/
+void DCDDumpWriter::flush()
+    {
+#ifdef ENABLE_MPI
+    if (!m_exec_conf->isRoot())
+        return;
+#endif
+
+    if (m_n_buffered > 0)
+        writeBuffer();
+    waitIdle();
+    }
+
 /*! \param timestep Current time step of the simulation
     The very first call to analyze() will result in the creation (or overwriting) of the
     file fname and the writing of the current timestep snapshot. After that, each call to analyze
@@ -147,10 +206,19 @@ void DCDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump DCD");
 
-    // take particle data snapshot
-    SnapshotParticleData<Scalar> snapshot;
+    if (m_unwrap_rigid && !m_unwrap_full)
+        {
+        // the image of the central particle of a body may be on another rank, take a full snapshot
+        SnapshotParticleData<Scalar> snapshot;
+        m_pdata->takeSnapshot(snapshot);
 
-    m_pdata->takeSnapshot(snapshot);
+        if (m_exec_conf->isRoot())
+            stageSnapshot(snapshot);
+        }
+    else
+        {
+        gatherPositions();
+        }
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
@@ -184,14 +252,17 @@ void DCDDumpWriter::analyze(unsigned int timestep)
     if ( (timestep - m_start_timestep) % m_period != 0)
         m_exec_conf->msg->warning() << "dump.dcd: writing time step " << timestep << " which is not specified in the period of the DCD file: " << m_start_timestep << " + i * " << m_period << endl;
 
-    // write the data for the current time step
-    m_file.seekp(0, std::ios_base::end);
-    write_frame_header(m_file);
-    write_frame_data(m_file, snapshot);
+    // encode the data for the current time step
+    write_frame_header(m_buffer.data);
+    write_frame_data(m_buffer.data);
 
-    // update the header with the number of frames written
     m_num_frames_written++;
-    write_updated_header(m_file, timestep);
+    m_n_buffered++;
+    m_buffer.n_frames = m_num_frames_written;
+    m_buffer.last_step = timestep;
+
+    if (m_n_buffered >= m_buffer_frames)
+        writeBuffer();
 
     if (m_prof)
         m_prof->pop();
@@ -265,11 +336,11 @@ void DCDDumpWriter::write_file_header(std::fstream &file)
         }
     }
 
-/*! \param file File to write to
-    Writes the header that precedes each snapshot in the file. This header
+/*! \param buffer Buffer to append to
+    Encodes the header that precedes each snapshot in the file. This header
     includes information on the box size of the simulation.
 */
-void DCDDumpWriter::write_frame_header(std::fstream &file)
+void DCDDumpWriter::write_frame_header(std::vector<char>& buffer)
     {
     double unitcell[6];
     BoxDim box = m_pdata->getGlobalBox();
@@ -293,40 +364,137 @@ void DCDDumpWriter::write_frame_header(std::fstream &file)
     unitcell[3] = beta;
     unitcell[4] = alpha;
 
-    write_int(file, 48);
-    file.write((char *)unitcell, 48);
-    write_int(file, 48);
+    append_int(buffer, 48);
+    buffer.insert(buffer.end(), (const char *)unitcell, (const char *)unitcell + 48);
+    append_int(buffer, 48);
+    }
+
+/*! Each rank converts the positions of its local group members the same way as a snapshot does, and sends them
+    with their index in the group to the root rank. This avoids gathering all other particle fields.
+*/
+void DCDDumpWriter::gatherPositions()
+    {
+    // get the local members first, the group may access the tag array
+    unsigned int n_local = m_group->getNumMembers();
+    m_local_rows.resize(n_local);
+    m_local_coords.resize(3*n_local);
+    for (unsigned int j = 0; j < n_local; j++)
+        m_local_rows[j] = m_group->getMemberIndex(j);
 
-    // check for errors
-    if (!file.good())
         {
-        m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frame header" << endl;
-        throw runtime_error("Error writing DCD file");
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        Scalar3 origin = m_pdata->getOrigin();
+        int3 origin_image = m_pdata->getOriginImage();
+
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = m_local_rows[j];
+
+            Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+            int3 img = h_image.data[idx];
+            img.x -= origin_image.x;
+            img.y -= origin_image.y;
+            img.z -= origin_image.z;
+            global_box.wrap(pos, img);
+
+            if (m_unwrap_full)
+                pos = global_box.shift(pos, img);
+
+            m_local_coords[j*3+0] = float(pos.x);
+            m_local_coords[j*3+1] = float(pos.y);
+            m_local_coords[j*3+2] = float(pos.z);
+
+            // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
+            // this only works in 2D simulations, obviously
+            if (m_angle)
+                {
+                quat<Scalar> q(h_orientation.data[idx]);
+                m_local_coords[j*3+2] = float(atan2(q.v.z, q.s) * 2);
+                }
+
+            m_local_rows[j] = m_group->getMemberTagIndex(h_tag.data[idx]);
+            }
+        }
+
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+    const unsigned int *rows = m_local_rows.data();
+    const float *coords = m_local_coords.data();
+    unsigned int n_rows = n_local;
+
+#ifdef ENABLE_MPI
+    std::vector<unsigned int> all_rows;
+    std::vector<float> all_coords;
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        bool root = m_exec_conf->isRoot();
+        unsigned int n_ranks = m_exec_conf->getNRanks();
+
+        std::vector<int> counts(n_ranks), displs(n_ranks), coord_counts(n_ranks), coord_displs(n_ranks);
+        int n = n_local;
+        MPI_Gather(&n, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, mpi_comm);
+
+        n_rows = 0;
+        if (root)
+            {
+            for (unsigned int r = 0; r < n_ranks; r++)
+                {
+                displs[r] = n_rows;
+                coord_counts[r] = 3*counts[r];
+                coord_displs[r] = 3*n_rows;
+                n_rows += counts[r];
+                }
+            all_rows.resize(n_rows);
+            all_coords.resize(3*n_rows);
+            }
+
+        MPI_Gatherv(m_local_rows.data(), n, MPI_UNSIGNED,
+                    all_rows.data(), counts.data(), displs.data(), MPI_UNSIGNED, 0, mpi_comm);
+        MPI_Gatherv(m_local_coords.data(), 3*n, MPI_FLOAT,
+                    all_coords.data(), coord_counts.data(), coord_displs.data(), MPI_FLOAT, 0, mpi_comm);
+
+        if (!root)
+            return;
+
+        rows = all_rows.data();
+        coords = all_coords.data();
+        }
+#endif
+
+    // place the coordinates in tag order
+    m_staging_buffer.resize(3*nparticles);
+    for (unsigned int k = 0; k < n_rows; k++)
+        {
+        unsigned int row = rows[k];
+        m_staging_buffer[row] = coords[k*3+0];
+        m_staging_buffer[nparticles + row] = coords[k*3+1];
+        m_staging_buffer[2*nparticles + row] = coords[k*3+2];
         }
     }
 
-/*! \param file File to write to
-    \param snapshot Snapshot to write
-    Writes the actual particle positions for all particles at the current time step
+/*! \param snapshot Snapshot to stage
+    Places the positions of the group members in tag order into the staging buffer, unwrapping particles as requested
 */
-void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleData<Scalar>& snapshot)
+void DCDDumpWriter::stageSnapshot(const SnapshotParticleData<Scalar>& snapshot)
     {
-    // we need to unsort the positions and write in tag order
-    assert(m_staging_buffer);
-
     BoxDim box = m_pdata->getGlobalBox();
 
     unsigned int nparticles = m_group->getNumMembersGlobal();
+    m_staging_buffer.resize(3*nparticles);
 
-    // Create a tmp copy of the particle data and unwrap particles
-    std::vector< vec3<Scalar> > tmp_pos(snapshot.pos);
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
         unsigned int i = m_group->getMemberTag(group_idx);
+        vec3<Scalar> pos = snapshot.pos[i];
 
         if (m_unwrap_full)
             {
-            tmp_pos[i] = box.shift(tmp_pos[i], snapshot.image[i]);
+            pos = box.shift(pos, snapshot.image[i]);
             }
         else if (m_unwrap_rigid && snapshot.body[i] < MIN_FLOPPY)
             {
@@ -339,74 +507,167 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
                                       particle_img.y - body_iy,
                                       particle_img.z - body_iz);
 
-            tmp_pos[i] = box.shift(tmp_pos[i], img_diff);
+            pos = box.shift(pos, img_diff);
+            }
+
+        m_staging_buffer[group_idx] = float(pos.x);
+        m_staging_buffer[nparticles + group_idx] = float(pos.y);
+        m_staging_buffer[2*nparticles + group_idx] = float(pos.z);
+
+        // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
+        // this only works in 2D simulations, obviously
+        if (m_angle)
+            {
+            m_staging_buffer[2*nparticles + group_idx] = float(atan2(snapshot.orientation[i].v.z, snapshot.orientation[i].s) * 2);
             }
         }
+    }
 
-    // prepare x coords for writing, looping in tag order
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
+/*! \param buffer Buffer to append to
+    Encodes the staged particle positions for all particles at the current time step
+*/
+void DCDDumpWriter::write_frame_data(std::vector<char>& buffer)
+    {
+    unsigned int nparticles = (unsigned int)(m_staging_buffer.size() / 3);
+    const char *data = (const char *)m_staging_buffer.data();
+    size_t block_size = nparticles * sizeof(float);
+
+    // write x, y, and z coords
+    for (unsigned int d = 0; d < 3; d++)
         {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].x);
+        append_int(buffer, nparticles * sizeof(float));
+        buffer.insert(buffer.end(), data + d*block_size, data + (d+1)*block_size);
+        append_int(buffer, nparticles * sizeof(float));
         }
+    }
 
-    // write x coords
-    write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
-    write_int(file, nparticles * sizeof(float));
+/*! \param frames Encoded frames to write
 
-    // prepare y coords for writing
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
+    Appends the frames to the file and updates the pointers in the main file header to reflect the current number of
+    frames written and the last time step written.
+
+    \returns false if an I/O error occurred
+*/
+bool DCDDumpWriter::write_frames(const FrameBuffer& frames)
+    {
+    m_file.seekp(0, std::ios_base::end);
+    m_file.write(frames.data.data(), frames.data.size());
+
+    m_file.seekp(NFILE_POS);
+    write_int(m_file, frames.n_frames);
+
+    m_file.seekp(NSTEP_POS);
+    write_int(m_file, frames.last_step);
+
+    m_file.flush();
+    return m_file.good();
+    }
+
+/*! In asynchronous mode, the buffer is handed to the I/O thread. This blocks when the I/O thread already has
+    max_queued_buffers buffers to write.
+*/
+void DCDDumpWriter::writeBuffer()
+    {
+    m_n_buffered = 0;
+
+    if (! m_async)
         {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].y);
+        bool success = write_frames(m_buffer);
+        m_buffer.data.clear();
+        if (!success)
+            {
+            m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frames" << endl;
+            throw runtime_error("Error writing DCD file");
+            }
+        return;
         }
 
-    // write y coords
-    write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
-    write_int(file, nparticles * sizeof(float));
-
-    // prepare z coords for writing
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
+    if (! m_io_thread.joinable())
         {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].z);
+        m_io_stop = false;
+        m_io_thread = std::thread(&DCDDumpWriter::ioThreadMain, this);
+        }
 
-        // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
-        // this only works in 2D simulations, obviously
-        if (m_angle)
+    bool io_error;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        if (m_queue.size() >= max_queued_buffers)
             {
-            m_staging_buffer[group_idx] = float(atan2(snapshot.orientation[i].v.z, snapshot.orientation[i].s) * 2);
+            m_exec_conf->msg->notice(10) << "dump.dcd: waiting for the I/O thread" << endl;
+            m_io_cv.wait(lock, [this] { return m_queue.size() < max_queued_buffers; });
             }
-        }
 
-    // write z coords
-    write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
-    write_int(file, nparticles * sizeof(float));
+        m_queue.push_back(std::move(m_buffer));
+        m_buffer = FrameBuffer();
 
-    // check for errors
-    if (!file.good())
+        io_error = m_io_error;
+        m_io_error = false;
+        }
+    m_io_cv.notify_all();
+
+    if (io_error)
         {
-        m_exec_conf->msg->error() << "I/O error while writing DCD frame data" << endl;
+        m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frames in the background" << endl;
         throw runtime_error("Error writing DCD file");
         }
     }
 
-/*! \param file File to write to
-    \param timestep Current time step of the simulation
+/*! The I/O thread writes the queued buffers in order. It only accesses m_file while a buffer is in the queue.
+*/
+void DCDDumpWriter::ioThreadMain()
+    {
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+    while (true)
+        {
+        m_io_cv.wait(lock, [this] { return m_io_stop || m_queue.size() > 0; });
+        if (m_queue.size() == 0)
+            break;
+
+        // the main thread only appends to the queue, so the front buffer stays in place
+        const FrameBuffer& frames = m_queue.front();
+        lock.unlock();
+
+        bool success = write_frames(frames);
 
-    Updates the pointers in the main file header to reflect the current number of frames
-    written and the last time step written.
+        lock.lock();
+        if (!success)
+            m_io_error = true;
+        m_queue.pop_front();
+        m_io_cv.notify_all();
+        }
+    }
+
+void DCDDumpWriter::waitIdle()
+    {
+    bool io_error;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_io_cv.wait(lock, [this] { return m_queue.size() == 0; });
+
+        io_error = m_io_error;
+        m_io_error = false;
+        }
+
+    if (io_error)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: I/O error while writing DCD frames in the background" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+    }
+
+/*! The I/O thread writes out all queued buffers before it exits.
 */
-void DCDDumpWriter::write_updated_header(std::fstream &file, unsigned int timestep)
+void DCDDumpWriter::stopIOThread()
     {
-    file.seekp(NFILE_POS);
-    write_int(file, m_num_frames_written);
+    if (! m_io_thread.joinable())
+        return;
 
-    file.seekp(NSTEP_POS);
-    write_int(file, timestep);
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_io_stop = true;
+        }
+    m_io_cv.notify_all();
+    m_io_thread.join();
     }
 
 void export_DCDDumpWriter(py::module& m)
@@ -416,5 +677,8 @@ void export_DCDDumpWriter(py::module& m)
     .def("setUnwrapFull", &DCDDumpWriter::setUnwrapFull)
     .def("setUnwrapRigid", &DCDDumpWriter::setUnwrapRigid)
     .def("setAngleZ", &DCDDumpWriter::setAngleZ)
+    .def("setBufferFrames", &DCDDumpWriter::setBufferFrames)
+    .def("setAsyncWrite", &DCDDumpWriter::setAsyncWrite)
+    .def("flush", &DCDDumpWriter::flush)
     ;
     }
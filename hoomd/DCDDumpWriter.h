@@ -13,6 +13,11 @@
 #include <string>
 #include <memory>
 #include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 /*! \file DCDDumpWriter.h
     \brief Declares the DCDDumpWriter class
@@ -46,6 +51,15 @@
     Due to a limitation in the DCD format, the time step period between calls to
     analyze() \b must be specified up front. If analyze() detects that this period is
     not being maintained, it will print a warning but continue.
+
+    Each rank converts the positions of its local group members and sends them with their index in the group to the
+    root rank, which places them in tag order. Only when rigid bodies are unwrapped, analyze() takes a full particle
+    data snapshot, because the image of a body's central particle may be on another rank.
+
+    The root rank encodes frames into a buffer and writes setBufferFrames() frames at once, updating the frame count
+    in the file header once per write. In asynchronous mode (setAsyncWrite()), the buffered frames are handed to a
+    background I/O thread instead. At most two writes are in flight, and errors of the I/O thread are raised by the
+    next write or flush(). Buffered frames are in the file after flush() or when the writer is destroyed.
     \ingroup analyzers
 */
 class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
@@ -82,6 +96,15 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
             m_angle = enable;
             }
 
+        //! Set the number of frames to buffer before writing them to the file
+        void setBufferFrames(unsigned int n);
+
+        //! Control asynchronous writes
+        void setAsyncWrite(bool b);
+
+        //! Write all buffered frames to the file
+        void flush();
+
     private:
         std::string m_fname;                //!< The file name we are writing to
         unsigned int m_start_timestep;      //!< First time step written to the file
@@ -98,22 +121,63 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         bool m_is_initialized;              //!< True if file IO has been initialized
         unsigned int m_nglobal;             //!< Initial number of particles
 
-        float *m_staging_buffer;            //!< Buffer for staging particle positions in tag order
+        std::vector<float> m_staging_buffer;    //!< x, y, and z coordinates of the group members in tag order
+        std::vector<unsigned int> m_local_rows; //!< Group indices of the local members
+        std::vector<float> m_local_coords;      //!< Coordinates of the local members
         std::fstream m_file;                //!< The file object
 
+        //! Frames encoded for writing to the file
+        struct FrameBuffer
+            {
+            std::vector<char> data;         //!< Encoded frames
+            unsigned int n_frames;          //!< Number of frames in the file after this buffer is written
+            unsigned int last_step;         //!< Time step of the last frame in the buffer
+
+            FrameBuffer() : n_frames(0), last_step(0) {}
+            };
+
+        unsigned int m_buffer_frames;       //!< Number of frames to buffer before writing
+        unsigned int m_n_buffered;          //!< Number of frames in m_buffer
+        FrameBuffer m_buffer;               //!< Frames not yet written or queued
+
+        bool m_async;                       //!< True if frames are written by the I/O thread
+        std::deque<FrameBuffer> m_queue;    //!< Buffers handed to the I/O thread and not yet written (front is in progress)
+        std::thread m_io_thread;            //!< The I/O thread
+        std::mutex m_io_mutex;              //!< Protects the queue and the I/O thread state
+        std::condition_variable m_io_cv;    //!< Signals changes of the queue
+        bool m_io_stop;                     //!< True when the I/O thread should exit
+        bool m_io_error;                    //!< True if the I/O thread failed to write a buffer
+
+        //! Maximum number of buffers handed to the I/O thread
+        static const unsigned int max_queued_buffers = 2;
+
         // helper functions
 
         //! Initializes the file header
         void write_file_header(std::fstream &file);
-        //! Writes the frame header
-        void write_frame_header(std::fstream &file);
-        //! Writes the particle positions for a frame
-        void write_frame_data(std::fstream &file, const SnapshotParticleData<Scalar>& snapshot);
-        //! Updates the file header
-        void write_updated_header(std::fstream &file, unsigned int timestep);
+        //! Encodes the frame header
+        void write_frame_header(std::vector<char>& buffer);
+        //! Encodes the staged particle positions
+        void write_frame_data(std::vector<char>& buffer);
+        //! Writes encoded frames to the end of the file and updates the file header
+        bool write_frames(const FrameBuffer& frames);
         //! Initializes the output file for writing
         void initFileIO(unsigned int timestep);
 
+        //! Gather the positions of the group members in tag order on the root rank
+        void gatherPositions();
+        //! Stage the positions of the group members from a snapshot
+        void stageSnapshot(const SnapshotParticleData<Scalar>& snapshot);
+
+        //! Write the buffered frames, or hand them to the I/O thread
+        void writeBuffer();
+        //! Main loop of the I/O thread
+        void ioThreadMain();
+        //! Wait until the I/O thread has written all queued buffers and raise its errors
+        void waitIdle();
+        //! Stop the I/O thread
+        void stopIOThread();
+
     };
 
 //! Exports the DCDDumpWriter class to python
@@ -35,7 +35,7 @@ DomainDecomposition::DomainDecomposition(std::shared_ptr<ExecutionConfiguration>
                                unsigned int nz,
                                bool twolevel
                                )
-      : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
+      : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator()), m_staggered(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing DomainDecomposition" << endl;
 
@@ -64,7 +64,7 @@ DomainDecomposition::DomainDecomposition(std::shared_ptr<ExecutionConfiguration>
                                          const std::vector<Scalar>& fxs,
                                          const std::vector<Scalar>& fys,
                                          const std::vector<Scalar>& fzs)
-    : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator())
+    : m_exec_conf(exec_conf), m_mpi_comm(m_exec_conf->getMPICommunicator()), m_staggered(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing DomainDecomposition" << endl;
 
@@ -522,6 +522,126 @@ void DomainDecomposition::setCumulativeFractions(unsigned int dir,
         m_exec_conf->msg->error() << "comm: domain decomposition cannot change topology after construction" << std::endl;
         throw std::runtime_error("comm: domain decomposition cannot change topology after construction");
         }
+
+    // in a staggered decomposition, the same cuts are applied to all slabs or columns
+    if (m_staggered && dir == 1)
+        {
+        for (unsigned int i=0; i < m_nx; ++i)
+            std::copy(m_cum_frac_y.begin(), m_cum_frac_y.end(), m_stagger_frac_y.begin() + i*(m_ny+1));
+        }
+    else if (m_staggered && dir == 2)
+        {
+        for (unsigned int i=0; i < m_nx*m_ny; ++i)
+            std::copy(m_cum_frac_z.begin(), m_cum_frac_z.end(), m_stagger_frac_z.begin() + i*(m_nz+1));
+        }
+    }
+
+/*!
+ * \param staggered If true, every slab with the same x grid position has its own cuts along y, and every column with
+ *                  the same x and y grid position has its own cuts along z
+ *
+ * When staggering is enabled, all slabs and columns start with the current cuts. Staggering can only be disabled
+ * again if the cuts of all slabs and columns are aligned.
+ *
+ * \note All ranks must call this method with the same argument.
+ */
+void DomainDecomposition::setStaggered(bool staggered)
+    {
+    if (staggered == m_staggered)
+        return;
+
+    if (staggered)
+        {
+        m_stagger_frac_y.clear();
+        for (unsigned int i=0; i < m_nx; ++i)
+            m_stagger_frac_y.insert(m_stagger_frac_y.end(), m_cum_frac_y.begin(), m_cum_frac_y.end());
+
+        m_stagger_frac_z.clear();
+        for (unsigned int i=0; i < m_nx*m_ny; ++i)
+            m_stagger_frac_z.insert(m_stagger_frac_z.end(), m_cum_frac_z.begin(), m_cum_frac_z.end());
+        }
+    else
+        {
+        // the local cuts are those of one of the slabs and columns, compare all others to them
+        bool aligned = true;
+        for (unsigned int i=0; aligned && i < m_nx; ++i)
+            aligned = std::equal(m_cum_frac_y.begin(), m_cum_frac_y.end(), m_stagger_frac_y.begin() + i*(m_ny+1));
+        for (unsigned int i=0; aligned && i < m_nx*m_ny; ++i)
+            aligned = std::equal(m_cum_frac_z.begin(), m_cum_frac_z.end(), m_stagger_frac_z.begin() + i*(m_nz+1));
+
+        if (! aligned)
+            {
+            m_exec_conf->msg->error() << "comm: cannot disable staggering of domains that are not aligned" << std::endl;
+            throw std::runtime_error("comm: cannot disable staggering of domains that are not aligned");
+            }
+
+        m_stagger_frac_y.clear();
+        m_stagger_frac_z.clear();
+        }
+
+    m_staggered = staggered;
+    }
+
+/*!
+ * \param dir Direction (1=y, 2=z) to set fractions
+ * \param stagger_frac Cumulative fractions of all slabs (y) or columns (z), each beginning with 0 and ending with 1
+ * \param root Rank to broadcast the set fractions from
+ *
+ * The layout of \a stagger_frac is the same as that of getStaggeredFractions(). The caller is responsible for keeping
+ * the cuts of neighboring slabs and columns within one domain of each other.
+ *
+ * \note Setting the fractions is a collective call requiring all ranks to participate in order to keep the
+ *       decomposition properly synchronized between ranks.
+ */
+void DomainDecomposition::setStaggeredFractions(unsigned int dir,
+                                                const std::vector<Scalar>& stagger_frac,
+                                                unsigned int root)
+    {
+    if (!m_staggered || (dir != 1 && dir != 2))
+        {
+        m_exec_conf->msg->error() << "comm: requested direction is not staggered" << std::endl;
+        throw std::runtime_error("comm: requested direction is not staggered");
+        }
+
+    std::vector<Scalar>& cur_frac = (dir == 1) ? m_stagger_frac_y : m_stagger_frac_z;
+    const unsigned int n = (dir == 1) ? m_ny+1 : m_nz+1;
+
+    bool changed = false;
+    if (m_exec_conf->getRank() == root && stagger_frac.size() == cur_frac.size())
+        {
+        cur_frac = stagger_frac;
+        changed = true;
+        }
+
+    // sync the update from the root to all ranks
+    bcast(changed, root, m_mpi_comm);
+    if (! changed)
+        {
+        m_exec_conf->msg->error() << "comm: domain decomposition cannot change topology after construction" << std::endl;
+        throw std::runtime_error("comm: domain decomposition cannot change topology after construction");
+        }
+
+    MPI_Bcast(&cur_frac[0], cur_frac.size(), MPI_HOOMD_SCALAR, root, m_mpi_comm);
+
+    for (unsigned int offs=0; offs < cur_frac.size(); offs += n)
+        {
+        if (cur_frac[offs] != Scalar(0.0) || cur_frac[offs+n-1] != Scalar(1.0))
+            {
+            m_exec_conf->msg->error() << "comm: specified fractions are invalid" << std::endl;
+            throw std::runtime_error("comm: specified fractions are invalid");
+            }
+        }
+
+    updateLocalFractions();
+    }
+
+void DomainDecomposition::updateLocalFractions()
+    {
+    std::vector<Scalar>::const_iterator y = m_stagger_frac_y.begin() + m_grid_pos.x*(m_ny+1);
+    m_cum_frac_y.assign(y, y + m_ny+1);
+
+    std::vector<Scalar>::const_iterator z = m_stagger_frac_z.begin() + (m_grid_pos.y*m_nx + m_grid_pos.x)*(m_nz+1);
+    m_cum_frac_z.assign(z, z + m_nz+1);
     }
 
 /*!
@@ -593,15 +713,24 @@ unsigned int DomainDecomposition::placeParticle(const BoxDim& global_box, Scalar
     else if (ix >= (int)m_nx)
         ix--;
 
-    it = std::lower_bound(m_cum_frac_y.begin(), m_cum_frac_y.end(), f.y);
-    int iy = it - 1 - m_cum_frac_y.begin();
+    // in a staggered decomposition, the cuts along y depend on the slab, and those along z on the column
+    std::vector<Scalar>::iterator begin_y = m_cum_frac_y.begin();
+    if (m_staggered)
+        begin_y = m_stagger_frac_y.begin() + ix*(m_ny+1);
+
+    it = std::lower_bound(begin_y, begin_y + m_ny+1, f.y);
+    int iy = it - 1 - begin_y;
     if (iy < 0)
         iy++;
     else if (iy >= (int)m_ny)
         iy--;
 
-    it = std::lower_bound(m_cum_frac_z.begin(), m_cum_frac_z.end(), f.z);
-    int iz = it - 1 - m_cum_frac_z.begin();
+    std::vector<Scalar>::iterator begin_z = m_cum_frac_z.begin();
+    if (m_staggered)
+        begin_z = m_stagger_frac_z.begin() + (iy*m_nx + ix)*(m_nz+1);
+
+    it = std::lower_bound(begin_z, begin_z + m_nz+1, f.z);
+    int iz = it - 1 - begin_z;
     if (iz < 0)
         iz++;
     else if (iz >= (int)m_nz)
@@ -678,6 +807,9 @@ void export_DomainDecomposition(py::module& m)
               const std::vector<Scalar>&,
               const std::vector<Scalar>&>())
     .def("getCumulativeFractions", &DomainDecomposition::getCumulativeFractions)
+    .def("setStaggered", &DomainDecomposition::setStaggered)
+    .def("isStaggered", &DomainDecomposition::isStaggered)
+    .def("getStaggeredFractions", &DomainDecomposition::getStaggeredFractions)
     ;
     }
 #endif // ENABLE_MPI
@@ -45,6 +45,14 @@
  *  uniform cuts along each dimension.
  *
  *  The initialization of the domain decomposition scheme is performed in the constructor.
+ *
+ *  In a staggered decomposition, the domains still form a grid of nx x ny x nz ranks, but only the cuts along x pass
+ *  through the entire box. Every slab of domains with the same x grid position has its own cuts
+ *  along y (nx sets of ny+1 fractions), and every column of domains with the same x and y grid positions has its own
+ *  cuts along z (nx*ny sets of nz+1 fractions). The cuts of neighboring slabs and columns must not
+ *  be displaced by more than one domain with respect to each other, so that every domain only touches domains whose
+ *  grid positions differ by at most one, and the 26 grid neighbors remain the neighbors for communication. Staggered
+ *  cuts are set by the LoadBalancer, and all cuts of a staggered decomposition are initially aligned.
  */
 class PYBIND11_EXPORT DomainDecomposition
     {
@@ -107,6 +115,8 @@ class PYBIND11_EXPORT DomainDecomposition
          * \param dir Direction (0=x, 1=y, 2=z) to get fraction
          * \param idx The rank index to get the cumulative fraction below (0 to N+1)
          * \returns Cumulative fraction of global box length below rank at \a idx
+         *
+         * In a staggered decomposition, the fractions along y and z are those of the local slab and column.
          */
         Scalar getCumulativeFraction(unsigned int dir, unsigned int idx) const
             {
@@ -136,6 +146,8 @@ class PYBIND11_EXPORT DomainDecomposition
         /*!
          * \param dir Direction (0=x, 1=y, 2=z) to get fraction
          * \returns Array of cumulative fractions of global box length below rank
+         *
+         * In a staggered decomposition, the fractions along y and z are those of the local slab and column.
          */
         std::vector<Scalar> getCumulativeFractions(unsigned int dir) const
             {
@@ -152,6 +164,38 @@ class PYBIND11_EXPORT DomainDecomposition
         //! Collectively set the cumulative fractions along a dimension from a given rank
         void setCumulativeFractions(unsigned int dir, const std::vector<Scalar>& cum_frac, unsigned int root);
 
+        //! Enable / disable staggered cuts along y and z
+        void setStaggered(bool staggered);
+
+        //! Returns true if the cuts along y and z are staggered
+        bool isStaggered() const
+            {
+            return m_staggered;
+            }
+
+        //! Get the cumulative fractions of all slabs (y) or columns (z) of a staggered decomposition
+        /*!
+         * \param dir Direction (1=y, 2=z) to get fractions
+         * \returns The cumulative fractions along y of every slab (nx*(ny+1) values), or along z of every column
+         *          (nx*ny*(nz+1) values), one after the other
+         *
+         * The cuts of the domains at grid position (i,j,k) start at index i*(ny+1) along y, and at index
+         * (j*nx + i)*(nz+1) along z.
+         */
+        const std::vector<Scalar>& getStaggeredFractions(unsigned int dir) const
+            {
+            if (dir == 1) return m_stagger_frac_y;
+            else if (dir == 2) return m_stagger_frac_z;
+            else
+                {
+                m_exec_conf->msg->error() << "comm: requested direction is not staggered" << std::endl;
+                throw std::runtime_error("comm: requested direction is not staggered");
+                }
+            }
+
+        //! Collectively set the cumulative fractions of all slabs (y) or columns (z) from a given rank
+        void setStaggeredFractions(unsigned int dir, const std::vector<Scalar>& stagger_frac, unsigned int root);
+
         //! Get the dimensions of the local simulation box
         const BoxDim calculateLocalBox(const BoxDim& global_box);
 
@@ -211,6 +255,13 @@ class PYBIND11_EXPORT DomainDecomposition
         std::vector<Scalar> m_cum_frac_x;   //!< Cumulative fractions in x below cut plane index
         std::vector<Scalar> m_cum_frac_y;   //!< Cumulative fractions in y below cut plane index
         std::vector<Scalar> m_cum_frac_z;   //!< Cumulative fractions in z below cut plane index
+
+        bool m_staggered;                       //!< True if the cuts along y and z are staggered
+        std::vector<Scalar> m_stagger_frac_y;   //!< Cumulative fractions in y of every slab along x
+        std::vector<Scalar> m_stagger_frac_z;   //!< Cumulative fractions in z of every (x,y) column
+
+        //! Copy the staggered fractions of the local domain into the cumulative fraction arrays
+        void updateLocalFractions();
 #endif // ENABLE_MPI
    };
 
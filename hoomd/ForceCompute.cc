@@ -181,6 +181,8 @@ Scalar ForceCompute::calcEnergySum()
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce potential energy on all processors
         MPI_Allreduce(MPI_IN_PLACE, &pe_total, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
@@ -206,6 +208,8 @@ Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce potential energy on all processors
         MPI_Allreduce(MPI_IN_PLACE, &pe_total, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
@@ -231,6 +235,8 @@ vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce potential energy on all processors
         MPI_Allreduce(MPI_IN_PLACE, &f_total, 3, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
@@ -257,6 +263,8 @@ std::vector<Scalar> ForceCompute::calcVirialGroup(std::shared_ptr<ParticleGroup>
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce potential energy on all processors
         MPI_Allreduce(MPI_IN_PLACE, total_virial.data(), 6, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
         }
@@ -69,6 +69,14 @@ class PYBIND11_EXPORT ForceCompute : public Compute
          * and can be used to overlap computation with communication
          */
         virtual void preCompute(unsigned int timestep){}
+
+        //! Compute the part of the forces that does not depend on ghost particles
+        /*! This method is called in MPI simulations while the ghost particle update is still in flight.
+         * Only the local particles are current at this point. A subclass that implements it must remember
+         * what it computed, so that the following compute() at the same time step only adds the contributions
+         * of the ghost particles.
+         */
+        virtual void computeInterior(unsigned int timestep){}
         #endif
 
         //! Computes the forces
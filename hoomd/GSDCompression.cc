@@ -0,0 +1,372 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file GSDCompression.cc
+    \brief Defines the GSDChunkEncoder and GSDChunkDecoder classes
+*/
+
+#include "GSDCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+const uint64_t GSDCompressedHeader::KEYFRAME;
+
+namespace
+    {
+    //! Version of the encoding written by GSDChunkEncoder
+    const uint32_t encoding_version = 1;
+
+    //! Number of values that share one Golomb-Rice parameter
+    const unsigned int block_size = 64;
+
+    //! Quotients of this size or larger are written as escaped raw values
+    const unsigned int escape_quotient = 24;
+
+    //! Largest magnitude of a quantized value, such that differences of two values fit into int64_t
+    const double max_quantized = 4611686018427387904.0;
+
+    //! Map signed values to unsigned values with small magnitudes mapped to small values
+    inline uint64_t zigzag_encode(int64_t v)
+        {
+        return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+        }
+
+    //! Inverse of zigzag_encode
+    inline int64_t zigzag_decode(uint64_t u)
+        {
+        return int64_t(u >> 1) ^ -int64_t(u & 1);
+        }
+
+    //! Number of significant bits in a value
+    inline unsigned int bit_length(uint64_t u)
+        {
+        return u == 0 ? 0 : 64 - __builtin_clzll(u);
+        }
+
+    //! Appends bits to a byte buffer, least significant bit first
+    class BitWriter
+        {
+        public:
+            BitWriter(std::vector<uint8_t>& out)
+                : m_out(out), m_acc(0), m_nbits(0)
+                {
+                }
+
+            //! Write the n lowest bits of v (n <= 64)
+            inline void put(uint64_t v, unsigned int n)
+                {
+                if (n == 0)
+                    return;
+                if (n < 64)
+                    v &= (uint64_t(1) << n) - 1;
+
+                m_acc |= v << m_nbits;
+                if (m_nbits + n >= 64)
+                    {
+                    for (unsigned int i = 0; i < 8; i++)
+                        m_out.push_back(uint8_t(m_acc >> (8*i)));
+                    m_acc = (m_nbits == 0) ? 0 : v >> (64 - m_nbits);
+                    m_nbits = m_nbits + n - 64;
+                    }
+                else
+                    {
+                    m_nbits += n;
+                    }
+                }
+
+            //! Write the remaining bits
+            void flush()
+                {
+                for (unsigned int i = 0; i < m_nbits; i += 8)
+                    m_out.push_back(uint8_t(m_acc >> i));
+                m_acc = 0;
+                m_nbits = 0;
+                }
+
+        private:
+            std::vector<uint8_t>& m_out;    //!< Output buffer
+            uint64_t m_acc;                 //!< Bits not yet written
+            unsigned int m_nbits;           //!< Number of bits in m_acc
+        };
+
+    //! Reads bits written by BitWriter
+    class BitReader
+        {
+        public:
+            BitReader(const char *data, size_t size)
+                : m_data((const uint8_t *)data), m_size(size), m_pos(0), m_acc(0), m_nbits(0), m_error(false)
+                {
+                }
+
+            //! Read n bits (n <= 56)
+            inline uint64_t get(unsigned int n)
+                {
+                refill();
+                if (m_nbits < n)
+                    {
+                    m_error = true;
+                    return 0;
+                    }
+
+                uint64_t v = (n == 0) ? 0 : m_acc & ((uint64_t(1) << n) - 1);
+                m_acc = (n == 64) ? 0 : m_acc >> n;
+                m_nbits -= n;
+                return v;
+                }
+
+            //! Read n bits (n <= 64)
+            inline uint64_t getLong(unsigned int n)
+                {
+                if (n <= 32)
+                    return get(n);
+                uint64_t lo = get(32);
+                return lo | (get(n-32) << 32);
+                }
+
+            //! Count and consume consecutive one bits, up to max_ones, and the terminating zero bit
+            inline unsigned int getUnary(unsigned int max_ones)
+                {
+                refill();
+                uint64_t zeros = ~m_acc;
+                unsigned int n = (zeros == 0) ? 64 : __builtin_ctzll(zeros);
+                if (n >= max_ones)
+                    {
+                    get(max_ones);
+                    return max_ones;
+                    }
+                if (n >= m_nbits)
+                    {
+                    m_error = true;
+                    return 0;
+                    }
+                get(n+1);
+                return n;
+                }
+
+            //! True if the data ended before all requested bits were read
+            bool error() const
+                {
+                return m_error;
+                }
+
+        private:
+            const uint8_t *m_data;  //!< Input data
+            size_t m_size;          //!< Size of the input
+            size_t m_pos;           //!< Next byte to read
+            uint64_t m_acc;         //!< Bits read but not yet consumed
+            unsigned int m_nbits;   //!< Number of bits in m_acc
+            bool m_error;           //!< True if a read went past the end of the data
+
+            //! Fill the accumulator with at least 57 bits, if available
+            inline void refill()
+                {
+                while (m_nbits <= 56 && m_pos < m_size)
+                    {
+                    m_acc |= uint64_t(m_data[m_pos++]) << m_nbits;
+                    m_nbits += 8;
+                    }
+                }
+        };
+
+    //! Write a block of values with a Golomb-Rice code
+    void encode_block(BitWriter& writer, const uint64_t *u, unsigned int n)
+        {
+        // choose the parameter from the mean value of the block
+        double sum = 0.0;
+        for (unsigned int i = 0; i < n; i++)
+            sum += double(u[i]);
+        uint64_t mean = uint64_t(std::min(sum/double(n), 9.2e18));
+        unsigned int k = (mean == 0) ? 0 : bit_length(mean) - 1;
+        writer.put(k, 6);
+
+        for (unsigned int i = 0; i < n; i++)
+            {
+            uint64_t q = u[i] >> k;
+            if (q < escape_quotient)
+                {
+                // unary quotient terminated by a zero bit, then the remainder
+                writer.put((uint64_t(1) << q) - 1, q + 1);
+                writer.put(u[i], k);
+                }
+            else
+                {
+                // escape, then the value with its length
+                unsigned int len = bit_length(u[i]);
+                writer.put((uint64_t(1) << escape_quotient) - 1, escape_quotient);
+                writer.put(len - 1, 6);
+                writer.put(u[i], len);
+                }
+            }
+        }
+
+    //! Read a block of values written by encode_block
+    void decode_block(BitReader& reader, uint64_t *u, unsigned int n)
+        {
+        unsigned int k = reader.get(6);
+        for (unsigned int i = 0; i < n; i++)
+            {
+            uint64_t q = reader.getUnary(escape_quotient);
+            if (q < escape_quotient)
+                {
+                u[i] = (q << k) | reader.getLong(k);
+                }
+            else
+                {
+                unsigned int len = reader.get(6) + 1;
+                u[i] = reader.getLong(len);
+                }
+            }
+        }
+    }
+
+/*! \param precision Quantization step
+    \param keyframe_period Maximum number of frames between keyframes
+*/
+GSDChunkEncoder::GSDChunkEncoder(double precision, unsigned int keyframe_period)
+    : m_precision(precision), m_keyframe_period(keyframe_period), m_last_M(0), m_last_frame(0), m_n_deltas(0),
+      m_has_last(false)
+    {
+    }
+
+/*! \param out Buffer to write the compressed chunk to
+    \param data Values to encode (N*M floats)
+    \param N Number of rows
+    \param M Number of columns
+    \param frame Index of the frame that the chunk is written to
+
+    \returns false if a value cannot be quantized (it is not finite or too large for the precision)
+*/
+bool GSDChunkEncoder::encode(std::vector<uint8_t>& out, const float *data, uint64_t N, uint32_t M, uint64_t frame)
+    {
+    uint64_t n_values = N*M;
+
+    // quantize
+    m_current.resize(n_values);
+    for (uint64_t i = 0; i < n_values; i++)
+        {
+        double x = double(data[i]) / m_precision;
+        if (!std::isfinite(x) || std::fabs(x) > max_quantized)
+            return false;
+        m_current[i] = std::llround(x);
+        }
+
+    bool keyframe = !m_has_last || m_last.size() != n_values || m_last_M != M || frame <= m_last_frame
+                    || m_n_deltas + 1 >= m_keyframe_period;
+
+    GSDCompressedHeader header;
+    header.version = encoding_version;
+    header.M = M;
+    header.N = N;
+    header.precision = m_precision;
+    header.reference_frame = keyframe ? GSDCompressedHeader::KEYFRAME : m_last_frame;
+
+    out.resize(sizeof(GSDCompressedHeader));
+    memcpy(&out[0], &header, sizeof(GSDCompressedHeader));
+
+    // write the (differences of the) quantized values in blocks
+    BitWriter writer(out);
+    uint64_t u[block_size];
+    for (uint64_t start = 0; start < n_values; start += block_size)
+        {
+        unsigned int n = (unsigned int)std::min(uint64_t(block_size), n_values - start);
+        for (unsigned int i = 0; i < n; i++)
+            {
+            int64_t v = m_current[start+i];
+            if (!keyframe)
+                v -= m_last[start+i];
+            u[i] = zigzag_encode(v);
+            }
+        encode_block(writer, u, n);
+        }
+    writer.flush();
+
+    m_last.swap(m_current);
+    m_last_M = M;
+    m_last_frame = frame;
+    m_n_deltas = keyframe ? 0 : m_n_deltas + 1;
+    m_has_last = true;
+
+    return true;
+    }
+
+/*! \param header Header to read into
+    \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+
+    \returns false if the data is not a valid compressed chunk
+*/
+bool GSDChunkDecoder::readHeader(GSDCompressedHeader& header, const char *data, size_t size)
+    {
+    if (size < sizeof(GSDCompressedHeader))
+        return false;
+
+    memcpy(&header, data, sizeof(GSDCompressedHeader));
+    return header.version == encoding_version && header.M > 0 && header.precision > 0.0;
+    }
+
+/*! \param values Quantized values. For chunks that are not keyframes, \a values must hold the values of the
+                  reference frame on input.
+    \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+
+    \returns false if the data is not a valid compressed chunk, or \a values does not match its size
+*/
+bool GSDChunkDecoder::decode(std::vector<int64_t>& values, const char *data, size_t size)
+    {
+    GSDCompressedHeader header;
+    if (!readHeader(header, data, size))
+        return false;
+
+    return decode(values, data, size, 0, header.N*header.M);
+    }
+
+/*! \param values Quantized values in the range. For chunks that are not keyframes, \a values must hold the values
+                  of the same range in the reference frame on input.
+    \param data Compressed chunk
+    \param size Size of the compressed chunk in bytes
+    \param first Index of the first value to decode
+    \param count Number of values to decode
+
+    The blocks before the range are parsed and discarded, and decoding stops after the last block that overlaps the
+    range. Only \a count values are held in memory.
+
+    \returns false if the data is not a valid compressed chunk, the range is out of bounds, or \a values does not
+             match the size of the range
+*/
+bool GSDChunkDecoder::decode(std::vector<int64_t>& values, const char *data, size_t size, uint64_t first,
+                             uint64_t count)
+    {
+    GSDCompressedHeader header;
+    if (!readHeader(header, data, size))
+        return false;
+
+    uint64_t n_values = header.N*header.M;
+    if (first > n_values || count > n_values - first)
+        return false;
+
+    bool keyframe = header.reference_frame == GSDCompressedHeader::KEYFRAME;
+    if (keyframe)
+        values.assign(count, 0);
+    else if (values.size() != count)
+        return false;
+
+    BitReader reader(data + sizeof(GSDCompressedHeader), size - sizeof(GSDCompressedHeader));
+    uint64_t u[block_size];
+    uint64_t end = first + count;
+    for (uint64_t start = 0; start < end; start += block_size)
+        {
+        unsigned int n = (unsigned int)std::min(uint64_t(block_size), n_values - start);
+        decode_block(reader, u, n);
+
+        // keep the values of the block that are in the range
+        uint64_t lo = std::max(start, first);
+        uint64_t hi = std::min(start + n, end);
+        for (uint64_t i = lo; i < hi; i++)
+            values[i-first] += zigzag_decode(u[i-start]);
+        }
+
+    return !reader.error();
+    }
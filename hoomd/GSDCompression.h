@@ -0,0 +1,100 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file GSDCompression.h
+    \brief Declares the GSDChunkEncoder and GSDChunkDecoder classes
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __GSD_COMPRESSION_H__
+#define __GSD_COMPRESSION_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+//! Header of a compressed per-particle chunk
+/*! A compressed chunk is stored in the GSD file as a uint8 chunk with the name of the original chunk prefixed by
+    "compressed/". The header is followed by the Golomb-Rice coded values.
+*/
+struct GSDCompressedHeader
+    {
+    uint32_t version;           //!< Version of the encoding
+    uint32_t M;                 //!< Number of columns of the original chunk
+    uint64_t N;                 //!< Number of rows of the original chunk
+    double precision;           //!< Quantization step
+    uint64_t reference_frame;   //!< Frame that the values are relative to, or KEYFRAME
+
+    //! Value of reference_frame for chunks that do not depend on other frames
+    static const uint64_t KEYFRAME = UINT64_MAX;
+    };
+
+//! Encodes float chunks as quantized, delta-encoded and entropy coded data
+/*! Every value is quantized to an integer multiple of the precision. In a keyframe, the quantized values are stored
+    directly. Otherwise, the encoder stores the difference to the quantized values of the previous frame that it
+    encoded, which is small when the particles move little between frames. The (zig-zag mapped) values are written
+    with an adaptive Golomb-Rice code, which selects the parameter for every block of 64 values.
+
+    The encoder writes a keyframe for the first frame, when the number of values changes, when the frame index does
+    not increase (e.g. after the file was truncated), and after keyframe_period-1 consecutive delta frames. A reader
+    therefore needs to decode at most keyframe_period chunks to restore any frame.
+
+    The decoded values differ from the input by at most half the precision.
+*/
+class GSDChunkEncoder
+    {
+    public:
+        //! Construct the encoder
+        GSDChunkEncoder(double precision=0.001, unsigned int keyframe_period=100);
+
+        //! Encode a frame
+        bool encode(std::vector<uint8_t>& out, const float *data, uint64_t N, uint32_t M, uint64_t frame);
+
+        //! Get the quantization step
+        double getPrecision() const
+            {
+            return m_precision;
+            }
+
+        //! Forget the previous frame, so that the next frame is a keyframe
+        void reset()
+            {
+            m_has_last = false;
+            }
+
+    private:
+        double m_precision;                 //!< Quantization step
+        unsigned int m_keyframe_period;     //!< Maximum number of frames between keyframes
+        std::vector<int64_t> m_last;        //!< Quantized values of the previous frame
+        std::vector<int64_t> m_current;     //!< Quantized values of the current frame
+        uint32_t m_last_M;                  //!< Number of columns in the previous frame
+        uint64_t m_last_frame;              //!< Index of the previous frame
+        unsigned int m_n_deltas;            //!< Number of delta frames since the last keyframe
+        bool m_has_last;                    //!< True if m_last holds a previous frame
+    };
+
+//! Decodes chunks written by GSDChunkEncoder
+class GSDChunkDecoder
+    {
+    public:
+        //! Read the header of a compressed chunk
+        static bool readHeader(GSDCompressedHeader& header, const char *data, size_t size);
+
+        //! Decode the quantized values of a chunk
+        static bool decode(std::vector<int64_t>& values, const char *data, size_t size);
+
+        //! Decode a contiguous range of the quantized values of a chunk
+        static bool decode(std::vector<int64_t>& values, const char *data, size_t size, uint64_t first, uint64_t count);
+
+        //! Convert a quantized value back to a float
+        static float dequantize(int64_t value, double precision)
+            {
+            return float(double(value)*precision);
+            }
+    };
+
+#endif
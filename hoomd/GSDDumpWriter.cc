@@ -20,6 +20,7 @@
 #include "hoomd/extern/pybind/include/pybind11/numpy.h"
 
 #include <string.h>
+#include <unistd.h>
 #include <stdexcept>
 #include <list>
 using namespace std;
@@ -44,9 +45,20 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_overwrite(overwrite),
                         m_truncate(truncate),
                         m_is_initialized(false),
-                        m_group(group)
+                        m_group(group),
+                        m_write_signal_used(false),
+                        m_nframes(0),
+                        m_async(false),
+                        m_io_stop(false),
+                        m_io_error(GSD_SUCCESS),
+                        m_io_errno(0),
+                        m_parallel(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing GSDDumpWriter: " << m_fname << " " << overwrite << " " << truncate << endl;
+
+    #ifdef ENABLE_MPI
+    m_mpi_file_open = false;
+    #endif
     }
 
 void GSDDumpWriter::checkError(int retval)
@@ -144,9 +156,110 @@ void GSDDumpWriter::initFileIO()
         throw runtime_error("Error opening GSD file");
         }
 
+    m_nframes = gsd_get_nframes(&m_handle);
     m_is_initialized = true;
     }
 
+/*! \param b True to write frames from a background I/O thread
+
+    Switching back to synchronous writes waits until all queued frames have been written.
+*/
+void GSDDumpWriter::setAsyncWrite(bool b)
+    {
+    if (b && m_parallel)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Asynchronous writes are not supported with parallel writes" << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+
+    if (m_async && !b)
+        {
+        flush();
+        stopIOThread();
+        }
+    m_async = b;
+    }
+
+/*! \param b True to write the per-particle data from all ranks
+
+    Parallel writes only take effect in simulations with a domain decomposition.
+*/
+void GSDDumpWriter::setParallelWrite(bool b)
+    {
+    if (b && m_async)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Parallel writes are not supported with asynchronous writes" << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+    if (b && ! m_encoders.empty())
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Parallel writes are not supported with compression" << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+
+    m_parallel = b;
+    }
+
+/*! \param quantity Name of the quantity to compress (position, orientation, or velocity)
+    \param precision Quantization step. The values in the file differ from the simulation by at most precision/2.
+
+    The first frame written after this call is a keyframe.
+*/
+void GSDDumpWriter::setCompression(const std::string& quantity, double precision)
+    {
+    if (quantity != "position" && quantity != "orientation" && quantity != "velocity")
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot compress " << quantity << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+    if (!(precision > 0.0))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The compression precision must be positive" << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+    if (m_parallel)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Compression is not supported with parallel writes" << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+
+    m_encoders[std::string("particles/") + quantity] = GSDChunkEncoder(precision);
+    }
+
+/*! \param category Category of quantities (attribute, property, momentum, or topology)
+    \param period Write the category only on time steps that are a multiple of \a period. 0 writes it every frame.
+
+    The period only applies when the category is written every frame (see setWriteAttribute() and similar).
+*/
+void GSDDumpWriter::setPeriod(const std::string& category, unsigned int period)
+    {
+    if (category != "attribute" && category != "property" && category != "momentum" && category != "topology")
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Unknown category " << category << endl;
+        throw runtime_error("Error setting up GSD output");
+        }
+
+    m_period[category] = period;
+    }
+
+/*! \param category Category of quantities
+    \param write True if the category is written every frame
+    \param timestep Current time step
+    \param nframes Number of frames in the file
+
+    \returns true if the category should be written in this frame
+*/
+bool GSDDumpWriter::isWriteStep(const std::string& category, bool write, unsigned int timestep, uint64_t nframes)
+    {
+    if (nframes == 0)
+        return true;
+    if (!write)
+        return false;
+
+    unsigned int period = m_period[category];
+    return period == 0 || timestep % period == 0;
+    }
+
 GSDDumpWriter::~GSDDumpWriter()
     {
     m_exec_conf->msg->notice(5) << "Destroying GSDDumpWriter" << endl;
@@ -156,11 +269,24 @@ GSDDumpWriter::~GSDDumpWriter()
     root = m_exec_conf->isRoot();
     #endif
 
+    // write out the remaining frames, errors can no longer be raised here
+    stopIOThread();
+    if (m_io_error != GSD_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Error " << m_io_error << " writing frames in the background - "
+                                  << m_fname << endl;
+        }
+
     if (root && m_is_initialized)
         {
         m_exec_conf->msg->notice(5) << "dump.gsd: close gsd file " << m_fname << endl;
         gsd_close(&m_handle);
         }
+
+    #ifdef ENABLE_MPI
+    if (m_mpi_file_open)
+        MPI_File_close(&m_mpi_file);
+    #endif
     }
 
 /*! \param timestep Current time step of the simulation
@@ -176,10 +302,19 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump GSD");
 
-    // take particle data snapshot
-    m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
+    bool parallel = false;
+#ifdef ENABLE_MPI
+    parallel = m_parallel && m_pdata->getDomainDecomposition();
+#endif
+
+    // take particle data snapshot, unless every rank writes its own particles
     SnapshotParticleData<float> snapshot;
-    const std::map<unsigned int, unsigned int>& map = m_pdata->takeSnapshot<float>(snapshot);
+    std::map<unsigned int, unsigned int> map;
+    if (! parallel)
+        {
+        m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
+        map = m_pdata->takeSnapshot<float>(snapshot);
+        }
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
@@ -190,18 +325,30 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (! m_is_initialized && root)
         initFileIO();
 
+    // discard chunks staged by a frame that failed
+    m_staging.n_chunks = 0;
+
+#ifdef ENABLE_MPI
+    if (parallel && ! m_mpi_file_open)
+        openMPIFile();
+#endif
+
     // truncate the file if requested
     if (m_truncate && root)
         {
+        // the I/O thread must not write to the file while it is truncated
+        waitIdle();
+
         m_exec_conf->msg->notice(10) << "dump.gsd: truncating file" << endl;
         retval = gsd_truncate(&m_handle);
         checkError(retval);
+        m_nframes = 0;
         }
 
     uint64_t nframes = 0;
     if (root)
         {
-        nframes = gsd_get_nframes(&m_handle);
+        nframes = m_nframes;
         m_exec_conf->msg->notice(10) << "dump.gsd: " << m_fname << " has " << nframes << " frames" << endl;
         }
 
@@ -209,22 +356,32 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     bcast(nframes, 0, m_exec_conf->getMPICommunicator());
     #endif
 
+    // only write out data chunk categories if requested and due, or if on frame 0
+    bool write_attribute = isWriteStep("attribute", m_write_attribute, timestep, nframes);
+    bool write_property = isWriteStep("property", m_write_property, timestep, nframes);
+    bool write_momentum = isWriteStep("momentum", m_write_momentum, timestep, nframes);
+    bool write_topology = isWriteStep("topology", m_write_topology, timestep, nframes);
+
     if (root)
         {
         // write out the frame header on all frames
         writeFrameHeader(timestep);
 
-        // only write out data chunk categories if requested, or if on frame 0
-        if (m_write_attribute || nframes == 0)
+        if (! parallel && write_attribute)
             writeAttributes(snapshot, map);
-        if (m_write_property || nframes == 0)
+        if (! parallel && write_property)
             writeProperties(snapshot, map);
-        if (m_write_momentum || nframes == 0)
+        if (! parallel && write_momentum)
             writeMomenta(snapshot, map);
         }
 
+#ifdef ENABLE_MPI
+    if (parallel)
+        writeParticlesParallel(nframes, write_attribute, write_property, write_momentum);
+#endif
+
     // topology is only meaningful if this is the all group
-    if (m_group->getNumMembersGlobal() == m_pdata->getNGlobal() && (m_write_topology || nframes == 0))
+    if (m_group->getNumMembersGlobal() == m_pdata->getNGlobal() && write_topology)
         {
         BondData::Snapshot bdata_snapshot;
         m_sysdef->getBondData()->takeSnapshot(bdata_snapshot);
@@ -248,22 +405,237 @@ void GSDDumpWriter::analyze(unsigned int timestep)
             writeTopology(bdata_snapshot, adata_snapshot, ddata_snapshot, idata_snapshot, cdata_snapshot, pdata_snapshot);
         }
 
+    // slots write to the handle directly, which the I/O thread must not use at the same time
+    if (m_write_signal_used && root)
+        waitIdle();
+
     // emit on all ranks, the slot needs to handle the mpi logic.
     m_write_signal.emit(m_handle);
 
     writeUser(timestep, root);
 
     if (root)
+        endFrame();
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+
+/*! \param name Name of the chunk
+    \param type Data type of the chunk
+    \param N Number of rows
+    \param M Number of columns
+    \param flags Chunk flags (must be 0)
+    \param data Data to write
+
+    In synchronous mode, the chunk is written with gsd_write_chunk(). In asynchronous mode, the data is copied into
+    the staging frame and written later by the I/O thread.
+
+    \returns The gsd error code
+*/
+int GSDDumpWriter::writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data)
+    {
+    if (! m_async)
+        return gsd_write_chunk(&m_handle, name, type, N, M, flags, data);
+
+    // validate the input here, so that errors are raised at the point of the call
+    if ((N > 0 && data == NULL) || M == 0 || flags != 0)
+        return GSD_ERROR_INVALID_ARGUMENT;
+
+    if (m_staging.n_chunks == m_staging.chunks.size())
+        m_staging.chunks.resize(m_staging.n_chunks+1);
+
+    ChunkBuffer& chunk = m_staging.chunks[m_staging.n_chunks++];
+    chunk.name = name;
+    chunk.type = type;
+    chunk.N = N;
+    chunk.M = M;
+
+    size_t size = N*M*gsd_sizeof_type(type);
+    chunk.data.resize(size);
+    if (size > 0)
+        memcpy(&chunk.data[0], data, size);
+
+    return GSD_SUCCESS;
+    }
+
+/*! \param name Name of the chunk
+    \param N Number of rows
+    \param M Number of columns
+    \param data Data to write
+
+    When the chunk is compressed, the encoded data is written to the chunk "compressed/<name>" instead.
+
+    \returns The gsd error code
+*/
+int GSDDumpWriter::writeFloatChunk(const char *name, uint64_t N, uint32_t M, const float *data)
+    {
+    auto it = m_encoders.find(name);
+    if (it == m_encoders.end())
+        return writeChunk(name, GSD_TYPE_FLOAT, N, M, 0, data);
+
+    if (!it->second.encode(m_compressed, data, N, M, m_nframes))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot compress " << name << " with precision "
+                                  << it->second.getPrecision() << ", the values are not finite or too large" << endl;
+        throw runtime_error("Error writing GSD file");
+        }
+
+    std::string compressed_name = std::string("compressed/") + name;
+    return writeChunk(compressed_name.c_str(), GSD_TYPE_UINT8, m_compressed.size(), 1, 0, &m_compressed[0]);
+    }
+
+/*! In asynchronous mode, the staged frame is handed to the I/O thread. This blocks when the I/O thread already
+    has max_queued_frames frames to write.
+*/
+void GSDDumpWriter::endFrame()
+    {
+    m_nframes++;
+
+    if (! m_async)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: ending frame" << endl;
-        retval = gsd_end_frame(&m_handle);
+        int retval = gsd_end_frame(&m_handle);
         checkError(retval);
+        return;
         }
 
-    if (m_prof)
-        m_prof->pop();
+    if (! m_io_thread.joinable())
+        {
+        m_io_stop = false;
+        m_io_thread = std::thread(&GSDDumpWriter::ioThreadMain, this);
+        }
+
+    int io_error, io_errno;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        if (m_queue.size() >= max_queued_frames)
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: waiting for the I/O thread" << endl;
+            m_io_cv.wait(lock, [this] { return m_queue.size() < max_queued_frames; });
+            }
+
+        m_exec_conf->msg->notice(10) << "dump.gsd: queueing frame" << endl;
+        m_queue.push_back(std::move(m_staging));
+
+        // reuse the buffers of a frame that has been written
+        if (m_free_frames.size() > 0)
+            {
+            m_staging = std::move(m_free_frames.back());
+            m_free_frames.pop_back();
+            }
+        else
+            {
+            m_staging = FrameBuffer();
+            }
+        m_staging.n_chunks = 0;
+
+        io_error = m_io_error;
+        io_errno = m_io_errno;
+        m_io_error = GSD_SUCCESS;
+        }
+    m_io_cv.notify_all();
+
+    if (io_error != GSD_SUCCESS)
+        {
+        errno = io_errno;
+        checkError(io_error);
+        }
+    }
+
+/*! The I/O thread writes the queued frames in order, and syncs the file after every frame. It only accesses
+    m_handle while a frame is in the queue.
+*/
+void GSDDumpWriter::ioThreadMain()
+    {
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+    while (true)
+        {
+        m_io_cv.wait(lock, [this] { return m_io_stop || m_queue.size() > 0; });
+        if (m_queue.size() == 0)
+            break;
+
+        // the main thread only appends to the queue, so the front frame stays in place
+        FrameBuffer& frame = m_queue.front();
+        lock.unlock();
+
+        int retval = GSD_SUCCESS;
+        for (unsigned int i = 0; i < frame.n_chunks && retval == GSD_SUCCESS; ++i)
+            {
+            const ChunkBuffer& chunk = frame.chunks[i];
+            retval = gsd_write_chunk(&m_handle,
+                                     chunk.name.c_str(),
+                                     chunk.type,
+                                     chunk.N,
+                                     chunk.M,
+                                     0,
+                                     chunk.data.size() > 0 ? &chunk.data[0] : NULL);
+            }
+        if (retval == GSD_SUCCESS)
+            retval = gsd_end_frame(&m_handle);
+        if (retval == GSD_SUCCESS && fsync(m_handle.fd) != 0)
+            retval = GSD_ERROR_IO;
+        int io_errno = errno;
+
+        lock.lock();
+        if (retval != GSD_SUCCESS && m_io_error == GSD_SUCCESS)
+            {
+            m_io_error = retval;
+            m_io_errno = io_errno;
+            }
+        m_free_frames.push_back(std::move(m_queue.front()));
+        m_queue.pop_front();
+        m_io_cv.notify_all();
+        }
+    }
+
+void GSDDumpWriter::waitIdle()
+    {
+    int io_error, io_errno;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_io_cv.wait(lock, [this] { return m_queue.size() == 0; });
+
+        io_error = m_io_error;
+        io_errno = m_io_errno;
+        m_io_error = GSD_SUCCESS;
+        }
+
+    if (io_error != GSD_SUCCESS)
+        {
+        errno = io_errno;
+        checkError(io_error);
+        }
+    }
+
+/*! Frames written with async writes enabled are on disk when flush() returns.
+*/
+void GSDDumpWriter::flush()
+    {
+    bool root=true;
+    #ifdef ENABLE_MPI
+    root = m_exec_conf->isRoot();
+    #endif
+
+    if (root)
+        waitIdle();
     }
 
+/*! The I/O thread writes out all queued frames before it exits.
+*/
+void GSDDumpWriter::stopIOThread()
+    {
+    if (! m_io_thread.joinable())
+        return;
+
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_io_stop = true;
+        }
+    m_io_cv.notify_all();
+    m_io_thread.join();
+    }
 
 void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping)
     {
@@ -279,7 +651,7 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
         std::vector<char> types(max_len * type_mapping.size());
         for (unsigned int i = 0; i < type_mapping.size(); i++)
             strncpy(&types[max_len*i], type_mapping[i].c_str(), max_len);
-        int retval = gsd_write_chunk(&m_handle, chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
+        int retval = writeChunk(chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
         checkError(retval);
         }
 
@@ -298,14 +670,14 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     int retval;
     m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/step" << endl;
     uint64_t step = timestep;
-    retval = gsd_write_chunk(&m_handle, "configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
+    retval = writeChunk("configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
     checkError(retval);
 
-    if (gsd_get_nframes(&m_handle) == 0)
+    if (m_nframes == 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/dimensions" << endl;
         uint8_t dimensions = m_sysdef->getNDimensions();
-        retval = gsd_write_chunk(&m_handle, "configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
+        retval = writeChunk("configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
         checkError(retval);
         }
 
@@ -318,12 +690,12 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     box_a[3] = box.getTiltFactorXY();
     box_a[4] = box.getTiltFactorXZ();
     box_a[5] = box.getTiltFactorYZ();
-    retval = gsd_write_chunk(&m_handle, "configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
+    retval = writeChunk("configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
     checkError(retval);
 
     m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/N" << endl;
     uint32_t N = m_group->getNumMembersGlobal();
-    retval = gsd_write_chunk(&m_handle, "particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+    retval = writeChunk("particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
     checkError(retval);
     }
 
@@ -335,7 +707,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
     {
     uint32_t N = m_group->getNumMembersGlobal();
     int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
     writeTypeMapping("particles/types", snapshot.type_mapping);
 
@@ -361,7 +733,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/typeid"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/typeid" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
+            retval = writeChunk("particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/typeid"] = true;
@@ -390,7 +762,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/mass"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/mass" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/mass"] = true;
@@ -414,7 +786,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/charge"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/charge" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/charge"] = true;
@@ -439,7 +811,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/diameter"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/diameter" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/diameter"] = true;
@@ -468,7 +840,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/body"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/body" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
+            retval = writeChunk("particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/body"] = true;
@@ -503,7 +875,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/moment_inertia"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/moment_inertia" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/moment_inertia"] = true;
@@ -519,7 +891,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
     {
     uint32_t N = m_group->getNumMembersGlobal();
     int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
         {
         std::vector<float> data(uint64_t(N)*3);
@@ -539,7 +911,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             }
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+        retval = writeFloatChunk("particles/position", N, 3, &data[0]);
         checkError(retval);
         }
 
@@ -573,7 +945,7 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
+            retval = writeFloatChunk("particles/orientation", N, 4, &data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/orientation"] = true;
@@ -589,7 +961,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
     {
     uint32_t N = m_group->getNumMembersGlobal();
     int retval;
-    uint64_t nframes = gsd_get_nframes(&m_handle);
+    uint64_t nframes = m_nframes;
 
         {
         std::vector<float> data(uint64_t(N)*3);
@@ -619,7 +991,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            retval = writeFloatChunk("particles/velocity", N, 3, &data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/velocity"] = true;
@@ -656,7 +1028,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
+            retval = writeChunk("particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/angmom"] = true;
@@ -691,7 +1063,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/image"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/image" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/image"] = true;
@@ -699,6 +1071,288 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         }
     }
 
+#ifdef ENABLE_MPI
+/*! The root rank creates the file in initFileIO() before the other ranks open it.
+*/
+void GSDDumpWriter::openMPIFile()
+    {
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    MPI_Barrier(mpi_comm);
+
+    m_exec_conf->msg->notice(3) << "dump.gsd: open gsd file " << m_fname << " for parallel writes" << endl;
+    int retval = MPI_File_open(mpi_comm, (char *)m_fname.c_str(), MPI_MODE_WRONLY, MPI_INFO_NULL, &m_mpi_file);
+    if (retval != MPI_SUCCESS)
+        {
+        char msg[MPI_MAX_ERROR_STRING];
+        int len;
+        MPI_Error_string(retval, msg, &len);
+        m_exec_conf->msg->error() << "dump.gsd: " << msg << " - " << m_fname << endl;
+        throw runtime_error("Error opening GSD file");
+        }
+    m_mpi_file_open = true;
+    }
+
+/*! \param nframes Number of frames in the file
+    \param write_attribute True if the attribute chunks are written in this frame
+    \param write_property True if the property chunks are written in this frame
+    \param write_momentum True if the momentum chunks are written in this frame
+
+    Writes the same chunks as writeAttributes(), writeProperties() and writeMomenta(), without gathering the
+    particles on the root rank. Every rank converts its local group members the same way as a snapshot does, and
+    sorts them by their index in the group. The ranks agree on which chunks are not at their default values, the
+    root reserves space for these chunks in the file, and every rank then writes its rows at their offsets in the
+    chunk with a collective MPI-IO write.
+*/
+void GSDDumpWriter::writeParticlesParallel(uint64_t nframes, bool write_attribute, bool write_property, bool write_momentum)
+    {
+    // per-particle chunks, in the categories attribute, property and momentum
+    enum { typeid_field, mass_field, charge_field, diameter_field, body_field, inertia_field,
+           position_field, orientation_field,
+           velocity_field, angmom_field, image_field, n_fields };
+    static const char *names[n_fields] = {"particles/typeid", "particles/mass", "particles/charge",
+                                          "particles/diameter", "particles/body", "particles/moment_inertia",
+                                          "particles/position", "particles/orientation",
+                                          "particles/velocity", "particles/angmom", "particles/image"};
+    static const gsd_type types[n_fields] = {GSD_TYPE_UINT32, GSD_TYPE_FLOAT, GSD_TYPE_FLOAT,
+                                             GSD_TYPE_FLOAT, GSD_TYPE_INT32, GSD_TYPE_FLOAT,
+                                             GSD_TYPE_FLOAT, GSD_TYPE_FLOAT,
+                                             GSD_TYPE_FLOAT, GSD_TYPE_FLOAT, GSD_TYPE_INT32};
+    static const uint32_t columns[n_fields] = {1, 1, 1, 1, 1, 3, 3, 4, 3, 4, 3};
+
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    bool root = m_exec_conf->isRoot();
+    uint32_t N = m_group->getNumMembersGlobal();
+
+    if (root && write_attribute)
+        {
+        std::vector<std::string> type_mapping;
+        for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+            type_mapping.push_back(m_pdata->getNameByType(i));
+        writeTypeMapping("particles/types", type_mapping);
+        }
+
+    // get the local members first, the group may access the tag array
+    unsigned int n_local = m_group->getNumMembers();
+    std::vector< std::pair<unsigned int, unsigned int> > rows(n_local);
+    for (unsigned int j = 0; j < n_local; j++)
+        rows[j].second = m_group->getMemberIndex(j);
+
+        {
+        // sort the local members by their row in the file
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        for (unsigned int j = 0; j < n_local; j++)
+            rows[j].first = m_group->getMemberTagIndex(h_tag.data[rows[j].second]);
+        }
+    std::sort(rows.begin(), rows.end());
+
+    // pack the local rows of all requested chunks, and check if they are at their defaults
+    bool requested[n_fields];
+    int all_default[n_fields];
+    std::vector< std::vector<char> > buffers(n_fields);
+    for (unsigned int f = 0; f < n_fields; f++)
+        {
+        if (f < position_field)
+            requested[f] = write_attribute;
+        else if (f < velocity_field)
+            requested[f] = write_property;
+        else
+            requested[f] = write_momentum;
+
+        all_default[f] = 1;
+        if (requested[f])
+            buffers[f].resize(size_t(n_local)*columns[f]*gsd_sizeof_type(types[f]));
+        }
+
+    // positions are always written
+    all_default[position_field] = 0;
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+        uint32_t *type = (uint32_t *)buffers[typeid_field].data();
+        float *mass = (float *)buffers[mass_field].data();
+        float *charge = (float *)buffers[charge_field].data();
+        float *diameter = (float *)buffers[diameter_field].data();
+        int32_t *body = (int32_t *)buffers[body_field].data();
+        float *inertia = (float *)buffers[inertia_field].data();
+        float *pos = (float *)buffers[position_field].data();
+        float *orientation = (float *)buffers[orientation_field].data();
+        float *vel = (float *)buffers[velocity_field].data();
+        float *angmom = (float *)buffers[angmom_field].data();
+        int32_t *image = (int32_t *)buffers[image_field].data();
+
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        Scalar3 origin = m_pdata->getOrigin();
+        int3 origin_image = m_pdata->getOriginImage();
+
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = rows[j].second;
+
+            if (write_attribute)
+                {
+                type[j] = uint32_t(__scalar_as_int(h_pos.data[idx].w));
+                mass[j] = float(h_vel.data[idx].w);
+                charge[j] = float(h_charge.data[idx]);
+                diameter[j] = float(h_diameter.data[idx]);
+                body[j] = int32_t(h_body.data[idx]);
+                inertia[j*3+0] = float(h_inertia.data[idx].x);
+                inertia[j*3+1] = float(h_inertia.data[idx].y);
+                inertia[j*3+2] = float(h_inertia.data[idx].z);
+
+                if (type[j] != 0)
+                    all_default[typeid_field] = 0;
+                if (mass[j] != float(1.0))
+                    all_default[mass_field] = 0;
+                if (charge[j] != float(0.0))
+                    all_default[charge_field] = 0;
+                if (diameter[j] != float(1.0))
+                    all_default[diameter_field] = 0;
+                if (h_body.data[idx] != NO_BODY)
+                    all_default[body_field] = 0;
+                if (inertia[j*3+0] != float(0.0) || inertia[j*3+1] != float(0.0) || inertia[j*3+2] != float(0.0))
+                    all_default[inertia_field] = 0;
+                }
+
+            if (write_property || write_momentum)
+                {
+                // convert and wrap the position in the same way as the snapshot
+                vec3<float> p(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin);
+                Scalar3 tmp = vec_to_scalar3(p);
+                int3 img = h_image.data[idx];
+                img.x -= origin_image.x;
+                img.y -= origin_image.y;
+                img.z -= origin_image.z;
+                global_box.wrap(tmp, img);
+
+                if (write_property)
+                    {
+                    pos[j*3+0] = float(tmp.x);
+                    pos[j*3+1] = float(tmp.y);
+                    pos[j*3+2] = float(tmp.z);
+
+                    quat<float> q(h_orientation.data[idx]);
+                    orientation[j*4+0] = q.s;
+                    orientation[j*4+1] = q.v.x;
+                    orientation[j*4+2] = q.v.y;
+                    orientation[j*4+3] = q.v.z;
+                    if (q.s != float(1.0) || q.v.x != float(0.0) || q.v.y != float(0.0) || q.v.z != float(0.0))
+                        all_default[orientation_field] = 0;
+                    }
+
+                if (write_momentum)
+                    {
+                    vel[j*3+0] = float(h_vel.data[idx].x);
+                    vel[j*3+1] = float(h_vel.data[idx].y);
+                    vel[j*3+2] = float(h_vel.data[idx].z);
+                    if (vel[j*3+0] != float(0.0) || vel[j*3+1] != float(0.0) || vel[j*3+2] != float(0.0))
+                        all_default[velocity_field] = 0;
+
+                    quat<float> a(h_angmom.data[idx]);
+                    angmom[j*4+0] = a.s;
+                    angmom[j*4+1] = a.v.x;
+                    angmom[j*4+2] = a.v.y;
+                    angmom[j*4+3] = a.v.z;
+                    if (a.s != float(0.0) || a.v.x != float(0.0) || a.v.y != float(0.0) || a.v.z != float(0.0))
+                        all_default[angmom_field] = 0;
+
+                    image[j*3+0] = img.x;
+                    image[j*3+1] = img.y;
+                    image[j*3+2] = img.z;
+                    if (img.x != 0 || img.y != 0 || img.z != 0)
+                        all_default[image_field] = 0;
+                    }
+                }
+            }
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, all_default, n_fields, MPI_INT, MPI_LAND, mpi_comm);
+
+    // the root decides which chunks to write and reserves space for them, -1 marks chunks that are skipped
+    int64_t location[n_fields];
+    if (root)
+        {
+        for (unsigned int f = 0; f < n_fields; f++)
+            {
+            location[f] = -1;
+            if (requested[f] && (!all_default[f] || (nframes > 0 && m_nondefault[names[f]])))
+                {
+                m_exec_conf->msg->notice(10) << "dump.gsd: writing " << names[f] << endl;
+                int retval = gsd_reserve_chunk(&m_handle, names[f], types[f], N, columns[f], 0, &location[f]);
+                checkError(retval);
+                if (nframes == 0)
+                    m_nondefault[names[f]] = true;
+                }
+            }
+        }
+    MPI_Bcast(location, n_fields, MPI_INT64_T, 0, mpi_comm);
+
+    // describe the rows of this rank in the file as blocks of consecutive rows
+    std::vector<MPI_Aint> block_start;
+    std::vector<int> block_rows;
+    for (unsigned int j = 0; j < n_local; j++)
+        {
+        if (j > 0 && rows[j].first == rows[j-1].first + 1)
+            {
+            block_rows.back()++;
+            }
+        else
+            {
+            block_start.push_back(rows[j].first);
+            block_rows.push_back(1);
+            }
+        }
+
+    std::vector<MPI_Aint> displs(block_start.size());
+    std::vector<int> lengths(block_rows.size());
+    for (unsigned int f = 0; f < n_fields; f++)
+        {
+        if (location[f] < 0)
+            continue;
+
+        int row_size = int(columns[f]*gsd_sizeof_type(types[f]));
+        for (unsigned int b = 0; b < block_start.size(); b++)
+            {
+            displs[b] = block_start[b]*row_size;
+            lengths[b] = block_rows[b]*row_size;
+            }
+
+        MPI_Datatype file_type, row_type;
+        MPI_Type_create_hindexed((int)lengths.size(), lengths.data(), displs.data(), MPI_BYTE, &file_type);
+        MPI_Type_commit(&file_type);
+        MPI_Type_contiguous(row_size, MPI_BYTE, &row_type);
+        MPI_Type_commit(&row_type);
+
+        int retval = MPI_File_set_view(m_mpi_file, location[f], MPI_BYTE, file_type, (char *)"native", MPI_INFO_NULL);
+        if (retval == MPI_SUCCESS)
+            retval = MPI_File_write_all(m_mpi_file, buffers[f].data(), n_local, row_type, MPI_STATUS_IGNORE);
+
+        MPI_Type_free(&row_type);
+        MPI_Type_free(&file_type);
+
+        if (retval != MPI_SUCCESS)
+            {
+            char msg[MPI_MAX_ERROR_STRING];
+            int len;
+            MPI_Error_string(retval, msg, &len);
+            m_exec_conf->msg->error() << "dump.gsd: " << msg << " writing " << names[f] << " - " << m_fname << endl;
+            throw runtime_error("Error writing GSD file");
+            }
+        }
+
+    // make the data visible before the root writes the frame index
+    MPI_File_sync(m_mpi_file);
+    }
+#endif
+
 /*! \param bond Bond data snapshot
     \param angle Angle data snapshot
     \param dihedral Dihedral data snapshot
@@ -719,68 +1373,68 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/N" << endl;
         uint32_t N = bond.size;
-        int retval = gsd_write_chunk(&m_handle, "bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("bonds/types", bond.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
+        retval = writeChunk("bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
+        retval = writeChunk("bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
         checkError(retval);
         }
     if (angle.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/N" << endl;
         uint32_t N = angle.size;
-        int retval = gsd_write_chunk(&m_handle, "angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("angles/types", angle.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
+        retval = writeChunk("angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
+        retval = writeChunk("angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
         checkError(retval);
         }
     if (dihedral.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/N" << endl;
         uint32_t N = dihedral.size;
-        int retval = gsd_write_chunk(&m_handle, "dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("dihedrals/types", dihedral.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
+        retval = writeChunk("dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
+        retval = writeChunk("dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
         checkError(retval);
         }
     if (improper.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/N" << endl;
         uint32_t N = improper.size;
-        int retval = gsd_write_chunk(&m_handle, "impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("impropers/types", improper.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
+        retval = writeChunk("impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
+        retval = writeChunk("impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
         checkError(retval);
         }
 
@@ -788,7 +1442,7 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/N" << endl;
         uint32_t N = constraint.size;
-        int retval = gsd_write_chunk(&m_handle, "constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/value" << endl;
@@ -798,12 +1452,12 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
             for (unsigned int i = 0; i < N; i++)
                 data[i] = float(constraint.val[i]);
 
-            retval = gsd_write_chunk(&m_handle, "constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             }
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
+        retval = writeChunk("constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
         checkError(retval);
         }
 
@@ -811,17 +1465,17 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/N" << endl;
         uint32_t N = pair.size;
-        int retval = gsd_write_chunk(&m_handle, "pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("pairs/types", pair.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
+        retval = writeChunk("pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
+        retval = writeChunk("pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
         checkError(retval);
         }
     }
@@ -899,7 +1553,7 @@ void GSDDumpWriter::writeUser(unsigned int timestep, bool root)
                 throw runtime_error("Invalid numpy dimension in gsd user-defined log data [" + item.first + "]");
                 }
 
-            int retval = gsd_write_chunk(&m_handle, name.c_str(), type, arr.shape(0), M, 0, (void *)arr.data());
+            int retval = writeChunk(name.c_str(), type, arr.shape(0), M, 0, (void *)arr.data());
             checkError(retval);
             }
         }
@@ -972,6 +1626,8 @@ void GSDDumpWriter::populateNonDefault()
     for (auto const& chunk : chunks)
         {
         const gsd_index_entry *entry = gsd_find_chunk(&m_handle, 0, chunk.c_str());
+        if (entry == nullptr)
+            entry = gsd_find_chunk(&m_handle, 0, ("compressed/" + chunk).c_str());
         m_nondefault[chunk] = (entry != nullptr);
         }
 
@@ -989,6 +1645,11 @@ void export_GSDDumpWriter(py::module& m)
         .def("setWriteProperty", &GSDDumpWriter::setWriteProperty)
         .def("setWriteMomentum", &GSDDumpWriter::setWriteMomentum)
         .def("setWriteTopology", &GSDDumpWriter::setWriteTopology)
+        .def("setAsyncWrite", &GSDDumpWriter::setAsyncWrite)
+        .def("setParallelWrite", &GSDDumpWriter::setParallelWrite)
+        .def("setCompression", &GSDDumpWriter::setCompression)
+        .def("setPeriod", &GSDDumpWriter::setPeriod)
+        .def("flush", &GSDDumpWriter::flush)
         .def_readwrite("user_log", &GSDDumpWriter::m_user_log)
     ;
     }
@@ -8,9 +8,15 @@
 #include "Analyzer.h"
 #include "ParticleGroup.h"
 #include "SharedSignal.h"
+#include "GSDCompression.h"
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "hoomd/extern/gsd.h"
 
 /*! \file GSDDumpWriter.h
@@ -31,6 +37,29 @@
     On the first call to analyze() \a fname is created with a dcd header. If it already
     exists, append to the file (unless the user specifies overwrite=True).
 
+    In asynchronous mode (setAsyncWrite()), the chunks of a frame are copied into a staging buffer on the root rank
+    and handed to a background I/O thread, which writes them, ends the frame and syncs the file to disk. At most
+    two frames are in flight: analyze() blocks only when the I/O thread has not yet finished the frame before the
+    previous one. Errors encountered by the I/O thread are raised by the next call to analyze() or flush(). Slots
+    connected to the write signal write directly to the file handle, so once the signal has been requested, the
+    writer waits for the I/O thread to become idle before emitting it.
+
+    In parallel mode (setParallelWrite()), the per-particle chunks are not gathered on the root rank. The root
+    reserves space for every chunk in the file, and all ranks write the rows of their local group members into it
+    with collective MPI-IO. The row of a particle is the index of its tag in the group, so the file is identical to
+    the one written in serial. The frame header, topology, user data and the file index are still written by the
+    root rank.
+
+    Positions, orientations and velocities can be compressed (setCompression()). The writer then stores the chunk,
+    encoded with a GSDChunkEncoder, as a uint8 chunk named "compressed/" followed by the original chunk name.
+    GSDReader decodes these chunks transparently. Compression requires the whole chunk on the root rank, so it
+    cannot be combined with parallel writes.
+
+    Each category of quantities (attribute, property, momentum, topology) that is written every frame can be given
+    its own period in time steps (setPeriod()). A frame then only includes the category when the time step is a
+    multiple of its period. Per the GSD schema, readers take the values of omitted chunks from frame 0. Frame 0
+    always includes all categories.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -67,13 +96,32 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
             m_write_topology = b;
             }
 
+        //! Control asynchronous writes
+        void setAsyncWrite(bool b);
+
+        //! Control parallel writes
+        void setParallelWrite(bool b);
+
+        //! Compress a per-particle quantity
+        void setCompression(const std::string& quantity, double precision);
+
+        //! Set the period of a category of quantities
+        void setPeriod(const std::string& category, unsigned int period);
+
         //! Destructor
         ~GSDDumpWriter();
 
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
-        hoomd::detail::SharedSignal<int (gsd_handle&)>& getWriteSignal() { return m_write_signal; }
+        //! Wait until all frames have been written to the file
+        void flush();
+
+        hoomd::detail::SharedSignal<int (gsd_handle&)>& getWriteSignal()
+            {
+            m_write_signal_used = true;
+            return m_write_signal;
+            }
 
     private:
         std::string m_fname;                //!< The file name we are writing to
@@ -84,6 +132,7 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
         bool m_write_property;              //!< True if properties should be written
         bool m_write_momentum;              //!< True if momenta should be written
         bool m_write_topology;              //!< True if topology should be written
+        std::map<std::string, unsigned int> m_period;   //!< Period of each category in time steps (0 for every frame)
         gsd_handle m_handle;                //!< Handle to the file
 
         std::shared_ptr<ParticleGroup> m_group;   //!< Group to write out to the file
@@ -91,6 +140,81 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
         std::map<std::string, pybind11::function> m_user_log;   //!< Map of user-defined quantities to log
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
+        bool m_write_signal_used;           //!< True if slots may be connected to m_write_signal
+
+        uint64_t m_nframes;                 //!< Number of frames in the file, including queued frames
+
+        //! A data chunk staged for the I/O thread
+        struct ChunkBuffer
+            {
+            std::string name;               //!< Name of the chunk
+            gsd_type type;                  //!< Data type
+            uint64_t N;                     //!< Number of rows
+            uint32_t M;                     //!< Number of columns
+            std::vector<char> data;         //!< Copy of the data
+            };
+
+        //! A frame staged for the I/O thread
+        /*! The chunk buffers are kept when the frame is recycled to reuse their memory.
+        */
+        struct FrameBuffer
+            {
+            std::vector<ChunkBuffer> chunks; //!< Chunk buffers
+            unsigned int n_chunks;           //!< Number of chunks in use
+
+            FrameBuffer() : n_chunks(0) {}
+            };
+
+        bool m_async;                       //!< True if frames are written by the I/O thread
+        FrameBuffer m_staging;              //!< Frame currently being staged
+        std::deque<FrameBuffer> m_queue;    //!< Frames handed to the I/O thread and not yet written (front is in progress)
+        std::vector<FrameBuffer> m_free_frames; //!< Written frames available for reuse
+        std::thread m_io_thread;            //!< The I/O thread
+        std::mutex m_io_mutex;              //!< Protects the queue and the I/O thread state
+        std::condition_variable m_io_cv;    //!< Signals changes of the queue
+        bool m_io_stop;                     //!< True when the I/O thread should exit
+        int m_io_error;                     //!< First error returned by gsd in the I/O thread
+        int m_io_errno;                     //!< errno that accompanied m_io_error
+
+        //! Maximum number of frames handed to the I/O thread
+        static const unsigned int max_queued_frames = 2;
+
+        //! Write a data chunk, or stage it for the I/O thread
+        int writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data);
+
+        //! End the current frame, or hand it to the I/O thread
+        void endFrame();
+
+        //! Main loop of the I/O thread
+        void ioThreadMain();
+
+        //! Wait until the I/O thread has written all queued frames and raise its errors
+        void waitIdle();
+
+        //! Stop the I/O thread
+        void stopIOThread();
+
+        bool m_parallel;                    //!< True if the particle data is written by all ranks
+
+        std::map<std::string, GSDChunkEncoder> m_encoders;  //!< Encoders of the compressed chunks, by chunk name
+        std::vector<uint8_t> m_compressed;  //!< Buffer for a compressed chunk
+
+        //! Write a float chunk, compressed if requested
+        int writeFloatChunk(const char *name, uint64_t N, uint32_t M, const float *data);
+
+        #ifdef ENABLE_MPI
+        MPI_File m_mpi_file;                //!< MPI-IO handle of the file
+        bool m_mpi_file_open;               //!< True if m_mpi_file is open
+
+        //! Open the file on all ranks for parallel writes
+        void openMPIFile();
+
+        //! Write the per-particle chunks from all ranks
+        void writeParticlesParallel(uint64_t nframes, bool write_attribute, bool write_property, bool write_momentum);
+        #endif
+
+        //! Test if a category is written in the current frame
+        bool isWriteStep(const std::string& category, bool write, unsigned int timestep, uint64_t nframes);
 
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
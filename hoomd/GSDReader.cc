@@ -11,8 +11,10 @@
 #include "GSDReader.h"
 #include "SnapshotSystemData.h"
 #include "ExecutionConfiguration.h"
+#include "GSDCompression.h"
 #include "hoomd/extern/gsd.h"
 #include <string.h>
+#include <sys/mman.h>
 
 #include <stdexcept>
 using namespace std;
@@ -23,21 +25,27 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param distributed Read the particles on all ranks into a distributed snapshot
 
     The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
-    memory (on the root rank).
+    memory (on the root rank, or on all ranks for a distributed read).
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool distributed)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_distributed(false), m_N(0),
+      m_first_row(0), m_mapped(NULL), m_mapped_size(0)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
     #ifdef ENABLE_MPI
+    // a distributed read is only useful with more than one rank
+    m_distributed = distributed && m_exec_conf->getNRanks() > 1;
+
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
@@ -72,24 +80,120 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
+    mapFile();
+
     readHeader();
     readParticles();
-    readTopology();
+
+    // the topology is distributed by the root rank when the system is initialized
+    if (m_exec_conf->isRoot())
+        readTopology();
+
+    // the reader may be kept alive to restore state while a writer truncates the same file, so later reads must
+    // not touch mapped pages that no longer exist
+    unmapFile();
     }
 
 GSDReader::~GSDReader()
     {
     #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
     #endif
 
+    unmapFile();
+
     gsd_close(&m_handle);
     }
 
+/*! Map the whole file read-only. The pages are only read from disk when the data of a chunk is accessed, so
+    reading a single frame from a large trajectory does not read the other frames.
+*/
+void GSDReader::mapFile()
+    {
+    m_mapped_size = m_handle.file_size;
+    void *mapped = mmap(NULL, m_mapped_size, PROT_READ, MAP_SHARED, m_handle.fd, 0);
+    if (mapped == MAP_FAILED)
+        {
+        m_exec_conf->msg->notice(5) << "data.gsd_snapshot: cannot map " << m_name << ", reading chunks instead" << endl;
+        m_mapped_size = 0;
+        return;
+        }
+
+    m_mapped = (const char *)mapped;
+    }
+
+/*! After the mapping is released, chunks are read with gsd_read_chunk(), which returns an error instead of
+    faulting when the file has been truncated in the meantime.
+*/
+void GSDReader::unmapFile()
+    {
+    if (m_mapped)
+        munmap((void *)m_mapped, m_mapped_size);
+
+    m_mapped = NULL;
+    m_mapped_size = 0;
+    }
+
+/*! \param entry Index entry of the chunk
+
+    \returns A pointer to the chunk data in the mapped file, or NULL if the file is not mapped.
+*/
+const char *GSDReader::getMappedChunk(const struct gsd_index_entry *entry)
+    {
+    if (!m_mapped)
+        return NULL;
+
+    size_t size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (entry->location == 0 || entry->location + size > m_mapped_size)
+        checkError(GSD_ERROR_FILE_CORRUPT);
+
+    return m_mapped + entry->location;
+    }
+
+/*! \param entry Index entry of the chunk
+    \param buffer Buffer to read the chunk into when the file is not mapped
+
+    \returns A pointer to the chunk data
+*/
+const char *GSDReader::getChunkData(const struct gsd_index_entry *entry, std::vector<char>& buffer)
+    {
+    const char *data = getMappedChunk(entry);
+    if (!data)
+        {
+        size_t size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+        buffer.resize(size);
+        int retval = gsd_read_chunk(&m_handle, &buffer[0], entry);
+        checkError(retval);
+        data = &buffer[0];
+        }
+
+    return data;
+    }
+
+/*! \param data Pointer to data to read into
+    \param entry Index entry of the chunk
+    \param first_row First row to copy
+    \param n_rows Number of rows to copy
+*/
+void GSDReader::copyChunkRows(void *data, const struct gsd_index_entry *entry, uint64_t first_row, uint64_t n_rows)
+    {
+    const char *mapped = getMappedChunk(entry);
+    if (mapped)
+        {
+        size_t row_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+        memcpy(data, mapped + first_row*row_size, n_rows*row_size);
+        }
+    else
+        {
+        int retval = gsd_read_chunk_rows(&m_handle, data, entry, first_row, n_rows);
+        checkError(retval);
+        }
+    }
+
 /*! \param data Pointer to data to read into
     \param frame Frame index to read from
     \param name Name of the data chunk
@@ -124,13 +228,171 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
             m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
             throw runtime_error("Error reading GSD file");
             }
-        int retval = gsd_read_chunk(&m_handle, data, entry);
-        checkError(retval);
+        copyChunkRows(data, entry, 0, entry->N);
 
         return true;
         }
     }
 
+/*! \param data Pointer to data to read into
+    \param name Name of the per-particle data chunk
+    \param row_size Size of the quantity of one particle in bytes
+
+    Reads the rows of the chunk that belong to the particles in the snapshot, with the same fallback to frame 0
+    as readChunk(). In a distributed read, only the range of particles assigned to this rank is read.
+
+    Return true if data is actually read from the file.
+*/
+bool GSDReader::readParticleChunk(void *data, const char *name, size_t row_size)
+    {
+    if (!m_distributed)
+        return readChunk(data, m_frame, name, m_N*row_size, m_N);
+
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, m_frame, name);
+    if (entry == NULL && m_frame != 0)
+        entry = gsd_find_chunk(&m_handle, 0, name);
+
+    if (entry == NULL || entry->N != m_N)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+    size_t actual_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (actual_size != row_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << m_N*row_size << " bytes in " << name
+                                  << " but found " << entry->N*actual_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    unsigned int n_rows = m_snapshot->particle_data.size;
+    if (n_rows > 0)
+        copyChunkRows(data, entry, m_first_row, n_rows);
+
+    return true;
+    }
+
+/*! \param data Pointer to data to read into
+    \param name Name of the per-particle data chunk
+    \param M Number of float values per particle
+
+    Reads the quantity from the chunk \a name or from its compressed form "compressed/<name>", whichever is present
+    in the selected frame. If neither is, fall back to frame 0 in the same order.
+
+    \returns true if the quantity was read from a compressed chunk
+*/
+bool GSDReader::readFloatParticleChunk(float *data, const char *name, unsigned int M)
+    {
+    std::string compressed_name = std::string("compressed/") + name;
+
+    bool compressed = false;
+    if (gsd_find_chunk(&m_handle, m_frame, name) == NULL)
+        {
+        if (gsd_find_chunk(&m_handle, m_frame, compressed_name.c_str()) != NULL)
+            compressed = true;
+        else if (gsd_find_chunk(&m_handle, 0, name) == NULL && gsd_find_chunk(&m_handle, 0, compressed_name.c_str()) != NULL)
+            compressed = true;
+        }
+
+    if (compressed)
+        return readCompressedParticleChunk(data, name, M);
+
+    readParticleChunk(data, name, M*sizeof(float));
+    return false;
+    }
+
+/*! \param data Pointer to data to read into
+    \param name Name of the per-particle data chunk (without the "compressed/" prefix)
+    \param M Number of float values per particle
+
+    Delta-encoded chunks refer to the chunk of an earlier frame. Follow the references back to the last keyframe,
+    then decode the chunks forward to the selected frame. In a distributed read, every chunk is decoded block by
+    block and only the values of the rows assigned to this rank are kept. Per the GSD spec, keep the default when N
+    does not match the current N.
+
+    Return true if data is actually read from the file.
+*/
+bool GSDReader::readCompressedParticleChunk(float *data, const char *name, unsigned int M)
+    {
+    std::string compressed_name = std::string("compressed/") + name;
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, m_frame, compressed_name.c_str());
+    if (entry == NULL && m_frame != 0)
+        entry = gsd_find_chunk(&m_handle, 0, compressed_name.c_str());
+    if (entry == NULL)
+        return false;
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << compressed_name << endl;
+
+    // collect the chunks back to the last keyframe
+    std::vector<const struct gsd_index_entry*> chain;
+    std::vector<char> buffer;
+    GSDCompressedHeader header;
+    GSDCompressedHeader target_header;
+    while (true)
+        {
+        const char *chunk = (entry->type == GSD_TYPE_UINT8 && entry->M == 1) ? getChunkData(entry, buffer) : NULL;
+        if (!chunk || !GSDChunkDecoder::readHeader(header, chunk, entry->N)
+            || (!chain.empty() && (header.N != target_header.N || header.M != target_header.M
+                                   || header.precision != target_header.precision)))
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid compressed chunk " << compressed_name
+                                      << " in frame " << entry->frame << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+
+        if (chain.empty())
+            target_header = header;
+        chain.push_back(entry);
+
+        if (header.reference_frame == GSDCompressedHeader::KEYFRAME)
+            break;
+
+        const struct gsd_index_entry* reference = NULL;
+        if (header.reference_frame < entry->frame)
+            reference = gsd_find_chunk(&m_handle, header.reference_frame, compressed_name.c_str());
+        if (reference == NULL)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Missing reference frame " << header.reference_frame
+                                      << " for " << compressed_name << " in frame " << entry->frame << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        entry = reference;
+        }
+
+    if (target_header.N != m_N)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << compressed_name << endl;
+        return false;
+        }
+    if (target_header.M != M)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << M << " columns in " << compressed_name
+                                  << " but found " << target_header.M << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // decode forward from the keyframe, keeping only the rows of this rank
+    uint64_t n_values = uint64_t(m_snapshot->particle_data.size)*M;
+    std::vector<int64_t> values;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+        const char *chunk = getChunkData(*it, buffer);
+        if (!GSDChunkDecoder::decode(values, chunk, (*it)->N, m_first_row*M, n_values))
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid compressed chunk " << compressed_name
+                                      << " in frame " << (*it)->frame << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        }
+
+    for (uint64_t i = 0; i < n_values; i++)
+        data[i] = GSDChunkDecoder::dequantize(values[i], target_header.precision);
+
+    return true;
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -157,10 +419,9 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
         return type_mapping;
     else
         {
-        size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
-        std::vector<char> data(actual_size);
-        int retval = gsd_read_chunk(&m_handle, &data[0], entry);
-        checkError(retval);
+        // parse the names directly from the mapped file when possible
+        std::vector<char> buffer;
+        const char *data = getChunkData(entry, buffer);
 
         type_mapping.clear();
         for (unsigned int i = 0; i < entry->N; i++)
@@ -195,29 +456,54 @@ void GSDReader::readHeader()
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "cannot read a file with 0 particles" << endl;
         throw runtime_error("Error reading GSD file");
         }
-    m_snapshot->particle_data.resize(N);
+    m_N = N;
+
+    if (m_distributed)
+        {
+        // read an equal share of the particles on every rank
+        uint64_t rank = m_exec_conf->getRank();
+        uint64_t n_ranks = m_exec_conf->getNRanks();
+        m_first_row = N*rank/n_ranks;
+        m_snapshot->particle_data.resize(N*(rank+1)/n_ranks - m_first_row);
+        m_snapshot->particle_data.is_distributed = true;
+        }
+    else
+        m_snapshot->particle_data.resize(N);
     }
 
 /*! Read the same data chunks for particles
 */
 void GSDReader::readParticles()
     {
-    uint64_t N = m_snapshot->particle_data.size;
     m_snapshot->particle_data.type_mapping = readTypes(m_frame, "particles/types");
 
     // the snapshot already has default values, if a chunk is not found, the value
     // is already at the default, and the failed read is not a problem
-    readChunk(&m_snapshot->particle_data.type[0], m_frame, "particles/typeid", N*4, N);
-    readChunk(&m_snapshot->particle_data.mass[0], m_frame, "particles/mass", N*4, N);
-    readChunk(&m_snapshot->particle_data.charge[0], m_frame, "particles/charge", N*4, N);
-    readChunk(&m_snapshot->particle_data.diameter[0], m_frame, "particles/diameter", N*4, N);
-    readChunk(&m_snapshot->particle_data.body[0], m_frame, "particles/body", N*4, N);
-    readChunk(&m_snapshot->particle_data.inertia[0], m_frame, "particles/moment_inertia", N*12, N);
-    readChunk(&m_snapshot->particle_data.pos[0], m_frame, "particles/position", N*12, N);
-    readChunk(&m_snapshot->particle_data.orientation[0], m_frame, "particles/orientation", N*16, N);
-    readChunk(&m_snapshot->particle_data.vel[0], m_frame, "particles/velocity", N*12, N);
-    readChunk(&m_snapshot->particle_data.angmom[0], m_frame, "particles/angmom", N*16, N);
-    readChunk(&m_snapshot->particle_data.image[0], m_frame, "particles/image", N*12, N);
+    readParticleChunk(m_snapshot->particle_data.type.data(), "particles/typeid", 4);
+    readParticleChunk(m_snapshot->particle_data.mass.data(), "particles/mass", 4);
+    readParticleChunk(m_snapshot->particle_data.charge.data(), "particles/charge", 4);
+    readParticleChunk(m_snapshot->particle_data.diameter.data(), "particles/diameter", 4);
+    readParticleChunk(m_snapshot->particle_data.body.data(), "particles/body", 4);
+    readParticleChunk(m_snapshot->particle_data.inertia.data(), "particles/moment_inertia", 12);
+    bool compressed_position = readFloatParticleChunk((float *)m_snapshot->particle_data.pos.data(),
+                                                      "particles/position", 3);
+    readFloatParticleChunk((float *)m_snapshot->particle_data.orientation.data(), "particles/orientation", 4);
+    readFloatParticleChunk((float *)m_snapshot->particle_data.vel.data(), "particles/velocity", 3);
+    readParticleChunk(m_snapshot->particle_data.angmom.data(), "particles/angmom", 16);
+    readParticleChunk(m_snapshot->particle_data.image.data(), "particles/image", 12);
+
+    // quantization may move particles just outside of the box, wrap them back in
+    if (compressed_position)
+        {
+        const BoxDim& box = m_snapshot->global_box;
+        for (unsigned int i = 0; i < m_snapshot->particle_data.size; i++)
+            {
+            const vec3<float>& p = m_snapshot->particle_data.pos[i];
+            Scalar3 pos = make_scalar3(p.x, p.y, p.z);
+            box.wrap(pos, m_snapshot->particle_data.image[i]);
+            m_snapshot->particle_data.pos[i] = vec3<float>(float(pos.x), float(pos.y), float(pos.z));
+            }
+        }
     }
 
 /*! Read the same data chunks for topology
@@ -360,6 +646,7 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
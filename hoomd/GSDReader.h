@@ -30,6 +30,19 @@ template <class Real> struct SnapshotSystemData;
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    By default, only the root rank reads the file. In a distributed read, every rank opens the file and reads
+    an equal, contiguous range of the particles into a distributed snapshot (see
+    SnapshotParticleData::is_distributed), which ParticleData then places without gathering it on the root rank.
+    The topology is still read by the root rank only.
+
+    Positions, orientations and velocities written with compression (see GSDDumpWriter::setCompression()) are
+    decoded from the chain of compressed chunks that starts at the last keyframe before the selected frame.
+
+    GSDReader maps the file into memory when it is opened and copies the chunks of the selected frame directly from
+    the mapped pages. Only the pages that hold the selected frame (and the static data in frame 0) are read from
+    disk, without any intermediate buffers. The mapping is released at the end of the constructor. Later reads,
+    such as those of restore_state, and reads of files that cannot be mapped use gsd_read_chunk().
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -39,7 +52,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool distributed=false);
 
         //! Destructor
         ~GSDReader();
@@ -94,10 +108,39 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        bool m_distributed;                                          //!< True if every rank reads a part of the particles
+        unsigned int m_N;                                            //!< Number of particles in the frame
+        uint64_t m_first_row;                                        //!< First particle read by this rank
+        const char *m_mapped;                                        //!< The file mapped into memory (NULL if not mapped)
+        size_t m_mapped_size;                                        //!< Size of the mapping in bytes
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
 
+        //! Map the file into memory
+        void mapFile();
+
+        //! Release the mapping of the file
+        void unmapFile();
+
+        //! Get a pointer to the data of a chunk in the mapped file
+        const char *getMappedChunk(const struct gsd_index_entry *entry);
+
+        //! Get the data of a chunk, from the mapped file or read into a buffer
+        const char *getChunkData(const struct gsd_index_entry *entry, std::vector<char>& buffer);
+
+        //! Copy rows of a chunk into a buffer
+        void copyChunkRows(void *data, const struct gsd_index_entry *entry, uint64_t first_row, uint64_t n_rows);
+
+        //! Helper function to read the rows of a per-particle quantity assigned to this rank
+        bool readParticleChunk(void *data, const char *name, size_t row_size);
+
+        //! Helper function to read a per-particle float quantity, which may be compressed
+        bool readFloatParticleChunk(float *data, const char *name, unsigned int M);
+
+        //! Helper function to decode the rows of a compressed per-particle quantity assigned to this rank
+        bool readCompressedParticleChunk(float *data, const char *name, unsigned int M);
+
         // helper functions to read sections of the file
         void readHeader();
         void readParticles();
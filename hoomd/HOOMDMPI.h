@@ -416,6 +416,77 @@ void all_gather_v(const T& in_value, std::vector<T> & out_values, const MPI_Comm
     delete[] rbuf;
     }
 
+//! Wrapper around MPI_Alltoallv that exchanges one serializable object with every rank
+/*! \param in_values Objects to send, in_values[i] is sent to rank i
+    \param out_values Received objects, out_values[i] is received from rank i
+    \param mpi_comm The MPI communicator
+ */
+template<typename T>
+void all_to_all_v(const std::vector<T>& in_values, std::vector<T>& out_values, const MPI_Comm mpi_comm)
+    {
+    int size;
+    MPI_Comm_size(mpi_comm, &size);
+
+    assert(in_values.size() == (unsigned int) size);
+
+    int *send_counts = new int[size];
+    int *send_displs = new int[size];
+    int *recv_counts = new int[size];
+    int *recv_displs = new int[size];
+
+    // serialize the objects for every destination
+    std::vector<std::string> str(size);
+    unsigned int send_len = 0;
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        std::stringstream s(std::ios_base::out | std::ios_base::binary);
+        cereal::BinaryOutputArchive ar(s);
+
+        ar << in_values[i];
+        s.flush();
+        str[i] = s.str();
+
+        send_displs[i] = (i > 0) ? send_displs[i-1] + send_counts[i-1] : 0;
+        send_counts[i] = str[i].length();
+        send_len += send_counts[i];
+        }
+
+    char *sbuf = new char[send_len];
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        str[i].copy(sbuf + send_displs[i], send_counts[i]);
+
+    // exchange lengths of buffers
+    MPI_Alltoall(send_counts, 1, MPI_INT, recv_counts, 1, MPI_INT, mpi_comm);
+
+    unsigned int recv_len = 0;
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        recv_displs[i] = (i > 0) ? recv_displs[i-1] + recv_counts[i-1] : 0;
+        recv_len += recv_counts[i];
+        }
+    char *rbuf = new char[recv_len];
+
+    // exchange actual objects
+    MPI_Alltoallv(sbuf, send_counts, send_displs, MPI_BYTE, rbuf, recv_counts, recv_displs, MPI_BYTE, mpi_comm);
+
+    // de-serialize data
+    out_values.resize(size);
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        std::stringstream s(std::string(rbuf + recv_displs[i], recv_counts[i]), std::ios_base::in | std::ios_base::binary);
+        cereal::BinaryInputArchive ar(s);
+
+        ar >> out_values[i];
+        }
+
+    delete[] send_counts;
+    delete[] send_displs;
+    delete[] recv_counts;
+    delete[] recv_displs;
+    delete[] sbuf;
+    delete[] rbuf;
+    }
+
 //! Wrapper around MPI_Send that handles any serializable object
 template<typename T>
 void send(const T& val,const unsigned int dest, const MPI_Comm mpi_comm)
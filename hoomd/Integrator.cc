@@ -18,6 +18,7 @@ namespace py = pybind11;
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
+#include "ClockSource.h"
 #endif
 
 using namespace std;
@@ -38,7 +39,10 @@ Integrator::~Integrator()
     if (m_request_flags_connected && m_comm)
         m_comm->getCommFlagsRequestSignal().disconnect<Integrator, &Integrator::determineFlags>(this);
     if (m_signals_connected && m_comm)
+        {
         m_comm->getComputeCallbackSignal().disconnect<Integrator, &Integrator::computeCallback>(this);
+        m_comm->getLocalComputeCallbackSignal().disconnect<Integrator, &Integrator::computeInteriorCallback>(this);
+        }
     #endif
     }
 
@@ -309,10 +313,21 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 */
 void Integrator::computeNetForce(unsigned int timestep)
     {
+    #ifdef ENABLE_MPI
+    ClockSource clk;
+    double collective_time = m_comm ? m_comm->getCollectiveTime() : 0.0;
+    #endif
+
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
         (*force_compute)->compute(timestep);
 
+    #ifdef ENABLE_MPI
+    // the measured time is used for cost-based load balancing, without the time spent waiting in collectives
+    if (m_comm)
+        m_comm->addComputeTime(double(clk.getTime())*1e-9 - (m_comm->getCollectiveTime() - collective_time));
+    #endif
+
     if (m_prof)
         {
         m_prof->push("Integrate");
@@ -904,7 +919,10 @@ void Integrator::setCommunicator(std::shared_ptr<Communicator> comm)
     m_request_flags_connected = true;
 
     if (! m_signals_connected && m_comm)
+        {
         comm->getComputeCallbackSignal().connect<Integrator, &Integrator::computeCallback>(this);
+        comm->getLocalComputeCallbackSignal().connect<Integrator, &Integrator::computeInteriorCallback>(this);
+        }
 
     m_signals_connected = true;
     }
@@ -917,6 +935,21 @@ void Integrator::computeCallback(unsigned int timestep)
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
         (*force_compute)->preCompute(timestep);
     }
+
+/*! \param timestep Current time step
+
+    Called by the Communicator while the ghost particle update is in flight.
+*/
+void Integrator::computeInteriorCallback(unsigned int timestep)
+    {
+    ClockSource clk;
+    double collective_time = m_comm->getCollectiveTime();
+
+    for (auto force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        (*force_compute)->computeInterior(timestep);
+
+    m_comm->addComputeTime(double(clk.getTime())*1e-9 - (m_comm->getCollectiveTime() - collective_time));
+    }
 #endif
 
 bool Integrator::getAnisotropic()
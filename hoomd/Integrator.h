@@ -137,6 +137,9 @@ class PYBIND11_EXPORT Integrator : public Updater
 
         //! Callback for pre-computing the forces
         void computeCallback(unsigned int timestep);
+
+        //! Callback for computing the forces among local particles during the ghost update
+        virtual void computeInteriorCallback(unsigned int timestep);
         #endif
 
     protected:
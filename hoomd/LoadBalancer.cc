@@ -20,6 +20,7 @@
 #include <cmath>
 #include <numeric>
 #include <limits>
+#include <set>
 
 using namespace std;
 namespace py = pybind11;
@@ -33,7 +34,9 @@ LoadBalancer::LoadBalancer(std::shared_ptr<SystemDefinition> sysdef,
         : Updater(sysdef), m_decomposition(decomposition), m_mpi_comm(m_exec_conf->getMPICommunicator()),
           m_max_imbalance(Scalar(1.0)), m_recompute_max_imbalance(true), m_needs_migrate(false),
           m_needs_recount(false), m_tolerance(Scalar(1.05)), m_maxiter(1), m_max_scale(Scalar(0.05)),
-          m_N_own(m_pdata->getN()), m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
+          m_cost_based(false), m_use_cost(false), m_total_load(Scalar(0.0)),
+          m_N_own(m_pdata->getN()), m_cost_local(Scalar(0.0)), m_cost_own(Scalar(0.0)),
+          m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
           m_n_iterations(0), m_n_rebalances(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing LoadBalancer" << endl;
@@ -63,6 +66,26 @@ void LoadBalancer::update(unsigned int timestep)
 
     if (m_prof) m_prof->push(m_exec_conf, "balance");
 
+    // the compute time measured since the last update is the cost of the particles currently on the rank
+    m_use_cost = false;
+    m_total_load = Scalar(m_pdata->getNGlobal());
+    if (m_cost_based)
+        {
+        Scalar cost = Scalar(m_comm->getComputeTime());
+        m_comm->resetComputeTime();
+
+        Scalar total_cost(0.0);
+        MPI_Allreduce(&cost, &total_cost, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_mpi_comm);
+
+        // fall back to the particle numbers if nothing has been measured yet
+        if (total_cost > Scalar(0.0))
+            {
+            m_use_cost = true;
+            m_cost_local = cost;
+            m_total_load = total_cost;
+            }
+        }
+
     // no adjustment has been made yet, so set m_N_own to the number of particles on the rank
     resetNOwn(m_pdata->getN());
 
@@ -112,12 +135,32 @@ void LoadBalancer::update(unsigned int timestep)
                 min_frac_i = min_domain_frac.z;
                 }
 
-            vector<unsigned int> N_i;
+            vector<Scalar> N_i;
             bool adjusted = false;
 
-            // reduce the number of particles in the slice along dim
+            // reduce the load in the slice along dim
             bool active = reduce(N_i, dim, reduce_root);
 
+            if (m_decomposition->isStaggered() && dim > 0)
+                {
+                // every slab (y) or column (z) of a staggered decomposition is adjusted separately
+                vector<Scalar> stagger_frac = m_decomposition->getStaggeredFractions(dim);
+                if (active)
+                    {
+                    adjusted = adjustStaggered(stagger_frac, N_i, dim, L_i, min_frac_i);
+                    }
+
+                bcast(adjusted, reduce_root, m_mpi_comm);
+
+                if (adjusted)
+                    {
+                    m_decomposition->setStaggeredFractions(dim, stagger_frac, reduce_root);
+                    m_pdata->setGlobalBox(box); // force a domain resizing to trigger
+                    signalResize();
+                    }
+                continue;
+                }
+
             // attempt an adjustment
             vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dim);
             if (active)
@@ -140,6 +183,13 @@ void LoadBalancer::update(unsigned int timestep)
         // force a particle migration if one is needed
         if (m_needs_migrate)
             {
+            // the migrated particles take their estimated cost along
+            if (m_use_cost)
+                {
+                computeOwnedParticles();
+                m_cost_local = m_cost_own;
+                }
+
             m_comm->forceMigrate();
             m_comm->communicate(timestep);
             resetNOwn(m_pdata->getN());
@@ -154,13 +204,14 @@ void LoadBalancer::update(unsigned int timestep)
     }
 
 /*!
- * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks.
+ * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks. In cost-based
+ * balancing, N is the estimated compute time of the rank.
  */
 Scalar LoadBalancer::getMaxImbalance()
     {
     if (m_recompute_max_imbalance)
         {
-        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+        Scalar cur_imb = getLoad() / (m_total_load / Scalar(m_exec_conf->getNRanks()));
         Scalar max_imb(0.0);
         MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
 
@@ -175,12 +226,13 @@ Scalar LoadBalancer::getMaxImbalance()
     }
 
 /*!
- * \param N_i Vector holding the total number of particles in each slice (will be allocated on call)
+ * \param N_i Vector holding the total load (number of particles or cost) in each slice (will be allocated on call)
  * \param dim The dimension of the slices (x=0, y=1, z=2)
  * \param reduce_root The rank to perform the reduction on
  * \returns true if the current rank holds the active \a N_i
  *
- * \post \a N_i holds the number of particles in each slice along \a dim
+ * \post \a N_i holds the load of each slice along \a dim. In a staggered decomposition, it holds the load of every
+ *       slice of every slab along y, and the load of every domain grouped by column along z.
  *
  * \note reduce() relies on collective MPI calls, and so all ranks must call it. However, for efficiency the data will
  *       be active only on Cartesian rank \a reduce_root, as indicated by the return value. As a result, only \a reduce_root
@@ -191,18 +243,18 @@ Scalar LoadBalancer::getMaxImbalance()
  * down dimensions. Generally, load balancing should not be performed too frequently, and so we do not pursue this
  * optimization right now.
  */
-bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root)
+bool LoadBalancer::reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root)
     {
     // do nothing if there is only one rank
     if (N_i.size() == 1) return false;
 
     const Index3D& di = m_decomposition->getDomainIndexer();
-    std::vector<unsigned int> N_per_rank(di.getNumElements());
+    std::vector<Scalar> N_per_rank(di.getNumElements());
 
-    // get the number of particles the current rank owns (the quantity to be reduced)
-    unsigned int N_own = getNOwn();
+    // get the load the current rank owns (the quantity to be reduced)
+    Scalar N_own = getLoad();
 
-    MPI_Gather(&N_own, 1, MPI_UNSIGNED, &N_per_rank[0], 1, MPI_UNSIGNED, reduce_root, m_mpi_comm);
+    MPI_Gather(&N_own, 1, MPI_HOOMD_SCALAR, &N_per_rank[0], 1, MPI_HOOMD_SCALAR, reduce_root, m_mpi_comm);
 
     // only the root rank performs the reduction
     if (m_exec_conf->getRank() != reduce_root)
@@ -210,12 +262,45 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
     // rearrange the data from ranks to cartesian order in case it is jumbled around
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_decomposition->getInverseCartRanks(), access_location::host, access_mode::read);
-    std::vector<unsigned int> N_per_cart_rank(di.getNumElements());
+    std::vector<Scalar> N_per_cart_rank(di.getNumElements());
     for (unsigned int cur_rank=0; cur_rank < di.getNumElements(); ++cur_rank)
         {
         N_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = N_per_rank[cur_rank];
         }
 
+    // in a staggered decomposition, the loads are summed per slab (y) or not at all (z)
+    if (m_decomposition->isStaggered() && dim == 1)
+        {
+        N_i.clear(); N_i.resize(di.getW()*di.getH());
+        for (unsigned int i=0; i < di.getW(); ++i)
+            {
+            for (unsigned int j=0; j < di.getH(); ++j)
+                {
+                N_i[i*di.getH()+j] = 0;
+                for (unsigned int k=0; k < di.getD(); ++k)
+                    {
+                    N_i[i*di.getH()+j] += N_per_cart_rank[di(i,j,k)];
+                    }
+                }
+            }
+        return true;
+        }
+    else if (m_decomposition->isStaggered() && dim == 2)
+        {
+        N_i.clear(); N_i.resize(di.getNumElements());
+        for (unsigned int j=0; j < di.getH(); ++j)
+            {
+            for (unsigned int i=0; i < di.getW(); ++i)
+                {
+                for (unsigned int k=0; k < di.getD(); ++k)
+                    {
+                    N_i[(j*di.getW()+i)*di.getD()+k] = N_per_cart_rank[di(i,j,k)];
+                    }
+                }
+            }
+        return true;
+        }
+
     // perform the summation along dim in as cache friendly of a way as we can manage
     if (dim == 0) // to x
         {
@@ -273,7 +358,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
 /*!
  * \param cum_frac_i The cumulative fraction array to write output into
- * \param N_i The reduced number of particles along the dimension
+ * \param N_i The reduced load along the dimension
  * \param L_i The global box length along the dimension
  * \param min_frac_i The minimum fractional width of a domain
  *
@@ -291,15 +376,17 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
  *     successful, apply the adjustment to \a cum_frac_i.
  */
 bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
-                          const vector<unsigned int>& N_i,
+                          const vector<Scalar>& N_i,
                           Scalar L_i,
                           Scalar min_frac_i)
     {
     if (N_i.size() == 1)
         return false;
 
-    // target particles per rank is uniform distribution
-    const Scalar target = Scalar(m_pdata->getNGlobal()) / Scalar(N_i.size());
+    // target load per rank is uniform distribution
+    const Scalar target = std::accumulate(N_i.begin(), N_i.end(), Scalar(0.0)) / Scalar(N_i.size());
+    if (target <= Scalar(0.0))
+        return false;
 
     // make the minimum domain slightly bigger so that the optimization won't fail at equality
     const Scalar min_domain_size = Scalar(1.00001) * min_frac_i * L_i;
@@ -314,7 +401,7 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     for (unsigned int i=0; i < N_i.size(); ++i)
         {
         const Scalar imb_factor = Scalar(N_i[i]) / target;
-        Scalar scale_factor = (N_i[i] > 0) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
+        Scalar scale_factor = (N_i[i] > Scalar(0.0)) ? Scalar(1.0) / imb_factor : (Scalar(1.0) + m_max_scale); // as in gromacs, use half the imbalance factor to scale
 
         // limit rescaling to 5% either direction
         // we should use absolute distance here, it is necessary to control balancing in corrugated systems
@@ -416,6 +503,81 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     return false;
     }
 
+/*!
+ * \param stagger_frac The cumulative fractions of all slabs (y) or columns (z) to write output into
+ * \param N_i The load of every domain along the dimension, grouped by slab or column
+ * \param dim The dimension of the cuts (y=1, z=2)
+ * \param L_i The global box length along the dimension
+ * \param min_frac_i The minimum fractional width of a domain
+ *
+ * \returns true if an adjustment occurred
+ *
+ * The cuts of every slab (y) or column (z) are adjusted with adjust() to balance the loads within it. An adjustment
+ * is rejected if a cut would come closer than \a min_frac_i to the next but one cut of a neighboring slab or column,
+ * so that the domains only ever touch their 26 grid neighbors. Every adjustment is checked against the current cuts
+ * of its neighbors, including those that have already been adjusted, which keeps all pairs consistent.
+ */
+bool LoadBalancer::adjustStaggered(vector<Scalar>& stagger_frac,
+                                   const vector<Scalar>& N_i,
+                                   unsigned int dim,
+                                   Scalar L_i,
+                                   Scalar min_frac_i)
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    const unsigned int n = (dim == 1) ? di.getH() : di.getD();
+    const unsigned int nx = di.getW();
+    const unsigned int ny = di.getH();
+    const unsigned int n_groups = (dim == 1) ? nx : nx*ny;
+
+    bool adjusted = false;
+    for (unsigned int g=0; g < n_groups; ++g)
+        {
+        vector<Scalar> cum_frac(stagger_frac.begin() + g*(n+1), stagger_frac.begin() + (g+1)*(n+1));
+        vector<Scalar> N_g(N_i.begin() + g*n, N_i.begin() + (g+1)*n);
+        if (!adjust(cum_frac, N_g, L_i, min_frac_i))
+            continue;
+
+        // neighboring slabs along x, or columns along x and y
+        std::set<unsigned int> neighbors;
+        const int i = g % nx;
+        const int j = g / nx;
+        for (int dx=-1; dx <= 1; ++dx)
+            {
+            for (int dy=-1; dy <= 1; ++dy)
+                {
+                if (dim == 1 && dy != 0) continue;
+                unsigned int neigh_i = (i + dx + nx) % nx;
+                unsigned int neigh_j = (dim == 1) ? 0 : (j + dy + ny) % ny;
+                unsigned int neigh = neigh_j*nx + neigh_i;
+                if (neigh != g)
+                    neighbors.insert(neigh);
+                }
+            }
+
+        bool valid = true;
+        for (std::set<unsigned int>::const_iterator it = neighbors.begin(); valid && it != neighbors.end(); ++it)
+            {
+            const Scalar *neigh_frac = &stagger_frac[(*it)*(n+1)];
+            for (unsigned int m=1; m < n; ++m)
+                {
+                if (cum_frac[m] - neigh_frac[m-1] < min_frac_i || neigh_frac[m+1] - cum_frac[m] < min_frac_i)
+                    {
+                    valid = false;
+                    break;
+                    }
+                }
+            }
+
+        if (valid)
+            {
+            std::copy(cum_frac.begin(), cum_frac.end(), stagger_frac.begin() + g*(n+1));
+            adjusted = true;
+            }
+        }
+
+    return adjusted;
+    }
+
 /*!
  * \param cnts Map holding result of number of particles on each rank that neighbors the local rank
  */
@@ -425,8 +587,10 @@ void LoadBalancer::countParticlesOffRank(std::map<unsigned int, unsigned int>& c
     ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
     const Index3D& di = m_decomposition->getDomainIndexer();
     const uint3 rank_pos = m_decomposition->getGridPos();
+    const bool staggered = m_decomposition->isStaggered();
 
     for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
         {
@@ -470,7 +634,12 @@ void LoadBalancer::countParticlesOffRank(std::map<unsigned int, unsigned int>& c
             moved = true;
             }
 
-        if (moved)
+        if (moved && staggered)
+            {
+            // the grid positions of staggered domains depend on the cuts of their slab and column
+            cnts[m_decomposition->placeParticle(global_box, cur_pos, h_cart_ranks.data)]++;
+            }
+        else if (moved)
             {
             if (grid_pos.x == (int)di.getW())
                 grid_pos.x = 0;
@@ -498,6 +667,9 @@ void LoadBalancer::countParticlesOffRank(std::map<unsigned int, unsigned int>& c
  * then perform send/receive calls, and count the new number of particles they own as the number they owned locally
  * plus the number received minus the number sent.
  *
+ * In cost-based balancing, the particles that leave the rank take an equal share of its cost along, which is added
+ * to the cost of the receiving rank.
+ *
  * \note All ranks must participate in this call since it involves send/receive operations between neighboring domains.
  */
 void LoadBalancer::computeOwnedParticles()
@@ -540,8 +712,35 @@ void LoadBalancer::computeOwnedParticles()
         N_own -= n_send_ptls[cur_neigh];
         }
 
+    // the cost is exchanged after the counts, so that it is not overwritten by resetNOwn()
+    Scalar cost_own = m_cost_local;
+    if (m_use_cost)
+        {
+        const Scalar cost_per_ptl = (m_pdata->getN() > 0) ? m_cost_local / Scalar(m_pdata->getN()) : Scalar(0.0);
+
+        std::vector<Scalar> send_cost(m_comm->getNUniqueNeighbors());
+        std::vector<Scalar> recv_cost(m_comm->getNUniqueNeighbors());
+        nreq = 0;
+        for (unsigned int cur_neigh=0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
+            {
+            unsigned int neigh_rank = h_unique_neigh.data[cur_neigh];
+            send_cost[cur_neigh] = cost_per_ptl * Scalar(n_send_ptls[cur_neigh]);
+
+            MPI_Isend(&send_cost[cur_neigh], 1, MPI_HOOMD_SCALAR, neigh_rank, 1, m_mpi_comm, & req[nreq++]);
+            MPI_Irecv(&recv_cost[cur_neigh], 1, MPI_HOOMD_SCALAR, neigh_rank, 1, m_mpi_comm, & req[nreq++]);
+            }
+        MPI_Waitall(nreq, req, stat);
+
+        for (unsigned int cur_neigh = 0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
+            {
+            cost_own += recv_cost[cur_neigh];
+            cost_own -= send_cost[cur_neigh];
+            }
+        }
+
     // set the count
     resetNOwn(N_own);
+    m_cost_own = cost_own;
     }
 
 /*!
@@ -578,6 +777,8 @@ void export_LoadBalancer(py::module& m)
     .def("setTolerance", &LoadBalancer::setTolerance)
     .def("getMaxIterations", &LoadBalancer::getMaxIterations)
     .def("setMaxIterations", &LoadBalancer::setMaxIterations)
+    .def("setCostBased", &LoadBalancer::setCostBased)
+    .def("getCostBased", &LoadBalancer::getCostBased)
     ;
     }
 #endif // ENABLE_MPI
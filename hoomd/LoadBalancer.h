@@ -31,6 +31,12 @@
  * is defined as the number of particles owned by a rank divided by the average number of particles per rank if the
  * particles had a uniform distribution.
  *
+ * Alternatively, the load of a rank can be measured by the wall time it spent computing forces (including the
+ * neighbor list) since the last balancing step, as reported to the Communicator by the Integrator. The time is
+ * attributed evenly to the particles of the rank, and particles that cross a domain boundary carry their share of the
+ * time along. This cost-based balancing accounts for variations of the work per particle, e.g. between dense and
+ * dilute regions. If no time has been measured, the particle counts are balanced instead.
+ *
  * At each load balancing step, we attempt to rescale the domain size by the inverse of the load balance, subject to the
  * following constraints that are imposed to both maintain a stable balancing and to keep communication isolated to the
  * 26 nearest neighbors of a cell:
@@ -41,6 +47,10 @@
  * Constraints are satisfied by solving a least-squares problem with box constraints, where the cost function is the
  * deviation of the domain sizes from the proposed rescaled width.
  *
+ * If the DomainDecomposition is staggered, the cuts along y are balanced separately in every slab along x, and the
+ * cuts along z in every column. As a fourth constraint, a staggered cut may not come closer than the minimum domain
+ * size to the next but one cut of a neighboring slab or column.
+ *
  * \ingroup updaters
  */
 class PYBIND11_EXPORT LoadBalancer : public Updater
@@ -83,6 +93,21 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             m_maxiter = maxiter;
             }
 
+        //! Enable / disable cost-based load balancing
+        /*!
+         * \param cost_based If true, balance the measured force computation time instead of the particle numbers
+         */
+        void setCostBased(bool cost_based)
+            {
+            m_cost_based = cost_based;
+            }
+
+        //! Returns true if the load balancing is cost-based
+        bool getCostBased() const
+            {
+            return m_cost_based;
+            }
+
         //! Enable / disable load balancing along a dimension
         /*!
          * \param dim Dimension along which to balance
@@ -119,8 +144,8 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
         Scalar m_max_imbalance;             //!< Maximum imbalance
         bool m_recompute_max_imbalance;     //!< Flag if maximum imbalance needs to be computed
 
-        //! Reduce the particle numbers per rank down to one dimension
-        bool reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root);
+        //! Reduce the loads per rank down to one dimension
+        bool reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root);
 
         //! Set flags within the class that a resize has been performed
         void signalResize()
@@ -132,9 +157,17 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
 
         //! Adjust the partitioning along a single dimension
         bool adjust(std::vector<Scalar>& cum_frac_i,
-                    const std::vector<unsigned int>& N_i,
+                    const std::vector<Scalar>& N_i,
                     Scalar L_i,
                     Scalar min_domain_frac);
+
+        //! Adjust the staggered cuts of all slabs or columns along a single dimension
+        bool adjustStaggered(std::vector<Scalar>& stagger_frac,
+                             const std::vector<Scalar>& N_i,
+                             unsigned int dim,
+                             Scalar L_i,
+                             Scalar min_frac_i);
+
         bool m_needs_migrate;   //!< Flag to signal that migration is necessary
 
         //! Compute the number of particles on each rank after an adjustment
@@ -150,6 +183,13 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             return m_N_own;
             }
 
+        //! Gets the load of the rank, updating if necessary
+        Scalar getLoad()
+            {
+            computeOwnedParticles();
+            return m_use_cost ? m_cost_own : Scalar(m_N_own);
+            }
+
         //! Force a reset of the number of owned particles without counting
         /*!
          * \param N number of particles owned by the rank
@@ -157,6 +197,7 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
         void resetNOwn(unsigned int N)
             {
             m_N_own = N;
+            m_cost_own = m_cost_local;
             m_recompute_max_imbalance = true;
             m_needs_recount = false;
             }
@@ -170,8 +211,14 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
 
         const Scalar m_max_scale;   //!< Maximum fraction to rescale either direction (5%)
 
+        bool m_cost_based;      //!< Flag to balance the measured compute time
+        bool m_use_cost;        //!< True if the compute time is balanced in the current update
+        Scalar m_total_load;    //!< Total load of all ranks in the current update
+
     private:
         unsigned int m_N_own;               //!< Number of particles owned by this rank
+        Scalar m_cost_local;                //!< Cost of the particles currently stored on this rank
+        Scalar m_cost_own;                  //!< Cost of the particles owned by this rank after an adjustment
 
         Scalar m_max_max_imbalance;     //!< The maximum imbalance of any check
         double m_total_max_imbalance;   //!< The average imbalance over checks
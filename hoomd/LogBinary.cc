@@ -0,0 +1,513 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBinary.cc
+    \brief Defines the LogBinary class
+*/
+
+#include "LogBinary.h"
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#endif
+
+namespace py = pybind11;
+
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+using namespace std;
+
+//! Magic bytes at the start of the file
+static const char log_binary_magic[8] = {'H', 'O', 'O', 'M', 'D', 'L', 'O', 'G'};
+//! Magic bytes at the start of each block
+static const char log_binary_block_magic[4] = {'H', 'L', 'B', 'K'};
+//! Version of the file format
+static const uint32_t log_binary_version = 1;
+
+//! Append the bytes of a value to a buffer
+template<class T> static void append_value(std::vector<char>& buffer, const T& value)
+    {
+    const char *p = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+//! Write a whole buffer to a file descriptor
+/*! \returns 0 on success, errno on failure
+*/
+static int write_all(int fd, const char *data, size_t size)
+    {
+    while (size > 0)
+        {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0)
+            {
+            if (errno == EINTR)
+                continue;
+            return errno;
+            }
+        data += n;
+        size -= n;
+        }
+    return 0;
+    }
+
+//! Read exactly \a size bytes at \a offset
+/*! \returns true on success, false when the file is too short or cannot be read
+*/
+static bool read_at(int fd, void *data, size_t size, off_t offset)
+    {
+    char *p = static_cast<char *>(data);
+    while (size > 0)
+        {
+        ssize_t n = ::pread(fd, p, size, offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+        offset += n;
+        }
+    return true;
+    }
+
+/*! \param sysdef Specified for Logger, but not used directly by Logger
+    \param fname File name to write the log to
+    \param overwrite Will overwrite an exiting file if true (default is to append)
+    \param buffer_rows Number of rows to collect before writing them to the file
+    \param flush_interval Maximum time in seconds that collected rows wait before they are written (0 to disable)
+
+    The file is opened when the logged quantities are set.
+*/
+LogBinary::LogBinary(std::shared_ptr<SystemDefinition> sysdef,
+                     const std::string& fname,
+                     bool overwrite,
+                     unsigned int buffer_rows,
+                     double flush_interval)
+    : Logger(sysdef), m_filename(fname), m_overwrite(overwrite), m_buffer_rows(buffer_rows), m_fd(-1),
+      m_io_stop(false), m_io_errno(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing LogBinary: " << fname << " " << overwrite << " " << buffer_rows
+                                << " " << flush_interval << endl;
+
+    if (m_filename == string(""))
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: A file name is required" << endl;
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    if (buffer_rows == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: buffer_rows must be positive" << endl;
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    if (!(flush_interval >= 0.0))
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: flush_interval must not be negative" << endl;
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    m_flush_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(flush_interval));
+    }
+
+LogBinary::~LogBinary()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying LogBinary" << endl;
+
+    // write the remaining rows, but do not throw from the destructor
+    stopIOThread();
+    if (m_io_errno)
+        m_exec_conf->msg->error() << "analyze.log_binary: I/O error while writing " << m_filename << ": "
+                                  << strerror(m_io_errno) << endl;
+
+    if (m_fd >= 0)
+        ::close(m_fd);
+    }
+
+/*! \param quantities A list of quantities to log
+
+    The first call opens the file and fixes its columns. Later calls must set the same quantities.
+*/
+void LogBinary::setLoggedQuantities(const std::vector< std::string >& quantities)
+    {
+#ifdef ENABLE_MPI
+    // only output to file on root processor
+    if (!m_pdata->getDomainDecomposition() || m_exec_conf->isRoot())
+#endif
+        {
+        if (m_fd < 0)
+            {
+            openFile(quantities);
+            }
+        else if (quantities != m_columns)
+            {
+            m_exec_conf->msg->error() << "analyze.log_binary: The logged quantities cannot change after "
+                                      << m_filename << " is opened" << endl;
+            throw runtime_error("Error setting logged quantities");
+            }
+        }
+
+    Logger::setLoggedQuantities(quantities);
+
+    if (quantities.size() == 0)
+        m_exec_conf->msg->warning() << "analyze.log_binary: No quantities specified for logging" << endl;
+    }
+
+/*! \param quantities Columns of the file
+
+    A new file gets a header with \a quantities. When appending to an existing file, its header must list the same
+    quantities, and anything after the last valid block is truncated.
+*/
+void LogBinary::openFile(const std::vector< std::string >& quantities)
+    {
+    int flags = O_RDWR | O_CREAT;
+    if (m_overwrite)
+        flags |= O_TRUNC;
+
+    int fd = ::open(m_filename.c_str(), flags, 0666);
+    if (fd < 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: Error opening log file " << m_filename << ": "
+                                  << strerror(errno) << endl;
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: Error opening log file " << m_filename << ": "
+                                  << strerror(errno) << endl;
+        ::close(fd);
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    if (st.st_size == 0)
+        {
+        m_exec_conf->msg->notice(3) << "analyze.log_binary: Creating new log in file \"" << m_filename << "\""
+                                    << endl;
+
+        std::vector<char> header(log_binary_magic, log_binary_magic + sizeof(log_binary_magic));
+        append_value(header, log_binary_version);
+        append_value(header, uint32_t(quantities.size()));
+        for (unsigned int i = 0; i < quantities.size(); i++)
+            {
+            append_value(header, uint32_t(quantities[i].size()));
+            header.insert(header.end(), quantities[i].begin(), quantities[i].end());
+            }
+
+        int err = write_all(fd, &header[0], header.size());
+        if (err == 0 && ::fsync(fd) != 0)
+            err = errno;
+        if (err)
+            {
+            m_exec_conf->msg->error() << "analyze.log_binary: Error writing log file " << m_filename << ": "
+                                      << strerror(err) << endl;
+            ::close(fd);
+            throw runtime_error("Error initializing LogBinary");
+            }
+        }
+    else
+        {
+        m_exec_conf->msg->notice(3) << "analyze.log_binary: Appending log to existing file \"" << m_filename << "\""
+                                    << endl;
+
+        // read the header and check that it lists the same quantities
+        char magic[sizeof(log_binary_magic)];
+        uint32_t version = 0, n_columns = 0;
+        off_t offset = 0;
+        bool valid = read_at(fd, magic, sizeof(magic), 0)
+                     && memcmp(magic, log_binary_magic, sizeof(magic)) == 0
+                     && read_at(fd, &version, sizeof(version), sizeof(magic))
+                     && version == log_binary_version
+                     && read_at(fd, &n_columns, sizeof(n_columns), sizeof(magic) + sizeof(version));
+        offset = sizeof(magic) + sizeof(version) + sizeof(n_columns);
+
+        if (!valid)
+            {
+            m_exec_conf->msg->error() << "analyze.log_binary: " << m_filename << " is not a binary log file" << endl;
+            ::close(fd);
+            throw runtime_error("Error initializing LogBinary");
+            }
+
+        std::vector<std::string> columns;
+        for (unsigned int i = 0; i < n_columns && valid; i++)
+            {
+            uint32_t len = 0;
+            valid = read_at(fd, &len, sizeof(len), offset) && off_t(offset + sizeof(len) + len) <= st.st_size;
+            offset += sizeof(len);
+            if (valid)
+                {
+                std::string name(len, ' ');
+                valid = len == 0 || read_at(fd, &name[0], len, offset);
+                offset += len;
+                columns.push_back(name);
+                }
+            }
+
+        if (!valid || columns != quantities)
+            {
+            m_exec_conf->msg->error() << "analyze.log_binary: " << m_filename
+                                      << " logs different quantities, use overwrite=True to replace it" << endl;
+            ::close(fd);
+            throw runtime_error("Error initializing LogBinary");
+            }
+
+        // skip over valid blocks
+        while (true)
+            {
+            char block_magic[sizeof(log_binary_block_magic)];
+            uint32_t n_rows = 0, n_rows_end = 0;
+            if (!read_at(fd, block_magic, sizeof(block_magic), offset)
+                || memcmp(block_magic, log_binary_block_magic, sizeof(block_magic)) != 0
+                || !read_at(fd, &n_rows, sizeof(n_rows), offset + sizeof(block_magic)))
+                break;
+
+            off_t size = sizeof(block_magic) + sizeof(n_rows) + off_t(n_rows)*sizeof(uint64_t)
+                         + off_t(n_rows)*n_columns*sizeof(double) + sizeof(n_rows_end);
+            if (offset + size > st.st_size
+                || !read_at(fd, &n_rows_end, sizeof(n_rows_end), offset + size - sizeof(n_rows_end))
+                || n_rows_end != n_rows)
+                break;
+
+            offset += size;
+            }
+
+        if (offset < st.st_size)
+            {
+            m_exec_conf->msg->notice(2) << "analyze.log_binary: Discarding " << st.st_size - offset
+                                        << " bytes of an incomplete block at the end of " << m_filename << endl;
+            if (::ftruncate(fd, offset) != 0)
+                {
+                m_exec_conf->msg->error() << "analyze.log_binary: Error truncating log file " << m_filename << ": "
+                                          << strerror(errno) << endl;
+                ::close(fd);
+                throw runtime_error("Error initializing LogBinary");
+                }
+            }
+        }
+
+    if (::lseek(fd, 0, SEEK_END) < 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: Error opening log file " << m_filename << ": "
+                                  << strerror(errno) << endl;
+        ::close(fd);
+        throw runtime_error("Error initializing LogBinary");
+        }
+
+    m_fd = fd;
+    m_columns = quantities;
+    m_block.timesteps.reserve(m_buffer_rows);
+    m_block.values.reserve(size_t(m_buffer_rows)*m_columns.size());
+    m_last_flush = std::chrono::steady_clock::now();
+    m_io_thread = std::thread(&LogBinary::ioThreadMain, this);
+    }
+
+/*! \param timestep Time step to write out data for
+
+    Appends a row with the logged quantities to the current block. Full blocks are handed to the I/O thread, which
+    waits when two blocks are already queued.
+*/
+void LogBinary::analyze(unsigned int timestep)
+    {
+    //Call the base class to cache all values.
+    Logger::analyze(timestep);
+
+    if (m_prof) m_prof->push("LogBinary");
+
+#ifdef ENABLE_MPI
+    // only output to file on root processor
+    if (m_comm)
+        if (! m_exec_conf->isRoot())
+            {
+            if (m_prof) m_prof->pop();
+            return;
+            }
+#endif
+
+    if (m_fd < 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: No quantities set for logging" << endl;
+        throw runtime_error("Error writing log file");
+        }
+
+    int io_errno = 0;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_block.timesteps.push_back(timestep);
+        m_block.values.insert(m_block.values.end(), m_cached_quantities.begin(), m_cached_quantities.end());
+
+        if (m_block.timesteps.size() >= m_buffer_rows)
+            {
+            m_io_cv.wait(lock, [this] { return m_queue.size() < max_queued_blocks; });
+            queueBlock();
+            }
+
+        io_errno = m_io_errno;
+        m_io_errno = 0;
+        }
+    m_io_cv.notify_all();
+
+    if (m_prof) m_prof->pop();
+
+    checkError(io_errno);
+    }
+
+/*! Hands the collected rows to the I/O thread and waits until they are in the file.
+*/
+void LogBinary::flush()
+    {
+#ifdef ENABLE_MPI
+    // only output to file on root processor
+    if (m_comm)
+        if (! m_exec_conf->isRoot())
+            return;
+#endif
+
+    if (m_fd < 0)
+        return;
+
+    int io_errno = 0;
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        if (m_block.timesteps.size() > 0)
+            {
+            m_io_cv.wait(lock, [this] { return m_queue.size() < max_queued_blocks; });
+            queueBlock();
+            m_io_cv.notify_all();
+            }
+
+        m_io_cv.wait(lock, [this] { return m_queue.empty(); });
+        io_errno = m_io_errno;
+        m_io_errno = 0;
+        }
+
+    checkError(io_errno);
+    }
+
+void LogBinary::queueBlock()
+    {
+    m_queue.push_back(std::move(m_block));
+    m_block = Block();
+    m_block.timesteps.reserve(m_buffer_rows);
+    m_block.values.reserve(size_t(m_buffer_rows)*m_columns.size());
+    m_last_flush = std::chrono::steady_clock::now();
+    }
+
+/*! The I/O thread writes queued blocks in order. When no block has been queued for the flush interval, it queues the
+    partially filled block itself so that rows reach the file even when the log period is long.
+*/
+void LogBinary::ioThreadMain()
+    {
+    std::vector<char> buffer;
+    std::unique_lock<std::mutex> lock(m_io_mutex);
+
+    while (true)
+        {
+        if (m_queue.empty() && !m_io_stop)
+            {
+            auto ready = [this] { return m_io_stop || !m_queue.empty(); };
+            if (m_flush_interval.count() > 0)
+                {
+                if (!m_io_cv.wait_until(lock, m_last_flush + m_flush_interval, ready))
+                    {
+                    if (m_block.timesteps.size() > 0)
+                        queueBlock();
+                    else
+                        m_last_flush = std::chrono::steady_clock::now();
+                    }
+                }
+            else
+                {
+                m_io_cv.wait(lock, ready);
+                }
+            }
+
+        if (m_queue.empty())
+            {
+            if (!m_io_stop)
+                continue;
+
+            // write the remaining rows before exiting
+            if (m_block.timesteps.size() == 0)
+                break;
+            queueBlock();
+            }
+
+        // the block stays at the front of the queue while it is written
+        const Block& block = m_queue.front();
+        lock.unlock();
+        int err = writeBlock(block, buffer);
+        lock.lock();
+
+        if (err && !m_io_errno)
+            m_io_errno = err;
+        m_queue.pop_front();
+        m_io_cv.notify_all();
+        }
+    }
+
+/*! \param block Block to write
+    \param buffer Scratch space to encode the block in
+
+    \returns 0 on success, errno on failure
+*/
+int LogBinary::writeBlock(const Block& block, std::vector<char>& buffer)
+    {
+    uint32_t n_rows = block.timesteps.size();
+    unsigned int n_columns = m_columns.size();
+
+    buffer.clear();
+    buffer.insert(buffer.end(), log_binary_block_magic, log_binary_block_magic + sizeof(log_binary_block_magic));
+    append_value(buffer, n_rows);
+    for (unsigned int i = 0; i < n_rows; i++)
+        append_value(buffer, block.timesteps[i]);
+
+    // store the values column by column
+    for (unsigned int j = 0; j < n_columns; j++)
+        for (unsigned int i = 0; i < n_rows; i++)
+            append_value(buffer, block.values[size_t(i)*n_columns + j]);
+
+    append_value(buffer, n_rows);
+
+    int err = write_all(m_fd, &buffer[0], buffer.size());
+    if (err == 0 && ::fsync(m_fd) != 0)
+        err = errno;
+    return err;
+    }
+
+void LogBinary::checkError(int io_errno)
+    {
+    if (io_errno)
+        {
+        m_exec_conf->msg->error() << "analyze.log_binary: I/O error while writing " << m_filename << ": "
+                                  << strerror(io_errno) << endl;
+        throw runtime_error("Error writing log file");
+        }
+    }
+
+void LogBinary::stopIOThread()
+    {
+    if (!m_io_thread.joinable())
+        return;
+
+        {
+        std::unique_lock<std::mutex> lock(m_io_mutex);
+        m_io_stop = true;
+        }
+    m_io_cv.notify_all();
+    m_io_thread.join();
+    }
+
+void export_LogBinary(py::module& m)
+    {
+    py::class_<LogBinary, std::shared_ptr<LogBinary> >(m,"LogBinary", py::base<Logger>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, bool, unsigned int, double >())
+    .def("flush", &LogBinary::flush)
+    ;
+    }
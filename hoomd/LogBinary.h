@@ -0,0 +1,117 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file LogBinary.h
+    \brief Declares the LogBinary class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "Logger.h"
+
+#include <stdint.h>
+#include <chrono>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#ifndef __LOGBINARY_H__
+#define __LOGBINARY_H__
+
+//! Logs registered quantities to a columnar binary file
+/*! LogBinary computes the logged quantities like Logger, and writes them as float64 values without formatting them
+    as text. Rows are collected in memory and written in blocks by a background I/O thread, either when
+    \a buffer_rows rows have been collected or when \a flush_interval seconds have passed since the last block was
+    handed to the thread. At most two blocks are in flight. Errors of the I/O thread are raised by the next call to
+    analyze() or flush().
+
+    File format (native byte order, little endian on all supported platforms):
+     - Header: the 8 byte magic "HOOMDLOG", a uint32 version, a uint32 number of columns M, and for each column a
+       uint32 length followed by the name of the logged quantity (without a terminating null).
+     - Any number of blocks: the 4 byte magic "HLBK", a uint32 number of rows n, n uint64 time steps, M columns of n
+       float64 values each, and n again as a uint32.
+
+    The file is only appended to, and every block is synced to disk after it is written. A block is valid when it
+    is complete and both row counts agree, so a reader can ignore a block that was cut short by a crash. When
+    appending to an existing file, LogBinary checks that the file logs the same quantities and truncates it after
+    the last valid block.
+
+    Only the root rank writes the file. The logged quantities cannot change once the file is open.
+
+    \ingroup analyzers
+*/
+class LogBinary : public Logger
+    {
+    public:
+        //! Constructs a logger
+        LogBinary(std::shared_ptr<SystemDefinition> sysdef,
+                  const std::string& fname,
+                  bool overwrite=false,
+                  unsigned int buffer_rows=1024,
+                  double flush_interval=10.0);
+
+        //! Destructor
+        ~LogBinary();
+
+        //! Selects which quantities to log
+        virtual void setLoggedQuantities(const std::vector< std::string >& quantities);
+
+        //! Write out the data for the current timestep
+        void analyze(unsigned int timestep);
+
+        //! Write all collected rows to the file
+        void flush();
+
+    private:
+        //! Rows of the log, in the order they were collected
+        struct Block
+            {
+            std::vector<uint64_t> timesteps;    //!< Time step of each row
+            std::vector<double> values;         //!< Values of the logged quantities, row by row
+            };
+
+        std::string m_filename;             //!< The output file name
+        bool m_overwrite;                   //!< True if an existing file should be overwritten
+        unsigned int m_buffer_rows;         //!< Number of rows in a full block
+        std::chrono::steady_clock::duration m_flush_interval;   //!< Maximum time between writes (0 to disable)
+        int m_fd;                           //!< File descriptor of the log (-1 when not open)
+        std::vector<std::string> m_columns; //!< Quantities in the file
+
+        Block m_block;                      //!< Rows collected since the last block was queued
+        std::chrono::steady_clock::time_point m_last_flush;    //!< Time when the last block was queued
+        std::deque<Block> m_queue;          //!< Blocks handed to the I/O thread and not yet written (front is in progress)
+        std::thread m_io_thread;            //!< The I/O thread
+        std::mutex m_io_mutex;              //!< Protects the current block, the queue and the I/O thread state
+        std::condition_variable m_io_cv;    //!< Signals changes of the queue
+        bool m_io_stop;                     //!< True when the I/O thread should exit
+        int m_io_errno;                     //!< errno of the first failed write in the I/O thread (0 if none)
+
+        //! Maximum number of blocks handed to the I/O thread
+        static const unsigned int max_queued_blocks = 2;
+
+        //! Open the file and write or check its header
+        void openFile(const std::vector< std::string >& quantities);
+
+        //! Hand the current block to the I/O thread (the caller must hold m_io_mutex)
+        void queueBlock();
+
+        //! Main loop of the I/O thread
+        void ioThreadMain();
+
+        //! Write a block to the file
+        int writeBlock(const Block& block, std::vector<char>& buffer);
+
+        //! Raise the error of a failed write in the I/O thread
+        void checkError(int io_errno);
+
+        //! Stop the I/O thread
+        void stopIOThread();
+    };
+
+//! exports the LogBinary class to python
+void export_LogBinary(pybind11::module& m);
+
+#endif
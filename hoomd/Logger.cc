@@ -191,10 +191,23 @@ Scalar Logger::getValue(const std::string &quantity, int timestep)
     // check to see if the quantity exists in the compute list
     else if (m_compute_quantities.count(quantity))
         {
+        std::shared_ptr<Compute> compute = m_compute_quantities[quantity];
+
+        // reuse the value if another logger already obtained it at this time step, unless the compute would
+        // compute again
+        Scalar value;
+        if (m_log_cache && ! compute->peekCompute(timestep)
+            && m_log_cache->find(compute.get(), quantity, timestep, value))
+            return value;
+
         // update the compute
-        m_compute_quantities[quantity]->compute(timestep);
+        compute->compute(timestep);
         // get the log value
-        return m_compute_quantities[quantity]->getLogValue(quantity, timestep);
+        value = compute->getLogValue(quantity, timestep);
+
+        if (m_log_cache)
+            m_log_cache->insert(compute.get(), quantity, timestep, value);
+        return value;
         }
     // check to see if the quantity exists in the updaters list
     else if (m_updater_quantities.count(quantity))
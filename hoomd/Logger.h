@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <utility>
 #include <fstream>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #include <memory>
@@ -27,6 +28,82 @@
 #ifndef __LOGGER_H__
 #define __LOGGER_H__
 
+//! Values of logged compute quantities at the current time step, shared by all loggers of a System
+/*! Every Logger that obtains a quantity from a Compute stores the value here, keyed by the compute and the name
+    of the quantity. Other loggers (and query() calls from python callbacks) that ask for the same quantity at the
+    same time step reuse the value, so reductions like ForceCompute::calcEnergySum() and their MPI collectives run
+    once per step instead of once per consumer.
+
+    Values are only valid for the time step they were stored at, which matches the way Compute::compute() skips
+    repeated calls at the same time step. Storing a value at a new time step discards all others. The cache is
+    cleared when the particles are sorted or initialized from a snapshot (both emit the particle sort signal), which
+    makes ForceCompute recompute at the same time step, and System clears it at the start of every run(), because
+    the state may be changed between runs. Logger also bypasses it for a Compute that would compute again
+    (Compute::peekCompute()).
+
+    All ranks log the same quantities in the same order, so cache hits are the same on all ranks.
+*/
+class LogQuantityCache
+    {
+    public:
+        //! Constructs an empty cache
+        /*! \param pdata Particle data whose sort signal invalidates the cache
+        */
+        LogQuantityCache(std::shared_ptr<ParticleData> pdata)
+            : m_pdata(pdata), m_timestep(0)
+            {
+            m_pdata->getParticleSortSignal().connect<LogQuantityCache, &LogQuantityCache::clear>(this);
+            }
+
+        //! Destructor
+        ~LogQuantityCache()
+            {
+            m_pdata->getParticleSortSignal().disconnect<LogQuantityCache, &LogQuantityCache::clear>(this);
+            }
+
+        //! Look up a value
+        /*! \param compute Compute providing the quantity
+            \param quantity Name of the quantity
+            \param timestep Current time step
+            \param value Set to the cached value
+            \returns true if a value was stored for \a compute and \a quantity at \a timestep
+        */
+        bool find(const Compute *compute, const std::string& quantity, unsigned int timestep, Scalar& value) const
+            {
+            if (m_values.empty() || timestep != m_timestep)
+                return false;
+
+            auto it = m_values.find(std::make_pair(compute, quantity));
+            if (it == m_values.end())
+                return false;
+
+            value = it->second;
+            return true;
+            }
+
+        //! Store a value
+        void insert(const Compute *compute, const std::string& quantity, unsigned int timestep, Scalar value)
+            {
+            if (timestep != m_timestep)
+                {
+                m_values.clear();
+                m_timestep = timestep;
+                }
+            m_values[std::make_pair(compute, quantity)] = value;
+            }
+
+        //! Discard all values
+        void clear()
+            {
+            m_values.clear();
+            }
+
+    private:
+        std::shared_ptr<ParticleData> m_pdata;  //!< Particle data the cache is connected to
+        unsigned int m_timestep;    //!< Time step of the stored values
+        std::map< std::pair<const Compute *, std::string>, Scalar > m_values;  //!< Values by compute and quantity
+    };
+
 //! Logs registered quantities and offers an interface for other classes to obtain these values.
 /*! \note design notes: Computes and Updaters have getProvidedLogQuantities and getLogValue. The first lists
     all quantities that the compute/updater provides (a list of strings). And getLogValue takes a string
@@ -72,6 +149,14 @@ class __attribute__((visibility("default"))) Logger : public Analyzer
         //! Returns the currently logged quantities
         std::vector<std::string> getLoggedQuantities(void)const{return m_logged_quantities;}
 
+        //! Share computed values with other loggers
+        /*! \param cache Cache of compute quantities at the current time step (may be null)
+        */
+        void setLogCache(std::shared_ptr<LogQuantityCache> cache)
+            {
+            m_log_cache = cache;
+            }
+
         //! Query the current value for a given quantity
         virtual Scalar getQuantity(const std::string& quantity, unsigned int timestep, bool use_cache);
 
@@ -106,6 +191,8 @@ class __attribute__((visibility("default"))) Logger : public Analyzer
         unsigned int m_cached_timestep;
         //! The values of the logged quantities at the last logger update.
         std::vector< Scalar > m_cached_quantities;
+        //! Values of compute quantities shared with other loggers
+        std::shared_ptr<LogQuantityCache> m_log_cache;
 
     private:
         //! Helper function to get a value for a given quantity
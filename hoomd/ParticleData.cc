@@ -61,6 +61,7 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
           m_max_nparticles(0),
           m_nglobal(0),
           m_accel_set(false),
+          m_sparse_rtag(false),
           m_resize_factor(9./8.),
           m_arrays_allocated(false)
     {
@@ -137,12 +138,14 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
  * \param global_box The dimensions of the global simulation box
  * \param exec_conf The execution configuration
  * \param decomposition (optional) Domain decomposition layout
+ * \param sparse_rtags (optional) True if the reverse-lookup tags are stored in a hash map from the start
  */
 template <class Real>
 ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
                            const BoxDim& global_box,
                            std::shared_ptr<ExecutionConfiguration> exec_conf,
-                           std::shared_ptr<DomainDecomposition> decomposition
+                           std::shared_ptr<DomainDecomposition> decomposition,
+                           bool sparse_rtags
                           )
     : m_exec_conf(exec_conf),
       m_nparticles(0),
@@ -150,6 +153,7 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
       m_max_nparticles(0),
       m_nglobal(0),
       m_accel_set(false),
+      m_sparse_rtag(sparse_rtags),
       m_resize_factor(9./8.),
       m_arrays_allocated(false)
     {
@@ -178,7 +182,13 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
         }
     #endif
 
-    // initialize rtag array
+    if (m_sparse_rtag && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Sparse reverse-lookup tags are not supported on the GPU" << endl;
+        throw runtime_error("Error initializing ParticleData");
+        }
+
+    // initialize rtag array, it stays empty with sparse reverse-lookup tags
     GlobalVector<unsigned int>(exec_conf).swap(m_rtag);
     TAG_ALLOCATION(m_rtag);
 
@@ -785,7 +795,7 @@ template <class Real>
 bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     {
     bool in_box = true;
-    if (m_exec_conf->getRank() == 0)
+    if (m_exec_conf->getRank() == 0 || snap.is_distributed)
         {
         Scalar3 lo = m_global_box.getLo();
         Scalar3 hi = m_global_box.getHi();
@@ -811,12 +821,39 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        bcast(in_box, 0, m_exec_conf->getMPICommunicator());
+        if (snap.is_distributed)
+            {
+            // every rank checks its own part of the snapshot
+            int all_in_box = in_box;
+            MPI_Allreduce(MPI_IN_PLACE, &all_in_box, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+            in_box = all_in_box;
+            }
+        else
+            bcast(in_box, 0, m_exec_conf->getMPICommunicator());
         }
     #endif
     return in_box;
     }
 
+#ifdef ENABLE_MPI
+//! Send per-rank particle data to every rank and concatenate the received data
+/*! \param in_values Values to send, in_values[i] is sent to rank i
+    \param out_values Values received from all ranks, in rank order
+    \param mpi_comm The MPI communicator
+ */
+template<typename T>
+static void exchange_particle_field(const std::vector< std::vector<T> >& in_values, std::vector<T>& out_values,
+    const MPI_Comm mpi_comm)
+    {
+    std::vector< std::vector<T> > recv_values;
+    all_to_all_v(in_values, recv_values, mpi_comm);
+
+    out_values.clear();
+    for (unsigned int i = 0; i < recv_values.size(); i++)
+        out_values.insert(out_values.end(), recv_values[i].begin(), recv_values[i].end());
+    }
+#endif
+
 //! Initialize from a snapshot
 /*! \param snapshot the initial particle data
     \param ignore_bodies If True, ignore particles that have a body flag set
@@ -824,6 +861,9 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     \post the particle data arrays are initialized from the snapshot, in index order
 
     \pre In parallel simulations, the local box size must be set before a call to initializeFromSnapshot().
+
+    When the snapshot is distributed (SnapshotParticleData::is_distributed), every rank places the particles it
+    holds and sends them directly to their domains, so that the full snapshot is never held by a single rank.
  */
 template <class Real>
 void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snapshot, bool ignore_bodies)
@@ -834,7 +874,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     removeAllGhostParticles();
 
     // check that all fields in the snapshot have correct length
-    if (m_exec_conf->getRank() == 0 && ! snapshot.validate())
+    if ((m_exec_conf->getRank() == 0 || snapshot.is_distributed) && ! snapshot.validate())
         {
         m_exec_conf->msg->error() << "init.*: invalid particle data snapshot."
                                 << std::endl << std::endl;
@@ -894,7 +934,10 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         tag_proc.resize(size);
         N_proc.resize(size,0);
 
-        if (my_rank == 0)
+        // number of particles initialized from the local part of a distributed snapshot
+        unsigned int n_local_snap = 0;
+
+        if (my_rank == 0 || snapshot.is_distributed)
             {
             ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
 
@@ -910,6 +953,20 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
 
             BoxDim global_box = m_global_box;
 
+            if (snapshot.is_distributed)
+                {
+                // the particles on this rank are tagged after those of all lower ranks
+                for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
+                    {
+                    if (! (ignore_bodies && snapshot.body[snap_idx] < MIN_FLOPPY))
+                        n_local_snap++;
+                    }
+
+                MPI_Exscan(&n_local_snap, &nglobal, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+                if (my_rank == 0)
+                    nglobal = 0;
+                }
+
             // loop over particles in snapshot, place them into domains
             for (typename std::vector< vec3<Real> >::const_iterator it=snapshot.pos.begin(); it != snapshot.pos.end(); it++)
                 {
@@ -962,7 +1019,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
 
                 if (rank >= n_ranks)
                     {
-                    m_exec_conf->msg->error() << "init.*: Particle " << snap_idx << " out of bounds." << std::endl;
+                    m_exec_conf->msg->error() << "init.*: Particle " << (snapshot.is_distributed ? nglobal : snap_idx)
+                        << " out of bounds." << std::endl;
                     m_exec_conf->msg->error() << "Cartesian coordinates: " << std::endl;
                     m_exec_conf->msg->error() << "x: " << pos.x << " y: " << pos.y << " z: " << pos.z << std::endl;
                     m_exec_conf->msg->error() << "Fractional coordinates: " << std::endl;
@@ -1005,11 +1063,15 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         // broadcast type mapping
         bcast(m_type_mapping, root, mpi_comm);
 
-        // broadcast global number of particles
-        bcast(nglobal, root, mpi_comm);
+        // determine global number of particles
+        if (snapshot.is_distributed)
+            MPI_Allreduce(&n_local_snap, &nglobal, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+        else
+            bcast(nglobal, root, mpi_comm);
 
         // resize array for reverse-lookup tags
-        m_rtag.resize(nglobal);
+        if (! m_sparse_rtag)
+            m_rtag.resize(nglobal);
 
         // Local particle data
         std::vector<Scalar3> pos;
@@ -1026,25 +1088,54 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         std::vector<Scalar3> inertia;
         std::vector<unsigned int> tag;
 
-        // distribute particle data
-        scatter_v(pos_proc,pos,root, mpi_comm);
-        scatter_v(vel_proc,vel,root, mpi_comm);
-        scatter_v(accel_proc, accel, root, mpi_comm);
-        scatter_v(type_proc, type, root, mpi_comm);
-        scatter_v(mass_proc, mass, root, mpi_comm);
-        scatter_v(charge_proc, charge, root, mpi_comm);
-        scatter_v(diameter_proc, diameter, root, mpi_comm);
-        scatter_v(image_proc, image, root, mpi_comm);
-        scatter_v(body_proc, body, root, mpi_comm);
-        scatter_v(orientation_proc, orientation, root, mpi_comm);
-        scatter_v(angmom_proc, angmom, root, mpi_comm);
-        scatter_v(inertia_proc, inertia, root, mpi_comm);
-        scatter_v(tag_proc, tag, root, mpi_comm);
-
-        // distribute number of particles
-        scatter_v(N_proc, m_nparticles, root, mpi_comm);
+        if (snapshot.is_distributed)
+            {
+            // every rank sends its particles directly to their domains
+            exchange_particle_field(pos_proc, pos, mpi_comm);
+            exchange_particle_field(vel_proc, vel, mpi_comm);
+            exchange_particle_field(accel_proc, accel, mpi_comm);
+            exchange_particle_field(type_proc, type, mpi_comm);
+            exchange_particle_field(mass_proc, mass, mpi_comm);
+            exchange_particle_field(charge_proc, charge, mpi_comm);
+            exchange_particle_field(diameter_proc, diameter, mpi_comm);
+            exchange_particle_field(image_proc, image, mpi_comm);
+            exchange_particle_field(body_proc, body, mpi_comm);
+            exchange_particle_field(orientation_proc, orientation, mpi_comm);
+            exchange_particle_field(angmom_proc, angmom, mpi_comm);
+            exchange_particle_field(inertia_proc, inertia, mpi_comm);
+            exchange_particle_field(tag_proc, tag, mpi_comm);
+
+            m_nparticles = tag.size();
+            }
+        else
+            {
+            // distribute particle data
+            scatter_v(pos_proc,pos,root, mpi_comm);
+            scatter_v(vel_proc,vel,root, mpi_comm);
+            scatter_v(accel_proc, accel, root, mpi_comm);
+            scatter_v(type_proc, type, root, mpi_comm);
+            scatter_v(mass_proc, mass, root, mpi_comm);
+            scatter_v(charge_proc, charge, root, mpi_comm);
+            scatter_v(diameter_proc, diameter, root, mpi_comm);
+            scatter_v(image_proc, image, root, mpi_comm);
+            scatter_v(body_proc, body, root, mpi_comm);
+            scatter_v(orientation_proc, orientation, root, mpi_comm);
+            scatter_v(angmom_proc, angmom, root, mpi_comm);
+            scatter_v(inertia_proc, inertia, root, mpi_comm);
+            scatter_v(tag_proc, tag, root, mpi_comm);
+
+            // distribute number of particles
+            scatter_v(N_proc, m_nparticles, root, mpi_comm);
+            }
 
 
+        if (m_sparse_rtag)
+            {
+            // the sparse map only holds the new local particles, this also removes 'leftover' ghosts
+            m_rtag_map.clear();
+            m_rtag_map.reserve(m_nparticles);
+            }
+        else
             {
             // reset all reverse lookup tags to NOT_LOCAL flag
             ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::overwrite);
@@ -1055,10 +1146,13 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 h_rtag.data[tag] = NOT_LOCAL;
             }
 
-        // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
+        // update list of active tags (sparse reverse-lookup tags are always contiguous)
+        if (! m_sparse_rtag)
             {
-            m_tag_set.insert(tag);
+            for (unsigned int tag = 0; tag < nglobal; tag++)
+                {
+                m_tag_set.insert(tag);
+                }
             }
 
         // Now that active tag list has changed, invalidate the cache
@@ -1080,7 +1174,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
-        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(*this, access_mode::readwrite);
 
         for (unsigned int idx = 0; idx < m_nparticles; idx++)
             {
@@ -1091,7 +1185,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_diameter.data[idx] = diameter[idx];
             h_image.data[idx] = image[idx];
             h_tag.data[idx] = tag[idx];
-            h_rtag.data[tag[idx]] = idx;
+            h_rtag.set(tag[idx], idx);
             h_body.data[idx] = body[idx];
             h_orientation.data[idx] = orientation[idx];
             h_angmom.data[idx] = angmom[idx];
@@ -1111,7 +1205,13 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             }
 
         // allocate array for reverse lookup tags
-        m_rtag.resize(snapshot.size);
+        if (m_sparse_rtag)
+            {
+            m_rtag_map.clear();
+            m_rtag_map.reserve(snapshot.size);
+            }
+        else
+            m_rtag.resize(snapshot.size);
 
         // Now that active tag list has changed, invalidate the cache
         m_invalid_cached_tags = true;
@@ -1130,7 +1230,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
-        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(*this, access_mode::readwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
             {
@@ -1153,7 +1253,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_diameter.data[nglobal] = snapshot.diameter[snap_idx];
             h_image.data[nglobal] = snapshot.image[snap_idx];
             h_tag.data[nglobal] = nglobal;
-            h_rtag.data[nglobal] = nglobal;
+            h_rtag.set(nglobal, nglobal);
             h_body.data[nglobal] = snapshot.body[snap_idx];
             h_orientation.data[nglobal] = quat_to_scalar4(snapshot.orientation[snap_idx]);
             h_angmom.data[nglobal] = quat_to_scalar4(snapshot.angmom[snap_idx]);
@@ -1163,14 +1263,17 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
 
         m_nparticles = nglobal;
 
-        // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
+        // update list of active tags (sparse reverse-lookup tags are always contiguous)
+        if (! m_sparse_rtag)
             {
-            m_tag_set.insert(tag);
-            }
+            for (unsigned int tag = 0; tag < nglobal; tag++)
+                {
+                m_tag_set.insert(tag);
+                }
 
-        // rtag size reflects actual number of tags
-        m_rtag.resize(nglobal);
+            // rtag size reflects actual number of tags
+            m_rtag.resize(nglobal);
+            }
 
         // initialize type mapping
         m_type_mapping = snapshot.type_mapping;
@@ -1218,7 +1321,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
     ArrayHandle< Scalar4 >  h_angmom(m_angmom, access_location::host, access_mode::read);
     ArrayHandle< Scalar3 >  h_inertia(m_inertia, access_location::host, access_mode::read);
     ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::read);
-    ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::read);
+    RTagHandle h_rtag(*this, access_mode::read);
 
 #ifdef ENABLE_MPI
     if (m_decomposition)
@@ -1330,13 +1433,14 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
                         it->first, std::pair<unsigned int, unsigned int>(irank, it->second)));
 
             // add particles to snapshot
-            assert(m_tag_set.size() == getNGlobal());
+            assert(m_sparse_rtag || m_tag_set.size() == getNGlobal());
             std::set<unsigned int>::const_iterator tag_set_it = m_tag_set.begin();
 
             std::map<unsigned int, std::pair<unsigned int, unsigned int> >::iterator rank_rtag_it;
             for (unsigned int snap_id = 0; snap_id < getNGlobal(); snap_id++)
                 {
-                unsigned int tag = *tag_set_it;
+                // sparse reverse-lookup tags are contiguous
+                unsigned int tag = m_sparse_rtag ? snap_id : *tag_set_it;
                 assert(tag <= getMaximumTag());
                 rank_rtag_it = rank_rtag_map.find(tag);
 
@@ -1374,7 +1478,8 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
                 m_global_box.wrap(tmp, snapshot.image[snap_id]);
                 snapshot.pos[snap_id] = vec3<Real>(tmp);
 
-                std::advance(tag_set_it, 1);
+                if (! m_sparse_rtag)
+                    std::advance(tag_set_it, 1);
                 }
             }
         }
@@ -1384,15 +1489,15 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         // allocate memory in snapshot
         snapshot.resize(getNGlobal());
 
-        assert(m_tag_set.size() == m_nparticles);
+        assert(m_sparse_rtag || m_tag_set.size() == m_nparticles);
         std::set<unsigned int>::const_iterator it = m_tag_set.begin();
 
         // iterate through active tags
         for (unsigned int snap_id = 0; snap_id < m_nparticles; snap_id++)
             {
-            unsigned int tag = *it;
+            unsigned int tag = m_sparse_rtag ? snap_id : *it;
             assert(tag <= getMaximumTag());
-            unsigned int idx = h_rtag.data[tag];
+            unsigned int idx = h_rtag[tag];
             assert(idx < m_nparticles);
 
             // store tag in index map
@@ -1419,7 +1524,8 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
             m_global_box.wrap(tmp, snapshot.image[snap_id]);
             snapshot.pos[snap_id] = vec3<Real>(tmp);
 
-            std::advance(it, 1);
+            if (! m_sparse_rtag)
+                std::advance(it, 1);
             }
         }
 
@@ -2207,6 +2313,12 @@ void ParticleData::setMomentsOfInertia(unsigned int tag, const Scalar3& inertia)
  */
 unsigned int ParticleData::addParticle(unsigned int type)
     {
+    if (m_sparse_rtag)
+        {
+        m_exec_conf->msg->error() << "Cannot add particles with sparse reverse-lookup tags (--sparse-rtags)" << endl;
+        throw runtime_error("Error adding particle");
+        }
+
     // we are changing the local number of particles, so remove ghosts
     removeAllGhostParticles();
 
@@ -2311,6 +2423,12 @@ void ParticleData::removeParticle(unsigned int tag)
         throw runtime_error("Error removing particle");
         }
 
+    if (m_sparse_rtag)
+        {
+        m_exec_conf->msg->error() << "Cannot remove particles with sparse reverse-lookup tags (--sparse-rtags)" << endl;
+        throw runtime_error("Error removing particle");
+        }
+
     // we are changing the local number of particles, so remove ghosts
     removeAllGhostParticles();
 
@@ -2424,6 +2542,10 @@ unsigned int ParticleData::getNthTag(unsigned int n)
         throw std::runtime_error("Error fetching particle");
         }
 
+    // sparse reverse-lookup tags are contiguous
+    if (m_sparse_rtag)
+        return n;
+
     assert(m_tag_set.size() == getNGlobal());
 
     // maybe_rebuild_tag_cache only rebuilds if necessary
@@ -2431,6 +2553,71 @@ unsigned int ParticleData::getNthTag(unsigned int n)
     return m_cached_tag_set[n];
     }
 
+/*! \param sparse True if the reverse-lookup tags should be stored in a hash map
+
+    With sparse reverse-lookup tags, the dense reverse-lookup array and the set of active tags, which both have one
+    element per global particle, are released. Every rank then only stores the tags of its local and ghost particles.
+    This requires the particle tags to be contiguous, and particles can no longer be added or removed.
+*/
+void ParticleData::setSparseRTags(bool sparse)
+    {
+    if (sparse == m_sparse_rtag)
+        return;
+
+    const unsigned int n_known = getN() + getNGhosts();
+
+    if (sparse)
+        {
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            m_exec_conf->msg->error() << "Sparse reverse-lookup tags are not supported on the GPU" << endl;
+            throw runtime_error("Error setting up reverse-lookup tags");
+            }
+
+        if (getNGlobal() && getMaximumTag() != getNGlobal()-1)
+            {
+            m_exec_conf->msg->error() << "Sparse reverse-lookup tags require contiguous particle tags" << endl;
+            throw runtime_error("Error setting up reverse-lookup tags");
+            }
+
+        m_rtag_map.clear();
+        m_rtag_map.reserve(n_known);
+
+            {
+            ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
+            for (unsigned int idx = 0; idx < n_known; ++idx)
+                m_rtag_map.set(h_tag.data[idx], idx);
+            }
+
+        // release the per-tag arrays
+        GlobalVector<unsigned int>(m_exec_conf).swap(m_rtag);
+        TAG_ALLOCATION(m_rtag);
+        m_tag_set.clear();
+        std::vector<unsigned int>().swap(m_cached_tag_set);
+        m_invalid_cached_tags = true;
+        }
+    else
+        {
+        m_rtag.resize(getNGlobal());
+
+            {
+            ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
+            std::fill(h_rtag.data, h_rtag.data + getNGlobal(), NOT_LOCAL);
+            for (unsigned int idx = 0; idx < n_known; ++idx)
+                h_rtag.data[h_tag.data[idx]] = idx;
+            }
+
+        for (unsigned int tag = 0; tag < getNGlobal(); ++tag)
+            m_tag_set.insert(tag);
+        m_invalid_cached_tags = true;
+
+        m_rtag_map.clear();
+        }
+
+    m_sparse_rtag = sparse;
+    }
+
 void export_BoxDim(py::module& m)
     {
     void (BoxDim::*wrap_overload)(Scalar3&, int3&, char3) const = &BoxDim::wrap;
@@ -2478,7 +2665,8 @@ string print_ParticleData(ParticleData *pdata)
 template ParticleData::ParticleData(const SnapshotParticleData<double>& snapshot,
                                            const BoxDim& global_box,
                                            std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                           std::shared_ptr<DomainDecomposition> decomposition
+                                           std::shared_ptr<DomainDecomposition> decomposition,
+                                           bool sparse_rtags
                                           );
 template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot, bool ignore_bodies);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
@@ -2487,7 +2675,8 @@ template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>
 template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                            const BoxDim& global_box,
                                            std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                           std::shared_ptr<DomainDecomposition> decomposition
+                                           std::shared_ptr<DomainDecomposition> decomposition,
+                                           bool sparse_rtags
                                           );
 template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
@@ -2542,6 +2731,8 @@ void export_ParticleData(py::module& m)
     .def("addParticle", &ParticleData::addParticle)
     .def("removeParticle", &ParticleData::removeParticle)
     .def("getNthTag", &ParticleData::getNthTag)
+    .def("setSparseRTags", &ParticleData::setSparseRTags)
+    .def("getSparseRTags", &ParticleData::getSparseRTags)
 #ifdef ENABLE_MPI
     .def("setDomainDecomposition", &ParticleData::setDomainDecomposition)
     .def("getDomainDecomposition", &ParticleData::getDomainDecomposition)
@@ -2553,7 +2744,7 @@ void export_ParticleData(py::module& m)
 //! Constructor for SnapshotParticleData
 template <class Real>
 SnapshotParticleData<Real>::SnapshotParticleData(unsigned int N)
-       : size(N), is_accel_set(false)
+       : size(N), is_accel_set(false), is_distributed(false)
     {
     resize(N);
     }
@@ -2636,7 +2827,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         {
         // access particle data tags and rtags
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(getCommFlags(), access_location::host, access_mode::read);
 
         // set all rtags of ptls with comm_flag != 0 to NOT_LOCAL and count removed particles
@@ -2646,7 +2837,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 {
                 unsigned int tag = h_tag.data[i];
                 assert(tag <= getMaximumTag());
-                h_rtag.data[tag] = NOT_LOCAL;
+                h_rtag.set(tag, NOT_LOCAL);
                 num_remove_ptls++;
                 }
         }
@@ -2679,7 +2870,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
 
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*this, access_mode::read);
 
         ArrayHandle<unsigned int> h_comm_flags(getCommFlags(), access_location::host, access_mode::readwrite);
 
@@ -2704,7 +2895,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         for (unsigned int i = 0; i < old_nparticles; ++i)
             {
             unsigned int tag = h_tag.data[i];
-            if (h_rtag.data[tag] != NOT_LOCAL)
+            if (h_rtag[tag] != NOT_LOCAL)
                 {
                 // copy over to alternate pdata arrays
                 h_pos_alt.data[n] = h_pos.data[i];
@@ -2772,7 +2963,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
     swapTags();
 
         {
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
 
         // recompute rtags (particles have moved)
@@ -2781,7 +2972,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
             // reset rtag of this ptl
             unsigned int tag = h_tag.data[idx];
             assert(tag <= getMaximumTag());
-            h_rtag.data[tag] = idx;
+            h_rtag.set(tag, idx);
             }
         }
 
@@ -2820,7 +3011,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
         ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
         unsigned int net_virial_pitch = m_net_virial.getPitch();
@@ -2856,7 +3047,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
             // reset rtag of this ptl
             unsigned int tag = h_tag.data[idx];
             assert(tag <= getMaximumTag());
-            h_rtag.data[tag] = idx;
+            h_rtag.set(tag, idx);
             }
         }
 
@@ -42,6 +42,7 @@
 #endif
 
 #include "DomainDecomposition.h"
+#include "RTagMap.h"
 
 #include <stdlib.h>
 #include <vector>
@@ -151,7 +152,7 @@ template <class Real>
 struct PYBIND11_EXPORT SnapshotParticleData {
     //! Empty snapshot
     SnapshotParticleData()
-        : size(0), is_accel_set(false)
+        : size(0), is_accel_set(false), is_distributed(false)
         {
         }
 
@@ -238,6 +239,13 @@ struct PYBIND11_EXPORT SnapshotParticleData {
     std::vector<std::string> type_mapping;     //!< Mapping between particle type ids and names
 
     bool is_accel_set;                         //!< Flag indicating if accel is set
+
+    //! Flag indicating that every rank holds a part of the particles
+    /*! In a distributed snapshot, the particles are divided between the ranks in rank order, such that the global
+        index of a particle is its local index plus the number of particles on all lower ranks. The type mapping
+        is present on all ranks.
+     */
+    bool is_distributed;
     };
 
 //! Structure to store packed particle data
@@ -291,6 +299,13 @@ struct pdata_element
 
     In a parallel simulation, the global tag is unique among all processors.
 
+    The reverse-lookup array has one element per global tag on every rank. For very large parallel simulations,
+    sparse reverse-lookup tags replace it with a hash map (RTagMap) that only holds the local and ghost particles, so
+    that the memory per rank scales with the size of the domain. They are selected when constructing from a snapshot,
+    so that the dense array is never allocated, or later with setSparseRTags(). In this mode, the tags are always contiguous (0 to N-1),
+    particles cannot be added or removed, and getRTags() is unavailable. Code that looks up particles by tag on the
+    host should use an RTagHandle, which supports both representations.
+
     In order to help other classes deal with particles changing indices, any class that
     changes the order must call notifyParticleSort(). Any class interested in being notified
     can subscribe to the signal by calling connectParticleSort().
@@ -419,7 +434,8 @@ class PYBIND11_EXPORT ParticleData
                      const BoxDim& global_box,
                      std::shared_ptr<ExecutionConfiguration> exec_conf,
                      std::shared_ptr<DomainDecomposition> decomposition
-                        = std::shared_ptr<DomainDecomposition>()
+                        = std::shared_ptr<DomainDecomposition>(),
+                     bool sparse_rtags = false
                      );
 
         //! Destructor
@@ -604,7 +620,49 @@ class PYBIND11_EXPORT ParticleData
         const GlobalArray< unsigned int >& getTags() const { return m_tag; }
 
         //! Return reverse-lookup tags
-        const GlobalVector< unsigned int >& getRTags() const { return m_rtag; }
+        /*! \note The dense reverse-lookup table is not available with sparse reverse-lookup tags. Use RTagHandle
+                   to look up particles independently of the representation.
+        */
+        const GlobalVector< unsigned int >& getRTags() const
+            {
+            if (m_sparse_rtag)
+                {
+                m_exec_conf->msg->error() << "This feature is not supported with sparse reverse-lookup tags (--sparse-rtags)" << std::endl;
+                throw std::runtime_error("Error accessing reverse-lookup tags");
+                }
+            return m_rtag;
+            }
+
+        //! Return the number of elements of arrays indexed by particle tag
+        /*! This is the size of the dense reverse-lookup table, or the (contiguous) number of tags with sparse
+            reverse-lookup tags.
+        */
+        unsigned int getRTagSize() const
+            {
+            return m_sparse_rtag ? m_nglobal : m_rtag.size();
+            }
+
+        //! Return the number of allocated elements of the dense reverse-lookup table
+        /*! This is zero with sparse reverse-lookup tags.
+        */
+        unsigned int getRTagCapacity() const
+            {
+            return m_rtag.getNumElements();
+            }
+
+        //! Return the sparse reverse-lookup map
+        /*! The map is only used with sparse reverse-lookup tags, and contains the local and ghost particles.
+        */
+        RTagMap& getRTagMap() const { return m_rtag_map; }
+
+        //! Enable or disable sparse reverse-lookup tags
+        void setSparseRTags(bool sparse);
+
+        //! Return true if the reverse-lookup tags are stored in a hash map
+        bool getSparseRTags() const
+            {
+            return m_sparse_rtag;
+            }
 
         //! Return body ids
         const GlobalArray< unsigned int >& getBodies() const { return m_body; }
@@ -845,6 +903,9 @@ class PYBIND11_EXPORT ParticleData
         //! Get the current index of a particle with a given global tag
         inline unsigned int getRTag(unsigned int tag) const
             {
+            if (m_sparse_rtag)
+                return m_rtag_map.find(tag);
+
             assert(tag < m_rtag.size());
             ArrayHandle< unsigned int> h_rtag(m_rtag,access_location::host, access_mode::read);
             unsigned int idx = h_rtag.data[tag];
@@ -858,6 +919,9 @@ class PYBIND11_EXPORT ParticleData
         //! Return true if particle is local (= owned by this processor)
         bool isParticleLocal(unsigned int tag) const
              {
+             if (m_sparse_rtag)
+                 return m_rtag_map.find(tag) < getN();
+
              assert(tag < m_rtag.size());
              ArrayHandle< unsigned int> h_rtag(m_rtag,access_location::host, access_mode::read);
              return h_rtag.data[tag] < getN();
@@ -866,6 +930,10 @@ class PYBIND11_EXPORT ParticleData
         //! Return true if the tag is active
         bool isTagActive(unsigned int tag) const
             {
+            // sparse reverse-lookup tags are contiguous
+            if (m_sparse_rtag)
+                return tag < m_nglobal;
+
             std::set<unsigned int>::const_iterator it = m_tag_set.find(tag);
             return it != m_tag_set.end();
             }
@@ -875,6 +943,9 @@ class PYBIND11_EXPORT ParticleData
          */
         unsigned int getMaximumTag() const
             {
+            if (m_sparse_rtag)
+                return m_nglobal ? m_nglobal-1 : UINT_MAX;
+
             if (m_tag_set.empty())
                 return UINT_MAX;
             else
@@ -1141,6 +1212,8 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<int3> m_image;                     //!< particle images
         GlobalArray<unsigned int> m_tag;               //!< particle tags
         GlobalVector<unsigned int> m_rtag;             //!< reverse lookup tags
+        bool m_sparse_rtag;                            //!< True if the reverse lookup tags are stored in m_rtag_map
+        mutable RTagMap m_rtag_map;                    //!< Sparse reverse lookup of local and ghost particles
         GlobalArray<unsigned int> m_body;              //!< rigid body ids
         GlobalArray< Scalar4 > m_orientation;          //!< Orientation quaternion for each particle (ignored if not anisotropic)
         GlobalArray< Scalar4 > m_angmom;               //!< Angular momementum quaternion for each particle
@@ -1225,6 +1298,57 @@ class PYBIND11_EXPORT ParticleData
         void setGPUAdvice();
     };
 
+//! Host access to the reverse-lookup tags of ParticleData
+/*! RTagHandle hides whether ParticleData stores the reverse-lookup tags in the dense array (getRTags()) or in the
+    sparse hash map (getRTagMap()). Like an ArrayHandle, it acquires the dense array on the host for its lifetime.
+
+    \ingroup data_structs
+*/
+class RTagHandle
+    {
+    public:
+        //! Acquire the reverse-lookup tags
+        /*! \param pdata Particle data
+            \param mode Access mode for the dense array
+        */
+        RTagHandle(const ParticleData& pdata, const access_mode::Enum mode)
+            : m_rtag(NULL), m_map(NULL)
+            {
+            if (pdata.getSparseRTags())
+                m_map = &pdata.getRTagMap();
+            else
+                {
+                m_handle.reset(new ArrayHandle<unsigned int>(pdata.getRTags(), access_location::host, mode));
+                m_rtag = m_handle->data;
+                }
+            }
+
+        //! Return the local index of a particle, or NOT_LOCAL
+        /*! \param tag Particle tag
+        */
+        inline unsigned int operator[](unsigned int tag) const
+            {
+            return m_rtag ? m_rtag[tag] : m_map->find(tag);
+            }
+
+        //! Set the local index of a particle
+        /*! \param tag Particle tag
+            \param idx Local index, or NOT_LOCAL to remove the particle
+        */
+        inline void set(unsigned int tag, unsigned int idx)
+            {
+            if (m_rtag)
+                m_rtag[tag] = idx;
+            else
+                m_map->set(tag, idx);
+            }
+
+    private:
+        std::unique_ptr< ArrayHandle<unsigned int> > m_handle; //!< Handle to the dense array
+        unsigned int *m_rtag;                                  //!< Dense reverse-lookup tags, or NULL
+        RTagMap *m_map;                                        //!< Sparse reverse-lookup tags, or NULL
+    };
+
 #ifndef NVCC
 //! Exports the BoxDim class to python
 void export_BoxDim(pybind11::module& m);
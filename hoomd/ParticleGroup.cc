@@ -372,6 +372,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
     : m_sysdef(sysdef),
       m_pdata(sysdef->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
+      m_num_members_global(0),
       m_num_local_members(0),
       m_particles_sorted(true),
       m_reallocated(false),
@@ -410,6 +411,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
     : m_sysdef(sysdef),
       m_pdata(sysdef->getParticleData()),
       m_exec_conf(m_pdata->getExecConf()),
+      m_num_members_global(0),
       m_num_local_members(0),
       m_particles_sorted(true),
       m_reallocated(false),
@@ -448,30 +450,14 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
     sort(sorted_member_tags.begin(), sorted_member_tags.end());
 
     // store member tags
-    GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_exec_conf);
-    m_member_tags.swap(member_tags_array);
-    TAG_ALLOCATION(m_member_tags);
-
-        {
-        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
-        std::copy(sorted_member_tags.begin(), sorted_member_tags.end(), h_member_tags.data);
-        }
+    setMemberTags(sorted_member_tags);
 
     // one byte per particle to indicate membership in the group, initialize with current number of local particles
     GlobalArray<unsigned int> is_member(m_pdata->getMaxN(), m_pdata->getExecConf());
     m_is_member.swap(is_member);
     TAG_ALLOCATION(m_is_member);
 
-    GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_pdata->getExecConf());
-    m_is_member_tag.swap(is_member_tag);
-    TAG_ALLOCATION(m_is_member_tag);
-
-    // build the reverse lookup table for tags
-    buildTagHash();
-
-    GlobalArray<unsigned int> member_idx(member_tags.size(), m_pdata->getExecConf());
-    m_member_idx.swap(member_idx);
-    TAG_ALLOCATION(m_member_idx);
+    allocateIndexList();
 
     #ifdef ENABLE_CUDA
     if (m_pdata->getExecConf()->isCUDAEnabled())
@@ -549,22 +535,11 @@ void ParticleGroup::updateMemberTags(bool force_update) const
             }
         #endif
 
-        // store member tags in GlobalArray
-        GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
-        m_member_tags.swap(member_tags_array);
-        TAG_ALLOCATION(m_member_tags);
-
         // sort member tags
         std::sort(member_tags.begin(), member_tags.end());
 
-            {
-            ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
-            std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
-            }
-
-        GlobalArray<unsigned int> member_idx(member_tags.size(), m_pdata->getExecConf());
-        m_member_idx.swap(member_idx);
-        TAG_ALLOCATION(m_member_idx);
+        // store member tags
+        setMemberTags(member_tags);
         }
 
     // one byte per particle to indicate membership in the group, initialize with current number of local particles
@@ -572,12 +547,7 @@ void ParticleGroup::updateMemberTags(bool force_update) const
     m_is_member.swap(is_member);
     TAG_ALLOCATION(m_is_member);
 
-    GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_pdata->getExecConf());
-    m_is_member_tag.swap(is_member_tag);
-    TAG_ALLOCATION(m_is_member_tag);
-
-    // build the reverse lookup table for tags
-    buildTagHash();
+    allocateIndexList();
 
     // now that the tag list is completely set up and all memory is allocated, rebuild the index list
     rebuildIndexList();
@@ -587,14 +557,23 @@ void ParticleGroup::reallocate() const
     {
     m_is_member.resize(m_pdata->getMaxN());
 
-    if (m_is_member_tag.getNumElements() != m_pdata->getRTags().size())
-        {
-        // reallocate if necessary
-        GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_exec_conf);
-        m_is_member_tag.swap(is_member_tag);
-        TAG_ALLOCATION(m_is_member_tag);
+    // the index list may be reallocated, rebuild it
+    allocateIndexList();
+    m_particles_sorted = true;
+    }
 
-        buildTagHash();
+/*! The index list can hold at most all local particles, or all members of the group, whichever is smaller.
+    It is only reallocated when its size changes. The list of a group without members stays a null array, which has
+    zero elements and can still be acquired, so it is not reallocated either.
+*/
+void ParticleGroup::allocateIndexList() const
+    {
+    unsigned int size = std::min(m_num_members_global, m_pdata->getMaxN());
+    if (m_member_idx.getNumElements() != size)
+        {
+        GlobalArray<unsigned int> member_idx(size, m_pdata->getExecConf());
+        m_member_idx.swap(member_idx);
+        TAG_ALLOCATION(m_member_idx);
         }
     }
 
@@ -664,32 +643,22 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupUnion(std::shared_ptr<Particl
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
+        vector<unsigned int> members_a, members_b;
+        a->getMemberTags(members_a);
+        b->getMemberTags(members_b);
 
         // make the union
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
-
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_union(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
+        set_union(members_a.begin(),
+                  members_a.end(),
+                  members_b.begin(),
+                  members_b.end(),
                   ii);
         }
     else
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
+        // If the two arguments are the same, just return a copy of the whole group
+        a->getMemberTags(member_tags);
         }
 
 
@@ -715,31 +684,22 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupIntersection(std::shared_ptr<
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
+        vector<unsigned int> members_a, members_b;
+        a->getMemberTags(members_a);
+        b->getMemberTags(members_b);
 
         // make the intersection
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
-
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_intersection(h_members_a.data,
-                         h_members_a.data + n_a,
-                         h_members_b.data,
-                         h_members_b.data + n_b,
+        set_intersection(members_a.begin(),
+                         members_a.end(),
+                         members_b.begin(),
+                         members_b.end(),
                          ii);
         }
     else
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
+        // If the two arguments are the same, just return a copy of the whole group
+        a->getMemberTags(member_tags);
         }
 
     // create the new particle group
@@ -763,23 +723,21 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupDifference(std::shared_ptr<Pa
 
     if (a != b)
         {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-        // make the difference
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+        vector<unsigned int> members_a, members_b;
+        a->getMemberTags(members_a);
+        b->getMemberTags(members_b);
 
+        // make the difference
         insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_difference(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
+        set_difference(members_a.begin(),
+                  members_a.end(),
+                  members_b.begin(),
+                  members_b.end(),
                   ii);
         }
     else
         {
-        // If the two arguments are the same, just return an empty group (we cannot
-        // acquire the member_tags array twice)
+        // If the two arguments are the same, just return an empty group
         }
 
 
@@ -790,24 +748,67 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupDifference(std::shared_ptr<Pa
     return new_group;
     }
 
-/*! Builds the by-tag-lookup table for group membership
+/*! \param member_tags Sorted list of member tags
+
+    Consecutive tags are merged into ranges, and duplicate tags are dropped.
+*/
+void ParticleGroup::setMemberTags(const std::vector<unsigned int>& member_tags) const
+    {
+    std::vector<uint2> ranges;
+    std::vector<unsigned int> offsets;
+    unsigned int num_members = 0;
+    for (std::vector<unsigned int>::const_iterator it = member_tags.begin(); it != member_tags.end(); ++it)
+        {
+        unsigned int tag = *it;
+        if (!ranges.empty() && tag < ranges.back().y)
+            continue; // duplicate tag
+
+        if (!ranges.empty() && tag == ranges.back().y)
+            ranges.back().y++;
+        else
+            {
+            ranges.push_back(make_uint2(tag, tag+1));
+            offsets.push_back(num_members);
+            }
+        num_members++;
+        }
+
+    GlobalArray<uint2> member_ranges(ranges.size(), m_exec_conf);
+    m_member_ranges.swap(member_ranges);
+    TAG_ALLOCATION(m_member_ranges);
+
+    GlobalArray<unsigned int> member_range_offset(offsets.size(), m_exec_conf);
+    m_member_range_offset.swap(member_range_offset);
+    TAG_ALLOCATION(m_member_range_offset);
+
+        {
+        ArrayHandle<uint2> h_member_ranges(m_member_ranges, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_range_offset(m_member_range_offset, access_location::host, access_mode::overwrite);
+        std::copy(ranges.begin(), ranges.end(), h_member_ranges.data);
+        std::copy(offsets.begin(), offsets.end(), h_range_offset.data);
+        }
+
+    m_num_members_global = num_members;
+    }
+
+/*! \param member_tags Vector to hold the sorted list of member tags (output)
  */
-void ParticleGroup::buildTagHash() const
+void ParticleGroup::getMemberTags(std::vector<unsigned int>& member_tags) const
     {
-    ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::overwrite);
-    ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+    checkRebuild();
 
-    // reset member ship flags
-    memset(h_is_member_tag.data, 0, sizeof(unsigned int)*(m_pdata->getRTags().size()));
+    ArrayHandle<uint2> h_member_ranges(m_member_ranges, access_location::host, access_mode::read);
 
-    unsigned int num_members = m_member_tags.getNumElements();
-    for (unsigned int member = 0; member < num_members; member++)
+    member_tags.clear();
+    member_tags.reserve(m_num_members_global);
+    for (unsigned int range = 0; range < m_member_ranges.getNumElements(); ++range)
         {
-        h_is_member_tag.data[h_member_tags.data[member]] = 1;
+        for (unsigned int tag = h_member_ranges.data[range].x; tag < h_member_ranges.data[range].y; ++tag)
+            member_tags.push_back(tag);
         }
     }
 
-/*! \pre m_member_tags has been filled out, listing all particle tags in the group
+/*! \pre m_member_ranges has been filled out, listing all particle tags in the group
     \pre memory has been allocated for m_is_member and m_member_idx
     \post m_is_member is updated so that it reflects the current indices of the particles in the group
     \post m_member_idx is updated listing all particle indices belonging to the group, in index order
@@ -828,15 +829,23 @@ void ParticleGroup::rebuildIndexList() const
 
         // rebuild the membership flags for the  indices in the group and construct member list
         ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+        ArrayHandle<uint2> h_member_ranges(m_member_ranges, access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
+        unsigned int n_ranges = m_member_ranges.getNumElements();
+        const uint2 *ranges_begin = h_member_ranges.data;
+        const uint2 *ranges_end = ranges_begin + n_ranges;
         unsigned int cur_member = 0;
         for (unsigned int idx = 0; idx < nparticles; idx ++)
             {
             assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-            unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
+            unsigned int tag = h_tag.data[idx];
+
+            // find the first range that ends after this tag
+            const uint2 *range = std::upper_bound(ranges_begin, ranges_end, tag,
+                [](unsigned int t, const uint2& r) { return t < r.y; });
+            unsigned int is_member = (range != ranges_end && range->x <= tag) ? 1 : 0;
             h_is_member.data[idx] =  is_member;
             if (is_member)
                 {
@@ -846,7 +855,7 @@ void ParticleGroup::rebuildIndexList() const
             }
 
         m_num_local_members = cur_member;
-        assert(m_num_local_members <= m_member_tags.getNumElements());
+        assert(m_num_local_members <= m_member_idx.getNumElements());
         }
 
     // index has been rebuilt
@@ -893,7 +902,7 @@ void ParticleGroup::updateGPUAdvice() const
 void ParticleGroup::rebuildIndexListGPU() const
     {
     ArrayHandle<unsigned int> d_is_member(m_is_member, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
+    ArrayHandle<uint2> d_member_ranges(m_member_ranges, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_member_idx(m_member_idx, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
 
@@ -901,10 +910,11 @@ void ParticleGroup::rebuildIndexListGPU() const
     ScopedAllocation<unsigned int> d_tmp(m_pdata->getExecConf()->getCachedAllocator(), m_pdata->getN());
 
     // reset membership properties
-    if (m_member_tags.getNumElements() > 0)
+    if (m_num_members_global > 0)
         {
         gpu_rebuild_index_list(m_pdata->getN(),
-                           d_is_member_tag.data,
+                           d_member_ranges.data,
+                           m_member_ranges.getNumElements(),
                            d_is_member.data,
                            d_tag.data);
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
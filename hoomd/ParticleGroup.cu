@@ -20,10 +20,11 @@
     \brief Contains GPU kernel code used by ParticleGroup
 */
 
-//! GPU kernel to translate between global and local membership lookup table
+//! GPU kernel to look up the membership of the local particles in the ranges of member tags
 __global__ void gpu_rebuild_index_list_kernel(unsigned int N,
-                                              unsigned int *d_tag,
-                                              unsigned int *d_is_member_tag,
+                                              const unsigned int *d_tag,
+                                              const uint2 *d_member_ranges,
+                                              unsigned int n_ranges,
                                               unsigned int *d_is_member)
     {
     unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -32,7 +33,19 @@ __global__ void gpu_rebuild_index_list_kernel(unsigned int N,
 
     unsigned int tag = d_tag[idx];
 
-    d_is_member[idx] = d_is_member_tag[tag];
+    // binary search for the first range that ends after this tag
+    unsigned int lo = 0;
+    unsigned int hi = n_ranges;
+    while (lo < hi)
+        {
+        unsigned int mid = (lo + hi)/2;
+        if (d_member_ranges[mid].y <= tag)
+            lo = mid + 1;
+        else
+            hi = mid;
+        }
+
+    d_is_member[idx] = (lo < n_ranges && d_member_ranges[lo].x <= tag) ? 1 : 0;
     }
 
 __global__ void gpu_scatter_member_indices(unsigned int N,
@@ -50,19 +63,19 @@ __global__ void gpu_scatter_member_indices(unsigned int N,
 
 //! GPU method for rebuilding the index list of a ParticleGroup
 /*! \param N number of local particles
-    \param d_is_member_tag Global lookup table for tag -> group membership
-    \param d_is_member Array of membership flags
-    \param d_member_idx Array of member indices
+    \param d_member_ranges Sorted ranges [x,y) of member tags
+    \param n_ranges Number of ranges
+    \param d_is_member Array of membership flags (output)
     \param d_tag Array of tags
-    \param num_local_members Number of members on the local processor (return value)
 */
 cudaError_t gpu_rebuild_index_list(unsigned int N,
-                                   unsigned int *d_is_member_tag,
+                                   const uint2 *d_member_ranges,
+                                   unsigned int n_ranges,
                                    unsigned int *d_is_member,
                                    unsigned int *d_tag)
     {
     assert(d_is_member);
-    assert(d_is_member_tag);
+    assert(d_member_ranges);
     assert(d_tag);
 
     unsigned int block_size = 512;
@@ -70,17 +83,16 @@ cudaError_t gpu_rebuild_index_list(unsigned int N,
 
     gpu_rebuild_index_list_kernel<<<n_blocks,block_size>>>(N,
                                                          d_tag,
-                                                         d_is_member_tag,
+                                                         d_member_ranges,
+                                                         n_ranges,
                                                          d_is_member);
     return cudaSuccess;
     }
 
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
-    \param d_is_member_tag Global lookup table for tag -> group membership
     \param d_is_member Array of membership flags
     \param d_member_idx Array of member indices
-    \param d_tag Array of tags
     \param num_local_members Number of members on the local processor (return value)
 */
 cudaError_t gpu_compact_index_list(unsigned int N,
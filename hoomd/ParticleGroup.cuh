@@ -14,16 +14,15 @@
 
 //! GPU method for rebuilding the index list of a ParticleGroup
 cudaError_t gpu_rebuild_index_list(unsigned int N,
-                                   unsigned int *d_is_member_tag,
+                                   const uint2 *d_member_ranges,
+                                   unsigned int n_ranges,
                                    unsigned int *d_is_member,
                                    unsigned int *d_tag);
 
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
-    \param d_is_member_tag Global lookup table for tag -> group membership
     \param d_is_member Array of membership flags
     \param d_member_idx Array of member indices
-    \param d_tag Array of tags
     \param num_local_members Number of members on the local processor (return value)
 */
 cudaError_t gpu_compact_index_list(unsigned int N,
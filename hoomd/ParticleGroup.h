@@ -17,6 +17,7 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <algorithm>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 #include "GlobalArray.h"
@@ -201,12 +202,17 @@ class PYBIND11_EXPORT ParticleSelectorRigidCenter : public ParticleSelector
 
     <b>Data Structures and Implementation</b>
 
-    The initial and fundamental data structure in the group is a vector listing all of the particle tags in the group,
-    in a sorted tag order. This list can be accessed directly via getMemberTag() to meet the 2nd use case listed above.
+    The initial and fundamental data structure in the group is the sorted list of all of the particle tags in the
+    group. It is stored compactly as a list of disjoint ranges of consecutive tags, together with the number of members
+    preceding each range, so that groups of consecutive tags (e.g. all particles, or all particles in a molecule)
+    need only a few words of memory on every rank. A tag can be looked up with getMemberTag() to meet the 2nd use case
+    listed above, and membership of a tag is tested with a binary search over the ranges. No table indexed by the
+    global tag is kept.
+
     In order to iterate through all particles in the group in a cache-efficient manner, an auxiliary list is stored
     that lists all particle <i>indices</i> that belong to the group. This list must be updated on every particle sort.
-    Thirdly, a dynamic bitset is used to store one bit per particle for efficient O(1) tests if a given particle is in
-    the group.
+    Thirdly, one flag per local particle is stored for efficient O(1) tests if a given particle is in the group.
+    Both of these arrays are sized by the local number of particles.
 
     Finally, the common use case on the GPU using groups will include running one thread per particle in the group.
     For that it needs a list of indices of all the particles in the group. To facilitates this, the list of indices
@@ -221,7 +227,7 @@ class PYBIND11_EXPORT ParticleGroup
         // @{
 
         //! Constructs an empty particle group
-        ParticleGroup() : m_num_local_members(0) {};
+        ParticleGroup() : m_num_members_global(0), m_num_local_members(0) {};
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleSelector> selector,
@@ -247,7 +253,7 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
-            return (unsigned int)m_member_tags.getNumElements();
+            return m_num_members_global;
             }
 
         //! Get the number of members that are present on the local processor
@@ -269,8 +275,34 @@ class PYBIND11_EXPORT ParticleGroup
             checkRebuild();
 
             assert(i < getNumMembersGlobal());
-            ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
-            return h_member_tags.data[i];
+            ArrayHandle<uint2> h_member_ranges(m_member_ranges, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_range_offset(m_member_range_offset, access_location::host, access_mode::read);
+
+            // find the last range that starts at or before member i
+            unsigned int n_ranges = (unsigned int)m_member_ranges.getNumElements();
+            unsigned int range = (unsigned int)(std::upper_bound(h_range_offset.data, h_range_offset.data + n_ranges, i)
+                - h_range_offset.data) - 1;
+            return h_member_ranges.data[range].x + (i - h_range_offset.data[range]);
+            }
+
+        //! Get the index of a member in the group
+        /*! \param tag Tag of a particle that belongs to the group
+            \returns Index \a i from 0 to getNumMembersGlobal()-1 such that getMemberTag(i) == \a tag
+        */
+        unsigned int getMemberTagIndex(unsigned int tag) const
+            {
+            checkRebuild();
+
+            ArrayHandle<uint2> h_member_ranges(m_member_ranges, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_range_offset(m_member_range_offset, access_location::host, access_mode::read);
+
+            // find the last range that starts at or before the tag
+            unsigned int n_ranges = (unsigned int)m_member_ranges.getNumElements();
+            const uint2 *ranges_begin = h_member_ranges.data;
+            unsigned int range = (unsigned int)(std::upper_bound(ranges_begin, ranges_begin + n_ranges, tag,
+                [](unsigned int t, const uint2& r) { return t < r.x; }) - ranges_begin) - 1;
+            assert(range < n_ranges && tag < h_member_ranges.data[range].y);
+            return h_range_offset.data[range] + (tag - h_member_ranges.data[range].x);
             }
 
         //! Get a member index from the group
@@ -364,13 +396,14 @@ class PYBIND11_EXPORT ParticleGroup
         // in ParticleGroup in the future by using resize methods on the arrays
         mutable GlobalArray<unsigned int> m_is_member;    //!< One byte per particle, == 1 if index is a local member of the group
         mutable GlobalArray<unsigned int> m_member_idx;    //!< List of all particle indices in the group
-        mutable GlobalArray<unsigned int> m_member_tags;   //!< Lists the tags of the particle members
+        mutable GlobalArray<uint2> m_member_ranges;        //!< Sorted, disjoint ranges [x,y) of member tags
+        mutable GlobalArray<unsigned int> m_member_range_offset; //!< Number of members in all preceding ranges
+        mutable unsigned int m_num_members_global;      //!< Number of members on all processors
         mutable unsigned int m_num_local_members;       //!< Number of members on the local processor
         mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
         mutable bool m_reallocated;                     //!< True if particle data arrays have been reallocated
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
 
-        mutable GlobalArray<unsigned int> m_is_member_tag;  //!< One byte per particle, == 1 if tag is a member of the group
         std::shared_ptr<ParticleSelector> m_selector; //!< The associated particle selector
 
         bool m_update_tags;                             //!< True if tags should be updated when global number of particles changes
@@ -434,8 +467,14 @@ class PYBIND11_EXPORT ParticleGroup
             m_global_ptl_num_change = true;
             }
 
-        //! Helper function to build the 1:1 hash for tag membership
-        void buildTagHash() const;
+        //! Helper function to store the member tags as ranges of consecutive tags
+        void setMemberTags(const std::vector<unsigned int>& member_tags) const;
+
+        //! Helper function to expand the ranges into a sorted list of member tags
+        void getMemberTags(std::vector<unsigned int>& member_tags) const;
+
+        //! Helper function to allocate the index list for the local members
+        void allocateIndexList() const;
 
 #ifdef ENABLE_CUDA
         //! Helper function to rebuild the index lists after the particles have been sorted
@@ -0,0 +1,207 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file RTagMap.h
+    \brief Defines the RTagMap class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __RTAG_MAP_H__
+#define __RTAG_MAP_H__
+
+#include <vector>
+
+//! Compact hash map from particle tags to local particle indices
+/*! RTagMap stores the reverse lookup of the particles known to a rank (local particles and ghosts) in an
+    open-addressing hash table with linear probing. Its memory is proportional to the number of stored tags, unlike
+    the dense reverse-lookup table of ParticleData, which is sized by the largest global tag.
+
+    Erased entries are removed with backward-shift deletion, so lookups never need to skip tombstones, and the table
+    shrinks again when it becomes sparsely populated.
+
+    \ingroup data_structs
+*/
+class RTagMap
+    {
+    public:
+        //! Value returned by find() for tags that are not in the map
+        static const unsigned int NOT_FOUND = 0xffffffff;
+
+        //! Constructs an empty map
+        RTagMap()
+            : m_mask(0), m_shift(32), m_size(0)
+            {
+            }
+
+        //! Return the index stored for a tag
+        /*! \param tag Particle tag
+            \returns the local index of the particle, or NOT_FOUND if the tag is not in the map
+        */
+        inline unsigned int find(unsigned int tag) const
+            {
+            if (m_size == 0)
+                return NOT_FOUND;
+
+            for (unsigned int slot = hash(tag); ; slot = (slot+1) & m_mask)
+                {
+                const entry& e = m_table[slot];
+                if (e.tag == tag)
+                    return e.idx;
+                if (e.tag == EMPTY)
+                    return NOT_FOUND;
+                }
+            }
+
+        //! Store the index of a tag
+        /*! \param tag Particle tag
+            \param idx Local index of the particle. If idx is NOT_FOUND, the tag is removed from the map.
+        */
+        inline void set(unsigned int tag, unsigned int idx)
+            {
+            if (idx == NOT_FOUND)
+                {
+                erase(tag);
+                return;
+                }
+
+            // keep the load factor below 1/2
+            if (2*(m_size+1) > m_table.size())
+                rehash(4*(m_size+1));
+
+            unsigned int slot = hash(tag);
+            while (m_table[slot].tag != EMPTY && m_table[slot].tag != tag)
+                slot = (slot+1) & m_mask;
+
+            if (m_table[slot].tag == EMPTY)
+                {
+                m_table[slot].tag = tag;
+                m_size++;
+                }
+            m_table[slot].idx = idx;
+            }
+
+        //! Remove a tag from the map
+        /*! \param tag Particle tag
+        */
+        void erase(unsigned int tag)
+            {
+            if (m_size == 0)
+                return;
+
+            unsigned int slot = hash(tag);
+            while (m_table[slot].tag != tag)
+                {
+                if (m_table[slot].tag == EMPTY)
+                    return;
+                slot = (slot+1) & m_mask;
+                }
+
+            // shift back later entries of the same probe sequence into the hole
+            unsigned int hole = slot;
+            for (unsigned int next = (hole+1) & m_mask; m_table[next].tag != EMPTY; next = (next+1) & m_mask)
+                {
+                unsigned int home = hash(m_table[next].tag);
+                if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+                    {
+                    m_table[hole] = m_table[next];
+                    hole = next;
+                    }
+                }
+            m_table[hole].tag = EMPTY;
+            m_size--;
+
+            // release memory when the table is mostly empty
+            if (m_table.size() > MIN_CAPACITY && 8*m_size < m_table.size())
+                rehash(4*m_size);
+            }
+
+        //! Remove all tags from the map
+        void clear()
+            {
+            m_table.clear();
+            m_table.shrink_to_fit();
+            m_mask = 0;
+            m_shift = 32;
+            m_size = 0;
+            }
+
+        //! Reserve space for a given number of tags
+        /*! \param n Number of tags the map should hold without growing
+        */
+        void reserve(unsigned int n)
+            {
+            if (2*n > m_table.size())
+                rehash(2*n);
+            }
+
+        //! Get the number of tags in the map
+        unsigned int size() const
+            {
+            return m_size;
+            }
+
+        //! Get the number of bytes allocated by the map
+        size_t getMemoryUsage() const
+            {
+            return m_table.capacity()*sizeof(entry);
+            }
+
+    private:
+        //! One slot of the hash table
+        struct entry
+            {
+            unsigned int tag;  //!< Particle tag, or EMPTY
+            unsigned int idx;  //!< Local particle index
+            };
+
+        static const unsigned int EMPTY = 0xffffffff;   //!< Tag of an unoccupied slot
+        static const unsigned int MIN_CAPACITY = 64;    //!< Smallest table allocated
+
+        std::vector<entry> m_table; //!< The hash table, its size is a power of two
+        unsigned int m_mask;        //!< Table size - 1
+        unsigned int m_shift;       //!< 32 - log2(table size)
+        unsigned int m_size;        //!< Number of tags stored
+
+        //! Fibonacci hash of a tag into the table
+        inline unsigned int hash(unsigned int tag) const
+            {
+            return (unsigned int)(tag*2654435769u) >> m_shift;
+            }
+
+        //! Resize the table to (at least) a given number of slots and reinsert all tags
+        void rehash(unsigned int n_slots)
+            {
+            unsigned int capacity = MIN_CAPACITY;
+            unsigned int log2_capacity = 6;
+            while (capacity < n_slots)
+                {
+                capacity *= 2;
+                log2_capacity++;
+                }
+
+            std::vector<entry> old_table(capacity);
+            old_table.swap(m_table);
+            for (unsigned int i = 0; i < capacity; ++i)
+                m_table[i].tag = EMPTY;
+
+            m_mask = capacity-1;
+            m_shift = 32-log2_capacity;
+
+            for (unsigned int i = 0; i < old_table.size(); ++i)
+                {
+                if (old_table[i].tag == EMPTY)
+                    continue;
+
+                unsigned int slot = hash(old_table[i].tag);
+                while (m_table[slot].tag != EMPTY)
+                    slot = (slot+1) & m_mask;
+                m_table[slot] = old_table[i];
+                }
+            }
+    };
+
+#endif
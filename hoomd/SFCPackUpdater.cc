@@ -123,7 +123,7 @@ void SFCPackUpdater::applySortOrder()
     ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+    RTagHandle h_rtag(*m_pdata, access_mode::readwrite);
 
     // construct a temporary holding array for the sorted data
     Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
@@ -237,7 +237,7 @@ void SFCPackUpdater::applySortOrder()
     // rebuild global rtag
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        h_rtag.data[h_tag.data[i]] = i;
+        h_rtag.set(h_tag.data[i], i);
         }
 
     delete[] scal_tmp;
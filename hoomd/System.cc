@@ -33,8 +33,8 @@ PyObject* walltimeLimitExceptionTypeObj = 0;
     statistics are printed every 10 seconds.
 */
 System::System(std::shared_ptr<SystemDefinition> sysdef, unsigned int initial_tstep)
-        : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep), m_cur_tps(0),
-        m_med_tps(0), m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
+        : m_sysdef(sysdef), m_log_cache(new LogQuantityCache(sysdef->getParticleData())), m_start_tstep(initial_tstep), m_end_tstep(0),
+        m_cur_tstep(initial_tstep), m_cur_tps(0), m_med_tps(0), m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
         m_profile(false), m_stats_period(10)
     {
     // sanity check
@@ -427,6 +427,9 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
     m_start_tstep = m_cur_tstep;
     m_end_tstep = m_cur_tstep + nsteps;
 
+    // the state may have changed since the last run
+    m_log_cache->clear();
+
     // initialize the last status time
     int64_t initial_time = m_clk.getTime();
     m_last_status_time = initial_time;
@@ -660,10 +663,13 @@ void System::enableProfiler(bool enable)
     }
 
 /*! \param logger Logger to register computes and updaters with
-    All computes and updaters registered with the system are also registered with the logger.
+    All computes and updaters registered with the system are also registered with the logger. All registered loggers
+    share values of compute quantities at the current time step.
 */
 void System::registerLogger(std::shared_ptr<Logger> logger)
     {
+    logger->setLogCache(m_log_cache);
+
     // set the profiler on everything
     if (m_integrator)
         logger->registerUpdater(m_integrator);
@@ -404,6 +404,7 @@ class PYBIND11_EXPORT System
         std::shared_ptr<Integrator> m_integrator;     //!< Integrator that advances time in this System
         std::shared_ptr<SystemDefinition> m_sysdef;   //!< SystemDefinition for this System
         std::shared_ptr<Profiler> m_profiler;         //!< Profiler to profile runs
+        std::shared_ptr<LogQuantityCache> m_log_cache; //!< Compute quantities shared by all registered loggers
 
 #ifdef ENABLE_MPI
         std::shared_ptr<Communicator> m_comm;         //!< Communicator to use
@@ -66,18 +66,21 @@ SystemDefinition::SystemDefinition(unsigned int N,
     \param snapshot Snapshot to use
     \param exec_conf Execution configuration to run on
     \param decomposition (optional) The domain decomposition layout
+    \param sparse_rtags (optional) True if the particle data stores its reverse-lookup tags in a hash map
 */
 template <class Real>
 SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<Real> > snapshot,
                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                   std::shared_ptr<DomainDecomposition> decomposition)
+                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                   bool sparse_rtags)
     {
     setNDimensions(snapshot->dimensions);
 
     m_particle_data = std::shared_ptr<ParticleData>(new ParticleData(snapshot->particle_data,
                  snapshot->global_box,
                  exec_conf,
-                 decomposition));
+                 decomposition,
+                 sparse_rtags));
 
     #ifdef ENABLE_MPI
     // in MPI simulations, broadcast dimensionality from rank zero
@@ -266,7 +269,8 @@ void SystemDefinition::initializeFromSnapshot(std::shared_ptr< SnapshotSystemDat
 // instantiate both float and double methods
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<float> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                                   std::shared_ptr<DomainDecomposition> decomposition);
+                                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                                   bool sparse_rtags);
 template std::shared_ptr< SnapshotSystemData<float> > SystemDefinition::takeSnapshot<float>(bool particles,
                                                                                               bool bonds,
                                                                                               bool angles,
@@ -279,7 +283,8 @@ template void SystemDefinition::initializeFromSnapshot<float>(std::shared_ptr< S
 
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<double> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                                   std::shared_ptr<DomainDecomposition> decomposition);
+                                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                                   bool sparse_rtags);
 template std::shared_ptr< SnapshotSystemData<double> > SystemDefinition::takeSnapshot<double>(bool particles,
                                                                                               bool bonds,
                                                                                               bool angles,
@@ -297,8 +302,10 @@ void export_SystemDefinition(py::module& m)
     .def(py::init<unsigned int, const BoxDim&, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, std::shared_ptr<ExecutionConfiguration> >())
     .def(py::init<unsigned int, const BoxDim&, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration> >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration> >())
     .def("setNDimensions", &SystemDefinition::setNDimensions)
     .def("getNDimensions", &SystemDefinition::getNDimensions)
@@ -573,6 +573,151 @@ class log(_analyzer):
 
         hoomd.context.current.loggers.append(self)
 
+class log_binary(log):
+    R""" Log a number of calculated quantities to a binary file.
+
+    Args:
+        filename (str): File to write the log to.
+        quantities (list): List of quantities to log.
+        period (int): Quantities are logged every *period* time steps.
+        overwrite (bool): When False (the default) an existing log will be appended to. When True, an existing log file will be overwritten instead.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+        buffer_rows (int): Number of rows to collect in memory before writing them to the file.
+        flush_interval (float): Maximum time in seconds that collected rows wait before they are written (0 to wait
+          until *buffer_rows* rows are collected).
+
+    :py:class:`log_binary` logs the same quantities as :py:class:`log`, but stores them as 64-bit floating point values
+    in a binary file instead of formatting them as text. Rows are collected in memory and written in blocks by a
+    background thread, so logging with a small *period* does not stall the simulation on file I/O. Read the file
+    with :py:func:`read_log_binary`.
+
+    The file starts with a header that lists the logged quantities. Each block stores the time steps and then the
+    values of one quantity after another. Every block is synced to disk after it is written, and a reader ignores a
+    block that a crash cut short. When appending to an existing file, the quantities must match the ones in the file,
+    and any incomplete block at the end of the file is discarded.
+
+    Collected rows are in the file after :py:meth:`flush()`, after *flush_interval* seconds, or when the logger is
+    destroyed. The logged quantities cannot be changed after the logger is created.
+
+    Examples::
+
+        logger = analyze.log_binary(filename='log.bin', quantities=['potential_energy', 'temperature'], period=10)
+        run(10000)
+        logger.flush()
+        data = analyze.read_log_binary('log.bin')
+        print(data['timestep'], data['temperature'])
+
+    """
+
+    def __init__(self, filename, quantities, period, overwrite=False, phase=0, buffer_rows=1024, flush_interval=10.0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _analyzer.__init__(self);
+
+        # create the c++ mirror class
+        self.cpp_analyzer = _hoomd.LogBinary(hoomd.context.current.system_definition, filename, overwrite,
+                                             int(buffer_rows), float(flush_interval));
+        self.setupAnalyzer(period, phase);
+
+        # set the logged quantities
+        quantity_list = _hoomd.std_vector_string();
+        for item in quantities:
+            quantity_list.append(str(item));
+        self.cpp_analyzer.setLoggedQuantities(quantity_list);
+
+        # add the logger to the list of loggers
+        hoomd.context.current.loggers.append(self);
+
+        # store metadata
+        self.metadata_fields = ['filename','period','buffer_rows','flush_interval']
+        self.filename = filename
+        self.period = period
+        self.buffer_rows = buffer_rows
+        self.flush_interval = flush_interval
+
+    def set_params(self, quantities=None):
+        R""" Change the parameters of the log.
+
+        Args:
+            quantities (list): List of quantities to log (if specified), which must match the quantities set when
+              the logger was created.
+        """
+        hoomd.util.print_status_line();
+
+        if quantities is not None:
+            quantity_list = _hoomd.std_vector_string();
+            for item in quantities:
+                quantity_list.append(str(item));
+            self.cpp_analyzer.setLoggedQuantities(quantity_list);
+
+    def flush(self):
+        R""" Write all collected rows to the file.
+
+        Examples::
+
+            logger.flush()
+
+        """
+        self.cpp_analyzer.flush();
+
+def read_log_binary(filename):
+    R""" Read a file written by :py:class:`log_binary`.
+
+    Args:
+        filename (str): File to read.
+
+    Returns:
+        An ordered dictionary that maps ``'timestep'`` and the name of each logged quantity to a numpy array with one
+        entry per logged row.
+
+    An incomplete block at the end of the file, left by a crash while writing, is ignored.
+
+    Examples::
+
+        data = analyze.read_log_binary('log.bin')
+        pyplot.plot(data['timestep'], data['potential_energy'])
+
+    """
+    import collections
+
+    with open(filename, 'rb') as f:
+        buf = f.read();
+
+    if buf[0:8] != b'HOOMDLOG':
+        raise RuntimeError(filename + ' is not a binary log file');
+    version, n_columns = numpy.frombuffer(buf, dtype=numpy.uint32, count=2, offset=8);
+    if version != 1:
+        raise RuntimeError('Unsupported binary log version ' + str(version));
+
+    offset = 16;
+    columns = [];
+    for i in range(n_columns):
+        length = int(numpy.frombuffer(buf, dtype=numpy.uint32, count=1, offset=offset)[0]);
+        columns.append(buf[offset+4:offset+4+length].decode('utf-8'));
+        offset += 4 + length;
+
+    timesteps = [];
+    values = [[] for c in columns];
+    while offset + 8 <= len(buf) and buf[offset:offset+4] == b'HLBK':
+        n = int(numpy.frombuffer(buf, dtype=numpy.uint32, count=1, offset=offset+4)[0]);
+        size = 8 + 8*n + 8*n*n_columns + 4;
+        if offset + size > len(buf):
+            break;
+        if numpy.frombuffer(buf, dtype=numpy.uint32, count=1, offset=offset+size-4)[0] != n:
+            break;
+
+        timesteps.append(numpy.frombuffer(buf, dtype=numpy.uint64, count=n, offset=offset+8));
+        for j in range(n_columns):
+            values[j].append(numpy.frombuffer(buf, dtype=numpy.float64, count=n, offset=offset+8+8*n+8*n*j));
+        offset += size;
+
+    result = collections.OrderedDict();
+    result['timestep'] = numpy.concatenate(timesteps) if timesteps else numpy.zeros(0, dtype=numpy.uint64);
+    for j, name in enumerate(columns):
+        result[name] = numpy.concatenate(values[j]) if values[j] else numpy.zeros(0, dtype=numpy.float64);
+    return result;
+
 class callback(_analyzer):
     R""" Callback analyzer.
 
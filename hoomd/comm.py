@@ -92,6 +92,7 @@ class decomposition(object):
         nx (int): Number of processors to uniformly space in x dimension (if *x* is None)
         ny (int): Number of processors to uniformly space in y dimension (if *y* is None)
         nz (int): Number of processors to uniformly space in z dimension (if *z* is None)
+        stagger (bool): If True, allow :py:class:`hoomd.update.balance` to stagger the cuts along y and z
 
     A single domain decomposition is defined for the simulation.
     A standard domain decomposition divides the simulation box into equal volumes along the Cartesian axes while minimizing
@@ -118,6 +119,14 @@ class decomposition(object):
     The decomposition can be adjusted dynamically if the best static decomposition is not known, or the system
     composition is changing dynamically. For this associated command, see update.balance().
 
+    By default, every cut plane passes through the entire box. With *stagger* = True, every slab of domains with the
+    same x grid position has its own cuts along y, and every column of domains with the same x and y grid position
+    has its own cuts along z. :py:class:`hoomd.update.balance`
+    then adjusts the cuts of every slab and column separately, which balances droplets and other localized
+    inhomogeneities far better than planar cuts. The cuts of neighboring slabs and columns stay within one domain of each
+    other, so that every rank still communicates with its 26 neighbors in the grid. Staggered cuts are only supported
+    on the CPU, and not with MPCD.
+
     Priority is always given to specified arguments over the command line arguments. If one of these is not set but
     a command line option is, then the command line option is used. Otherwise, a default decomposition is chosen.
 
@@ -125,6 +134,7 @@ class decomposition(object):
 
         comm.decomposition(x=0.4, ny=2, nz=2)
         comm.decomposition(nx=2, y=0.8, z=[0.2,0.3])
+        comm.decomposition(nx=2, ny=2, nz=2, stagger=True)
 
     Warning:
         The decomposition command will override specified command line options.
@@ -142,13 +152,17 @@ class decomposition(object):
         raised if both are set.
     """
 
-    def __init__(self, x=None, y=None, z=None, nx=None, ny=None, nz=None):
+    def __init__(self, x=None, y=None, z=None, nx=None, ny=None, nz=None, stagger=False):
         hoomd.util.print_status_line()
 
         # check that the context has been initialized though
         if hoomd.context.exec_conf is None:
             raise RuntimeError("Cannot initialize decomposition without context.initialize() first")
 
+        if stagger and hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("comm.decomposition: staggered cuts are not supported on the GPU\n")
+            raise RuntimeError("Staggered domain decomposition is not supported on the GPU")
+
         # check that system is not initialized
         if hoomd.context.current.system is not None:
             hoomd.context.msg.error("comm.decomposition: cannot modify decomposition after system is initialized. Call before init.*\n")
@@ -168,6 +182,7 @@ class decomposition(object):
             self.uniform_x = True
             self.uniform_y = True
             self.uniform_z = True
+            self.stagger = stagger
 
             hoomd.util.quiet_status()
             self.set_params(x,y,z,nx,ny,nz)
@@ -257,6 +272,7 @@ class decomposition(object):
         # if the box is uniform in all directions, just use these values
         if self.uniform_x and self.uniform_y and self.uniform_z:
             self.cpp_dd = _hoomd.DomainDecomposition(hoomd.context.exec_conf, box.getL(), self.nx, self.ny, self.nz, not hoomd.context.options.onelevel)
+            self.cpp_dd.setStaggered(self.stagger)
             return self.cpp_dd
 
         # otherwise, make the fractional decomposition
@@ -306,6 +322,7 @@ class decomposition(object):
                 raise RuntimeError("Sum of decomposition in z must lie between 0.0 and 1.0")
 
             self.cpp_dd = _hoomd.DomainDecomposition(hoomd.context.exec_conf, box.getL(), fxs, fys, fzs)
+            self.cpp_dd.setStaggered(self.stagger)
             return self.cpp_dd
 
         except TypeError as te:
@@ -69,7 +69,7 @@ def read_xml(filename, restart = None, time_step = None, wrap_coordinates = Fals
 
     my_domain_decomposition = hoomd.init._create_domain_decomposition(snapshot._global_box);
     if my_domain_decomposition is not None:
-        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, hoomd.init._use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
@@ -166,7 +166,7 @@ def create_random(N, phi_p=None, name="A", min_dist=0.7, box=None, seed=1, dimen
 
     my_domain_decomposition = hoomd.init._create_domain_decomposition(snapshot._global_box);
     if my_domain_decomposition is not None:
-        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, hoomd.init._use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
@@ -393,7 +393,7 @@ def create_random_polymers(box, polymers, separation, seed=1):
 
     my_domain_decomposition = hoomd.init._create_domain_decomposition(snapshot._global_box);
     if my_domain_decomposition is not None:
-        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, hoomd.init._use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
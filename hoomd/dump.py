@@ -33,6 +33,8 @@ class dcd(hoomd.analyze._analyzer):
                some particles may be written just outside it. *unwrap_rigid* is ignored when *unwrap_full* is True.
         angle_z (bool): When True, the particle orientation angle is written to the z component (only useful for 2D simulations)
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+        buffer_frames (int): Number of frames to collect in memory before writing them to the file. (added in version 2.10)
+        async_write (bool): When True, write frames to the file from a background thread. (added in version 2.10)
 
     Every *period* time steps a new simulation snapshot is written to the
     specified file in the DCD file format. DCD only stores particle positions, in distance
@@ -43,10 +45,17 @@ class dcd(hoomd.analyze._analyzer):
     nor can you change the period of the dump at any time. Either of these tasks
     can be performed by creating a new dump file with the needed settings.
 
+    In MPI simulations, :py:class:`dcd` only collects the positions of the group members on the root rank (except with
+    *unwrap_rigid*, which needs the full particle data). When writing at a high frequency, set *buffer_frames* to write
+    several frames to the file at once, and *async_write* to write them from a background thread while the simulation
+    continues. Frames that are still in memory are written when the writer is destroyed; call :py:meth:`flush` to
+    write them earlier, e.g. before reading the file in the same job script.
+
     Examples::
 
         dump.dcd(filename="trajectory.dcd", period=1000)
         dcd = dump.dcd(filename"data/dump.dcd", period=1000)
+        dump.dcd(filename="fast.dcd", period=10, buffer_frames=100, async_write=True)
 
     Warning:
         When you use dump.dcd to append to an existing dcd file:
@@ -55,7 +64,7 @@ class dcd(hoomd.analyze._analyzer):
         * dump.dcd will not write out data at time steps that already are present in the dcd file to maintain a
           consistent timeline
     """
-    def __init__(self, filename, period, group=None, overwrite=False, unwrap_full=False, unwrap_rigid=False, angle_z=False, phase=0):
+    def __init__(self, filename, period, group=None, overwrite=False, unwrap_full=False, unwrap_rigid=False, angle_z=False, phase=0, buffer_frames=1, async_write=False):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -77,6 +86,8 @@ class dcd(hoomd.analyze._analyzer):
         self.cpp_analyzer.setUnwrapFull(unwrap_full);
         self.cpp_analyzer.setUnwrapRigid(unwrap_rigid);
         self.cpp_analyzer.setAngleZ(angle_z);
+        self.cpp_analyzer.setBufferFrames(int(buffer_frames));
+        self.cpp_analyzer.setAsyncWrite(async_write);
         self.setupAnalyzer(period, phase);
 
         # store metadata
@@ -99,6 +110,16 @@ class dcd(hoomd.analyze._analyzer):
         hoomd.context.msg.error("you cannot change the period of a dcd dump writer\n");
         raise RuntimeError('Error changing updater period');
 
+    def flush(self):
+        """ Write all buffered frames to the file.
+
+        Call :py:meth:`flush` before reading the file in the same job script when *buffer_frames* is larger than 1
+        or *async_write* is True.
+
+        .. versionadded:: 2.10
+        """
+        self.cpp_analyzer.flush();
+
 class getar(hoomd.analyze._analyzer):
     """Analyzer for dumping system properties to a getar file at intervals.
 
@@ -504,6 +525,12 @@ class gsd(hoomd.analyze._analyzer):
         time_step (int): Time step to write to the file (only used when period is None)
         dynamic (list): A list of quantity categories to save every frame. (added in version 2.2)
         static (list): A list of quantity categories save only in frame 0 (may not be set in conjunction with *dynamic*, deprecated in version 2.2).
+        async_write (bool): When True, write frames to the file from a background thread. (added in version 2.10)
+        parallel_write (bool): When True, all MPI ranks write their particles to the file. (added in version 2.10)
+        compression (dict): Map of ``position``, ``orientation`` and ``velocity`` to the precision to store them with.
+                            (added in version 2.10)
+        periods (dict): Map of categories to the number of time steps between writes of that category.
+                        (added in version 2.10)
 
     Write a simulation snapshot to the specified GSD file at regular intervals. GSD is capable of storing all particle
     and bond data fields in hoomd, in every frame of the trajectory. This allows GSD to store simulations where the
@@ -557,9 +584,43 @@ class gsd(hoomd.analyze._analyzer):
     specifying a group to write out. :py:class:`gsd` will write out all of the particles in the group in ascending
     tag order. When the group is not :py:func:`hoomd.group.all()`, :py:class:`gsd` will not write the topology fields.
 
+    Use **periods** to write some categories less often than every frame. A category with a period is written to the
+    frames on time steps that are a multiple of its period (the category is made dynamic if it is not already). The
+    GSD schema defines that readers take quantities missing from a frame from frame 0, so analysis scripts should only
+    use a category in the frames that contain it. To write only part of the system at a high rate, use a second
+    :py:class:`gsd` with a different **group**, **filename** and **period**.
+
     To write restart files with gsd, set `truncate=True`. This will cause :py:class:`gsd` to write a new frame 0
     to the file every period steps.
 
+    .. rubric:: Asynchronous writes
+
+    With ``async_write=True``, :py:class:`gsd` copies the data of a frame into a buffer and returns to the simulation
+    while a background thread writes the frame to the file and syncs it to disk. The simulation only waits when the
+    background thread has not finished writing the frame before the previous one. Frames may therefore not yet be in
+    the file when :py:func:`hoomd.run()` returns. Call :py:meth:`flush` before reading the file in the same job
+    script. Errors that occur while writing a frame are raised at the next write or :py:meth:`flush`.
+
+    .. rubric:: Parallel writes
+
+    In MPI simulations, :py:class:`gsd` by default gathers all particles on the root rank, which then writes the file
+    alone. With ``parallel_write=True``, every rank writes the per-particle data of its own particles directly into
+    the file with collective MPI-IO, and the root rank never holds the whole system. The file contents are the same.
+    The topology, user-defined log quantities and state data are still written by the root rank. Parallel writes
+    require a file system that supports MPI-IO from all ranks, and cannot be combined with *async_write*.
+
+    .. rubric:: Compression
+
+    Set *compression* to store positions, orientations, and/or velocities as integer multiples of the given
+    precision. :py:class:`gsd` stores the difference to the previous frame, which is small when particles move little
+    between frames, in a compact variable length code. The values read back differ from those in the simulation by at
+    most half the precision. Every 100th frame is a keyframe that does not depend on earlier frames.
+
+    Compressed quantities are written to the chunks ``compressed/particles/position``, etc... in place of the standard
+    chunks. :py:func:`hoomd.init.read_gsd()` and :py:func:`hoomd.data.gsd_snapshot()` decode them, but other
+    readers of GSD files (including the ``gsd`` python package) do not. Compression cannot be combined with
+    *parallel_write*.
+
     .. rubric:: State data
 
     :py:class:`gsd` can save internal state data for the following hoomd objects:
@@ -584,6 +645,10 @@ class gsd(hoomd.analyze._analyzer):
         dump.gsd(filename="configuration.gsd", overwrite=True, period=None, group=group.all(), time_step=0)
         dump.gsd(filename="momentum_too.gsd", period=1000, group=group.all(), phase=0, dynamic=['momentum'])
         dump.gsd(filename="saveall.gsd", overwrite=True, period=1000, group=group.all(), dynamic=['attribute', 'momentum', 'topology'])
+        dump.gsd(filename="trajectory.gsd", period=100, group=group.all(), phase=0, async_write=True)
+        dump.gsd(filename="small.gsd", period=100, group=group.all(), phase=0, compression=dict(position=1e-3))
+        dump.gsd(filename="solute.gsd", period=100, group=solute, phase=0, periods=dict(momentum=10000))
+        dump.gsd(filename="solvent.gsd", period=10000, group=solvent, phase=0)
 
     """
     def __init__(self,
@@ -595,7 +660,11 @@ class gsd(hoomd.analyze._analyzer):
                  phase=0,
                  time_step=None,
                  static=None,
-                 dynamic=None):
+                 dynamic=None,
+                 async_write=False,
+                 parallel_write=False,
+                 compression=None,
+                 periods=None):
         hoomd.util.print_status_line();
 
         if static is not None and dynamic is not None:
@@ -626,6 +695,25 @@ class gsd(hoomd.analyze._analyzer):
 
             dynamic_quantities = ['property'] + dynamic;
 
+        if periods is None:
+            periods = {}
+        for k in periods:
+            if k not in categories:
+                raise ValueError("dump.gsd: category " + str(k) + " is not recognized");
+            if k not in dynamic_quantities:
+                dynamic_quantities.append(k);
+
+        if async_write and parallel_write:
+            raise ValueError("Cannot specify both async_write and parallel_write");
+
+        if compression is None:
+            compression = {}
+        if compression and parallel_write:
+            raise ValueError("Cannot specify both compression and parallel_write");
+        for k in compression:
+            if k not in ['position', 'orientation', 'velocity']:
+                raise ValueError("dump.gsd: cannot compress " + str(k));
+
         # initialize base class
         hoomd.analyze._analyzer.__init__(self);
 
@@ -635,6 +723,12 @@ class gsd(hoomd.analyze._analyzer):
         self.cpp_analyzer.setWriteProperty('property' in dynamic_quantities);
         self.cpp_analyzer.setWriteMomentum('momentum' in dynamic_quantities);
         self.cpp_analyzer.setWriteTopology('topology' in dynamic_quantities);
+        self.cpp_analyzer.setAsyncWrite(async_write);
+        self.cpp_analyzer.setParallelWrite(parallel_write);
+        for k, v in compression.items():
+            self.cpp_analyzer.setCompression(k, float(v));
+        for k, v in periods.items():
+            self.cpp_analyzer.setPeriod(k, int(v));
 
         if period is not None:
             self.setupAnalyzer(period, phase);
@@ -660,6 +754,17 @@ class gsd(hoomd.analyze._analyzer):
 
         time_step = hoomd.context.current.system.getCurrentTimeStep()
         self.cpp_analyzer.analyze(time_step);
+        self.cpp_analyzer.flush();
+
+    def flush(self):
+        """ Wait until all frames are written to the file.
+
+        With ``async_write=True``, call :py:meth:`flush` before reading the file in the same job script. Does nothing
+        when *async_write* is False.
+
+        .. versionadded:: 2.10
+        """
+        self.cpp_analyzer.flush();
 
     def dump_state(self, obj):
         """Write state information for a hoomd object.
@@ -728,3 +833,73 @@ class gsd(hoomd.analyze._analyzer):
         .. versionadded:: 2.7
         """
         return self.cpp_analyzer.user_log;
+
+class checkpoint(hoomd.analyze._analyzer):
+    R""" Writes checkpoints for exact restarts.
+
+    Args:
+        filename (str): File name to write
+        period (int): Number of time steps between checkpoints, or None to write a single checkpoint immediately.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+
+    A checkpoint stores the particles, bonds, angles, dihedrals, impropers, constraints, special pairs, the box and
+    the state of the integrators in the native precision of the build, without any conversion.
+    :py:func:`hoomd.init.read_checkpoint()` restores these values bit for bit. When the restart runs on the same number
+    of MPI ranks with the same domain decomposition, it also restores the order of the particles in memory, so that
+    forces are summed in the same order as in the uninterrupted run. Random numbers in hoomd are computed from the seed,
+    the time step and the particle tags, so they need no state in the checkpoint. The neighbor list is rebuilt on the
+    first step after the restart, which may still change the order of the summation of pair forces.
+
+    Every MPI rank writes its own particles in parallel: rank 0 writes *filename*, and the other ranks write
+    *filename.<rank>*. Each checkpoint replaces the previous one. The files are first written under a temporary name
+    and renamed once all ranks have written theirs, so a job that is killed while writing leaves the previous
+    checkpoint intact.
+
+    Checkpoints are not a trajectory format. They can only be read by a build of hoomd with the same precision, and
+    do not store parameters of force fields, updaters and integrators: the restart script sets those up again.
+
+    Warning:
+        Checkpoints do not store the state of HPMC integrators. The move sizes *d* and *a* are lost, so an HPMC run
+        restarted from a checkpoint alone does not continue exactly. HPMC runs still need a GSD restart file
+        written with :py:meth:`gsd.dump_state` and read with ``restore_state=True``::
+
+            ckp = dump.checkpoint(filename="restart.ckp", period=100000)
+            restart = dump.gsd(filename="restart.gsd", group=group.all(), period=100000, truncate=True)
+            restart.dump_state(mc)
+
+    Examples::
+
+        dump.checkpoint(filename="restart.ckp", period=100000)
+        ckp = dump.checkpoint(filename="restart.ckp", period=None)
+
+    See Also:
+        :py:func:`hoomd.init.read_checkpoint`
+    """
+    def __init__(self, filename, period, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        hoomd.analyze._analyzer.__init__(self);
+
+        # every rank opens its own file: broadcast the name from rank 0
+        filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+        self.cpp_analyzer = _hoomd.CheckpointWriter(hoomd.context.current.system_definition, filename);
+
+        if period is not None:
+            self.setupAnalyzer(period, phase);
+        else:
+            self.cpp_analyzer.analyze(hoomd.context.current.system.getCurrentTimeStep());
+
+        # store metadata
+        self.filename = filename
+        self.period = period
+        self.phase = phase
+        self.metadata_fields = ['filename', 'period', 'phase']
+
+    def write(self):
+        """ Write a checkpoint at the current time step.
+
+        Call :py:meth:`write` at the end of a job to save the final state.
+        """
+        hoomd.util.print_status_line();
+        self.cpp_analyzer.analyze(hoomd.context.current.system.getCurrentTimeStep());
@@ -2026,6 +2026,76 @@ int gsd_write_chunk(struct gsd_handle* handle,
     return GSD_SUCCESS;
 }
 
+int gsd_reserve_chunk(struct gsd_handle* handle,
+                      const char* name,
+                      enum gsd_type type,
+                      uint64_t N,
+                      uint32_t M,
+                      uint8_t flags,
+                      int64_t* location)
+{
+    // validate input
+    if (handle == NULL || location == NULL)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (M == 0)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (gsd_sizeof_type(type) == 0)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (handle->open_flags == GSD_OPEN_READONLY)
+    {
+        return GSD_ERROR_FILE_MUST_BE_WRITABLE;
+    }
+    if (flags != 0)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint16_t id = gsd_name_id_map_find(&handle->name_map, name);
+    if (id == UINT16_MAX)
+    {
+        // not found, append to the index
+        int retval = gsd_append_name(&id, handle, name);
+        if (retval != GSD_SUCCESS)
+        {
+            return retval;
+        }
+
+        if (id == UINT16_MAX)
+        {
+            // this should never happen
+            return GSD_ERROR_NAMELIST_FULL;
+        }
+    }
+
+    // add an entry to the frame index
+    struct gsd_index_entry* index_entry;
+    int retval = gsd_index_buffer_add(&handle->frame_index, &index_entry);
+    if (retval != GSD_SUCCESS)
+    {
+        return retval;
+    }
+
+    gsd_util_zero_memory(index_entry, sizeof(struct gsd_index_entry));
+    index_entry->frame = handle->cur_frame;
+    index_entry->id = id;
+    index_entry->type = (uint8_t)type;
+    index_entry->N = N;
+    index_entry->M = M;
+
+    // reserve the space at the end of the file, the caller writes the data
+    index_entry->location = handle->file_size;
+    *location = index_entry->location;
+    handle->file_size += N * M * gsd_sizeof_type(type);
+
+    return GSD_SUCCESS;
+}
+
 uint64_t gsd_get_nframes(struct gsd_handle* handle)
 {
     if (handle == NULL)
@@ -2174,6 +2244,64 @@ int gsd_read_chunk(struct gsd_handle* handle, void* data, const struct gsd_index
     return GSD_SUCCESS;
 }
 
+int gsd_read_chunk_rows(struct gsd_handle* handle,
+                        void* data,
+                        const struct gsd_index_entry* chunk,
+                        uint64_t first_row,
+                        uint64_t n_rows)
+{
+    if (handle == NULL)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (data == NULL)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (chunk == NULL)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (first_row + n_rows > chunk->N)
+    {
+        return GSD_ERROR_INVALID_ARGUMENT;
+    }
+    if (handle->open_flags == GSD_OPEN_APPEND)
+    {
+        return GSD_ERROR_FILE_MUST_BE_READABLE;
+    }
+
+    size_t row_size = chunk->M * gsd_sizeof_type((enum gsd_type)chunk->type);
+    if (row_size == 0)
+    {
+        return GSD_ERROR_FILE_CORRUPT;
+    }
+    if (chunk->location == 0)
+    {
+        return GSD_ERROR_FILE_CORRUPT;
+    }
+
+    // validate that the chunk does not extend past the end of the file
+    if ((chunk->location + chunk->N * row_size) > (uint64_t)handle->file_size)
+    {
+        return GSD_ERROR_FILE_CORRUPT;
+    }
+
+    size_t size = n_rows * row_size;
+    if (size == 0)
+    {
+        return GSD_SUCCESS;
+    }
+
+    ssize_t bytes_read = gsd_io_pread_retry(handle->fd, data, size, chunk->location + first_row * row_size);
+    if (bytes_read == -1 || bytes_read != size)
+    {
+        return GSD_ERROR_IO;
+    }
+
+    return GSD_SUCCESS;
+}
+
 size_t gsd_sizeof_type(enum gsd_type type)
 {
     size_t val = 0;
@@ -497,6 +497,39 @@ int gsd_write_chunk(struct gsd_handle* handle,
                     uint8_t flags,
                     const void* data);
 
+/** Reserve space for a data chunk in the current frame
+
+    @param handle Handle to an open GSD file.
+    @param name Name of the data chunk.
+    @param type type ID that identifies the type of data in *data*.
+    @param N Number of rows in the data.
+    @param M Number of columns in the data.
+    @param flags set to 0, non-zero values reserved for future use.
+    @param location Set to the byte offset in the file where the data must be written.
+
+    @pre *handle* was opened by gsd_open().
+    @pre *name* is a unique name for data chunks in the given frame.
+
+    @post The index entry of the chunk is added to the in-memory index and `N * M * gsd_sizeof_type(type)`
+    bytes are reserved at the end of the file. The caller must write the data at *location* (for example from
+    several processes in parallel) before the file is read.
+
+    @return
+      - GSD_SUCCESS (0) on success. Negative value on failure:
+      - GSD_ERROR_INVALID_ARGUMENT: *handle* or *location* is NULL, *M* == 0, *type* is invalid, or
+        *flags* != 0.
+      - GSD_ERROR_FILE_MUST_BE_WRITABLE: The file was opened read-only.
+      - GSD_ERROR_NAMELIST_FULL: The file cannot store any additional unique chunk names.
+      - GSD_ERROR_MEMORY_ALLOCATION_FAILED: failed to allocate memory.
+*/
+int gsd_reserve_chunk(struct gsd_handle* handle,
+                      const char* name,
+                      enum gsd_type type,
+                      uint64_t N,
+                      uint32_t M,
+                      uint8_t flags,
+                      int64_t* location);
+
 /** Find a chunk in the GSD file
 
     @param handle Handle to an open GSD file
@@ -532,6 +565,32 @@ gsd_find_chunk(struct gsd_handle* handle, uint64_t frame, const char* name);
 */
 int gsd_read_chunk(struct gsd_handle* handle, void* data, const struct gsd_index_entry* chunk);
 
+/** Read a range of rows of a chunk from the GSD file
+
+    @param handle Handle to an open GSD file.
+    @param data Data buffer to read into.
+    @param chunk Chunk to read.
+    @param first_row Index of the first row to read.
+    @param n_rows Number of rows to read.
+
+    @pre *handle* was opened in read or readwrite mode.
+    @pre *chunk* was found by gsd_find_chunk().
+    @pre *data* points to an allocated buffer with at least `n_rows * M * gsd_sizeof_type(type)` bytes.
+
+    @return
+      - GSD_SUCCESS (0) on success. Negative value on failure:
+      - GSD_ERROR_IO: IO error (check errno).
+      - GSD_ERROR_INVALID_ARGUMENT: *handle* is NULL, *data* is NULL, *chunk* is NULL, or the rows are
+        not within the chunk.
+      - GSD_ERROR_FILE_MUST_BE_READABLE: The file was opened in append mode.
+      - GSD_ERROR_FILE_CORRUPT: The GSD file is corrupt.
+*/
+int gsd_read_chunk_rows(struct gsd_handle* handle,
+                        void* data,
+                        const struct gsd_index_entry* chunk,
+                        uint64_t first_row,
+                        uint64_t n_rows);
+
 /** Get the number of frames in the GSD file
 
     @param handle Handle to an open GSD file
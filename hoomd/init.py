@@ -190,7 +190,7 @@ def read_getar(filename, modes={'any': 'any'}):
     my_domain_decomposition = _create_domain_decomposition(box);
     if my_domain_decomposition is not None:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(
-            snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+            snapshot, hoomd.context.exec_conf, my_domain_decomposition, _use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(
             snapshot, hoomd.context.exec_conf);
@@ -240,7 +240,7 @@ def read_snapshot(snapshot):
     my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
 
     if my_domain_decomposition is not None:
-        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, _use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
@@ -250,7 +250,7 @@ def read_snapshot(snapshot):
     _perform_common_init_tasks();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
-def read_gsd(filename, restart = None, frame = 0, time_step = None):
+def read_gsd(filename, restart = None, frame = 0, time_step = None, parallel_read = False):
     R""" Read initial system state from an GSD file.
 
     Args:
@@ -258,6 +258,7 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
         restart (str): If it exists, read the file *restart* instead of *filename*.
         frame (int): Index of the frame to read from the GSD file. Negative values index from the end of the file.
         time_step (int): (if specified) Time step number to initialize instead of the one stored in the GSD file.
+        parallel_read (bool): When True, read the particles on all MPI ranks. (added in version 2.10)
 
     All particles, bonds, angles, dihedrals, impropers, constraints, and box information
     are read from the given GSD file at the given frame index. To read and write GSD files
@@ -273,6 +274,12 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     The result of :py:func:`hoomd.init.read_gsd` can be saved in a variable and later used to read and/or
     change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
 
+    By default, rank 0 reads the whole frame and scatters the particles to the other MPI ranks. With
+    *parallel_read* set to True, every rank reads an equal part of the particles directly from the file
+    and sends them to the ranks that own them, so that no single rank needs memory for the whole system.
+    Use this option to initialize very large systems on many ranks. All ranks must be able to read the file.
+    Bonds, angles, dihedrals, impropers, constraints, and pairs are still read on rank 0.
+
     See Also:
         :py:class:`hoomd.dump.gsd`
     """
@@ -288,10 +295,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     restart = _hoomd.mpi_bcast_str(restart, hoomd.context.exec_conf);
 
     if restart is not None and os.path.exists(restart):
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0, parallel_read);
         time_step = reader.getTimeStep();
     else:
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0, parallel_read);
         if time_step is None:
             time_step = reader.getTimeStep();
 
@@ -302,7 +309,7 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
 
     if my_domain_decomposition is not None:
-        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, _use_sparse_rtags());
     else:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
 
@@ -314,6 +321,63 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     hoomd.context.current.state_reader.clearSnapshot();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
+def read_checkpoint(filename):
+    R""" Read initial system state from a checkpoint.
+
+    Args:
+        filename (str): Checkpoint to read (the file written by rank 0).
+
+    Particles, bonds, angles, dihedrals, impropers, constraints, special pairs, the box, the time step and the state
+    of the integrators are read exactly as :py:class:`hoomd.dump.checkpoint` wrote them. The integrators pick up their
+    state when the script creates them again in the same order as before. The state of HPMC integrators is not part
+    of the checkpoint: restore it from a GSD restart file, see :py:class:`hoomd.dump.checkpoint`.
+
+    Every MPI rank reads the file its rank wrote. When the checkpoint was written by a different number of ranks,
+    rank 0 reads all files and distributes the particles. The order of the particles in memory is restored only when
+    every rank receives the same particles it saved, that is when the domain decomposition is the same.
+
+    Examples::
+
+        if os.path.exists("restart.ckp"):
+            init.read_checkpoint(filename="restart.ckp")
+        else:
+            init.read_gsd(filename="init.gsd")
+
+    See Also:
+        :py:class:`hoomd.dump.checkpoint`
+    """
+    hoomd.context._verify_init();
+    hoomd.util.print_status_line();
+
+    # check if initialization has already occurred
+    if is_initialized():
+        hoomd.context.msg.error("Cannot initialize more than once\n");
+        raise RuntimeError("Error initializing");
+
+    filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+
+    reader = _hoomd.CheckpointReader(hoomd.context.exec_conf, filename);
+    time_step = reader.getTimeStep();
+    snapshot = reader.getSnapshot();
+
+    # broadcast snapshot metadata so that all ranks have _global_box
+    snapshot._broadcast_box(hoomd.context.exec_conf);
+    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
+
+    if my_domain_decomposition is not None:
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition, _use_sparse_rtags());
+    else:
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
+
+    reader.restoreLocalData(hoomd.context.current.system_definition);
+    reader.clearSnapshot();
+
+    # initialize the system
+    hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, time_step);
+
+    _perform_common_init_tasks();
+    return hoomd.data.system_data(hoomd.context.current.system_definition);
+
 def restore_getar(filename, modes={'any': 'any'}):
     """Restore a subset of the current system's parameters from a
     trajectory archive (.tar, .zip, .sqlite) file. For a detailed
@@ -357,6 +421,12 @@ def _perform_common_init_tasks():
             # create the c++ Communicator
             if not hoomd.context.exec_conf.isCUDAEnabled():
                 cpp_communicator = _hoomd.Communicator(hoomd.context.current.system_definition, cpp_decomposition)
+                if hoomd.context.options.single_stage or hoomd.context.options.shared_ghosts:
+                    cpp_communicator.setSingleStage(True)
+                if hoomd.context.options.compress_ghosts:
+                    cpp_communicator.setCompressGhostUpdates(True)
+                if hoomd.context.options.shared_ghosts:
+                    cpp_communicator.setSharedGhostUpdates(True)
             else:
                 cpp_communicator = _hoomd.CommunicatorGPU(hoomd.context.current.system_definition, cpp_decomposition)
 
@@ -383,6 +453,12 @@ def _create_domain_decomposition(box):
 
     return hoomd.context.current.decomposition._make_cpp_decomposition(box)
 
+## Test if the particle data should be constructed with sparse reverse-lookup tags
+# \internal
+# Only used together with a domain decomposition, where the CPU Communicator supports them
+def _use_sparse_rtags():
+    return bool(hoomd.context.options.sparse_rtags) and not hoomd.context.exec_conf.isCUDAEnabled();
+
 def _parse_getar_modes(modes):
     newModes = {}
     for key in modes:
@@ -49,6 +49,10 @@ cudaError_t gpu_compute_dpdthermo_forces(const pair_args_t& pair_args,
 cudaError_t gpu_compute_ewald_forces(const pair_args_t& pair_args,
                                      const Scalar2 *d_params);
 
+//! Compute damped shifted force pair forces on the GPU with EvaluatorPairDSF
+cudaError_t gpu_compute_dsf_forces(const pair_args_t& pair_args,
+                                   const Scalar3 *d_params);
+
 //! Compute moliere pair forces on the GPU with EvaluatorPairMoliere
 cudaError_t gpu_compute_moliere_forces(const pair_args_t& pair_args,
                                        const Scalar2 *d_params);
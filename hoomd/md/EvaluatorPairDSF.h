@@ -0,0 +1,153 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifndef __PAIR_EVALUATOR_DSF_H__
+#define __PAIR_EVALUATOR_DSF_H__
+
+#ifndef NVCC
+#include <string>
+#endif
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorPairDSF.h
+    \brief Defines the pair evaluator class for damped shifted force electrostatics
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Class for evaluating the damped shifted force (DSF) electrostatic pair potential
+/*! <b>General Overview</b>
+
+    See EvaluatorPairLJ
+
+    <b>DSF specifics</b>
+
+    EvaluatorPairDSF evaluates the damped shifted force potential of Fennell and Gezelter (J. Chem. Phys. 124,
+    234104 (2006)), a Wolf-type real space approximation to the Ewald sum:
+
+    \f[
+    V_{\mathrm{DSF}}(r) = q_i q_j \left[\frac{\mathrm{erfc}(\alpha r)}{r} - \frac{\mathrm{erfc}(\alpha r_{\mathrm{cut}})}{r_{\mathrm{cut}}}
+                          + \left(\frac{\mathrm{erfc}(\alpha r_{\mathrm{cut}})}{r_{\mathrm{cut}}^2}
+                          + \frac{2\alpha}{\sqrt{\pi}} \frac{\exp(-\alpha^2 r_{\mathrm{cut}}^2)}{r_{\mathrm{cut}}}\right)
+                          (r - r_{\mathrm{cut}})\right]
+    \f]
+
+    Both the potential and the force go smoothly to zero at the cutoff, so no energy shift mode applies. The
+    shifts only depend on the type pair parameters and the cutoff, and are precomputed when the parameters are
+    set. Three parameters are stored in a Scalar3.
+    \a alpha is placed in \a params.x
+    \a v_shift = erfc(alpha*r_cut)/r_cut is placed in \a params.y
+    \a f_shift (the term multiplying r - r_cut) is placed in \a params.z
+
+    Every charge also interacts with its own image at the cutoff sphere and the neutralizing damping charge.
+    This self energy is not a pair term, it is evaluated per particle by evalSelfEnergy().
+*/
+class EvaluatorPairDSF
+    {
+    public:
+        //! Define the parameter type used by this pair potential evaluator
+        typedef Scalar3 param_type;
+
+        //! Constructs the pair potential evaluator
+        /*! \param _rsq Squared distance between the particles
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param _params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairDSF(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
+            : rsq(_rsq), rcutsq(_rcutsq), alpha(_params.x), v_shift(_params.y), f_shift(_params.z), qiqj(0)
+            {
+            }
+
+        //! DSF doesn't use diameter
+        DEVICE static bool needsDiameter() { return false; }
+        //! Accept the optional diameter values
+        /*! \param di Diameter of particle i
+            \param dj Diameter of particle j
+        */
+        DEVICE void setDiameter(Scalar di, Scalar dj) { }
+
+        //! DSF uses charge
+        DEVICE static bool needsCharge() { return true; }
+        //! Accept the optional charge values
+        /*! \param qi Charge of particle i
+            \param qj Charge of particle j
+        */
+        DEVICE void setCharge(Scalar qi, Scalar qj)
+            {
+            qiqj = qi * qj;
+            }
+
+        //! Evaluate the force and energy
+        /*! \param force_divr Output parameter to write the computed force divided by r.
+            \param pair_eng Output parameter to write the computed pair energy
+            \param energy_shift Ignored, the DSF potential is always shifted
+            \note There is no need to check if rsq < rcutsq in this method. Cutoff tests are performed
+                  in PotentialPair.
+
+            \return True if they are evaluated or false if they are not because we are beyond the cutoff
+        */
+        DEVICE bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
+            {
+            if (rsq < rcutsq && qiqj != 0)
+                {
+                Scalar rinv = fast::rsqrt(rsq);
+                Scalar r = Scalar(1.0) / rinv;
+                Scalar rcut = fast::sqrt(rcutsq);
+
+                Scalar erfc_r = fast::erfc(alpha*r);
+                Scalar gauss = Scalar(2.0)*alpha/fast::sqrt(Scalar(M_PI))*fast::exp(-alpha*alpha*rsq);
+
+                force_divr = qiqj * (erfc_r*rinv*rinv + gauss*rinv - f_shift) * rinv;
+                pair_eng = qiqj * (erfc_r*rinv - v_shift + f_shift*(r - rcut));
+
+                return true;
+                }
+            else
+                return false;
+            }
+
+        //! Evaluate the self energy of a single charge
+        /*! \param q Charge of the particle
+            \param params Parameters of the type pair (i,i)
+            \returns The self energy -(v_shift/2 + alpha/sqrt(pi)) q^2
+        */
+        DEVICE static Scalar evalSelfEnergy(Scalar q, const param_type& params)
+            {
+            return -(Scalar(0.5)*params.y + params.x/fast::sqrt(Scalar(M_PI)))*q*q;
+            }
+
+        #ifndef NVCC
+        //! Get the name of this potential
+        /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
+            via analyze.log.
+        */
+        static std::string getName()
+            {
+            return std::string("dsf");
+            }
+
+        std::string getShapeSpec() const
+            {
+            throw std::runtime_error("Shape definition not supported for this pair potential.");
+            }
+        #endif
+
+    protected:
+        Scalar rsq;     //!< Stored rsq from the constructor
+        Scalar rcutsq;  //!< Stored rcutsq from the constructor
+        Scalar alpha;   //!< Damping parameter
+        Scalar v_shift; //!< Potential shift erfc(alpha*r_cut)/r_cut
+        Scalar f_shift; //!< Force shift
+        Scalar qiqj;    //!< product of qi and qj
+    };
+
+
+#endif // __PAIR_EVALUATOR_DSF_H__
@@ -167,7 +167,7 @@ unsigned int IntegrationMethodTwoStep::getRotationalNDOF(std::shared_ptr<Particl
 void IntegrationMethodTwoStep::validateGroup()
     {
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    RTagHandle h_rtag(*m_pdata, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_group_index(m_group->getIndexArray(), access_location::host, access_mode::read);
 
@@ -437,6 +437,17 @@ void IntegratorTwoStep::setCommunicator(std::shared_ptr<Communicator> comm)
 
     Integrator::setCommunicator(comm);
     }
+
+/*! \param timestep Current time step
+*/
+void IntegratorTwoStep::computeInteriorCallback(unsigned int timestep)
+    {
+    // constituent particles are only placed after the ghost update, and the distance check has to wait for them
+    if (! m_composite_forces.empty())
+        return;
+
+    Integrator::computeInteriorCallback(timestep);
+    }
 #endif
 
 //! Updates the rigid body constituent particles
@@ -104,6 +104,9 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         /*! \param comm The Communicator
          */
         virtual void setCommunicator(std::shared_ptr<Communicator> comm);
+
+        //! Callback for computing the forces among local particles during the ghost update
+        virtual void computeInteriorCallback(unsigned int timestep);
 #endif
 
         //! Updates the rigid body constituent particles
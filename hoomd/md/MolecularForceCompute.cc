@@ -14,7 +14,7 @@
 #endif
 
 #include <string.h>
-#include <map>
+#include <algorithm>
 
 namespace py = pybind11;
 
@@ -240,78 +240,146 @@ void MolecularForceCompute::initMolecules()
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
 
-    std::set<unsigned int> local_molecule_tags;
+    unsigned int n_rtag = m_pdata->getRTags().getNumElements();
+    unsigned int n_cached = m_cached_molecule_tag.size();
 
-    unsigned int n_local_molecules = 0;
-
-    std::vector<unsigned int> local_molecule_idx(nptl_local, NO_MOLECULE);
-
-    // resize molecule lookup to size of local particle data
-    m_molecule_order.resize(m_pdata->getMaxN());
-
-    // keep track of particle with lowest tag
-    std::map<unsigned int, unsigned int> lowest_tag_by_molecule;
+    // a cached molecule is reused if all of its members are still local and still belong to it
+    std::vector<unsigned int> keep(n_cached, 1);
+    for (unsigned int imol = 0; imol < n_cached; ++imol)
+        {
+        unsigned int mol_tag = m_cached_molecule_tag[imol];
+        for (unsigned int j = m_cached_member_start[imol]; j < m_cached_member_start[imol+1]; ++j)
+            {
+            unsigned int tag = m_cached_member_tag[j];
+            if (tag >= n_rtag || tag >= m_molecule_tag.getNumElements() || h_rtag.data[tag] >= nptl_local
+                || h_molecule_tag.data[tag] != mol_tag)
+                {
+                keep[imol] = 0;
+                break;
+                }
+            }
+        }
 
+    // count the local members of every cached molecule, to detect molecules that gained particles
+    std::vector<unsigned int> n_members(n_cached, 0);
     for (unsigned int iptl = 0; iptl < nptl_local; ++iptl)
         {
         unsigned int tag = h_tag.data[iptl];
         assert(tag < m_molecule_tag.getNumElements());
 
         unsigned int mol_tag = h_molecule_tag.data[tag];
-        if (mol_tag == NO_MOLECULE)
+        if (mol_tag == NO_MOLECULE || mol_tag >= m_molecule_slot.size())
             continue;
 
-        auto it = lowest_tag_by_molecule.find(mol_tag);
-        unsigned int min_tag = tag;
-        if (it != lowest_tag_by_molecule.end())
-            min_tag = std::min(it->second, tag);
-
-        lowest_tag_by_molecule[mol_tag] = min_tag;
+        unsigned int slot = m_molecule_slot[mol_tag];
+        if (slot != NO_MOLECULE)
+            n_members[slot]++;
         }
 
-    // sort local molecules by index of lowest tag, and inside the molecule by ptl tag
-    std::map<unsigned int, std::set<unsigned int> > local_molecules_sorted;
+    for (unsigned int imol = 0; imol < n_cached; ++imol)
+        {
+        if (n_members[imol] != m_cached_member_start[imol+1] - m_cached_member_start[imol])
+            keep[imol] = 0;
+        }
 
+    // collect the particles of all new or changed molecules, sorted by molecule and inside the molecule by ptl tag
+    std::vector< std::pair<unsigned int, unsigned int> > regroup;
     for (unsigned int iptl = 0; iptl < nptl_local; ++iptl)
         {
         unsigned int tag = h_tag.data[iptl];
-        assert(tag < m_molecule_tag.getNumElements());
-
         unsigned int mol_tag = h_molecule_tag.data[tag];
-        if (mol_tag == NO_MOLECULE) continue;
+        if (mol_tag == NO_MOLECULE)
+            continue;
 
-        unsigned int lowest_tag = lowest_tag_by_molecule[mol_tag];
-        unsigned int lowest_idx = h_rtag.data[lowest_tag];
-        assert(lowest_idx < m_pdata->getN() + m_pdata->getNGhosts());
+        unsigned int slot = mol_tag < m_molecule_slot.size() ? m_molecule_slot[mol_tag] : NO_MOLECULE;
+        if (slot == NO_MOLECULE || !keep[slot])
+            regroup.push_back(std::make_pair(mol_tag, tag));
+        }
+
+    std::sort(regroup.begin(), regroup.end());
+    regroup.erase(std::unique(regroup.begin(), regroup.end()), regroup.end());
+
+    // assemble the new set of molecules, kept ones first
+    std::vector<unsigned int> molecule_tag;
+    std::vector<unsigned int> member_start(1, 0);
+    std::vector<unsigned int> member_tag;
+
+    for (unsigned int imol = 0; imol < n_cached; ++imol)
+        {
+        // invalidate the old cache entry
+        m_molecule_slot[m_cached_molecule_tag[imol]] = NO_MOLECULE;
 
-        local_molecules_sorted[lowest_idx].insert(tag);
+        if (!keep[imol])
+            continue;
+
+        molecule_tag.push_back(m_cached_molecule_tag[imol]);
+        member_tag.insert(member_tag.end(),
+            m_cached_member_tag.begin() + m_cached_member_start[imol],
+            m_cached_member_tag.begin() + m_cached_member_start[imol+1]);
+        member_start.push_back(member_tag.size());
         }
 
-    n_local_molecules = local_molecules_sorted.size();
+    unsigned int n_kept = molecule_tag.size();
 
-    m_exec_conf->msg->notice(7) << "MolecularForceCompute: " << n_local_molecules << " molecules" << std::endl;
+    for (unsigned int i = 0; i < regroup.size(); ++i)
+        {
+        if (i == 0 || regroup[i].first != regroup[i-1].first)
+            {
+            if (i > 0)
+                member_start.push_back(member_tag.size());
+            molecule_tag.push_back(regroup[i].first);
+            }
+        member_tag.push_back(regroup[i].second);
+        }
+    if (regroup.size())
+        member_start.push_back(member_tag.size());
 
-    m_molecule_length.resize(n_local_molecules);
+    unsigned int n_local_molecules = molecule_tag.size();
 
-    ArrayHandle<unsigned int> h_molecule_length(m_molecule_length, access_location::host, access_mode::overwrite);
+    m_exec_conf->msg->notice(7) << "MolecularForceCompute: " << n_local_molecules << " molecules, "
+        << n_kept << " reused" << std::endl;
 
-    // reset lengths
+    // sort local molecules by index of lowest tag (the first member), using the local index as a bucket
+    std::vector<unsigned int> molecule_by_lowest_idx(nptl_local, NO_MOLECULE);
     for (unsigned int imol = 0; imol < n_local_molecules; ++imol)
         {
-        h_molecule_length.data[imol] = 0;
+        unsigned int lowest_idx = h_rtag.data[member_tag[member_start[imol]]];
+        assert(lowest_idx < nptl_local);
+        molecule_by_lowest_idx[lowest_idx] = imol;
         }
 
-    // count molecule lengths
-    unsigned int i = 0;
-    for (auto it = local_molecules_sorted.begin(); it != local_molecules_sorted.end(); ++it)
+    // store the cache in output order
+    m_cached_molecule_tag.clear();
+    m_cached_member_start.assign(1, 0);
+    m_cached_member_tag.clear();
+
+    for (unsigned int idx = 0; idx < nptl_local; ++idx)
         {
-        h_molecule_length.data[i++] = it->second.size();
+        unsigned int imol = molecule_by_lowest_idx[idx];
+        if (imol == NO_MOLECULE)
+            continue;
+
+        unsigned int mol_tag = molecule_tag[imol];
+        if (mol_tag >= m_molecule_slot.size())
+            m_molecule_slot.resize(mol_tag+1, NO_MOLECULE);
+        m_molecule_slot[mol_tag] = m_cached_molecule_tag.size();
+
+        m_cached_molecule_tag.push_back(mol_tag);
+        m_cached_member_tag.insert(m_cached_member_tag.end(),
+            member_tag.begin() + member_start[imol],
+            member_tag.begin() + member_start[imol+1]);
+        m_cached_member_start.push_back(m_cached_member_tag.size());
         }
 
+    m_molecule_length.resize(n_local_molecules);
+
+    ArrayHandle<unsigned int> h_molecule_length(m_molecule_length, access_location::host, access_mode::overwrite);
+
     // find maximum length
     unsigned nmax = 0;
     for (unsigned int imol = 0; imol < n_local_molecules; ++imol)
         {
+        h_molecule_length.data[imol] = m_cached_member_start[imol+1] - m_cached_member_start[imol];
         if (h_molecule_length.data[imol] > nmax)
             {
             nmax = h_molecule_length.data[imol];
@@ -324,11 +392,8 @@ void MolecularForceCompute::initMolecules()
     // resize molecule list
     m_molecule_list.resize(m_molecule_indexer.getNumElements());
 
-    // reset lengths again
-    for (unsigned int imol = 0; imol < n_local_molecules; ++imol)
-        {
-        h_molecule_length.data[imol] = 0;
-        }
+    // resize molecule lookup to size of local particle data
+    m_molecule_order.resize(m_pdata->getMaxN());
 
     // reset molecule order
     ArrayHandle<unsigned int> h_molecule_order(m_molecule_order, access_location::host, access_mode::overwrite);
@@ -344,19 +409,17 @@ void MolecularForceCompute::initMolecules()
     // reset reverse lookup
     memset(h_molecule_idx.data, 0, sizeof(unsigned int)*nptl_local);
 
-    unsigned int i_mol = 0;
-    for (auto it_mol = local_molecules_sorted.begin(); it_mol != local_molecules_sorted.end(); ++it_mol)
+    for (unsigned int i_mol = 0; i_mol < n_local_molecules; ++i_mol)
         {
-        for (std::set<unsigned int>::iterator it_tag = it_mol->second.begin(); it_tag != it_mol->second.end(); ++it_tag)
+        for (unsigned int j = m_cached_member_start[i_mol]; j < m_cached_member_start[i_mol+1]; ++j)
             {
-            unsigned int n = h_molecule_length.data[i_mol]++;
-            unsigned int ptl_idx = h_rtag.data[*it_tag];
+            unsigned int n = j - m_cached_member_start[i_mol];
+            unsigned int ptl_idx = h_rtag.data[m_cached_member_tag[j]];
             assert(ptl_idx < m_pdata->getN() + m_pdata->getNGhosts());
             h_molecule_list.data[m_molecule_indexer(n, i_mol)] = ptl_idx;
             h_molecule_idx.data[ptl_idx] = i_mol;
             h_molecule_order.data[ptl_idx] = n;
             }
-        i_mol ++;
         }
 
     if (m_prof) m_prof->pop(m_exec_conf);
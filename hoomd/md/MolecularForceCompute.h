@@ -21,6 +21,10 @@
     The data structures are initialized by calling initMolecules(). This is done in the derived class
     whenever particles are reordered.
 
+    On the CPU, the member tags of every local molecule are cached between calls. After a particle sort, only the
+    local indices of the cached molecules are looked up again through the reverse-lookup tags, and after particle
+    migration only those molecules that gained or lost local members are regrouped.
+
     Every molecule has a unique contiguous tag, 0 <=tag <m_n_molecules_global.
 
     Derived classes take care of resizing the ghost layer accordingly so that
@@ -155,6 +159,11 @@ class PYBIND11_EXPORT MolecularForceCompute : public ForceConstraint
 
         Index2D m_molecule_indexer;                 //!< Index of the molecule table
 
+        std::vector<unsigned int> m_cached_molecule_tag;   //!< Molecule tag of every cached local molecule
+        std::vector<unsigned int> m_cached_member_start;   //!< Offset of every cached molecule into m_cached_member_tag
+        std::vector<unsigned int> m_cached_member_tag;     //!< Member tags of the cached molecules, sorted by tag
+        std::vector<unsigned int> m_molecule_slot;         //!< Index of a molecule in the cache, by molecule tag
+
         void setDirty()
             {
             m_dirty = true;
@@ -13,6 +13,7 @@
 
 namespace py = pybind11;
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -34,7 +35,7 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     : Compute(sysdef), m_typpair_idx(m_pdata->getNTypes()), m_rcut_max_max(_r_cut), m_rcut_min(_r_cut),
       m_r_buff(r_buff), m_d_max(1.0), m_filter_body(false), m_diameter_shift(false), m_storage_mode(half),
       m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_force_update(true),
-      m_dist_check(true), m_has_been_updated_once(false)
+      m_dist_check(true), m_has_been_updated_once(false), m_num_builds(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing Neighborlist" << endl;
 
@@ -53,6 +54,10 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_exclusions_set = false;
 
     m_need_reallocate_exlist = false;
+    m_ex_tag_max = 0;
+    m_topology_exclusions = false;
+    m_topology_ex_flags = 0;
+    m_ex_cache_dirty = true;
 
     // initialize box length at last update
     m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
@@ -163,17 +168,16 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_pos.swap(last_pos);
     TAG_ALLOCATION(m_last_pos);
 
-    // allocate initial memory allowing 4 exclusions per particle (will grow to match specified exclusions)
+    // the exclusion list by tag is allocated when exclusions are added
+    GlobalVector<unsigned int> ex_tag_head(m_exec_conf);
+    m_ex_tag_head.swap(ex_tag_head);
+    TAG_ALLOCATION(m_ex_tag_head);
 
-    // note: this breaks O(N/P) memory scaling
-    GlobalVector<unsigned int> n_ex_tag(m_pdata->getRTags().size(), m_exec_conf);
-    m_n_ex_tag.swap(n_ex_tag);
-    TAG_ALLOCATION(m_n_ex_tag);
-
-    GlobalArray<unsigned int> ex_list_tag(m_pdata->getRTags().size(), 1, m_exec_conf);
-    m_ex_list_tag.swap(ex_list_tag);
-    TAG_ALLOCATION(m_ex_list_tag);
+    GlobalVector<unsigned int> ex_tag_list(m_exec_conf);
+    m_ex_tag_list.swap(ex_tag_list);
+    TAG_ALLOCATION(m_ex_tag_list);
 
+    // allocate initial memory allowing one exclusion per particle (will grow to match specified exclusions)
     GlobalArray<unsigned int> n_ex_idx(m_pdata->getMaxN(), m_exec_conf);
     m_n_ex_idx.swap(n_ex_idx);
     TAG_ALLOCATION(m_n_ex_idx);
@@ -186,7 +190,6 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     clearExclusions();
 
     m_ex_list_indexer = Index2D(m_ex_list_idx.getPitch(), 1);
-    m_ex_list_indexer_tag = Index2D(m_ex_list_tag.getPitch(), 1);
 
     // connect to particle sort to force rebuild
     m_pdata->getParticleSortSignal().connect<NeighborList, &NeighborList::forceUpdate>(this);
@@ -309,6 +312,9 @@ NeighborList::~NeighborList()
 
     m_pdata->getNumTypesChangeSignal().disconnect<NeighborList, &NeighborList::reallocateTypes>(this);
 
+    if (m_topology_exclusions)
+        connectTopologySignals(false);
+
     getRCutChangeSignal().disconnect<NeighborList, &NeighborList::slotRCutChange>(this);
     }
 
@@ -368,6 +374,7 @@ void NeighborList::compute(unsigned int timestep)
 
         setLastUpdatedPos();
         m_has_been_updated_once = true;
+        m_num_builds++;
         }
     if (m_prof) m_prof->pop();
     }
@@ -580,7 +587,7 @@ Scalar NeighborList::estimateNNeigh()
     \param tag2 TAG (not index) of the second particle in the pair
     \post The pair \a tag1, \a tag2 will not appear in the neighborlist
     \note This only takes effect on the next call to compute() that updates the list
-    \note Duplicates are checked for and not added.
+    \note Duplicates are removed when the exclusion is merged into the list by tag.
 */
 void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
     {
@@ -590,48 +597,11 @@ void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
     assert(! m_need_reallocate_exlist);
 
     m_exclusions_set = true;
+    m_ex_cache_dirty = true;
 
-    // don't add an exclusion twice
-    if (isExcluded(tag1, tag2))
-        return;
-
-    // this is clunky, but needed due to the fact that we cannot have an array handle in scope when
-    // calling grow exclusion list
-    bool grow = false;
-        {
-        // access arrays
-        ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::readwrite);
-
-        // grow the list if necessary
-        if (h_n_ex_tag.data[tag1] == m_ex_list_indexer.getH())
-            grow = true;
-
-        if (h_n_ex_tag.data[tag2] == m_ex_list_indexer.getH())
-            grow = true;
-        }
-
-    if (grow)
-        {
-        growExclusionList();
-        }
-
-        {
-        // access arrays
-        ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::readwrite);
-
-        // add tag2 to tag1's exclusion list
-        unsigned int pos1 = h_n_ex_tag.data[tag1];
-        assert(pos1 < m_ex_list_indexer.getH());
-        h_ex_list_tag.data[m_ex_list_indexer_tag(tag1,pos1)] = tag2;
-        h_n_ex_tag.data[tag1]++;
-
-        // add tag1 to tag2's exclusion list
-        unsigned int pos2 = h_n_ex_tag.data[tag2];
-        assert(pos2 < m_ex_list_indexer.getH());
-        h_ex_list_tag.data[m_ex_list_indexer_tag(tag2,pos2)] = tag1;
-        h_n_ex_tag.data[tag2]++;
-        }
+    // defer sorting the exclusion into the list by tag until it is needed
+    m_ex_tag_pending.push_back(make_uint2(tag1, tag2));
+    m_ex_tag_pending.push_back(make_uint2(tag2, tag1));
 
     forceUpdate();
     }
@@ -640,29 +610,21 @@ void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
 */
 void NeighborList::clearExclusions()
     {
-    // reallocate list of exclusions per tag if necessary
-    if (m_need_reallocate_exlist)
-        {
-        m_n_ex_tag.resize(m_pdata->getRTags().size());
-
-        // slave the width of the exclusion list to the capacity of the number of exclusions array
-        // in order to amortize reallocation costs
-        if (m_ex_list_tag.getPitch() != m_n_ex_tag.getNumElements())
-            {
-            m_ex_list_tag.resize(m_n_ex_tag.getNumElements(), m_ex_list_tag.getHeight());
-            m_ex_list_indexer_tag = Index2D(m_ex_list_tag.getPitch(), m_ex_list_tag.getHeight());
-            }
-
-        m_need_reallocate_exlist = false;
-        }
-
+    // release the exclusion list by tag
+    GlobalVector<unsigned int>(m_exec_conf).swap(m_ex_tag_head);
+    TAG_ALLOCATION(m_ex_tag_head);
+    GlobalVector<unsigned int>(m_exec_conf).swap(m_ex_tag_list);
+    TAG_ALLOCATION(m_ex_tag_list);
+    std::vector<uint2>().swap(m_ex_tag_pending);
+    m_ex_tag_max = 0;
+    m_topology_ex_flags = 0;
+    m_need_reallocate_exlist = false;
 
-    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::overwrite);
 
-    memset(h_n_ex_tag.data, 0, sizeof(unsigned int)*m_n_ex_tag.getNumElements());
     memset(h_n_ex_idx.data, 0, sizeof(unsigned int)*m_n_ex_idx.getNumElements());
     m_exclusions_set = false;
+    m_ex_cache_dirty = true;
 
     forceUpdate();
     }
@@ -670,20 +632,21 @@ void NeighborList::clearExclusions()
 //! Get number of exclusions involving n particles
 unsigned int NeighborList::getNumExclusions(unsigned int size)
     {
-    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
+    buildLocalExclusions();
+
     unsigned int count = 0;
-    unsigned int ntags = m_pdata->getRTags().size();
-    for (unsigned int tag = 0; tag <= ntags; tag++)
+    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
         {
-        if (! m_pdata->isTagActive(tag))
-            {
-            continue;
-            }
-        unsigned int num_excluded = h_n_ex_tag.data[tag];
+        unsigned int num_excluded = m_ex_local_head[idx+1] - m_ex_local_head[idx];
 
         if (num_excluded == size) count++;
         }
 
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &count, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+
     return count;
     }
 
@@ -691,22 +654,21 @@ unsigned int NeighborList::getNumExclusions(unsigned int size)
 */
 void NeighborList::countExclusions()
     {
-    unsigned int MAX_COUNT_EXCLUDED = 16;
+    const unsigned int MAX_COUNT_EXCLUDED = 16;
     unsigned int excluded_count[MAX_COUNT_EXCLUDED+2];
     unsigned int num_excluded, max_num_excluded;
 
     assert(! m_need_reallocate_exlist);
 
-    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
+    buildLocalExclusions();
 
     max_num_excluded = 0;
     for (unsigned int c=0; c <= MAX_COUNT_EXCLUDED+1; ++c)
         excluded_count[c] = 0;
 
-    unsigned int max_tag = m_pdata->getRTags().size();
-    for (unsigned int i = 0; i < max_tag; i++)
+    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
         {
-        num_excluded = h_n_ex_tag.data[i];
+        num_excluded = m_ex_local_head[idx+1] - m_ex_local_head[idx];
 
         if (num_excluded > max_num_excluded)
             max_num_excluded = num_excluded;
@@ -717,6 +679,15 @@ void NeighborList::countExclusions()
         excluded_count[num_excluded] += 1;
         }
 
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, excluded_count, MAX_COUNT_EXCLUDED+2, MPI_UNSIGNED, MPI_SUM,
+            m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &max_num_excluded, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
     m_exec_conf->msg->notice(2) << "-- Neighborlist exclusion statistics -- :" << endl;
     for (unsigned int i=0; i <= MAX_COUNT_EXCLUDED; ++i)
         {
@@ -755,6 +726,17 @@ void NeighborList::addExclusionsFromBonds()
     {
     std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
 
+    if (m_topology_exclusions)
+        {
+        // the exclusions are derived from the local bonds in buildLocalExclusions()
+        m_topology_ex_flags |= exclude_bonds;
+        m_ex_cache_dirty = true;
+        if (bond_data->getNGlobal())
+            m_exclusions_set = true;
+        forceUpdate();
+        return;
+        }
+
     // access bond data by snapshot
     BondData::Snapshot snapshot;
     bond_data->takeSnapshot(snapshot);
@@ -789,6 +771,17 @@ void NeighborList::addExclusionsFromAngles()
     {
     std::shared_ptr<AngleData> angle_data = m_sysdef->getAngleData();
 
+    if (m_topology_exclusions)
+        {
+        // the exclusions are derived from the local angles in buildLocalExclusions()
+        m_topology_ex_flags |= exclude_angles;
+        m_ex_cache_dirty = true;
+        if (angle_data->getNGlobal())
+            m_exclusions_set = true;
+        forceUpdate();
+        return;
+        }
+
     // access angle data by snapshot
     AngleData::Snapshot snapshot;
     angle_data->takeSnapshot(snapshot);
@@ -822,6 +815,17 @@ void NeighborList::addExclusionsFromDihedrals()
     {
     std::shared_ptr<DihedralData> dihedral_data = m_sysdef->getDihedralData();
 
+    if (m_topology_exclusions)
+        {
+        // the exclusions are derived from the local dihedrals in buildLocalExclusions()
+        m_topology_ex_flags |= exclude_dihedrals;
+        m_ex_cache_dirty = true;
+        if (dihedral_data->getNGlobal())
+            m_exclusions_set = true;
+        forceUpdate();
+        return;
+        }
+
     // access dihedral data by snapshot
     DihedralData::Snapshot snapshot;
     dihedral_data->takeSnapshot(snapshot);
@@ -855,6 +859,17 @@ void NeighborList::addExclusionsFromConstraints()
     {
     std::shared_ptr<ConstraintData> constraint_data = m_sysdef->getConstraintData();
 
+    if (m_topology_exclusions)
+        {
+        // the exclusions are derived from the local constraints in buildLocalExclusions()
+        m_topology_ex_flags |= exclude_constraints;
+        m_ex_cache_dirty = true;
+        if (constraint_data->getNGlobal())
+            m_exclusions_set = true;
+        forceUpdate();
+        return;
+        }
+
     // access constraint data by snapshot
     ConstraintData::Snapshot snapshot;
     constraint_data->takeSnapshot(snapshot);
@@ -889,6 +904,17 @@ void NeighborList::addExclusionsFromPairs()
     {
     std::shared_ptr<PairData> pair_data = m_sysdef->getPairData();
 
+    if (m_topology_exclusions)
+        {
+        // the exclusions are derived from the local pairs in buildLocalExclusions()
+        m_topology_ex_flags |= exclude_pairs;
+        m_ex_cache_dirty = true;
+        if (pair_data->getNGlobal())
+            m_exclusions_set = true;
+        forceUpdate();
+        return;
+        }
+
     // access pair data by snapshot
     PairData::Snapshot snapshot;
     pair_data->takeSnapshot(snapshot);
@@ -919,6 +945,7 @@ void NeighborList::addExclusionsFromPairs()
 /*! \param tag1 First particle tag in the pair
     \param tag2 Second particle tag in the pair
     \return true if the particles \a tag1 and \a tag2 have been excluded from the neighbor list
+    \note Exclusions derived from the local topology (setTopologyExclusions()) are not included.
 */
 bool NeighborList::isExcluded(unsigned int tag1, unsigned int tag2)
     {
@@ -927,17 +954,18 @@ bool NeighborList::isExcluded(unsigned int tag1, unsigned int tag2)
     assert(tag1 <= m_pdata->getMaximumTag());
     assert(tag2 <= m_pdata->getMaximumTag());
 
-    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::read);
+    mergeExclusionTags();
 
-    unsigned int n_ex = h_n_ex_tag.data[tag1];
-    for (unsigned int i = 0; i < n_ex; i++)
-        {
-        if (h_ex_list_tag.data[m_ex_list_indexer_tag(tag1,i)] == tag2)
-            return true;
-        }
+    if (tag1 + 1 >= m_ex_tag_head.size())
+        return false;
+
+    ArrayHandle<unsigned int> h_ex_tag_head(m_ex_tag_head, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ex_tag_list(m_ex_tag_list, access_location::host, access_mode::read);
 
-    return false;
+    // the excluded tags are sorted
+    return std::binary_search(h_ex_tag_list.data + h_ex_tag_head.data[tag1],
+                              h_ex_tag_list.data + h_ex_tag_head.data[tag1+1],
+                              tag2);
     }
 
 /*! Add topologically derived exclusions for angles
@@ -950,7 +978,7 @@ bool NeighborList::isExcluded(unsigned int tag1, unsigned int tag2)
 void NeighborList::addOneThreeExclusionsFromTopology()
     {
     std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = m_pdata->getRTags().size();
+    const unsigned int myNAtoms = m_pdata->getRTagSize();
     const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
     const unsigned int nBonds = bond_data->getNGlobal();
 
@@ -1029,7 +1057,7 @@ void NeighborList::addOneThreeExclusionsFromTopology()
 void NeighborList::addOneFourExclusionsFromTopology()
     {
     std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = m_pdata->getRTags().size();
+    const unsigned int myNAtoms = m_pdata->getRTagSize();
     const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
     const unsigned int nBonds = bond_data->getNGlobal();
 
@@ -1173,12 +1201,15 @@ bool NeighborList::distanceCheck(unsigned int timestep)
         // check if migrate criterion is fulfilled on any rank
         int local_result = result ? 1 : 0;
         int global_result = 0;
-        MPI_Allreduce(&local_result,
-            &global_result,
-            1,
-            MPI_INT,
-            MPI_MAX,
-            m_exec_conf->getMPICommunicator());
+            {
+            CollectiveTimer timer(m_comm);
+            MPI_Allreduce(&local_result,
+                &global_result,
+                1,
+                MPI_INT,
+                MPI_MAX,
+                m_exec_conf->getMPICommunicator());
+            }
         result = (global_result > 0);
         if (m_prof) m_prof->pop();
         }
@@ -1380,7 +1411,245 @@ void NeighborList::buildNlist(unsigned int timestep)
     throw runtime_error("Error updating neighborlist bins");
     }
 
-/*! Translates the exclusions set in \c m_n_ex_tag and \c m_ex_list_tag to indices in \c m_n_ex_idx and \c m_ex_list_idx
+/*! Merges the pairs in \c m_ex_tag_pending into the exclusion list by tag, and removes duplicates
+*/
+void NeighborList::mergeExclusionTags()
+    {
+    if (m_ex_tag_pending.empty())
+        return;
+
+    std::vector<uint2> pairs;
+    pairs.swap(m_ex_tag_pending);
+
+        {
+        // add the exclusions already in the list
+        ArrayHandle<unsigned int> h_ex_tag_head(m_ex_tag_head, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ex_tag_list(m_ex_tag_list, access_location::host, access_mode::read);
+
+        const unsigned int n_tags = m_ex_tag_head.size() ? m_ex_tag_head.size() - 1 : 0;
+        for (unsigned int tag = 0; tag < n_tags; ++tag)
+            for (unsigned int k = h_ex_tag_head.data[tag]; k < h_ex_tag_head.data[tag+1]; ++k)
+                pairs.push_back(make_uint2(tag, h_ex_tag_list.data[k]));
+        }
+
+    std::sort(pairs.begin(), pairs.end(), [](const uint2& a, const uint2& b)
+        {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), [](const uint2& a, const uint2& b)
+        {
+        return a.x == b.x && a.y == b.y;
+        }), pairs.end());
+
+    // the list is only as long as the largest excluded tag
+    const unsigned int n_tags = pairs.back().x + 1;
+    m_ex_tag_head.resize(n_tags + 1);
+    m_ex_tag_list.resize(pairs.size());
+
+    ArrayHandle<unsigned int> h_ex_tag_head(m_ex_tag_head, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_ex_tag_list(m_ex_tag_list, access_location::host, access_mode::overwrite);
+
+    memset(h_ex_tag_head.data, 0, sizeof(unsigned int)*(n_tags + 1));
+    for (unsigned int i = 0; i < pairs.size(); ++i)
+        {
+        h_ex_tag_head.data[pairs[i].x + 1]++;
+        h_ex_tag_list.data[i] = pairs[i].y;
+        }
+
+    m_ex_tag_max = 0;
+    for (unsigned int tag = 0; tag < n_tags; ++tag)
+        {
+        m_ex_tag_max = std::max(m_ex_tag_max, h_ex_tag_head.data[tag+1]);
+        h_ex_tag_head.data[tag+1] += h_ex_tag_head.data[tag];
+        }
+    }
+
+//! Append the excluded tags of the local particles in bonded groups
+/*! \param group_data The bonded groups
+    \param a Position of the first excluded particle in a group
+    \param b Position of the second excluded particle in a group
+    \param h_rtag Reverse-lookup tags
+    \param N Number of local particles
+    \param pairs List of (local index, excluded tag) pairs to append to
+*/
+template<class group_data_t>
+static void appendGroupExclusions(std::shared_ptr<group_data_t> group_data,
+                                  unsigned int a,
+                                  unsigned int b,
+                                  const RTagHandle& h_rtag,
+                                  unsigned int N,
+                                  std::vector<uint2>& pairs)
+    {
+    ArrayHandle<typename group_data_t::members_t> h_groups(group_data->getMembersArray(),
+        access_location::host, access_mode::read);
+
+    // ghost groups are included, the excluded particles of a local group are not necessarily local
+    const unsigned int n_groups = group_data->getN() + group_data->getNGhosts();
+    for (unsigned int group_idx = 0; group_idx < n_groups; ++group_idx)
+        {
+        const unsigned int tag_a = h_groups.data[group_idx].tag[a];
+        const unsigned int tag_b = h_groups.data[group_idx].tag[b];
+
+        const unsigned int idx_a = h_rtag[tag_a];
+        if (idx_a < N)
+            pairs.push_back(make_uint2(idx_a, tag_b));
+
+        const unsigned int idx_b = h_rtag[tag_b];
+        if (idx_b < N)
+            pairs.push_back(make_uint2(idx_b, tag_a));
+        }
+    }
+
+/*! Collects the excluded tags of every local particle from the exclusion list by tag and from the bonded groups
+    selected with setTopologyExclusions() in \c m_ex_local_head and \c m_ex_local_tag. The excluded tags of every
+    particle are sorted and unique.
+
+    The result is cached by particle tag. As long as no exclusions are added or removed, no bonded groups are added
+    or removed, and the cache holds every local particle, a new local order (e.g. after a particle sort) is served
+    from the cache without scanning the bonded groups.
+*/
+void NeighborList::buildLocalExclusions()
+    {
+    const unsigned int N = m_pdata->getN();
+
+    if (!m_exclusions_set)
+        {
+        m_ex_local_head.assign(N + 1, 0);
+        m_ex_local_tag.clear();
+        return;
+        }
+
+    if (!m_ex_cache_dirty && mapCachedExclusions())
+        return;
+
+    mergeExclusionTags();
+
+    // (local index, excluded tag) pairs
+    std::vector<uint2> pairs;
+
+        {
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ex_tag_head(m_ex_tag_head, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_ex_tag_list(m_ex_tag_list, access_location::host, access_mode::read);
+
+        const unsigned int n_tags = m_ex_tag_head.size() ? m_ex_tag_head.size() - 1 : 0;
+        for (unsigned int idx = 0; idx < N; ++idx)
+            {
+            const unsigned int tag = h_tag.data[idx];
+            if (tag >= n_tags)
+                continue;
+
+            for (unsigned int k = h_ex_tag_head.data[tag]; k < h_ex_tag_head.data[tag+1]; ++k)
+                pairs.push_back(make_uint2(idx, h_ex_tag_list.data[k]));
+            }
+        }
+
+    if (m_topology_ex_flags)
+        {
+        RTagHandle h_rtag(*m_pdata, access_mode::read);
+
+        if (m_topology_ex_flags & exclude_bonds)
+            appendGroupExclusions(m_sysdef->getBondData(), 0, 1, h_rtag, N, pairs);
+        if (m_topology_ex_flags & exclude_angles)
+            appendGroupExclusions(m_sysdef->getAngleData(), 0, 2, h_rtag, N, pairs);
+        if (m_topology_ex_flags & exclude_dihedrals)
+            appendGroupExclusions(m_sysdef->getDihedralData(), 0, 3, h_rtag, N, pairs);
+        if (m_topology_ex_flags & exclude_constraints)
+            appendGroupExclusions(m_sysdef->getConstraintData(), 0, 1, h_rtag, N, pairs);
+        if (m_topology_ex_flags & exclude_pairs)
+            appendGroupExclusions(m_sysdef->getPairData(), 0, 1, h_rtag, N, pairs);
+        }
+
+    // counting sort by local index
+    m_ex_local_head.assign(N + 1, 0);
+    for (unsigned int i = 0; i < pairs.size(); ++i)
+        m_ex_local_head[pairs[i].x + 1]++;
+    for (unsigned int idx = 0; idx < N; ++idx)
+        m_ex_local_head[idx+1] += m_ex_local_head[idx];
+
+    m_ex_local_tag.resize(pairs.size());
+        {
+        std::vector<unsigned int> fill(m_ex_local_head.begin(), m_ex_local_head.end() - 1);
+        for (unsigned int i = 0; i < pairs.size(); ++i)
+            m_ex_local_tag[fill[pairs[i].x]++] = pairs[i].y;
+        }
+
+    // sort the excluded tags of every particle, and remove duplicates
+    unsigned int n_out = 0;
+    for (unsigned int idx = 0; idx < N; ++idx)
+        {
+        const unsigned int begin = m_ex_local_head[idx];
+        const unsigned int end = m_ex_local_head[idx+1];
+        std::sort(m_ex_local_tag.begin() + begin, m_ex_local_tag.begin() + end);
+
+        m_ex_local_head[idx] = n_out;
+        for (unsigned int k = begin; k < end; ++k)
+            {
+            const unsigned int ex_tag = m_ex_local_tag[k];
+            if (n_out == m_ex_local_head[idx] || m_ex_local_tag[n_out-1] != ex_tag)
+                m_ex_local_tag[n_out++] = ex_tag;
+            }
+        }
+    m_ex_local_head[N] = n_out;
+    m_ex_local_tag.resize(n_out);
+
+    // cache the exclusions ordered by tag
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    std::vector<unsigned int> order(N);
+    for (unsigned int idx = 0; idx < N; ++idx)
+        order[idx] = idx;
+    std::sort(order.begin(), order.end(),
+        [&h_tag](unsigned int i, unsigned int j) { return h_tag.data[i] < h_tag.data[j]; });
+
+    m_ex_cache_tag.resize(N);
+    m_ex_cache_head.resize(N + 1);
+    m_ex_cache_list.resize(n_out);
+    m_ex_cache_head[0] = 0;
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        const unsigned int idx = order[i];
+        m_ex_cache_tag[i] = h_tag.data[idx];
+        m_ex_cache_head[i+1] = m_ex_cache_head[i] + (m_ex_local_head[idx+1] - m_ex_local_head[idx]);
+        std::copy(m_ex_local_tag.begin() + m_ex_local_head[idx], m_ex_local_tag.begin() + m_ex_local_head[idx+1],
+                  m_ex_cache_list.begin() + m_ex_cache_head[i]);
+        }
+
+    m_ex_cache_dirty = false;
+    }
+
+/*! Fills \c m_ex_local_head and \c m_ex_local_tag in the current local order from the exclusions cached by
+    buildLocalExclusions().
+
+    \returns false if a local particle is not in the cache
+*/
+bool NeighborList::mapCachedExclusions()
+    {
+    const unsigned int N = m_pdata->getN();
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    m_ex_local_head.resize(N + 1);
+    m_ex_local_tag.clear();
+    m_ex_local_head[0] = 0;
+    for (unsigned int idx = 0; idx < N; ++idx)
+        {
+        const unsigned int tag = h_tag.data[idx];
+        std::vector<unsigned int>::const_iterator it
+            = std::lower_bound(m_ex_cache_tag.begin(), m_ex_cache_tag.end(), tag);
+        if (it == m_ex_cache_tag.end() || *it != tag)
+            return false;
+
+        const unsigned int i = it - m_ex_cache_tag.begin();
+        m_ex_local_tag.insert(m_ex_local_tag.end(), m_ex_cache_list.begin() + m_ex_cache_head[i],
+                              m_ex_cache_list.begin() + m_ex_cache_head[i+1]);
+        m_ex_local_head[idx+1] = m_ex_local_tag.size();
+        }
+
+    return true;
+    }
+
+/*! Translates the excluded tags of the local particles (buildLocalExclusions()) to indices in \c m_n_ex_idx and
+    \c m_ex_list_idx
 */
 void NeighborList::updateExListIdx()
     {
@@ -1389,30 +1658,34 @@ void NeighborList::updateExListIdx()
     if (m_prof)
         m_prof->push("update-ex");
 
+    buildLocalExclusions();
+
+    // make room for the particle with the most exclusions
+    const unsigned int N = m_pdata->getN();
+    unsigned int max_n_ex = 0;
+    for (unsigned int idx = 0; idx < N; idx++)
+        max_n_ex = std::max(max_n_ex, m_ex_local_head[idx+1] - m_ex_local_head[idx]);
+    growExclusionList(max_n_ex);
+
     // access data
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    RTagHandle h_rtag(*m_pdata, access_mode::read);
 
-    ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_n_ex_idx(m_n_ex_idx, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_ex_list_idx(m_ex_list_idx, access_location::host, access_mode::overwrite);
 
     // translate the number and exclusions from one array to the other
-    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+    for (unsigned int idx = 0; idx < N; idx++)
         {
-        // get the tag for this index
-        unsigned int tag = h_tag.data[idx];
-
         // copy the number of exclusions over
-        unsigned int n = h_n_ex_tag.data[tag];
+        const unsigned int head = m_ex_local_head[idx];
+        const unsigned int n = m_ex_local_head[idx+1] - head;
         h_n_ex_idx.data[idx] = n;
 
         // construct the exclusion list
         for (unsigned int offset = 0; offset < n; offset++)
             {
-            unsigned int ex_tag = h_ex_list_tag.data[m_ex_list_indexer_tag(tag,offset)];
-            unsigned int ex_idx = h_rtag.data[ex_tag];
+            unsigned int ex_tag = m_ex_local_tag[head + offset];
+            unsigned int ex_idx = h_rtag[ex_tag];
 
             // store excluded particle idx
             h_ex_list_idx.data[m_ex_list_indexer(idx, offset)] = ex_idx;
@@ -1437,6 +1710,10 @@ void NeighborList::filterNlist()
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
 
+    // m_ex_mark[j] == idx marks particle j as excluded from the list of particle idx, so that every neighbor is
+    // tested in constant time
+    m_ex_mark.assign(m_pdata->getN() + m_pdata->getNGhosts(), NOT_LOCAL);
+
     // for each particle's neighbor list
     for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
         {
@@ -1445,25 +1722,20 @@ void NeighborList::filterNlist()
         unsigned int n_ex = h_n_ex_idx.data[idx];
         unsigned int new_n_neigh = 0;
 
+        for (unsigned int cur_ex_idx = 0; cur_ex_idx < n_ex; cur_ex_idx++)
+            {
+            unsigned int cur_ex = h_ex_list_idx.data[m_ex_list_indexer(idx, cur_ex_idx)];
+            if (cur_ex < m_ex_mark.size())
+                m_ex_mark[cur_ex] = idx;
+            }
+
         // loop over the list, regenerating it as we go
         for (unsigned int cur_neigh_idx = 0; cur_neigh_idx < n_neigh; cur_neigh_idx++)
             {
             unsigned int cur_neigh = h_nlist.data[myHead + cur_neigh_idx];
 
-            // test if excluded
-            bool excluded = false;
-            for (unsigned int cur_ex_idx = 0; cur_ex_idx < n_ex; cur_ex_idx++)
-                {
-                unsigned int cur_ex = h_ex_list_idx.data[m_ex_list_indexer(idx, cur_ex_idx)];
-                if (cur_ex == cur_neigh)
-                    {
-                    excluded = true;
-                    break;
-                    }
-                }
-
             // add it back to the list if it is not excluded
-            if (!excluded)
+            if (m_ex_mark[cur_neigh] != idx)
                 {
                 h_nlist.data[myHead + new_n_neigh] = cur_neigh;
                 new_n_neigh++;
@@ -1566,18 +1838,67 @@ void NeighborList::resetConditions()
     memset(h_conditions.data, 0, sizeof(unsigned int)*m_pdata->getNTypes());
     }
 
-void NeighborList::growExclusionList()
+/*! \param n_ex Number of exclusions the list should hold for every particle
+*/
+void NeighborList::growExclusionList(unsigned int n_ex)
     {
-    unsigned int new_height = m_ex_list_indexer.getH() + 1;
+    if (n_ex <= m_ex_list_indexer.getH())
+        return;
+
+    m_ex_list_idx.resize(m_pdata->getMaxN(), n_ex);
+
+    // update the indexer
+    m_ex_list_indexer = Index2D(m_ex_list_idx.getPitch(), n_ex);
+    }
 
-    m_ex_list_tag.resize(m_pdata->getRTags().size(), new_height);
-    m_ex_list_idx.resize(m_pdata->getMaxN(), new_height);
+/*! \param topology_exclusions True if the exclusions of bonded groups should be derived from the local topology
 
-    // update the indexers
-    m_ex_list_indexer = Index2D(m_ex_list_idx.getPitch(), new_height);
-    m_ex_list_indexer_tag = Index2D(m_ex_list_tag.getPitch(), new_height);
+    This setting applies to the exclusions that are added afterwards with addExclusionsFromBonds(),
+    addExclusionsFromAngles(), addExclusionsFromDihedrals(), addExclusionsFromConstraints() and
+    addExclusionsFromPairs().
+*/
+void NeighborList::setTopologyExclusions(bool topology_exclusions)
+    {
+    if (topology_exclusions == m_topology_exclusions)
+        return;
+
+    connectTopologySignals(topology_exclusions);
+    m_topology_exclusions = topology_exclusions;
+    if (!m_topology_exclusions)
+        m_topology_ex_flags = 0;
+    m_ex_cache_dirty = true;
+    forceUpdate();
+    }
 
-    // we didn't copy data for the new idx list, force an update so it will be correct
+/*! \param connect True to connect to the signals, false to disconnect
+*/
+void NeighborList::connectTopologySignals(bool connect)
+    {
+    if (connect)
+        {
+        m_sysdef->getBondData()->getGroupNumChangeSignal().connect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getAngleData()->getGroupNumChangeSignal().connect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getDihedralData()->getGroupNumChangeSignal().connect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getConstraintData()->getGroupNumChangeSignal().connect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getPairData()->getGroupNumChangeSignal().connect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        }
+    else
+        {
+        m_sysdef->getBondData()->getGroupNumChangeSignal().disconnect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getAngleData()->getGroupNumChangeSignal().disconnect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getDihedralData()->getGroupNumChangeSignal().disconnect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getConstraintData()->getGroupNumChangeSignal().disconnect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        m_sysdef->getPairData()->getGroupNumChangeSignal().disconnect<NeighborList, &NeighborList::slotGroupNumChange>(this);
+        }
+    }
+
+/*! Groups that are added later are excluded as well, so exclusions may need to be turned on.
+*/
+void NeighborList::slotGroupNumChange()
+    {
+    if (m_topology_ex_flags)
+        m_exclusions_set = true;
+    m_ex_cache_dirty = true;
     forceUpdate();
     }
 
@@ -1688,6 +2009,8 @@ void export_NeighborList(py::module& m)
         .def("addExclusionsFromPairs", &NeighborList::addExclusionsFromPairs)
         .def("addOneThreeExclusionsFromTopology", &NeighborList::addOneThreeExclusionsFromTopology)
         .def("addOneFourExclusionsFromTopology", &NeighborList::addOneFourExclusionsFromTopology)
+        .def("setTopologyExclusions", &NeighborList::setTopologyExclusions)
+        .def("getTopologyExclusions", &NeighborList::getTopologyExclusions)
         .def("setFilterBody", &NeighborList::setFilterBody)
         .def("getFilterBody", &NeighborList::getFilterBody)
         .def("setDiameterShift", &NeighborList::setDiameterShift)
@@ -99,6 +99,17 @@
     through the neighbor list and removes any particles that are excluded. This allows an arbitrary number of exclusions
     to be processed without slowing the performance of the buildNlist() step itself.
 
+    The exclusions by tag are kept in compressed sparse row format (\a m_ex_tag_head, \a m_ex_tag_list), sorted by tag
+    and without duplicates. New exclusions are collected in a list of pending pairs and merged into the table the next
+    time it is needed, so that adding many exclusions is quasi-linear in their number. The table is only as long as the
+    largest excluded tag, and takes no memory when only bonded exclusions are used with setTopologyExclusions().
+
+    With setTopologyExclusions(), the exclusions of bonds, angles, dihedrals, constraints and special pairs are not
+    stored by tag at all. Instead, they are derived from the bonded groups of the local particles whenever the
+    exclusion list by index is updated. Since the bonded groups are distributed with the particles, the memory
+    needed for these exclusions is proportional to the number of local particles, and groups added or removed later
+    are excluded automatically.
+
     <b>Overflow handling:</b>
     For easy support of derived GPU classes to implement overflow detection the overflow condition is stored in the
     GlobalArray \a d_conditions.
@@ -326,6 +337,15 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Add an exclusion for every 1,4 pair
         void addOneFourExclusionsFromTopology();
 
+        //! Derive the exclusions of bonded groups from the local topology
+        void setTopologyExclusions(bool topology_exclusions);
+
+        //! Test if exclusions of bonded groups are derived from the local topology
+        bool getTopologyExclusions() const
+            {
+            return m_topology_exclusions;
+            }
+
         //! Enable/disable body filtering
         virtual void setFilterBody(bool filter_body)
             {
@@ -430,6 +450,14 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_updates + m_forced_updates;
             }
 
+        //! Get the number of times the list has actually been built
+        /*! Unlike getNumUpdates(), this also counts builds forced after the update check at the same time step.
+        */
+        unsigned int getNumBuilds() const
+            {
+            return m_num_builds;
+            }
+
 
 #ifdef ENABLE_MPI
         //! Set the communicator to use
@@ -481,15 +509,36 @@ class PYBIND11_EXPORT NeighborList : public Compute
         GlobalArray<unsigned int> m_Nmax;          //!< Holds the maximum number of neighbors for each particle type
         GlobalArray<unsigned int> m_conditions;    //!< Holds the max number of computed particles by type for resizing
 
-        GlobalArray<unsigned int> m_ex_list_tag;  //!< List of excluded particles referenced by tag
+        GlobalVector<unsigned int> m_ex_tag_head; //!< Offset of the exclusions of every tag in m_ex_tag_list
+        GlobalVector<unsigned int> m_ex_tag_list; //!< Excluded tags, sorted per tag
+        std::vector<uint2> m_ex_tag_pending;      //!< Excluded pairs of tags not yet merged into m_ex_tag_list
+        unsigned int m_ex_tag_max;                //!< Maximum number of exclusions of any tag in m_ex_tag_list
         GlobalArray<unsigned int> m_ex_list_idx;  //!< List of excluded particles referenced by index
-        GlobalVector<unsigned int> m_n_ex_tag;    //!< Number of exclusions for a given particle tag
         GlobalArray<unsigned int> m_n_ex_idx;     //!< Number of exclusions for a given particle index
         Index2D m_ex_list_indexer;             //!< Indexer for accessing the exclusion list
-        Index2D m_ex_list_indexer_tag;         //!< Indexer for accessing the by-tag exclusion list
         bool m_exclusions_set;                 //!< True if any exclusions have been set
         bool m_need_reallocate_exlist;         //!< True if global exclusion list needs to be reallocated
 
+        //! Bonded groups whose exclusions are derived from the local topology
+        enum topologyExclusion
+            {
+            exclude_bonds = 1,
+            exclude_angles = 2,
+            exclude_dihedrals = 4,
+            exclude_constraints = 8,
+            exclude_pairs = 16
+            };
+
+        bool m_topology_exclusions;            //!< True if exclusions of bonded groups are derived from the topology
+        unsigned int m_topology_ex_flags;      //!< Combination of topologyExclusion flags
+        std::vector<unsigned int> m_ex_local_head;  //!< Offset of the exclusions of every local particle
+        std::vector<unsigned int> m_ex_local_tag;   //!< Excluded tags of the local particles
+        std::vector<unsigned int> m_ex_cache_tag;   //!< Sorted tags of the particles in the exclusion cache
+        std::vector<unsigned int> m_ex_cache_head;  //!< Offset of the cached exclusions of every tag
+        std::vector<unsigned int> m_ex_cache_list;  //!< Cached excluded tags
+        bool m_ex_cache_dirty;                      //!< True if the exclusion cache needs to be rebuilt
+        std::vector<unsigned int> m_ex_mark;        //!< Particle that last excluded a particle index, in filterNlist()
+
         //! Return true if we are supposed to do a distance check in this time step
         bool shouldCheckDistance(unsigned int timestep);
 
@@ -505,6 +554,18 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Updates the idx exclusion list
         virtual void updateExListIdx();
 
+        //! Merge the pending exclusions into the exclusion list by tag
+        void mergeExclusionTags();
+
+        //! Collect the excluded tags of every local particle
+        void buildLocalExclusions();
+
+        //! Collect the excluded tags of every local particle from the cache
+        bool mapCachedExclusions();
+
+        //! Grow the exclusion list by index to hold a given number of exclusions per particle
+        void growExclusionList(unsigned int n_ex);
+
         //! Loops through all pairs, and updates the r_list(i,j)
         void updateRList();
 
@@ -558,6 +619,7 @@ class PYBIND11_EXPORT NeighborList : public Compute
         bool m_force_update;            //!< Flag to handle the forcing of neighborlist updates
         bool m_dist_check;              //!< Set to false to disable distance checks (nlist always built m_every steps)
         bool m_has_been_updated_once;   //!< True if the neighbor list has been updated at least once
+        unsigned int m_num_builds;      //!< Number of times the neighbor list has been built
 
         unsigned int m_last_updated_tstep; //!< Track the last time step we were updated
         unsigned int m_last_checked_tstep; //!< Track the last time step we have checked
@@ -580,15 +642,19 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Resets the condition status to all zeroes
         virtual void resetConditions();
 
-        //! Grow the exclusions list memory capacity by one row
-        void growExclusionList();
-
         //! Method to be called when the global particle number changes
         void slotGlobalParticleNumberChange()
             {
             m_need_reallocate_exlist = true;
+            m_ex_cache_dirty = true;
             }
 
+        //! Method to be called when bonded groups are added or removed
+        void slotGroupNumChange();
+
+        //! Connect to or disconnect from the signals of the bonded group data
+        void connectTopologySignals(bool connect);
+
         #ifdef ENABLE_CUDA
         GPUPartition m_last_gpu_partition; //!< The partition at the time of the last memory hints
         #endif
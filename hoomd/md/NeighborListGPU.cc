@@ -182,22 +182,32 @@ void NeighborListGPU::updateExListIdx()
     {
     assert(! m_need_reallocate_exlist);
 
+    // the exclusions of bonded groups are collected from the local topology on the host
+    if (m_topology_ex_flags)
+        {
+        NeighborList::updateExListIdx();
+        return;
+        }
+
     if (m_prof)
         m_prof->push(m_exec_conf,"update-ex");
 
+    mergeExclusionTags();
+    growExclusionList(m_ex_tag_max);
+
     ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
 
-    ArrayHandle<unsigned int> d_n_ex_tag(m_n_ex_tag, access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_ex_list_tag(m_ex_list_tag, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_ex_tag_head(m_ex_tag_head, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_ex_tag_list(m_ex_tag_list, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_n_ex_idx(m_n_ex_idx, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_ex_list_idx(m_ex_list_idx, access_location::device, access_mode::overwrite);
 
     gpu_update_exclusion_list(d_tag.data,
                               d_rtag.data,
-                              d_n_ex_tag.data,
-                              d_ex_list_tag.data,
-                              m_ex_list_indexer_tag,
+                              d_ex_tag_head.data,
+                              d_ex_tag_list.data,
+                              m_ex_tag_head.size() ? m_ex_tag_head.size() - 1 : 0,
                               d_n_ex_idx.data,
                               d_ex_list_idx.data,
                               m_ex_list_indexer,
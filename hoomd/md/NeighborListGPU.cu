@@ -266,9 +266,9 @@ cudaError_t gpu_nlist_filter(unsigned int *d_n_neigh,
 //! GPU kernel to update the exclusions list
 __global__ void gpu_update_exclusion_list_kernel(const unsigned int *tags,
                                                   const unsigned int *rtags,
-                                                  const unsigned int *n_ex_tag,
-                                                  const unsigned int *ex_list_tag,
-                                                  const Index2D ex_list_tag_indexer,
+                                                  const unsigned int *ex_tag_head,
+                                                  const unsigned int *ex_tag_list,
+                                                  const unsigned int n_ex_tags,
                                                   unsigned int *n_ex_idx,
                                                   unsigned int *ex_list_idx,
                                                   const Index2D ex_list_indexer,
@@ -281,14 +281,21 @@ __global__ void gpu_update_exclusion_list_kernel(const unsigned int *tags,
 
     unsigned int tag = tags[idx];
 
-    unsigned int n = n_ex_tag[tag];
+    // the exclusion list by tag ends at the largest excluded tag
+    unsigned int head = 0;
+    unsigned int n = 0;
+    if (tag < n_ex_tags)
+        {
+        head = ex_tag_head[tag];
+        n = ex_tag_head[tag+1] - head;
+        }
 
     // copy over number of exclusions
     n_ex_idx[idx] = n;
 
     for (unsigned int offset = 0; offset < n; offset++)
         {
-        unsigned int ex_tag = ex_list_tag[ex_list_tag_indexer(tag, offset)];
+        unsigned int ex_tag = ex_tag_list[head + offset];
         unsigned int ex_idx = rtags[ex_tag];
 
         ex_list_idx[ex_list_indexer(idx, offset)] = ex_idx;
@@ -299,9 +306,9 @@ __global__ void gpu_update_exclusion_list_kernel(const unsigned int *tags,
 //! GPU function to update the exclusion list on the device
 /*! \param d_tag Array of particle tags
     \param d_rtag Array of reverse-lookup tag->idx
-    \param d_n_ex_tag List of number of exclusions per tag
-    \param d_ex_list_tag 2D Exclusion list per tag
-    \param ex_list_tag_indexer Indexer for per-tag exclusion list
+    \param d_ex_tag_head Offset of the exclusions of every tag in \a d_ex_tag_list
+    \param d_ex_tag_list Excluded tags, sorted per tag
+    \param n_ex_tags Number of tags in \a d_ex_tag_head
     \param d_n_ex_idx List of number of exclusions per idx
     \param d_ex_list_idx Exclusion list per idx
     \param ex_list_indexer Indexer for per-idx exclusion list
@@ -309,9 +316,9 @@ __global__ void gpu_update_exclusion_list_kernel(const unsigned int *tags,
  */
 cudaError_t gpu_update_exclusion_list(const unsigned int *d_tag,
                                 const unsigned int *d_rtag,
-                                const unsigned int *d_n_ex_tag,
-                                const unsigned int *d_ex_list_tag,
-                                const Index2D& ex_list_tag_indexer,
+                                const unsigned int *d_ex_tag_head,
+                                const unsigned int *d_ex_tag_list,
+                                const unsigned int n_ex_tags,
                                 unsigned int *d_n_ex_idx,
                                 unsigned int *d_ex_list_idx,
                                 const Index2D& ex_list_indexer,
@@ -321,9 +328,9 @@ cudaError_t gpu_update_exclusion_list(const unsigned int *d_tag,
 
     gpu_update_exclusion_list_kernel<<<N/block_size + 1, block_size>>>(d_tag,
                                                                        d_rtag,
-                                                                       d_n_ex_tag,
-                                                                       d_ex_list_tag,
-                                                                       ex_list_tag_indexer,
+                                                                       d_ex_tag_head,
+                                                                       d_ex_tag_list,
+                                                                       n_ex_tags,
                                                                        d_n_ex_idx,
                                                                        d_ex_list_idx,
                                                                        ex_list_indexer,
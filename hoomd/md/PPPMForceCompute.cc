@@ -4,6 +4,14 @@
 #include "PPPMForceCompute.h"
 #include <map>
 
+#ifdef ENABLE_MPI
+#include "hoomd/Communicator.h"
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 namespace py = pybind11;
 
 bool is_pow2(unsigned int n)
@@ -147,8 +155,7 @@ PPPMForceCompute::~PPPMForceCompute()
 
     if (m_kiss_fft_initialized)
         {
-        free(m_kiss_fft);
-        free(m_kiss_ifft);
+        m_real_fft.reset();
         kiss_fft_cleanup();
         }
     #ifdef ENABLE_MPI
@@ -307,6 +314,8 @@ void PPPMForceCompute::setupCoeffs()
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce sum
         MPI_Allreduce(MPI_IN_PLACE,
                       &m_q,
@@ -469,6 +478,14 @@ void PPPMForceCompute::initializeFFT()
         pidx[1] = pcoord.y;
         pidx[2] = pcoord.x;
         int row_m = 0; /* both local grid and proc grid are row major, no transposition necessary */
+
+        // parameters may have been changed, release the previous plans
+        if (m_dfft_initialized)
+            {
+            dfft_destroy_plan(m_dfft_plan_forward);
+            dfft_destroy_plan(m_dfft_plan_inverse);
+            }
+
         ArrayHandle<unsigned int> h_cart_ranks(m_pdata->getDomainDecomposition()->getCartRanks(),
             access_location::host, access_mode::read);
         dfft_create_plan(&m_dfft_plan_forward, 3, gdim, embed, NULL, pdim, pidx,
@@ -479,47 +496,63 @@ void PPPMForceCompute::initializeFFT()
         }
     #endif // ENABLE_MPI
 
+    // number of elements in (the stored part of) the transformed mesh
+    unsigned int n_fourier_cells = m_n_inner_cells;
+
     if (local_fft)
         {
-        int dims[3];
-        dims[0] = m_mesh_points.z;
-        dims[1] = m_mesh_points.y;
-        dims[2] = m_mesh_points.x;
-
-        m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
-        m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
+        // the local transform takes advantage of the real charge density and only stores half of the spectrum
+        m_real_fft = std::unique_ptr<RealFFT3D>(new RealFFT3D(m_mesh_points.x, m_mesh_points.y, m_mesh_points.z));
+        n_fourier_cells = m_real_fft->getNumComplexElements();
 
         m_kiss_fft_initialized = true;
+
+        // allocate real meshes
+        GlobalArray<kiss_fft_scalar> real_mesh(m_n_cells, m_exec_conf);
+        m_real_mesh.swap(real_mesh);
+
+        GlobalArray<kiss_fft_scalar> inv_real_mesh_x(m_n_cells, m_exec_conf);
+        m_inv_real_mesh_x.swap(inv_real_mesh_x);
+
+        GlobalArray<kiss_fft_scalar> inv_real_mesh_y(m_n_cells, m_exec_conf);
+        m_inv_real_mesh_y.swap(inv_real_mesh_y);
+
+        GlobalArray<kiss_fft_scalar> inv_real_mesh_z(m_n_cells, m_exec_conf);
+        m_inv_real_mesh_z.swap(inv_real_mesh_z);
         }
+    else
+        {
+        // allocate complex meshes for the distributed FFT
 
-    // allocate mesh and transformed mesh
+        // pad with offset
+        GlobalArray<kiss_fft_cpx> mesh(m_n_cells + m_ghost_offset,m_exec_conf);
+        m_mesh.swap(mesh);
 
-    // pad with offset
-    GlobalArray<kiss_fft_cpx> mesh(m_n_cells + m_ghost_offset,m_exec_conf);
-    m_mesh.swap(mesh);
+        // pad with offset
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh.swap(fourier_mesh);
+        GlobalArray<kiss_fft_cpx> inv_fourier_mesh_x(m_n_cells+m_ghost_offset, m_exec_conf);
+        m_inv_fourier_mesh_x.swap(inv_fourier_mesh_x);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_x(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_x.swap(fourier_mesh_G_x);
+        GlobalArray<kiss_fft_cpx> inv_fourier_mesh_y(m_n_cells+m_ghost_offset, m_exec_conf);
+        m_inv_fourier_mesh_y.swap(inv_fourier_mesh_y);
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_y(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_y.swap(fourier_mesh_G_y);
+        GlobalArray<kiss_fft_cpx> inv_fourier_mesh_z(m_n_cells+m_ghost_offset, m_exec_conf);
+        m_inv_fourier_mesh_z.swap(inv_fourier_mesh_z);
+        }
 
-    GlobalArray<kiss_fft_cpx> fourier_mesh_G_z(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_z.swap(fourier_mesh_G_z);
+    // allocate transformed meshes
 
-    // pad with offset
+    GlobalArray<kiss_fft_cpx> fourier_mesh(n_fourier_cells, m_exec_conf);
+    m_fourier_mesh.swap(fourier_mesh);
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_x(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_x.swap(inv_fourier_mesh_x);
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_x(n_fourier_cells, m_exec_conf);
+    m_fourier_mesh_G_x.swap(fourier_mesh_G_x);
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_y(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_y.swap(inv_fourier_mesh_y);
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_y(n_fourier_cells, m_exec_conf);
+    m_fourier_mesh_G_y.swap(fourier_mesh_G_y);
 
-    GlobalArray<kiss_fft_cpx> inv_fourier_mesh_z(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_z.swap(inv_fourier_mesh_z);
+    GlobalArray<kiss_fft_cpx> fourier_mesh_G_z(n_fourier_cells, m_exec_conf);
+    m_fourier_mesh_G_z.swap(fourier_mesh_G_z);
     }
 
 //! CPU implementation of sinc(x)==sin(x)/x
@@ -717,6 +750,7 @@ void PPPMForceCompute::assignParticles()
 
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::overwrite);
+    ArrayHandle<kiss_fft_scalar> h_real_mesh(m_real_mesh, access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff,access_location::host, access_mode::read);
@@ -725,22 +759,34 @@ void PPPMForceCompute::assignParticles()
 
     // set mesh to zero
     memset(h_mesh.data, 0, sizeof(kiss_fft_cpx)*m_mesh.getNumElements());
+    memset(h_real_mesh.data, 0, sizeof(kiss_fft_scalar)*m_real_mesh.getNumElements());
+
+    // the local FFT takes a real mesh, the distributed FFT the real part of a complex one
+    kiss_fft_scalar *mesh = m_kiss_fft_initialized ? h_real_mesh.data : &h_mesh.data[0].r;
+    unsigned int mesh_stride = m_kiss_fft_initialized ? 1 : 2;
 
     Scalar V_cell = box.getVolume()/(Scalar)(m_mesh_points.x*m_mesh_points.y*m_mesh_points.z);
 
-    // loop over group
+    // only charged particles contribute to the mesh, and receive a force in interpolateForces()
+    m_charged_particles.clear();
     unsigned int group_size = m_group->getNumMembers();
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
         unsigned int idx = m_group->getMemberIndex(group_idx);
+        if (h_charge.data[idx] != Scalar(0.0))
+            m_charged_particles.push_back(idx);
+        }
 
+    // spread the charge of particle idx onto a mesh with the given stride between elements
+    auto spread_charge = [&](unsigned int idx, kiss_fft_scalar *target, unsigned int stride)
+        {
         Scalar4 postype = h_postype.data[idx];
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
 
         // ignore if NaN
         if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
             {
-            continue;
+            return;
             }
 
         Scalar qi = h_charge.data[idx];
@@ -791,7 +837,7 @@ void PPPMForceCompute::assignParticles()
             iz < 0 || iz >= (int)m_grid_dim.z)
             {
             // ignore, error will be thrown elsewhere (in CellList)
-            continue;
+            return;
             }
 
         int mult_fact = 2*m_order+1;
@@ -859,11 +905,43 @@ void PPPMForceCompute::assignParticles()
                     // store in row major order
                     unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
 
-                    h_mesh.data[neigh_idx].r += qi*W/V_cell;
+                    target[neigh_idx*stride] += qi*W/V_cell;
                     }
                 }
             }
-        } // end loop over particles
+        };
+
+    unsigned int n_charged = m_charged_particles.size();
+
+    #ifdef ENABLE_TBB
+    // every thread spreads its particles onto a private mesh, to avoid write conflicts
+    for (auto it = m_thread_mesh.begin(); it != m_thread_mesh.end(); ++it)
+        it->assign(m_n_cells, kiss_fft_scalar(0.0));
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_charged),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+        std::vector<kiss_fft_scalar>& thread_mesh = m_thread_mesh.local();
+        if (thread_mesh.size() != m_n_cells)
+            thread_mesh.assign(m_n_cells, kiss_fft_scalar(0.0));
+
+        for (unsigned int i = range.begin(); i != range.end(); ++i)
+            spread_charge(m_charged_particles[i], &thread_mesh.front(), 1);
+        });
+
+    // sum up the private meshes
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_n_cells),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+        for (auto it = m_thread_mesh.begin(); it != m_thread_mesh.end(); ++it)
+            {
+            const kiss_fft_scalar *thread_mesh = &it->front();
+            for (unsigned int cell_idx = range.begin(); cell_idx != range.end(); ++cell_idx)
+                mesh[cell_idx*mesh_stride] += thread_mesh[cell_idx];
+            }
+        });
+    #else
+    for (unsigned int i = 0; i < n_charged; ++i)
+        spread_charge(m_charged_particles[i], mesh, mesh_stride);
+    #endif
 
     if (m_prof) m_prof->pop();
     }
@@ -874,16 +952,19 @@ void PPPMForceCompute::updateMeshes()
         {
         if (m_prof) m_prof->push("FFT");
         // transform the particle mesh locally (forward transform)
-        ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_scalar> h_real_mesh(m_real_mesh, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
 
-        kiss_fftnd(m_kiss_fft, h_mesh.data, h_fourier_mesh.data);
+        m_real_fft->forward(h_real_mesh.data, h_fourier_mesh.data);
         if (m_prof) m_prof->pop();
         }
 
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
+        // the ghost cell update and the distributed FFT wait for other ranks
+        CollectiveTimer timer(m_comm);
+
         // update inner cells of particle mesh
         if (m_prof) m_prof->push("ghost cell update");
         m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
@@ -914,23 +995,56 @@ void PPPMForceCompute::updateMeshes()
 
         unsigned int NNN = m_global_dim.x*m_global_dim.y*m_global_dim.z;
 
-        // multiply with influence function and I*k
-        for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+        if (m_kiss_fft_initialized)
             {
-            kiss_fft_cpx f = h_fourier_mesh.data[k];
+            // multiply the half spectrum with influence function and I*k
+            unsigned int nx_cpx = m_mesh_points.x/2+1;
+            for (unsigned int kidx = 0; kidx < m_fourier_mesh.getNumElements(); ++kidx)
+                {
+                unsigned int kx = kidx % nx_cpx;
+                unsigned int ky = (kidx / nx_cpx) % m_mesh_points.y;
+                unsigned int kz = kidx / (nx_cpx*m_mesh_points.y);
+
+                unsigned int k = kx + m_mesh_points.x*(ky + m_mesh_points.y*kz);
+                unsigned int k_mirror = getMirrorIndex(kx, ky, kz);
 
-            Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
+                kiss_fft_cpx f = h_fourier_mesh.data[kidx];
 
-            Scalar3 kvec = h_k.data[k];
+                // only the real part of the inverse transform is used, so symmetrize the field
+                // with respect to the mirror wave vector -k
+                Scalar3 kvec = Scalar(0.5)/((Scalar)NNN)*(h_inf_f.data[k]*h_k.data[k]
+                    - h_inf_f.data[k_mirror]*h_k.data[k_mirror]);
 
-            h_fourier_mesh_G_x.data[k].r = f.i * kvec.x * scaled_inf_f;
-            h_fourier_mesh_G_x.data[k].i = -f.r * kvec.x * scaled_inf_f;
+                h_fourier_mesh_G_x.data[kidx].r = f.i * kvec.x;
+                h_fourier_mesh_G_x.data[kidx].i = -f.r * kvec.x;
 
-            h_fourier_mesh_G_y.data[k].r = f.i * kvec.y * scaled_inf_f;
-            h_fourier_mesh_G_y.data[k].i = -f.r * kvec.y * scaled_inf_f;
+                h_fourier_mesh_G_y.data[kidx].r = f.i * kvec.y;
+                h_fourier_mesh_G_y.data[kidx].i = -f.r * kvec.y;
 
-            h_fourier_mesh_G_z.data[k].r = f.i * kvec.z * scaled_inf_f;
-            h_fourier_mesh_G_z.data[k].i = -f.r * kvec.z * scaled_inf_f;
+                h_fourier_mesh_G_z.data[kidx].r = f.i * kvec.z;
+                h_fourier_mesh_G_z.data[kidx].i = -f.r * kvec.z;
+                }
+            }
+        else
+            {
+            // multiply with influence function and I*k
+            for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+                {
+                kiss_fft_cpx f = h_fourier_mesh.data[k];
+
+                Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
+
+                Scalar3 kvec = h_k.data[k];
+
+                h_fourier_mesh_G_x.data[k].r = f.i * kvec.x * scaled_inf_f;
+                h_fourier_mesh_G_x.data[k].i = -f.r * kvec.x * scaled_inf_f;
+
+                h_fourier_mesh_G_y.data[k].r = f.i * kvec.y * scaled_inf_f;
+                h_fourier_mesh_G_y.data[k].i = -f.r * kvec.y * scaled_inf_f;
+
+                h_fourier_mesh_G_z.data[k].r = f.i * kvec.z * scaled_inf_f;
+                h_fourier_mesh_G_z.data[k].i = -f.r * kvec.z * scaled_inf_f;
+                }
             }
         }
 
@@ -939,22 +1053,26 @@ void PPPMForceCompute::updateMeshes()
     if (m_kiss_fft_initialized)
         {
         if (m_prof) m_prof->push("FFT");
-        // do a local inverse transform of the force mesh
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+        // do a local inverse transform of the force mesh, all three components at once
+        // (the transformed meshes are used as scratch space)
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::readwrite);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::readwrite);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::readwrite);
+        ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_x(m_inv_real_mesh_x, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_y(m_inv_real_mesh_y, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_z(m_inv_real_mesh_z, access_location::host, access_mode::overwrite);
+
+        kiss_fft_cpx *in[3] = {h_fourier_mesh_G_x.data, h_fourier_mesh_G_y.data, h_fourier_mesh_G_z.data};
+        kiss_fft_scalar *out[3] = {h_inv_real_mesh_x.data, h_inv_real_mesh_y.data, h_inv_real_mesh_z.data};
+        m_real_fft->inverse(3, in, out);
         if (m_prof) m_prof->pop();
         }
 
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
+        CollectiveTimer timer(m_comm);
+
         if (m_prof) m_prof->push("FFT");
         // Distributed inverse transform force on mesh points
         m_exec_conf->msg->notice(8) << "charge.pppm: Distributed iFFT" << std::endl;
@@ -978,6 +1096,8 @@ void PPPMForceCompute::updateMeshes()
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
+        CollectiveTimer timer(m_comm);
+
         // update outer cells of force mesh using ghost cells from neighboring processors
         if (m_prof) m_prof->push("ghost cell update");
         m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
@@ -1001,6 +1121,15 @@ void PPPMForceCompute::interpolateForces()
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_x(m_inv_real_mesh_x, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_y(m_inv_real_mesh_y, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_scalar> h_inv_real_mesh_z(m_inv_real_mesh_z, access_location::host, access_mode::read);
+
+    // the local FFT yields real meshes, the distributed FFT complex ones of which only the real part is used
+    const kiss_fft_scalar *inv_mesh_x = m_kiss_fft_initialized ? h_inv_real_mesh_x.data : &h_inv_fourier_mesh_x.data[0].r;
+    const kiss_fft_scalar *inv_mesh_y = m_kiss_fft_initialized ? h_inv_real_mesh_y.data : &h_inv_fourier_mesh_y.data[0].r;
+    const kiss_fft_scalar *inv_mesh_z = m_kiss_fft_initialized ? h_inv_real_mesh_z.data : &h_inv_fourier_mesh_z.data[0].r;
+    unsigned int mesh_stride = m_kiss_fft_initialized ? 1 : 2;
 
     // access force array
     ArrayHandle<Scalar4> h_force(m_force, access_location::host, access_mode::overwrite);
@@ -1012,11 +1141,9 @@ void PPPMForceCompute::interpolateForces()
 
     const BoxDim& box = m_pdata->getBox();
 
-    // loop over group
-    unsigned int group_size = m_group->getNumMembers();
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    // interpolate the force on particle idx, which is the only element of the force array written
+    auto interpolate_force = [&](unsigned int idx)
         {
-        unsigned int idx = m_group->getMemberIndex(group_idx);
         Scalar4 postype = h_postype.data[idx];
 
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
@@ -1024,7 +1151,7 @@ void PPPMForceCompute::interpolateForces()
         // ignore if NaN
         if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
             {
-            continue;
+            return;
             }
 
         Scalar qi = h_charge.data[idx];
@@ -1074,7 +1201,7 @@ void PPPMForceCompute::interpolateForces()
             iz < 0 || iz >= (int)m_grid_dim.z)
             {
             // ignore, error will be thrown elsewhere (in CellList)
-            continue;
+            return;
             }
 
         Scalar3 force = make_scalar3(0.0,0.0,0.0);
@@ -1142,20 +1269,34 @@ void PPPMForceCompute::interpolateForces()
 
                     unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
 
-                    kiss_fft_cpx E_x = h_inv_fourier_mesh_x.data[neigh_idx];
-                    kiss_fft_cpx E_y = h_inv_fourier_mesh_y.data[neigh_idx];
-                    kiss_fft_cpx E_z = h_inv_fourier_mesh_z.data[neigh_idx];
+                    Scalar E_x = inv_mesh_x[neigh_idx*mesh_stride];
+                    Scalar E_y = inv_mesh_y[neigh_idx*mesh_stride];
+                    Scalar E_z = inv_mesh_z[neigh_idx*mesh_stride];
 
                     Scalar W = Wx * Wy * Wz;
-                    force.x += qi*W*E_x.r;
-                    force.y += qi*W*E_y.r;
-                    force.z += qi*W*E_z.r;
+                    force.x += qi*W*E_x;
+                    force.y += qi*W*E_y;
+                    force.z += qi*W*E_z;
                     }
                 }
             }
 
         h_force.data[idx] = make_scalar4(force.x,force.y,force.z,0.0);
-        }  // end of loop over particles
+        };
+
+    // loop over the charged particles found in assignParticles(), uncharged particles experience no force
+    unsigned int n_charged = m_charged_particles.size();
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_charged),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+        for (unsigned int i = range.begin(); i != range.end(); ++i)
+            interpolate_force(m_charged_particles[i]);
+        });
+    #else
+    for (unsigned int i = 0; i < n_charged; ++i)
+        interpolate_force(m_charged_particles[i]);
+    #endif
 
     if (m_prof) m_prof->pop();
     }
@@ -1178,17 +1319,40 @@ Scalar PPPMForceCompute::computePE()
         }
     #endif
 
-    for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+    if (m_kiss_fft_initialized)
         {
-        bool exclude = false;
-        if (exclude_dc)
-            // exclude DC bin
-            exclude = (k == 0);
+        // sum over the half spectrum, adding the mirror wave vector -k where it is not stored,
+        // and skipping the DC bin
+        unsigned int nx_cpx = m_mesh_points.x/2+1;
+        for (unsigned int kidx = 1; kidx < m_fourier_mesh.getNumElements(); ++kidx)
+            {
+            unsigned int kx = kidx % nx_cpx;
+            unsigned int ky = (kidx / nx_cpx) % m_mesh_points.y;
+            unsigned int kz = kidx / (nx_cpx*m_mesh_points.y);
 
-        if (! exclude)
+            unsigned int k = kx + m_mesh_points.x*(ky + m_mesh_points.y*kz);
+            Scalar inf_f = h_inf_f.data[k];
+            if (kx != 0 && 2*kx != m_mesh_points.x)
+                inf_f += h_inf_f.data[getMirrorIndex(kx, ky, kz)];
+
+            sum += (h_fourier_mesh.data[kidx].r * h_fourier_mesh.data[kidx].r
+                + h_fourier_mesh.data[kidx].i * h_fourier_mesh.data[kidx].i)*inf_f;
+            }
+        }
+    else
+        {
+        for (unsigned int k = 0; k < m_n_inner_cells; ++k)
             {
-            sum += (h_fourier_mesh.data[k].r * h_fourier_mesh.data[k].r
-                + h_fourier_mesh.data[k].i * h_fourier_mesh.data[k].i)*h_inf_f.data[k];
+            bool exclude = false;
+            if (exclude_dc)
+                // exclude DC bin
+                exclude = (k == 0);
+
+            if (! exclude)
+                {
+                sum += (h_fourier_mesh.data[k].r * h_fourier_mesh.data[k].r
+                    + h_fourier_mesh.data[k].i * h_fourier_mesh.data[k].i)*h_inf_f.data[k];
+                }
             }
         }
 
@@ -1217,6 +1381,8 @@ Scalar PPPMForceCompute::computePE()
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
+        CollectiveTimer timer(m_comm);
+
         // reduce sum
         MPI_Allreduce(MPI_IN_PLACE,
                       &sum,
@@ -1313,7 +1479,7 @@ void PPPMForceCompute::computeVirial()
     {
     if (m_prof) m_prof->push("virial");
 
-    ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::read);
 
     ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
     ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
@@ -1332,7 +1498,11 @@ void PPPMForceCompute::computeVirial()
         }
     #endif
 
-    for (unsigned int kidx = 0; kidx < m_n_inner_cells; ++kidx)
+    // the local FFT stores only half of the spectrum
+    unsigned int n_fourier_cells = m_fourier_mesh.getNumElements();
+    unsigned int nx_cpx = m_mesh_points.x/2+1;
+
+    for (unsigned int kidx = 0; kidx < n_fourier_cells; ++kidx)
         {
         bool exclude = false;
         if (exclude_dc)
@@ -1343,19 +1513,41 @@ void PPPMForceCompute::computeVirial()
             {
             // non-zero wave vector
             kiss_fft_cpx fourier = h_fourier_mesh.data[kidx];
+            Scalar rho_sq = fourier.r * fourier.r + fourier.i * fourier.i;
 
-            Scalar3 k = h_k.data[kidx];
-            Scalar ksq = dot(k,k);
+            // wave vectors sharing this Fourier coefficient, k and (for the half spectrum) -k
+            unsigned int n_wave = 1;
+            unsigned int wave_idx[2] = {kidx, kidx};
 
-            Scalar rhog = (fourier.r * fourier.r + fourier.i * fourier.i)*h_inf_f.data[kidx];
+            if (m_kiss_fft_initialized)
+                {
+                unsigned int kx = kidx % nx_cpx;
+                unsigned int ky = (kidx / nx_cpx) % m_mesh_points.y;
+                unsigned int kz = kidx / (nx_cpx*m_mesh_points.y);
 
-            Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
-            virial[0] += rhog*(Scalar(1.0) + vterm*k.x*k.x); // xx
-            virial[1] += rhog*(              vterm*k.x*k.y); // xy
-            virial[2] += rhog*(              vterm*k.x*k.z); // xz
-            virial[3] += rhog*(Scalar(1.0) + vterm*k.y*k.y); // yy
-            virial[4] += rhog*(              vterm*k.y*k.z); // yz
-            virial[5] += rhog*(Scalar(1.0) + vterm*k.z*k.z); // zz
+                wave_idx[0] = kx + m_mesh_points.x*(ky + m_mesh_points.y*kz);
+                if (kx != 0 && 2*kx != m_mesh_points.x)
+                    {
+                    wave_idx[1] = getMirrorIndex(kx, ky, kz);
+                    n_wave = 2;
+                    }
+                }
+
+            for (unsigned int i = 0; i < n_wave; ++i)
+                {
+                Scalar3 k = h_k.data[wave_idx[i]];
+                Scalar ksq = dot(k,k);
+
+                Scalar rhog = rho_sq*h_inf_f.data[wave_idx[i]];
+
+                Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
+                virial[0] += rhog*(Scalar(1.0) + vterm*k.x*k.x); // xx
+                virial[1] += rhog*(              vterm*k.x*k.y); // xy
+                virial[2] += rhog*(              vterm*k.x*k.z); // xz
+                virial[3] += rhog*(Scalar(1.0) + vterm*k.y*k.y); // yy
+                virial[4] += rhog*(              vterm*k.y*k.z); // yz
+                virial[5] += rhog*(Scalar(1.0) + vterm*k.z*k.z); // zz
+                }
             }
         }
 
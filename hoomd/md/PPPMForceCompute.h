@@ -13,11 +13,15 @@
 #include "hoomd/extern/dfftlib/src/dfft_host.h"
 #endif
 
-#include "hoomd/extern/kiss_fftnd.h"
+#include "RealFFT3D.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
 
+#ifdef ENABLE_TBB
+#include <tbb/enumerable_thread_specific.h>
+#endif
+
 const Scalar EPS_HOC(1.0e-7);
 
 const unsigned int PPPM_MAX_ORDER = 7;
@@ -178,8 +182,7 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         virtual void computeBodyCorrection();
 
     private:
-        kiss_fftnd_cfg m_kiss_fft;         //!< The FFT configuration
-        kiss_fftnd_cfg m_kiss_ifft;        //!< Inverse FFT configuration
+        std::unique_ptr<RealFFT3D> m_real_fft; //!< Local real-to-complex FFT
 
         #ifdef ENABLE_MPI
         dfft_plan m_dfft_plan_forward;     //!< Distributed FFT for forward transform
@@ -190,14 +193,24 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
         bool m_kiss_fft_initialized;               //!< True if a local KISS FFT has been set up
 
-        GlobalArray<kiss_fft_cpx> m_mesh;             //!< The particle density mesh
-        GlobalArray<kiss_fft_cpx> m_fourier_mesh;     //!< The fourier transformed mesh
+        GlobalArray<kiss_fft_cpx> m_mesh;             //!< The particle density mesh (distributed FFT)
+        GlobalArray<kiss_fft_scalar> m_real_mesh;     //!< The particle density mesh (local FFT)
+        GlobalArray<kiss_fft_cpx> m_fourier_mesh;     //!< The fourier transformed mesh (half spectrum for the local FFT)
         GlobalArray<kiss_fft_cpx> m_fourier_mesh_G_x;   //!< Fourier transformed mesh times the influence function, x-component
         GlobalArray<kiss_fft_cpx> m_fourier_mesh_G_y;   //!< Fourier transformed mesh times the influence function, y-component
         GlobalArray<kiss_fft_cpx> m_fourier_mesh_G_z;   //!< Fourier transformed mesh times the influence function, z-component
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_x;   //!< Fourier transformed mesh times the influence function, x-component
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_y;   //!< Fourier transformed mesh times the influence function, y-component
         GlobalArray<kiss_fft_cpx> m_inv_fourier_mesh_z;   //!< Fourier transformed mesh times the influence function, z-component
+        GlobalArray<kiss_fft_scalar> m_inv_real_mesh_x;   //!< Inverse transformed force mesh, x-component (local FFT)
+        GlobalArray<kiss_fft_scalar> m_inv_real_mesh_y;   //!< Inverse transformed force mesh, y-component (local FFT)
+        GlobalArray<kiss_fft_scalar> m_inv_real_mesh_z;   //!< Inverse transformed force mesh, z-component (local FFT)
+
+        std::vector<unsigned int> m_charged_particles;  //!< Local indices of the charged group members
+
+        #ifdef ENABLE_TBB
+        tbb::enumerable_thread_specific< std::vector<kiss_fft_scalar> > m_thread_mesh; //!< Per-thread charge meshes
+        #endif
 
         std::vector<std::string> m_log_names;           //!< Name of the log quantity
 
@@ -206,6 +219,15 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         //! Compute virial on mesh
         void computeVirialMesh();
 
+        //! Get the index of the wave vector -k in the full local mesh
+        unsigned int getMirrorIndex(unsigned int kx, unsigned int ky, unsigned int kz) const
+            {
+            unsigned int mx = (m_mesh_points.x - kx) % m_mesh_points.x;
+            unsigned int my = (m_mesh_points.y - ky) % m_mesh_points.y;
+            unsigned int mz = (m_mesh_points.z - kz) % m_mesh_points.z;
+            return mx + m_mesh_points.x*(my + m_mesh_points.y*mz);
+            }
+
         //! Compute number of ghost cellso
         uint3 computeGhostCellNum();
 
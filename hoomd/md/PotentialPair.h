@@ -133,6 +133,9 @@ class PotentialPair : public ForceCompute
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! Compute the forces between local particles while the ghost update is in flight
+        virtual void computeInterior(unsigned int timestep);
         #endif
 
         //! Calculates the energy between two lists of particles.
@@ -166,9 +169,26 @@ class PotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        #ifdef ENABLE_MPI
+        bool m_interior_computed;                   //!< True if the interior pairs have been computed by computeInterior()
+        unsigned int m_interior_timestep;           //!< Time step of the last call to computeInterior()
+        unsigned int m_interior_nlist_builds;       //!< Number of neighbor list builds at the last call to computeInterior()
+        #endif
+
+        //! Subsets of the neighbor list evaluated by computePairs()
+        enum pairSubset
+            {
+            all_pairs = 0,      //!< All pairs, starting from zero force
+            interior_pairs,     //!< Only pairs between two local particles, starting from zero force
+            boundary_pairs      //!< Only pairs with a ghost particle, added to the current force
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! Evaluate the forces of a subset of the pairs in the neighbor list
+        void computePairs(pairSubset subset);
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -221,6 +241,9 @@ PotentialPair< evaluator >::PotentialPair(std::shared_ptr<SystemDefinition> sysd
                                                 std::shared_ptr<NeighborList> nlist,
                                                 const std::string& log_suffix)
     : ForceCompute(sysdef), m_nlist(nlist), m_shift_mode(no_shift), m_typpair_idx(m_pdata->getNTypes())
+    #ifdef ENABLE_MPI
+      , m_interior_computed(false), m_interior_timestep(0), m_interior_nlist_builds(0)
+    #endif
     {
     m_exec_conf->msg->notice(5) << "Constructing PotentialPair<" << evaluator::getName() << ">" << std::endl;
 
@@ -385,6 +408,9 @@ Scalar PotentialPair< evaluator >::getLogValue(const std::string& quantity, unsi
 /*! \post The pair forces are computed for the given timestep. The neighborlist's compute method is called to ensure
     that it is up to date before proceeding.
 
+    If computeInterior() has already evaluated the pairs between local particles at this time step, and the
+    neighbor list has not been rebuilt since, only the pairs with ghost particles are added.
+
     \param timestep specifies the current time step of the simulation
 */
 template< class evaluator >
@@ -393,9 +419,29 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     // start by updating the neighborlist
     m_nlist->compute(timestep);
 
+    pairSubset subset = all_pairs;
+    #ifdef ENABLE_MPI
+    if (m_interior_computed && m_interior_timestep == timestep && m_interior_nlist_builds == m_nlist->getNumBuilds())
+        subset = boundary_pairs;
+    m_interior_computed = false;
+    #endif
+
     // start the profile for this compute
     if (m_prof) m_prof->push(m_prof_name);
 
+    computePairs(subset);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param subset The pairs to evaluate
+
+    Pairs between local particles are taken from the neighbor list as is, whereas pairs with a ghost particle
+    only contribute to the force on the local particle.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computePairs(pairSubset subset)
+    {
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
@@ -412,8 +458,9 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
 
     //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+    const access_mode::Enum force_mode = (subset == boundary_pairs) ? access_mode::readwrite : access_mode::overwrite;
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, force_mode);
+    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, force_mode);
 
 
     const BoxDim& box = m_pdata->getGlobalBox();
@@ -425,11 +472,16 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
 
     // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    if (subset != boundary_pairs)
+        {
+        memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+        }
+
+    const unsigned int N = m_pdata->getN();
 
     // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    for (int i = 0; i < (int)N; i++)
         {
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -465,6 +517,10 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
             unsigned int j = h_nlist.data[myHead + k];
             assert(j < m_pdata->getN() + m_pdata->getNGhosts());
 
+            // skip the pairs that are not part of the requested subset
+            if ((subset == interior_pairs && j >= N) || (subset == boundary_pairs && j < N))
+                continue;
+
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
             Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
             Scalar3 dx = pi - pj;
@@ -563,7 +619,7 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 
                 // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
                 // only add force to local particles
-                if (third_law && j < m_pdata->getN())
+                if (third_law && j < N)
                     {
                     unsigned int mem_idx = j;
                     h_force.data[mem_idx].x -= dx.x*force_divr;
@@ -599,11 +655,35 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
             h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
             }
         }
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+
+    The pairs between local particles are evaluated with the current neighbor list. This is only possible if the
+    list is not going to be rebuilt at this time step, and if the forces have not been computed yet.
+*/
+template < class evaluator >
+void PotentialPair< evaluator >::computeInterior(unsigned int timestep)
+    {
+    // the update check is collective, so call it on every rank before anything else
+    if (m_nlist->peekUpdate(timestep))
+        return;
+
+    if (m_particles_sorted || !peekCompute(timestep))
+        return;
+
+    if (m_prof) m_prof->push(m_prof_name);
+
+    computePairs(interior_pairs);
 
     if (m_prof) m_prof->pop();
+
+    m_interior_computed = true;
+    m_interior_timestep = timestep;
+    m_interior_nlist_builds = m_nlist->getNumBuilds();
     }
 
-#ifdef ENABLE_MPI
 /*! \param timestep Current time step
  */
 template < class evaluator >
@@ -660,7 +740,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
     energy = Scalar(0.0);
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle< unsigned int > h_rtags(m_pdata->getRTags(), access_location::host, access_mode::read);
+    RTagHandle h_rtags(*m_pdata, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -672,7 +752,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
     // for each particle in tags1
     while (first1 != last1)
         {
-        unsigned int i = h_rtags.data[*first1]; first1++;
+        unsigned int i = h_rtags[*first1]; first1++;
         if (i >= m_pdata->getN()) // not owned by this processor.
             continue;
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
@@ -694,7 +774,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
         for (InputIterator iter = first2; iter != last2; ++iter)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_rtags.data[*iter];
+            unsigned int j = h_rtags[*iter];
             if (j >= m_pdata->getN() + m_pdata->getNGhosts()) // not on this processor at all
                 continue;
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
@@ -63,6 +63,9 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! The thermostat forces are evaluated in computeForces() only, there is no separate interior pass
+        virtual void computeInterior(unsigned int timestep) { }
         #endif
 
     protected:
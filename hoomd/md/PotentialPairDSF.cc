@@ -0,0 +1,109 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#include "PotentialPairDSF.h"
+
+namespace py = pybind11;
+
+/*! \file PotentialPairDSF.cc
+    \brief Defines the PotentialPairDSF class
+*/
+
+/*! \param pdata Particle data
+    \param params Per type pair parameters
+    \param typpair_idx Indexer for the type pair parameters
+    \returns The self energy of the local particles on this rank
+*/
+Scalar computeDSFSelfEnergy(std::shared_ptr<ParticleData> pdata,
+                            const GlobalArray<EvaluatorPairDSF::param_type>& params,
+                            const Index2D& typpair_idx)
+    {
+    ArrayHandle<Scalar4> h_postype(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<EvaluatorPairDSF::param_type> h_params(params, access_location::host, access_mode::read);
+
+    Scalar self_energy(0.0);
+    for (unsigned int i = 0; i < pdata->getN(); ++i)
+        {
+        Scalar qi = h_charge.data[i];
+        if (qi == Scalar(0.0))
+            continue;
+
+        unsigned int typei = __scalar_as_int(h_postype.data[i].w);
+        self_energy += EvaluatorPairDSF::evalSelfEnergy(qi, h_params.data[typpair_idx(typei, typei)]);
+        }
+
+    return self_energy;
+    }
+
+/*! \param pdata Particle data
+    \param params Per type pair parameters
+    \param typpair_idx Indexer for the type pair parameters
+    \returns The self energy summed over all ranks
+*/
+Scalar computeDSFSelfEnergyGlobal(std::shared_ptr<ParticleData> pdata,
+                                  const GlobalArray<EvaluatorPairDSF::param_type>& params,
+                                  const Index2D& typpair_idx)
+    {
+    Scalar self_energy = computeDSFSelfEnergy(pdata, params, typpair_idx);
+
+    #ifdef ENABLE_MPI
+    if (pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE,
+                      &self_energy,
+                      1,
+                      MPI_HOOMD_SCALAR,
+                      MPI_SUM,
+                      pdata->getExecConf()->getMPICommunicator());
+        }
+    #endif
+
+    return self_energy;
+    }
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param log_suffix Name given to this instance of the force
+*/
+PotentialPairDSF::PotentialPairDSF(std::shared_ptr<SystemDefinition> sysdef,
+                                   std::shared_ptr<NeighborList> nlist,
+                                   const std::string& log_suffix)
+    : PotentialPair<EvaluatorPairDSF>(sysdef, nlist, log_suffix)
+    {
+    }
+
+/*! \param quantity Name of the log value to get
+    \param timestep Current timestep of the simulation
+*/
+Scalar PotentialPairDSF::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == m_log_name)
+        {
+        compute(timestep);
+        return calcEnergySum() + computeDSFSelfEnergyGlobal(m_pdata, m_params, m_typpair_idx);
+        }
+    else
+        {
+        return PotentialPair<EvaluatorPairDSF>::getLogValue(quantity, timestep);
+        }
+    }
+
+/*! \param timestep specifies the current time step of the simulation
+*/
+void PotentialPairDSF::computeForces(unsigned int timestep)
+    {
+    PotentialPair<EvaluatorPairDSF>::computeForces(timestep);
+
+    // the self energy is only needed when the potential energy is requested
+    if (m_pdata->getFlags()[pdata_flag::potential_energy])
+        m_external_energy = computeDSFSelfEnergy(m_pdata, m_params, m_typpair_idx);
+    else
+        m_external_energy = Scalar(0.0);
+    }
+
+void export_PotentialPairDSF(py::module& m)
+    {
+    export_PotentialPair<PotentialPairDSF>(m, "PotentialPairDSF");
+    }
@@ -0,0 +1,61 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifndef __POTENTIAL_PAIR_DSF_H__
+#define __POTENTIAL_PAIR_DSF_H__
+
+#include "PotentialPair.h"
+#include "EvaluatorPairDSF.h"
+
+/*! \file PotentialPairDSF.h
+    \brief Declares the PotentialPairDSF class
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Damped shifted force electrostatics
+/*! PotentialPairDSF evaluates the pair part of the damped shifted force potential with EvaluatorPairDSF, like any
+    other PotentialPair. In addition, every charge carries a self energy that does not depend on the particle
+    positions (see EvaluatorPairDSF::evalSelfEnergy()). It is evaluated over the local particles after the pair
+    forces and stored as external energy of this rank, so that it enters the potential energy of ComputeThermo
+    the same way the self energy of PPPMForceCompute does. The logged pair energy includes the self energy.
+
+    Since the DSF potential is already shifted, the energy shift mode has no effect on it.
+*/
+class PYBIND11_EXPORT PotentialPairDSF : public PotentialPair<EvaluatorPairDSF>
+    {
+    public:
+        //! Construct the pair potential
+        PotentialPairDSF(std::shared_ptr<SystemDefinition> sysdef,
+                         std::shared_ptr<NeighborList> nlist,
+                         const std::string& log_suffix="");
+
+        //! Destructor
+        virtual ~PotentialPairDSF() { }
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    protected:
+        //! Actually compute the forces
+        virtual void computeForces(unsigned int timestep);
+    };
+
+//! Sum the DSF self energy of the local particles
+Scalar computeDSFSelfEnergy(std::shared_ptr<ParticleData> pdata,
+                            const GlobalArray<EvaluatorPairDSF::param_type>& params,
+                            const Index2D& typpair_idx);
+
+//! Sum the DSF self energy of all particles in the system
+Scalar computeDSFSelfEnergyGlobal(std::shared_ptr<ParticleData> pdata,
+                                  const GlobalArray<EvaluatorPairDSF::param_type>& params,
+                                  const Index2D& typpair_idx);
+
+//! Exports the PotentialPairDSF class to python
+void export_PotentialPairDSF(pybind11::module& m);
+
+#endif // __POTENTIAL_PAIR_DSF_H__
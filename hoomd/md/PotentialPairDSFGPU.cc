@@ -0,0 +1,67 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#include "PotentialPairDSFGPU.h"
+
+namespace py = pybind11;
+
+/*! \file PotentialPairDSFGPU.cc
+    \brief Defines the PotentialPairDSFGPU class
+*/
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param log_suffix Name given to this instance of the force
+*/
+PotentialPairDSFGPU::PotentialPairDSFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                         std::shared_ptr<NeighborList> nlist,
+                                         const std::string& log_suffix)
+    : PotentialPairGPU<EvaluatorPairDSF, gpu_compute_dsf_forces>(sysdef, nlist, log_suffix)
+    {
+    }
+
+/*! \param quantity Name of the log value to get
+    \param timestep Current timestep of the simulation
+*/
+Scalar PotentialPairDSFGPU::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == m_log_name)
+        {
+        compute(timestep);
+        return calcEnergySum() + computeDSFSelfEnergyGlobal(m_pdata, m_params, m_typpair_idx);
+        }
+    else
+        {
+        return PotentialPairGPU<EvaluatorPairDSF, gpu_compute_dsf_forces>::getLogValue(quantity, timestep);
+        }
+    }
+
+/*! \param timestep specifies the current time step of the simulation
+*/
+void PotentialPairDSFGPU::computeForces(unsigned int timestep)
+    {
+    PotentialPairGPU<EvaluatorPairDSF, gpu_compute_dsf_forces>::computeForces(timestep);
+
+    // the self energy is only needed when the potential energy is requested
+    if (m_pdata->getFlags()[pdata_flag::potential_energy])
+        m_external_energy = computeDSFSelfEnergy(m_pdata, m_params, m_typpair_idx);
+    else
+        m_external_energy = Scalar(0.0);
+    }
+
+void export_PotentialPairDSFGPU(py::module& m)
+    {
+    // PotentialPairDSFGPU is not derived from PotentialPairDSF, export the full interface
+    py::class_<PotentialPairDSFGPU, std::shared_ptr<PotentialPairDSFGPU> >(m, "PotentialPairDSFGPU", py::base<ForceCompute>())
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, const std::string& >())
+        .def("setParams", &PotentialPairDSFGPU::setParams)
+        .def("setRcut", &PotentialPairDSFGPU::setRcut)
+        .def("setRon", &PotentialPairDSFGPU::setRon)
+        .def("setShiftMode", &PotentialPairDSFGPU::setShiftMode)
+        .def("setTuningParam", &PotentialPairDSFGPU::setTuningParam)
+        .def("computeEnergyBetweenSets", &PotentialPairDSFGPU::computeEnergyBetweenSetsPythonList)
+        .def("slotWriteGSDShapeSpec", &PotentialPairDSFGPU::slotWriteGSDShapeSpec)
+        .def("connectGSDShapeSpec", &PotentialPairDSFGPU::connectGSDShapeSpec)
+    ;
+    }
@@ -0,0 +1,50 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifndef __POTENTIAL_PAIR_DSF_GPU_H__
+#define __POTENTIAL_PAIR_DSF_GPU_H__
+
+#ifdef ENABLE_CUDA
+
+#include "PotentialPairGPU.h"
+#include "PotentialPairDSF.h"
+#include "AllDriverPotentialPairGPU.cuh"
+
+/*! \file PotentialPairDSFGPU.h
+    \brief Declares the PotentialPairDSFGPU class
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Damped shifted force electrostatics on the GPU
+/*! The pair forces are computed by PotentialPairGPU. The self energy only depends on the charges and is summed on
+    the host, see PotentialPairDSF.
+*/
+class PYBIND11_EXPORT PotentialPairDSFGPU : public PotentialPairGPU<EvaluatorPairDSF, gpu_compute_dsf_forces>
+    {
+    public:
+        //! Construct the pair potential
+        PotentialPairDSFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                            std::shared_ptr<NeighborList> nlist,
+                            const std::string& log_suffix="");
+
+        //! Destructor
+        virtual ~PotentialPairDSFGPU() { }
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    protected:
+        //! Actually compute the forces
+        virtual void computeForces(unsigned int timestep);
+    };
+
+//! Exports the PotentialPairDSFGPU class to python
+void export_PotentialPairDSFGPU(pybind11::module& m);
+
+#endif // ENABLE_CUDA
+#endif // __POTENTIAL_PAIR_DSF_GPU_H__
@@ -78,6 +78,11 @@ class PotentialPairGPU : public PotentialPair<evaluator>
             m_tuner->setEnabled(enable);
             }
 
+        #ifdef ENABLE_MPI
+        //! The GPU kernel evaluates all pairs in computeForces(), there is no separate interior pass
+        virtual void computeInterior(unsigned int timestep) { }
+        #endif
+
     protected:
         std::unique_ptr<Autotuner> m_tuner;   //!< Autotuner for block size and threads per particle
         unsigned int m_param;                       //!< Kernel tuning parameter
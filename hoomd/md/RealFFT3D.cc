@@ -0,0 +1,251 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "RealFFT3D.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+/*! \file RealFFT3D.cc
+    \brief Defines the RealFFT3D class
+*/
+
+/*! \param nx Number of mesh points along x
+    \param ny Number of mesh points along y
+    \param nz Number of mesh points along z
+*/
+RealFFT3D::RealFFT3D(unsigned int nx, unsigned int ny, unsigned int nz)
+    : m_nx(nx), m_ny(ny), m_nz(nz), m_nx_cpx(nx/2+1)
+    {
+    m_fft_x = kiss_fft_alloc(m_nx, 0, NULL, NULL);
+    m_ifft_x = kiss_fft_alloc(m_nx, 1, NULL, NULL);
+    m_fft_y = kiss_fft_alloc(m_ny, 0, NULL, NULL);
+    m_ifft_y = kiss_fft_alloc(m_ny, 1, NULL, NULL);
+    m_fft_z = kiss_fft_alloc(m_nz, 0, NULL, NULL);
+    m_ifft_z = kiss_fft_alloc(m_nz, 1, NULL, NULL);
+    }
+
+RealFFT3D::~RealFFT3D()
+    {
+    kiss_fft_free(m_fft_x);
+    kiss_fft_free(m_ifft_x);
+    kiss_fft_free(m_fft_y);
+    kiss_fft_free(m_ifft_y);
+    kiss_fft_free(m_fft_z);
+    kiss_fft_free(m_ifft_z);
+    }
+
+/*! \param in Real input mesh (nx*ny*nz elements)
+    \param out Half spectrum (getNumComplexElements() elements)
+*/
+void RealFFT3D::forward(const kiss_fft_scalar *in, kiss_fft_cpx *out)
+    {
+    unsigned int n_rows = m_ny*m_nz;
+    unsigned int n_pairs = (n_rows+1)/2;
+
+    // transform pairs of real rows along x as one complex row
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_pairs),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+    std::vector<kiss_fft_cpx> buf_in(m_nx);
+    std::vector<kiss_fft_cpx> buf_out(m_nx);
+    for (unsigned int pair = range.begin(); pair != range.end(); ++pair)
+    #else
+    std::vector<kiss_fft_cpx> buf_in(m_nx);
+    std::vector<kiss_fft_cpx> buf_out(m_nx);
+    for (unsigned int pair = 0; pair < n_pairs; ++pair)
+    #endif
+        {
+        unsigned int row_a = 2*pair;
+        unsigned int row_b = 2*pair+1;
+        bool has_b = row_b < n_rows;
+
+        const kiss_fft_scalar *in_a = in + row_a*m_nx;
+        const kiss_fft_scalar *in_b = in + row_b*m_nx;
+        for (unsigned int j = 0; j < m_nx; ++j)
+            {
+            buf_in[j].r = in_a[j];
+            buf_in[j].i = has_b ? in_b[j] : kiss_fft_scalar(0.0);
+            }
+
+        kiss_fft(m_fft_x, &buf_in.front(), &buf_out.front());
+
+        // separate the two spectra, A = (Z(k) + conj(Z(-k)))/2 and B = (Z(k) - conj(Z(-k)))/(2i)
+        kiss_fft_cpx *out_a = out + row_a*m_nx_cpx;
+        kiss_fft_cpx *out_b = out + row_b*m_nx_cpx;
+        for (unsigned int k = 0; k < m_nx_cpx; ++k)
+            {
+            kiss_fft_cpx z = buf_out[k];
+            kiss_fft_cpx z_mirror = buf_out[(m_nx-k) % m_nx];
+
+            out_a[k].r = kiss_fft_scalar(0.5)*(z.r + z_mirror.r);
+            out_a[k].i = kiss_fft_scalar(0.5)*(z.i - z_mirror.i);
+
+            if (has_b)
+                {
+                out_b[k].r = kiss_fft_scalar(0.5)*(z.i + z_mirror.i);
+                out_b[k].i = kiss_fft_scalar(0.5)*(z_mirror.r - z.r);
+                }
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+    #endif
+
+    kiss_fft_cpx *data[1] = {out};
+    transformYZ(1, data, false);
+    }
+
+/*! \param n_mesh Number of meshes to transform
+    \param in Half spectra (getNumComplexElements() elements each), overwritten on output
+    \param out Real output meshes (nx*ny*nz elements each)
+
+    The half spectra must be Hermitian, i.e. represent real data.
+*/
+void RealFFT3D::inverse(unsigned int n_mesh, kiss_fft_cpx * const *in, kiss_fft_scalar * const *out)
+    {
+    transformYZ(n_mesh, in, true);
+
+    unsigned int n_rows = m_ny*m_nz;
+    unsigned int n_pairs = (n_rows+1)/2;
+
+    // combine pairs of half spectra along x into one complex row Z = A + iB
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_mesh*n_pairs),
+        [&](const tbb::blocked_range<unsigned int>& range) {
+    std::vector<kiss_fft_cpx> buf_in(m_nx);
+    std::vector<kiss_fft_cpx> buf_out(m_nx);
+    for (unsigned int line = range.begin(); line != range.end(); ++line)
+    #else
+    std::vector<kiss_fft_cpx> buf_in(m_nx);
+    std::vector<kiss_fft_cpx> buf_out(m_nx);
+    for (unsigned int line = 0; line < n_mesh*n_pairs; ++line)
+    #endif
+        {
+        unsigned int mesh = line / n_pairs;
+        unsigned int pair = line % n_pairs;
+
+        unsigned int row_a = 2*pair;
+        unsigned int row_b = 2*pair+1;
+        bool has_b = row_b < n_rows;
+
+        const kiss_fft_cpx *in_a = in[mesh] + row_a*m_nx_cpx;
+        const kiss_fft_cpx *in_b = in[mesh] + row_b*m_nx_cpx;
+        for (unsigned int k = 0; k < m_nx; ++k)
+            {
+            // the upper half follows from Hermitian symmetry
+            bool lower = k < m_nx_cpx;
+            unsigned int k_half = lower ? k : m_nx-k;
+            kiss_fft_scalar sign = lower ? kiss_fft_scalar(1.0) : kiss_fft_scalar(-1.0);
+
+            kiss_fft_cpx a = in_a[k_half];
+            a.i *= sign;
+
+            kiss_fft_cpx b;
+            b.r = b.i = kiss_fft_scalar(0.0);
+            if (has_b)
+                {
+                b = in_b[k_half];
+                b.i *= sign;
+                }
+
+            buf_in[k].r = a.r - b.i;
+            buf_in[k].i = a.i + b.r;
+            }
+
+        kiss_fft(m_ifft_x, &buf_in.front(), &buf_out.front());
+
+        kiss_fft_scalar *out_a = out[mesh] + row_a*m_nx;
+        kiss_fft_scalar *out_b = out[mesh] + row_b*m_nx;
+        for (unsigned int j = 0; j < m_nx; ++j)
+            {
+            out_a[j] = buf_out[j].r;
+            if (has_b)
+                out_b[j] = buf_out[j].i;
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+    #endif
+    }
+
+/*! \param n_mesh Number of half spectra
+    \param data The half spectra
+    \param inverse True if this is an inverse transform
+*/
+void RealFFT3D::transformYZ(unsigned int n_mesh, kiss_fft_cpx * const *data, bool inverse)
+    {
+    // pass along y
+        {
+        // lines are indexed by (mesh, z, kx)
+        unsigned int n_lines_y = n_mesh*m_nz*m_nx_cpx;
+        kiss_fft_cfg cfg_y = inverse ? m_ifft_y : m_fft_y;
+
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_lines_y),
+            [&](const tbb::blocked_range<unsigned int>& range) {
+        std::vector<kiss_fft_cpx> buf_in(m_ny);
+        std::vector<kiss_fft_cpx> buf_out(m_ny);
+        for (unsigned int line = range.begin(); line != range.end(); ++line)
+        #else
+        std::vector<kiss_fft_cpx> buf_in(m_ny);
+        std::vector<kiss_fft_cpx> buf_out(m_ny);
+        for (unsigned int line = 0; line < n_lines_y; ++line)
+        #endif
+            {
+            unsigned int mesh = line / (m_nz*m_nx_cpx);
+            unsigned int z = (line / m_nx_cpx) % m_nz;
+            unsigned int kx = line % m_nx_cpx;
+
+            kiss_fft_cpx *first = data[mesh] + kx + m_nx_cpx*m_ny*z;
+            for (unsigned int y = 0; y < m_ny; ++y)
+                buf_in[y] = first[y*m_nx_cpx];
+
+            kiss_fft(cfg_y, &buf_in.front(), &buf_out.front());
+
+            for (unsigned int y = 0; y < m_ny; ++y)
+                first[y*m_nx_cpx] = buf_out[y];
+            }
+        #ifdef ENABLE_TBB
+            });
+        #endif
+        }
+
+    // pass along z
+        {
+        // lines are indexed by (mesh, y, kx)
+        unsigned int n_lines_z = n_mesh*m_ny*m_nx_cpx;
+        kiss_fft_cfg cfg_z = inverse ? m_ifft_z : m_fft_z;
+
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_lines_z),
+            [&](const tbb::blocked_range<unsigned int>& range) {
+        std::vector<kiss_fft_cpx> buf_in(m_nz);
+        std::vector<kiss_fft_cpx> buf_out(m_nz);
+        for (unsigned int line = range.begin(); line != range.end(); ++line)
+        #else
+        std::vector<kiss_fft_cpx> buf_in(m_nz);
+        std::vector<kiss_fft_cpx> buf_out(m_nz);
+        for (unsigned int line = 0; line < n_lines_z; ++line)
+        #endif
+            {
+            unsigned int mesh = line / (m_ny*m_nx_cpx);
+            unsigned int y = (line / m_nx_cpx) % m_ny;
+            unsigned int kx = line % m_nx_cpx;
+
+            kiss_fft_cpx *first = data[mesh] + kx + m_nx_cpx*y;
+            unsigned int stride = m_nx_cpx*m_ny;
+            for (unsigned int z = 0; z < m_nz; ++z)
+                buf_in[z] = first[z*stride];
+
+            kiss_fft(cfg_z, &buf_in.front(), &buf_out.front());
+
+            for (unsigned int z = 0; z < m_nz; ++z)
+                first[z*stride] = buf_out[z];
+            }
+        #ifdef ENABLE_TBB
+            });
+        #endif
+        }
+    }
@@ -0,0 +1,73 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __REAL_FFT_3D_H__
+#define __REAL_FFT_3D_H__
+
+#include "hoomd/extern/kiss_fft.h"
+
+#include <vector>
+
+/*! \file RealFFT3D.h
+    \brief Declares the RealFFT3D class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Local three-dimensional real-to-complex FFT
+/*! RealFFT3D transforms a real mesh of nx*ny*nz points, stored in row major order (x fastest), into the
+    non-redundant half of its spectrum, and back. The spectrum is stored in row major order with
+    nx/2+1 points along x, i.e. element (kx,ky,kz) is at kx + (nx/2+1)*(ky + ny*kz). The remaining modes follow
+    from Hermitian symmetry, F(-k) = conj(F(k)).
+
+    The transform is decomposed into one-dimensional kiss_fft passes. Along x, two real rows are packed into
+    the real and imaginary parts of one complex row, transformed together and separated using the symmetry of
+    the spectrum. The y and z passes are complex transforms of the nx/2+1 columns. Independent lines of every pass
+    are distributed over TBB threads if HOOMD is compiled with ENABLE_TBB.
+
+    inverse() transforms several meshes in one call, so that the lines of all of them are processed by the
+    same parallel passes.
+
+    As with kiss_fft, neither direction is normalized.
+*/
+class RealFFT3D
+    {
+    public:
+        //! Constructor
+        RealFFT3D(unsigned int nx, unsigned int ny, unsigned int nz);
+
+        //! Destructor
+        ~RealFFT3D();
+
+        //! Get the number of complex elements in the half spectrum
+        unsigned int getNumComplexElements() const
+            {
+            return (m_nx/2+1)*m_ny*m_nz;
+            }
+
+        //! Forward transform of a real mesh
+        void forward(const kiss_fft_scalar *in, kiss_fft_cpx *out);
+
+        //! Inverse transform of several half spectra into real meshes
+        void inverse(unsigned int n_mesh, kiss_fft_cpx * const *in, kiss_fft_scalar * const *out);
+
+    private:
+        unsigned int m_nx;          //!< Number of mesh points along x
+        unsigned int m_ny;          //!< Number of mesh points along y
+        unsigned int m_nz;          //!< Number of mesh points along z
+        unsigned int m_nx_cpx;      //!< Number of complex mesh points along x (nx/2+1)
+
+        kiss_fft_cfg m_fft_x;       //!< Forward transform along x
+        kiss_fft_cfg m_ifft_x;      //!< Inverse transform along x
+        kiss_fft_cfg m_fft_y;       //!< Forward transform along y
+        kiss_fft_cfg m_ifft_y;      //!< Inverse transform along y
+        kiss_fft_cfg m_fft_z;       //!< Forward transform along z
+        kiss_fft_cfg m_ifft_z;      //!< Inverse transform along z
+
+        //! Complex transforms along y and z of the half spectra, in place
+        void transformYZ(unsigned int n_mesh, kiss_fft_cpx * const *data, bool inverse);
+    };
+
+#endif // __REAL_FFT_3D_H__
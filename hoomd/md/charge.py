@@ -220,6 +220,142 @@ class pppm(force._force):
         # set the parameters for the appropriate type
         self.cpp_force.setParams(Nx, Ny, Nz, order, kappa, rcut, alpha);
 
+    def tune(self, accuracy, rcut_min, rcut_max, jumps=5, orders=None, max_mesh=512, warmup=1000, steps=1000, quiet=False):
+        R""" Make a series of short runs to determine the fastest PPPM parameters for a given accuracy.
+
+        Args:
+            accuracy (float): Target RMS error of the electrostatic force (in units of force)
+            rcut_min (float): Smallest short-range cutoff to test
+            rcut_max (float): Largest short-range cutoff to test
+            jumps (int): Number of different cutoffs to test
+            orders (list): Assignment orders to test (defaults to ``[4, 5, 6]``)
+            max_mesh (int): Largest number of grid points along any direction
+            warmup (int): Number of time steps to run() to warm up the benchmark
+            steps (int): Number of time steps to run() at each point
+            quiet (bool): Quiet the individual run() calls.
+
+        For every combination of the short-range cutoff (*jumps* values from *rcut_min* to *rcut_max*) and assignment
+        order in *orders*, :py:meth:`tune()` chooses the smallest mesh for which the error estimates of both the
+        real-space and the reciprocal-space part of the force stay below *accuracy*, and sets the parameters with
+        :py:meth:`set_params()`. It then runs for *steps* time steps and records the TPS value. Each benchmark is
+        repeated 3 times and the median value chosen. The fastest parameters are left set for further
+        :py:func:`hoomd.run()` calls.
+
+        Mesh sizes are products of powers of 2, 3 and 5 in single-rank simulations, and powers of two that are
+        divisible by the processor grid in MPI simulations.
+
+        In total, ``(warmup + 3*jumps*len(orders)*steps)`` time steps are run. Combinations that need more than
+        *max_mesh* grid points are skipped. Integration must be set up before calling :py:meth:`tune()`.
+
+        Returns:
+            (Nx, Ny, Nz, order, rcut) of the fastest combination
+
+        Example::
+
+            pppm.tune(accuracy=1e-4, rcut_min=1.5, rcut_max=3.0)
+
+        .. versionadded:: 2.10
+        """
+        hoomd.util.print_status_line();
+
+        # check if initialization has occurred
+        if not hoomd.init.is_initialized():
+            hoomd.context.msg.error("Cannot tune PPPM before initialization\n");
+            raise RuntimeError("Error tuning PPPM");
+
+        if orders is None:
+            orders = [4, 5, 6];
+
+        if accuracy <= 0.0:
+            hoomd.context.msg.error("charge.pppm: accuracy must be positive\n");
+            raise RuntimeError("Error tuning PPPM");
+
+        q2 = self.cpp_force.getQ2Sum();
+        if q2 == 0.0:
+            hoomd.context.msg.error("charge.pppm: Cannot tune PPPM for a system without charges\n");
+            raise RuntimeError("Error tuning PPPM");
+
+        pdata = hoomd.context.current.system_definition.getParticleData()
+        N = pdata.getNGlobal()
+        L = pdata.getGlobalBox().getL()
+        box_L = [L.x, L.y, L.z]
+
+        # number of domains along every direction
+        domains = [1, 1, 1]
+        if hoomd.comm.get_num_ranks() > 1:
+            dd = pdata.getDomainDecomposition()
+            domains = [len(dd.getCumulativeFractions(d))-1 for d in range(3)]
+
+        # build the list of candidate parameters
+        candidates = [];
+        for i in range(0,jumps):
+            rcut = rcut_min
+            if jumps > 1:
+                rcut += i * (rcut_max - rcut_min) / (jumps - 1);
+
+            # splitting parameter at which the real space error estimate equals the target
+            arg = accuracy * sqrt(N*rcut*box_L[0]*box_L[1]*box_L[2]) / (2.0*q2)
+            if arg >= 1.0:
+                kappa = 0.0
+            else:
+                kappa = sqrt(-math.log(arg)) / rcut
+
+            for order in orders:
+                if order < 1 or order > 7:
+                    hoomd.context.msg.error("charge.pppm: Interpolation order has to be between 1 and 7\n");
+                    raise RuntimeError("Error tuning PPPM");
+
+                mesh = [fft_mesh_size(box_L[d], N, order, kappa, q2, accuracy, max_mesh, domains[d]) for d in range(3)]
+                if None in mesh:
+                    hoomd.context.msg.notice(2, "charge.pppm: order " + str(order) + ", rcut " + str(rcut)
+                                             + " needs more than " + str(max_mesh) + " grid points, skipping\n");
+                    continue;
+
+                candidates.append((mesh[0], mesh[1], mesh[2], order, rcut))
+
+        if len(candidates) == 0:
+            hoomd.context.msg.error("charge.pppm: No parameters reach an accuracy of " + str(accuracy)
+                                    + " with at most " + str(max_mesh) + " grid points\n");
+            raise RuntimeError("Error tuning PPPM");
+
+        # quiet the tuner starting here so that the user doesn't see all of the parameter set and run calls
+        hoomd.util.quiet_status();
+
+        # make the warmup run
+        self.set_params(*candidates[0]);
+        hoomd.run(warmup, quiet=quiet);
+
+        tps_list = [];
+        for params in candidates:
+            self.set_params(*params);
+
+            # run the benchmark 3 times
+            tps = [];
+            hoomd.run(steps, quiet=quiet);
+            tps.append(hoomd.context.current.system.getLastTPS())
+            hoomd.run(steps, quiet=quiet);
+            tps.append(hoomd.context.current.system.getLastTPS())
+            hoomd.run(steps, quiet=quiet);
+            tps.append(hoomd.context.current.system.getLastTPS())
+
+            # record the median tps of the 3
+            tps.sort();
+            tps_list.append(tps[1]);
+
+        # find the fastest parameters
+        fastest = candidates[tps_list.index(max(tps_list))];
+        self.set_params(*fastest);
+
+        # all done with the parameter sets and run calls
+        hoomd.util.unquiet_status();
+
+        # notify the user of the benchmark results
+        hoomd.context.msg.notice(2, "(Nx, Ny, Nz, order, rcut) = " + str(candidates) + '\n');
+        hoomd.context.msg.notice(2, "tps = " + str(tps_list) + '\n');
+        hoomd.context.msg.notice(2, "Optimal PPPM parameters: " + str(fastest) + '\n');
+
+        return fastest;
+
     def update_coeffs(self):
         if not self.params_set:
             hoomd.context.msg.error("Coefficients for PPPM are not set. Call set_coeff prior to run()\n");
@@ -274,3 +410,25 @@ def rms(h, prd, N, order, kappa, q2):
         sum += acons[order][m]*pow(h*kappa, 2.0*m)
     value = q2*pow(h*kappa,order)*sqrt(kappa*prd*sqrt(2.0*math.pi)*sum/N)/prd/prd
     return value
+
+def fft_mesh_size(prd, N, order, kappa, q2, accuracy, max_mesh, n_domains):
+    # smallest number of grid points for which the reciprocal space error estimate reaches the accuracy
+    # returns None if more than max_mesh grid points are needed
+    for n in range(n_domains, max_mesh+1, n_domains):
+        if n_domains > 1:
+            # distributed FFTs need powers of two
+            if n & (n-1):
+                continue
+        else:
+            # mesh sizes with small prime factors
+            m = n
+            for p in (2, 3, 5):
+                while m % p == 0:
+                    m //= p
+            if m != 1:
+                continue
+
+        if rms(prd/n, prd, N, order, kappa, q2) <= accuracy:
+            return n
+
+    return None
@@ -38,6 +38,7 @@
 #include "PotentialBond.h"
 #include "PotentialExternal.h"
 #include "PotentialPairDPDThermo.h"
+#include "PotentialPairDSF.h"
 #include "PotentialPair.h"
 #include "PotentialTersoff.h"
 #include "PPPMForceCompute.h"
@@ -81,6 +82,7 @@
 #include "PotentialBondGPU.h"
 #include "PotentialExternalGPU.h"
 #include "PotentialPairDPDThermoGPU.h"
+#include "PotentialPairDSFGPU.h"
 #include "PotentialPairGPU.h"
 #include "PotentialTersoffGPU.h"
 #include "PPPMForceComputeGPU.h"
@@ -259,6 +261,7 @@ PYBIND11_MODULE(_md, m)
     export_PotentialPair<PotentialPairSLJ>(m, "PotentialPairSLJ");
     export_PotentialPair<PotentialPairYukawa>(m, "PotentialPairYukawa");
     export_PotentialPair<PotentialPairEwald>(m, "PotentialPairEwald");
+    export_PotentialPairDSF(m);
     export_PotentialPair<PotentialPairMorse>(m, "PotentialPairMorse");
     export_PotentialPair<PotentialPairDPD>(m, "PotentialPairDPD");
     export_PotentialPair<PotentialPairMoliere>(m, "PotentialPairMoliere");
@@ -320,6 +323,7 @@ PYBIND11_MODULE(_md, m)
     export_PotentialPairGPU<PotentialPairDLVOGPU, PotentialPairDLVO>(m, "PotentialPairDLVOGPU");
     export_PotentialPairGPU<PotentialPairFourierGPU, PotentialPairFourier>(m, "PotentialPairFourierGPU");
     export_PotentialPairGPU<PotentialPairEwaldGPU, PotentialPairEwald>(m, "PotentialPairEwaldGPU");
+    export_PotentialPairDSFGPU(m);
     export_PotentialPairGPU<PotentialPairMorseGPU, PotentialPairMorse>(m, "PotentialPairMorseGPU");
     export_PotentialPairGPU<PotentialPairDPDGPU, PotentialPairDPD>(m, "PotentialPairDPDGPU");
     export_PotentialPairGPU<PotentialPairMoliereGPU, PotentialPairMoliere>(m, "PotentialPairMoliereGPU");
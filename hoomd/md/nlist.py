@@ -126,7 +126,7 @@ class nlist:
             self.cpp_nlist.addExclusion(i, j)
             hoomd.util.unquiet_status();
 
-    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True):
+    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True, topology_exclusions=None):
         R""" Change neighbor list parameters.
 
         Args:
@@ -138,6 +138,8 @@ class nlist:
               run() commands. (in distance units)
             dist_check (bool): When set to False, disable the distance checking logic and always regenerate the nlist every
               *check_period* steps
+            topology_exclusions (bool): (if set) When True, derive the **bond**, **angle**, **dihedral**, **constraint**
+              and **pair** exclusions from the bonded groups of the local particles instead of storing them by tag
 
         :py:meth:`set_params()` changes one or more parameters of the neighbor list. *r_buff* and *check_period*
         can have a significant effect on performance. As *r_buff* is made larger, the neighbor list needs
@@ -171,12 +173,20 @@ class nlist:
             **MUST** be left at the default value of 1.0 or the simulation will be incorrect if d_max is less than 1.0
             and slower than necessary if d_max is greater than 1.0.
 
+        By default, every rank stores the exclusions of all particles in the system by tag. With
+        *topology_exclusions=True*, the exclusions of bonded groups (see :py:meth:`reset_exclusions()`) are instead
+        derived from the bonds, angles, dihedrals, constraints and special pairs of the local particles whenever the
+        particles are sorted or migrate. This saves memory in large MPI simulations of molecules, and groups that are
+        added or removed later are excluded automatically. The **1-3** and **1-4** exclusions and exclusions added with
+        :py:meth:`add_exclusion()` are still stored by tag.
+
         Examples::
 
             nl.set_params(r_buff = 0.9)
             nl.set_params(check_period = 11)
             nl.set_params(r_buff = 0.7, check_period = 4)
             nl.set_params(d_max = 3.0)
+            nl.set_params(topology_exclusions = True)
         """
         hoomd.util.print_status_line();
 
@@ -195,6 +205,17 @@ class nlist:
         if d_max is not None:
             self.cpp_nlist.setMaximumDiameter(d_max);
 
+        if topology_exclusions is not None:
+            self.cpp_nlist.setTopologyExclusions(topology_exclusions);
+
+            # store the current exclusions in the new representation
+            if self.is_exclusion_overridden:
+                hoomd.util.quiet_status();
+                self.reset_exclusions(exclusions=self.exclusions);
+                for i, j in self.exclusion_list:
+                    self.cpp_nlist.addExclusion(i, j)
+                hoomd.util.unquiet_status();
+
     def reset_exclusions(self, exclusions = None):
         R""" Resets all exclusions in the neighborlist.
 
@@ -971,6 +971,103 @@ class ewald(pair):
         raise RuntimeError('Not implemented for DPD Conservative');
         return;
 
+class dsf(pair):
+    R""" Damped shifted force electrostatics.
+
+    Args:
+        r_cut (float): Default cutoff radius (in distance units).
+        nlist (:py:mod:`hoomd.md.nlist`): Neighbor list
+        name (str): Name of the force instance.
+
+    :py:class:`dsf` specifies that the damped shifted force (DSF) potential of
+    `Fennell and Gezelter 2006 <http://dx.doi.org/10.1063/1.2206581>`_ should be applied between every
+    non-excluded particle pair in the simulation. DSF is a mesh-free, purely real space approximation to the
+    Ewald sum, and an alternative to :py:class:`hoomd.md.charge.pppm` for homogeneous, dense systems.
+
+    .. math::
+        :nowrap:
+
+        \begin{eqnarray*}
+         V_{\mathrm{DSF}}(r)  = & q_i q_j \left[\frac{\mathrm{erfc}(\alpha r)}{r}
+                                  - \frac{\mathrm{erfc}(\alpha r_{\mathrm{cut}})}{r_{\mathrm{cut}}}
+                                  + \left(\frac{\mathrm{erfc}(\alpha r_{\mathrm{cut}})}{r_{\mathrm{cut}}^2}
+                                  + \frac{2\alpha}{\sqrt{\pi}}\frac{\exp(-\alpha^2 r_{\mathrm{cut}}^2)}{r_{\mathrm{cut}}}\right)
+                                  (r-r_{\mathrm{cut}})\right] & r < r_{\mathrm{cut}} \\
+                            = & 0 & r \ge r_{\mathrm{cut}} \\
+        \end{eqnarray*}
+
+    Both the potential and the force vanish smoothly at the cutoff, so :py:class:`dsf` has no energy shift modes.
+    In addition, every particle carries the self energy
+
+    .. math::
+
+        V_{\mathrm{self},i} = -\left(\frac{\mathrm{erfc}(\alpha r_{\mathrm{cut}})}{2 r_{\mathrm{cut}}}
+                              + \frac{\alpha}{\sqrt{\pi}}\right) q_i^2
+
+    where :math:`\alpha` and :math:`r_{\mathrm{cut}}` are taken from the type pair (i,i). The self energy does not
+    depend on the particle positions. It is included in the logged energy of :py:class:`dsf` and in the potential
+    energy reported by :py:class:`hoomd.compute.thermo`, but not in the per particle energies.
+
+    Use :py:meth:`pair_coeff.set <coeff.set>` to set potential coefficients.
+
+    The following coefficients must be set per unique pair of particle types:
+
+    - :math:`\alpha` - *alpha* (Damping parameter, in 1/distance units)
+      - *optional*: defaults to 0.2
+    - :math:`r_{\mathrm{cut}}` - *r_cut* (in distance units)
+      - *optional*: defaults to the global r_cut specified in the pair command
+
+    .. versionadded:: 2.10
+
+    Example::
+
+        nl = nlist.cell()
+        dsf = pair.dsf(r_cut=3.0, nlist=nl)
+        dsf.pair_coeff.set('A', 'A', alpha=0.2)
+        dsf.pair_coeff.set(['A', 'B'], 'B', alpha=0.2, r_cut=2.5)
+
+    """
+    def __init__(self, r_cut, nlist, name=None):
+        hoomd.util.print_status_line();
+
+        # initialize the base class
+        pair.__init__(self, r_cut, nlist, name);
+
+        # create the c++ mirror class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            self.cpp_force = _md.PotentialPairDSF(hoomd.context.current.system_definition, self.nlist.cpp_nlist, self.name);
+            self.cpp_class = _md.PotentialPairDSF;
+        else:
+            self.nlist.cpp_nlist.setStorageMode(_md.NeighborList.storageMode.full);
+            self.cpp_force = _md.PotentialPairDSFGPU(hoomd.context.current.system_definition, self.nlist.cpp_nlist, self.name);
+            self.cpp_class = _md.PotentialPairDSFGPU;
+
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
+
+        # setup the coefficient options
+        self.required_coeffs = ['alpha'];
+        self.pair_coeff.set_default_coeff('alpha', 0.2);
+
+    def process_coeff(self, coeff):
+        alpha = coeff['alpha'];
+        r_cut = coeff['r_cut'];
+
+        # precompute the potential and force shifts at the cutoff
+        v_shift = 0.0;
+        f_shift = 0.0;
+        if r_cut > 0:
+            erfc_rc = math.erfc(alpha*r_cut);
+            v_shift = erfc_rc/r_cut;
+            f_shift = erfc_rc/r_cut**2 + 2.0*alpha/math.sqrt(math.pi)*math.exp(-alpha**2*r_cut**2)/r_cut;
+
+        return _hoomd.make_scalar3(alpha, v_shift, f_shift);
+
+    def set_params(self, mode=None):
+        """ :py:class:`dsf` has no energy shift modes """
+
+        hoomd.context.msg.error("pair.dsf: the DSF potential is always shifted, set_params is not supported\n");
+        raise RuntimeError('Error changing parameters in pair force');
+
 def _table_eval(r, rmin, rmax, V, F, width):
     dr = (rmax - rmin) / float(width-1);
     i = int(round((r - rmin)/dr))
@@ -100,6 +100,14 @@ class analyze_log_query_tests (unittest.TestCase):
         self.assertNotEqual(U0, U1);
         self.assertNotEqual(K0, K1);
 
+    # tests that loggers logging the same quantity agree
+    def test_shared(self):
+        log1 = hoomd.analyze.log(quantities = ['pair_lj_energy', 'kinetic_energy'], period = 10, filename=None);
+        log2 = hoomd.analyze.log(quantities = ['pair_lj_energy'], period = 5, filename=None);
+        hoomd.run(21);
+        self.assertEqual(log1.query('pair_lj_energy'), log2.query('pair_lj_energy'));
+        self.assertNotEqual(log2.query('pair_lj_energy'), 0);
+
     # tests basic creation of the analyzer
     def test_with_file(self):
         if hoomd.comm.get_rank() == 0:
@@ -131,6 +139,61 @@ class analyze_log_query_tests (unittest.TestCase):
         hoomd.context.initialize();
 
 
+# test analyze.log_binary
+class analyze_log_binary_tests (unittest.TestCase):
+    def setUp(self):
+        init.create_lattice(lattice.sc(a=1.5),n=[5,5,4]);
+        hoomd.md.integrate.mode_standard(dt=0.005);
+        hoomd.md.integrate.nve(hoomd.group.all());
+
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.bin');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+    # test that the file contains the logged rows
+    def test(self):
+        log = hoomd.analyze.log_binary(quantities = ['kinetic_energy', 'test1'], period = 10, filename=self.tmp_file,
+                                       buffer_rows=3);
+        log.register_callback('test1', lambda timestep: timestep * 0.5);
+        hoomd.run(100);
+        log.flush();
+
+        if hoomd.comm.get_rank() == 0:
+            data = hoomd.analyze.read_log_binary(self.tmp_file);
+            self.assertEqual(list(data.keys()), ['timestep', 'kinetic_energy', 'test1']);
+            numpy.testing.assert_array_equal(data['timestep'], numpy.arange(0, 100, 10));
+            numpy.testing.assert_array_equal(data['test1'], numpy.arange(0, 100, 10) * 0.5);
+
+    # test appending and the check of the logged quantities
+    def test_append(self):
+        log = hoomd.analyze.log_binary(quantities = ['test1'], period = 10, filename=self.tmp_file);
+        hoomd.run(50);
+        log.flush();
+        # the file is only checked on the root rank
+        if hoomd.comm.get_num_ranks() == 1:
+            self.assertRaises(RuntimeError, log.set_params, quantities=['test2']);
+        log.disable();
+        del log;
+
+        log = hoomd.analyze.log_binary(quantities = ['test1'], period = 10, filename=self.tmp_file, phase=0);
+        hoomd.run(50);
+        log.flush();
+
+        if hoomd.comm.get_rank() == 0:
+            data = hoomd.analyze.read_log_binary(self.tmp_file);
+            numpy.testing.assert_array_equal(data['timestep'], numpy.arange(0, 100, 10));
+
+        if hoomd.comm.get_num_ranks() == 1:
+            self.assertRaises(RuntimeError, hoomd.analyze.log_binary, quantities = ['test2'], period = 10,
+                              filename=self.tmp_file);
+
+    def tearDown(self):
+        hoomd.context.initialize();
+        if (hoomd.comm.get_rank()==0):
+            os.remove(self.tmp_file);
+
 try:
     import h5py
 except ImportError:
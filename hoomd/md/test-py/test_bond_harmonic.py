@@ -101,6 +101,42 @@ class bond_harmonic_tests (unittest.TestCase):
         del lj
         del harmonic
 
+    # test exclusions derived from the local topology
+    def test_topology_exclusions(self):
+        harmonic = md.bond.harmonic();
+        harmonic.bond_coeff.set('polymer', k=1.0, r0=1.0)
+        nl = md.nlist.cell()
+        nl.set_params(topology_exclusions=True)
+        self.assertTrue(nl.cpp_nlist.getTopologyExclusions())
+        lj = md.pair.lj(r_cut=3.0, nlist = nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        lj.pair_coeff.set('A', 'B', epsilon=1.0, sigma=1.0);
+        lj.pair_coeff.set('B', 'B', epsilon=1.0, sigma=1.0);
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(all);
+        run(100)
+
+        self.assertEqual(nl.cpp_nlist.getNumExclusions(2), (17*100+2*10))
+        self.assertEqual(nl.cpp_nlist.getNumExclusions(1), (2*100+2*10))
+
+        # removed bonds are no longer excluded, without resetting the exclusions
+        tags = []
+        for b in self.s.bonds:
+            if b.a == 2 or b.b == 2:
+                tags.append(b.tag)
+
+        for t in tags:
+            self.s.bonds.remove(t)
+
+        self.assertEqual(nl.cpp_nlist.getNumExclusions(2), (17*100+2*10)-3)
+        self.assertEqual(nl.cpp_nlist.getNumExclusions(1), (2*100+2*10)+2)
+
+        run(100)
+        del nl
+        del lj
+        del harmonic
+
     def tearDown(self):
         del self.s
         context.initialize();
@@ -32,6 +32,25 @@ class charge_pppm_tests (unittest.TestCase):
         del all
         del c
 
+    # test automatic parameter selection
+    def test_tune(self):
+        all = group.all()
+        nl = md.nlist.cell()
+        c = md.charge.pppm(all, nlist = nl);
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(all);
+        (Nx, Ny, Nz, order, rcut) = c.tune(accuracy=1e-2, rcut_min=1.5, rcut_max=2.0, jumps=2, orders=[4,5], warmup=10, steps=10);
+        self.assertTrue(order in [4,5]);
+        self.assertTrue(rcut >= 1.5 and rcut <= 2.0);
+        self.assertTrue(Nx > 0 and Ny > 0 and Nz > 0);
+        run(10);
+
+        # unreachable accuracy
+        self.assertRaises(RuntimeError, c.tune, accuracy=1e-12, rcut_min=1.5, rcut_max=2.0, max_mesh=16);
+
+        del all
+        del c
+
     # Cannot test pppm multiple times currently because of implementation limitations
     ## test missing coefficients
     #def test_set_missing_coeff(self):
@@ -0,0 +1,103 @@
+# -*- coding: iso-8859-1 -*-
+
+from hoomd import *
+from hoomd import md
+import unittest
+import os
+
+context.initialize()
+
+# md.pair.dsf
+class pair_dsf_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        system = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.nl = md.nlist.cell()
+        context.current.sorter.set_params(grid=8)
+
+    # basic test of creation
+    def test(self):
+        dsf = md.pair.dsf(r_cut=3.0, nlist = self.nl);
+        dsf.pair_coeff.set('A', 'A', r_cut=1.0, alpha=0.3);
+        dsf.update_coeffs();
+
+    # test default coefficients
+    def test_default_alpha(self):
+        dsf = md.pair.dsf(r_cut=3.0, nlist = self.nl);
+        dsf.pair_coeff.set('A', 'A', r_cut=1.0);
+        dsf.update_coeffs();
+
+    # test missing coefficients
+    def test_missing_AA(self):
+        dsf = md.pair.dsf(r_cut=3.0, nlist = self.nl);
+        self.assertRaises(RuntimeError, dsf.update_coeffs);
+
+    # test that shift modes are rejected
+    def test_set_params(self):
+        dsf = md.pair.dsf(r_cut=3.0, nlist = self.nl);
+        self.assertRaises(RuntimeError, dsf.set_params, mode='xplor');
+
+    # test nlist subscribe
+    def test_nlist_subscribe(self):
+        dsf = md.pair.dsf(r_cut=2.5, nlist = self.nl);
+
+        dsf.pair_coeff.set('A', 'A', alpha=0.3)
+        self.nl.update_rcut();
+        self.assertAlmostEqual(2.5, self.nl.r_cut.get_pair('A','A'));
+
+        dsf.pair_coeff.set('A', 'A', r_cut = 2.0)
+        self.nl.update_rcut();
+        self.assertAlmostEqual(2.0, self.nl.r_cut.get_pair('A','A'));
+
+    def tearDown(self):
+        del self.nl
+        context.initialize();
+
+# test the validity of the pair potential
+class test_pair_dsf_potential(unittest.TestCase):
+    def setUp(self):
+        snap = data.make_snapshot(N=2, box=data.boxdim(L=10),particle_types=['A'])
+        if comm.get_rank() == 0:
+            snap.particles.charge[0] = 1
+            snap.particles.charge[1] = 2
+            snap.particles.position[0] = (0,0,0)
+            snap.particles.position[1] = (0.5,0,0)
+        init.read_snapshot(snap)
+        self.nl = md.nlist.cell()
+
+    # test the calculation of force, potential and self energy
+    def test_potential(self):
+        dsf = md.pair.dsf(r_cut=2.0, nlist = self.nl)
+        dsf.pair_coeff.set('A','A', alpha=0.3)
+
+        md.integrate.mode_standard(dt=0)
+        nve = md.integrate.nve(group = group.all())
+        log = analyze.log(filename=None, quantities=['pair_dsf_energy', 'potential_energy'], period=1)
+        run(1)
+        f0 = dsf.forces[0].force
+        f1 = dsf.forces[1].force
+        e0 = dsf.forces[0].energy
+        e1 = dsf.forces[1].energy
+
+        # per particle energies only contain the pair term
+        self.assertAlmostEqual(e0,0.5*2.280505,5)
+        self.assertAlmostEqual(e1,0.5*2.280505,5)
+
+        self.assertAlmostEqual(f0[0],-7.545716,5)
+        self.assertAlmostEqual(f0[1],0)
+        self.assertAlmostEqual(f0[2],0)
+
+        self.assertAlmostEqual(f1[0],7.545716,5)
+        self.assertAlmostEqual(f1[1],0)
+        self.assertAlmostEqual(f1[2],0)
+
+        # the total energy includes the self energy -1.341464
+        self.assertAlmostEqual(log.query('pair_dsf_energy'),0.939040,5)
+        self.assertAlmostEqual(log.query('potential_energy'),0.939040,5)
+
+    def tearDown(self):
+        del self.nl
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -204,6 +204,93 @@ void comparison_test(std::shared_ptr<ExecutionConfiguration> exec_conf_cpu, std:
         }
     }
 
+//! Test that updating the molecule table after a sort gives the same result as building it from scratch
+void incremental_update_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    unsigned int nptl = 100;
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(nptl, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    unsigned int niter = 100;
+
+    std::vector<unsigned int> molecule_tags(nptl, NO_MOLECULE);
+    hoomd::RandomGenerator rng(654321);
+
+    MyMolecularForceCompute mfc(sysdef, molecule_tags, 0);
+
+    for (unsigned i = 0; i < niter; ++i)
+        {
+        // change the molecule tags of a few particles
+        for (unsigned int j = 0; j < 5; ++j)
+            {
+            unsigned int t = hoomd::UniformIntDistribution(nptl/4)(rng);
+            if (t == nptl/4) t = NO_MOLECULE;
+
+            molecule_tags[hoomd::UniformIntDistribution(nptl-1)(rng)] = t;
+            }
+
+        std::set<unsigned int> unique_tags;
+        for (auto it = molecule_tags.begin(); it != molecule_tags.end(); ++it)
+            {
+            if (*it != NO_MOLECULE) unique_tags.insert(*it);
+            }
+
+        mfc.setNMolecules(unique_tags.size());
+        mfc.setMoleculeTags(molecule_tags);
+
+            {
+            // randomly permute the particles
+            ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+            for (unsigned int j = nptl-1; j > 0; --j)
+                {
+                unsigned int k = hoomd::UniformIntDistribution(j)(rng);
+                std::swap(h_tag.data[j], h_tag.data[k]);
+                }
+            for (unsigned int j = 0; j < nptl; ++j)
+                h_rtag.data[h_tag.data[j]] = j;
+            }
+        pdata->notifyParticleSort();
+
+        MyMolecularForceCompute mfc_ref(sysdef, molecule_tags, unique_tags.size());
+
+            {
+            ArrayHandle<unsigned int> h_molecule_length(mfc.getMoleculeLengths(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_list(mfc.getMoleculeList(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_idx(mfc.getMoleculeIndex(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_order(mfc.getMoleculeOrder(), access_location::host, access_mode::read);
+            Index2D molecule_indexer = mfc.getMoleculeIndexer();
+
+            ArrayHandle<unsigned int> h_molecule_length_ref(mfc_ref.getMoleculeLengths(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_list_ref(mfc_ref.getMoleculeList(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_idx_ref(mfc_ref.getMoleculeIndex(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_molecule_order_ref(mfc_ref.getMoleculeOrder(), access_location::host, access_mode::read);
+            Index2D molecule_indexer_ref = mfc_ref.getMoleculeIndexer();
+
+            UP_ASSERT_EQUAL(molecule_indexer.getW(),molecule_indexer_ref.getW());
+            UP_ASSERT_EQUAL(molecule_indexer.getH(),molecule_indexer_ref.getH());
+
+            for (unsigned int j = 0; j < molecule_indexer_ref.getH(); ++j)
+                {
+                UP_ASSERT_EQUAL(h_molecule_length.data[j], h_molecule_length_ref.data[j]);
+
+                for (unsigned int k = 0; k < h_molecule_length_ref.data[j]; ++k)
+                    {
+                    UP_ASSERT_EQUAL(h_molecule_list.data[molecule_indexer(k,j)],
+                        h_molecule_list_ref.data[molecule_indexer_ref(k,j)]);
+                    }
+                }
+
+            for (unsigned int j = 0; j < nptl; ++j)
+                {
+                UP_ASSERT_EQUAL(h_molecule_idx.data[j], h_molecule_idx_ref.data[j]);
+                UP_ASSERT_EQUAL(h_molecule_order.data[j], h_molecule_order_ref.data[j]);
+                }
+            }
+        }
+    }
+
 
 //! test case for particle test on CPU
 UP_TEST( MolecularForceCompute_basic )
@@ -211,6 +298,12 @@ UP_TEST( MolecularForceCompute_basic )
     basic_molecule_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for incremental molecule table updates on CPU
+UP_TEST( MolecularForceCompute_incremental )
+    {
+    incremental_update_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 # ifdef ENABLE_CUDA
 //! test case for particle test on GPU
 UP_TEST( MolecularForceCompute_basic_GPU)
@@ -19,6 +19,8 @@ HOOMD_UP_MAIN()
 #include "hoomd/ConstForceCompute.h"
 #include "hoomd/md/TwoStepNVE.h"
 #include "hoomd/md/IntegratorTwoStep.h"
+#include "hoomd/md/AllPairPotentials.h"
+#include "hoomd/md/NeighborListTree.h"
 
 #ifdef ENABLE_CUDA
 #include "hoomd/CommunicatorGPU.h"
@@ -3443,6 +3445,604 @@ void test_communicator_ghosts_per_type(communicator_creator comm_creator, std::s
         }
     }
 
+//! Pair potential that counts how often the forces between local particles are computed ahead of the ghost update
+class PotentialPairLJInteriorCount : public PotentialPairLJ
+    {
+    public:
+        PotentialPairLJInteriorCount(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<NeighborList> nlist)
+            : PotentialPairLJ(sysdef, nlist), m_num_interior(0)
+            {
+            }
+
+        virtual void computeInterior(unsigned int timestep)
+            {
+            PotentialPairLJ::computeInterior(timestep);
+            if (m_interior_computed)
+                m_num_interior++;
+            }
+
+        unsigned int m_num_interior; //!< Number of time steps with an interior pass
+    };
+
+//! Test that pair forces computed during the ghost update agree with a full computation
+void test_communicator_overlap_forces(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a slightly perturbed simple cubic lattice
+    unsigned int n_side = 10;
+    unsigned int n = n_side*n_side*n_side;
+    Scalar a = 1.2;
+    BoxDim box(a*n_side);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n,           // number of particles
+                                                             box,         // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    Scalar3 lo = pdata->getBox().getLo();
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        unsigned int ix = i % n_side;
+        unsigned int iy = (i / n_side) % n_side;
+        unsigned int iz = i / (n_side*n_side);
+        snap.pos[i] = vec3<Scalar>(lo.x + a*(ix + Scalar(0.5)) + Scalar(0.1)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                   lo.y + a*(iy + Scalar(0.5)) + Scalar(0.1)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                   lo.z + a*(iz + Scalar(0.5)) + Scalar(0.1)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        snap.vel[i] = vec3<Scalar>((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5),
+                                   (Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5));
+        }
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), 2, 2, 2));
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.3)));
+    std::shared_ptr<PotentialPairLJInteriorCount> fc(new PotentialPairLJInteriorCount(sysdef, nlist));
+    fc->setRcut(0, 0, Scalar(2.5));
+    fc->setParams(0, 0, make_scalar2(Scalar(4.0), Scalar(4.0)));
+    fc->setShiftMode(PotentialPairLJ::shift);
+
+    std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata->getNGlobal()-1));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+    std::shared_ptr<TwoStepNVE> two_step_nve(new TwoStepNVE(sysdef, group_all));
+
+    std::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, Scalar(0.002)));
+    nve_up->addIntegrationMethod(two_step_nve);
+    nve_up->addForceCompute(fc);
+
+    nlist->setCommunicator(comm);
+    fc->setCommunicator(comm);
+    nve_up->setCommunicator(comm);
+
+    // request the virial so that it is checked, too
+    PDataFlags flags;
+    flags[pdata_flag::potential_energy] = 1;
+    flags[pdata_flag::pressure_tensor] = 1;
+    pdata->setFlags(flags);
+
+    nve_up->prepRun(0);
+
+    for (unsigned int step = 0; step < 100; ++step)
+        {
+        nve_up->update(step);
+
+        // copy the forces computed during the step
+        unsigned int N = pdata->getN();
+        std::vector<Scalar4> force(N);
+        std::vector<Scalar> virial(6*N);
+            {
+            ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+            unsigned int pitch = fc->getVirialArray().getPitch();
+            for (unsigned int i = 0; i < N; ++i)
+                {
+                force[i] = h_force.data[i];
+                for (unsigned int k = 0; k < 6; ++k)
+                    virial[6*i+k] = h_virial.data[k*pitch+i];
+                }
+            }
+
+        // recompute all pairs at once
+        fc->forceCompute(step+1);
+
+        ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc->getVirialArray().getPitch();
+        Scalar tol = Scalar(1e-6);
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            CHECK_SMALL(force[i].x - h_force.data[i].x, tol);
+            CHECK_SMALL(force[i].y - h_force.data[i].y, tol);
+            CHECK_SMALL(force[i].z - h_force.data[i].z, tol);
+            CHECK_SMALL(force[i].w - h_force.data[i].w, tol);
+            for (unsigned int k = 0; k < 6; ++k)
+                CHECK_SMALL(virial[6*i+k] - h_virial.data[k*pitch+i], tol);
+            }
+        }
+
+    // the neighbor list is not rebuilt in every step, so most steps should have used the interior pass
+    UP_ASSERT(fc->m_num_interior > 0);
+    }
+
+//! Check that every particle within the ghost layer of the local domain is present
+void check_ghost_layer(std::shared_ptr<ParticleData> pdata, const std::vector<Scalar3>& global_pos, Scalar r_ghost)
+    {
+    const BoxDim& box = pdata->getBox();
+    const BoxDim& global_box = pdata->getGlobalBox();
+    const Scalar3 ghost_fraction = r_ghost / box.getNearestPlaneDistance();
+    const Scalar3 L = global_box.getL();
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    RTagHandle h_rtag(*pdata, access_mode::read);
+
+    // all local particles are inside the local box
+    for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+        {
+        Scalar3 f = box.makeFraction(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z));
+        UP_ASSERT(f.x >= Scalar(0.0) && f.x < Scalar(1.0));
+        UP_ASSERT(f.y >= Scalar(0.0) && f.y < Scalar(1.0));
+        UP_ASSERT(f.z >= Scalar(0.0) && f.z < Scalar(1.0));
+        }
+
+    // every periodic image within the ghost layer is a local particle or a ghost
+    unsigned int n_missing = 0;
+    for (unsigned int tag = 0; tag < global_pos.size(); ++tag)
+        {
+        bool needed = false;
+        for (int i = -1; i <= 1; ++i)
+            for (int j = -1; j <= 1; ++j)
+                for (int k = -1; k <= 1; ++k)
+                    {
+                    Scalar3 pos = global_pos[tag] + make_scalar3(i*L.x, j*L.y, k*L.z);
+                    Scalar3 f = box.makeFraction(pos);
+                    if (f.x >= -ghost_fraction.x && f.x < Scalar(1.0) + ghost_fraction.x &&
+                        f.y >= -ghost_fraction.y && f.y < Scalar(1.0) + ghost_fraction.y &&
+                        f.z >= -ghost_fraction.z && f.z < Scalar(1.0) + ghost_fraction.z)
+                        needed = true;
+                    }
+
+        if (needed && h_rtag[tag] >= pdata->getN() + pdata->getNGhosts())
+            n_missing++;
+        }
+    UP_ASSERT_EQUAL(n_missing, 0);
+    }
+
+//! Test ghost exchange and migration between domains with staggered cuts
+void test_communicator_staggered(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                 unsigned int nx, unsigned int ny, unsigned int nz)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    unsigned int n = 1000;
+    BoxDim box(6.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n,           // number of particles
+                                                             box,         // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+
+    std::vector<Scalar3> global_pos(n);
+    srand(54321);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        global_pos[i] = make_scalar3(Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        int3 img = make_int3(0,0,0);
+        box.wrap(global_pos[i], img);
+        snap.pos[i] = vec3<Scalar>(global_pos[i]);
+        }
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), nx, ny, nz));
+    decomposition->setStaggered(true);
+    UP_ASSERT(decomposition->isStaggered());
+
+    // shift the cuts of every slab and column, keeping neighbors within one domain
+    std::vector<Scalar> frac_y = decomposition->getStaggeredFractions(1);
+    for (unsigned int i = 0; i < nx; ++i)
+        for (unsigned int j = 1; j < ny; ++j)
+            frac_y[i*(ny+1)+j] += ((i % 2) ? Scalar(0.2) : Scalar(-0.2))/Scalar(ny);
+    decomposition->setStaggeredFractions(1, frac_y, 0);
+
+    std::vector<Scalar> frac_z = decomposition->getStaggeredFractions(2);
+    for (unsigned int c = 0; c < nx*ny; ++c)
+        for (unsigned int k = 1; k < nz; ++k)
+            frac_z[c*(nz+1)+k] += Scalar(0.3)*(Scalar(c % 3) - Scalar(1.0))/Scalar(nz);
+    decomposition->setStaggeredFractions(2, frac_z, 0);
+
+    // the local cuts are those of the local slab and column
+    uint3 grid_pos = decomposition->getGridPos();
+    UP_ASSERT_EQUAL(decomposition->getCumulativeFraction(1, 1), frac_y[grid_pos.x*(ny+1)+1]);
+    UP_ASSERT_EQUAL(decomposition->getCumulativeFraction(2, 1), frac_z[(grid_pos.y*nx+grid_pos.x)*(nz+1)+1]);
+
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    Scalar r_ghost(0.5);
+    ghost_layer_width g(r_ghost);
+    comm->getGhostLayerWidthRequestSignal().connect<ghost_layer_width, &ghost_layer_width::get>(g);
+
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    check_ghost_layer(pdata, global_pos, r_ghost);
+
+    // displace all particles, and migrate them between the staggered domains
+    for (unsigned int step = 0; step < 3; ++step)
+        {
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+            // like an integrator, only wrap along the periodic directions of the local box
+            const BoxDim& local_box = pdata->getBox();
+            for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+                {
+                unsigned int tag = h_tag.data[idx];
+                Scalar3 d = make_scalar3(Scalar(0.2)*sin(Scalar(tag)), Scalar(0.2)*cos(Scalar(3*tag)), Scalar(0.2)*sin(Scalar(7*tag)));
+                h_pos.data[idx].x += d.x;
+                h_pos.data[idx].y += d.y;
+                h_pos.data[idx].z += d.z;
+                local_box.wrap(h_pos.data[idx], h_image.data[idx]);
+                }
+            }
+
+        for (unsigned int tag = 0; tag < n; ++tag)
+            {
+            Scalar3 d = make_scalar3(Scalar(0.2)*sin(Scalar(tag)), Scalar(0.2)*cos(Scalar(3*tag)), Scalar(0.2)*sin(Scalar(7*tag)));
+            global_pos[tag] += d;
+            int3 img = make_int3(0,0,0);
+            box.wrap(global_pos[tag], img);
+            }
+
+        comm->migrateParticles();
+
+        unsigned int n_global = pdata->getN();
+        MPI_Allreduce(MPI_IN_PLACE, &n_global, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+        UP_ASSERT_EQUAL(n_global, n);
+
+        comm->exchangeGhosts();
+        check_ghost_layer(pdata, global_pos, r_ghost);
+        }
+    }
+
+//! Test migration, ghost exchange and ghost updates with sparse reverse-lookup tags
+void test_communicator_sparse_rtags(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    unsigned int n = 1000;
+    BoxDim box(6.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n,           // number of particles
+                                                             box,         // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+
+    std::vector<Scalar3> global_pos(n);
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        global_pos[i] = make_scalar3(Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        int3 img = make_int3(0,0,0);
+        box.wrap(global_pos[i], img);
+        snap.pos[i] = vec3<Scalar>(global_pos[i]);
+        }
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), 2, 2, 2));
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+
+    pdata->setSparseRTags(true);
+    UP_ASSERT(pdata->getSparseRTags());
+    UP_ASSERT_EQUAL(pdata->getMaximumTag(), n-1);
+    UP_ASSERT(pdata->isTagActive(n-1));
+    UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN());
+
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    Scalar r_ghost(0.5);
+    ghost_layer_width g(r_ghost);
+    comm->getGhostLayerWidthRequestSignal().connect<ghost_layer_width, &ghost_layer_width::get>(g);
+
+    // set ghost exchange flags for position
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    comm->setFlags(flags);
+
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    check_ghost_layer(pdata, global_pos, r_ghost);
+
+    // the map only holds local particles and ghosts
+    UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN() + pdata->getNGhosts());
+
+    // displace all particles, and migrate them
+    for (unsigned int step = 0; step < 3; ++step)
+        {
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+            const BoxDim& local_box = pdata->getBox();
+            for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+                {
+                unsigned int tag = h_tag.data[idx];
+                Scalar3 d = make_scalar3(Scalar(0.2)*cos(Scalar(5*tag)), Scalar(0.2)*sin(Scalar(2*tag)), Scalar(0.2)*cos(Scalar(tag)));
+                h_pos.data[idx].x += d.x;
+                h_pos.data[idx].y += d.y;
+                h_pos.data[idx].z += d.z;
+                local_box.wrap(h_pos.data[idx], h_image.data[idx]);
+                }
+            }
+
+        for (unsigned int tag = 0; tag < n; ++tag)
+            {
+            Scalar3 d = make_scalar3(Scalar(0.2)*cos(Scalar(5*tag)), Scalar(0.2)*sin(Scalar(2*tag)), Scalar(0.2)*cos(Scalar(tag)));
+            global_pos[tag] += d;
+            int3 img = make_int3(0,0,0);
+            box.wrap(global_pos[tag], img);
+            }
+
+        comm->migrateParticles();
+
+        unsigned int n_global = pdata->getN();
+        MPI_Allreduce(MPI_IN_PLACE, &n_global, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+        UP_ASSERT_EQUAL(n_global, n);
+
+        comm->exchangeGhosts();
+        check_ghost_layer(pdata, global_pos, r_ghost);
+        UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN() + pdata->getNGhosts());
+        }
+
+    // move the local particles a little, and update the ghosts
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+            h_pos.data[idx].x += Scalar(0.01);
+        }
+    comm->beginUpdateGhosts(0);
+    comm->finishUpdateGhosts(0);
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*pdata, access_mode::read);
+        for (unsigned int idx = pdata->getN(); idx < pdata->getN() + pdata->getNGhosts(); ++idx)
+            {
+            unsigned int tag = h_tag.data[idx];
+            UP_ASSERT_EQUAL(h_rtag[tag], idx);
+
+            Scalar3 dr = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z)
+                - global_pos[tag] - make_scalar3(Scalar(0.01), 0, 0);
+            dr = box.minImage(dr);
+            CHECK_SMALL(dot(dr,dr), Scalar(1e-8));
+            }
+        }
+
+    // snapshots are complete
+    SnapshotParticleData<Scalar> snap_out;
+    pdata->takeSnapshot(snap_out);
+    if (exec_conf->getRank() == 0)
+        {
+        UP_ASSERT_EQUAL(snap_out.size, n);
+        for (unsigned int tag = 0; tag < n; ++tag)
+            {
+            Scalar3 dr = box.minImage(vec_to_scalar3(snap_out.pos[tag]) - global_pos[tag] - make_scalar3(Scalar(0.01), 0, 0));
+            CHECK_SMALL(dot(dr,dr), Scalar(1e-8));
+            }
+        }
+
+    // switching back restores the dense lookup table
+    pdata->setSparseRTags(false);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL(pdata->getRTags().size(), n);
+        for (unsigned int idx = 0; idx < pdata->getN() + pdata->getNGhosts(); ++idx)
+            UP_ASSERT_EQUAL(h_rtag.data[h_tag.data[idx]], idx);
+        }
+    }
+
+//! Test that sparse reverse-lookup tags selected at construction never allocate the dense table
+void test_sparse_rtags_initialization(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    unsigned int n = 1000;
+    BoxDim box(6.0);
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = box;
+    snap->particle_data.resize(n);
+    snap->particle_data.type_mapping.push_back("A");
+
+    std::vector<Scalar3> global_pos(n);
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        global_pos[i] = make_scalar3(Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        int3 img = make_int3(0,0,0);
+        box.wrap(global_pos[i], img);
+        snap->particle_data.pos[i] = vec3<Scalar>(global_pos[i]);
+        }
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), 2, 2, 2));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf, decomposition, true));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // the dense table was never sized by the global number of particles
+    UP_ASSERT(pdata->getSparseRTags());
+    UP_ASSERT_EQUAL(pdata->getRTagCapacity(), (unsigned int)0);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ pdata->getRTags(); });
+    UP_ASSERT_EQUAL(pdata->getNGlobal(), n);
+    UP_ASSERT_EQUAL(pdata->getRTagSize(), n);
+    UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN());
+
+    unsigned int n_global = pdata->getN();
+    MPI_Allreduce(MPI_IN_PLACE, &n_global, 1, MPI_UNSIGNED, MPI_SUM, MPI_COMM_WORLD);
+    UP_ASSERT_EQUAL(n_global, n);
+
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        RTagHandle h_rtag(*pdata, access_mode::read);
+        for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+            UP_ASSERT_EQUAL(h_rtag[h_tag.data[idx]], idx);
+        }
+
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    Scalar r_ghost(0.5);
+    ghost_layer_width g(r_ghost);
+    comm->getGhostLayerWidthRequestSignal().connect<ghost_layer_width, &ghost_layer_width::get>(g);
+
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    comm->setFlags(flags);
+
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    check_ghost_layer(pdata, global_pos, r_ghost);
+    UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN() + pdata->getNGhosts());
+    UP_ASSERT_EQUAL(pdata->getRTagCapacity(), (unsigned int)0);
+
+    // re-initializing from a snapshot keeps the sparse map
+    pdata->initializeFromSnapshot(snap->particle_data);
+    UP_ASSERT(pdata->getSparseRTags());
+    UP_ASSERT_EQUAL(pdata->getRTagCapacity(), (unsigned int)0);
+    UP_ASSERT_EQUAL(pdata->getRTagMap().size(), pdata->getN());
+    }
+
+//! Test that a distributed snapshot initializes the same particle data as a snapshot on the root rank
+void test_distributed_snapshot(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    unsigned int n = 1003;
+    BoxDim box(6.0);
+
+    SnapshotParticleData<Scalar> snap(n);
+    snap.type_mapping.push_back("A");
+    snap.type_mapping.push_back("B");
+
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        snap.pos[i] = vec3<Scalar>(Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                   Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                   Scalar(6.0)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        snap.vel[i] = vec3<Scalar>(Scalar(i), Scalar(0.0), Scalar(-1.0*i));
+        snap.type[i] = i % 2;
+        snap.mass[i] = Scalar(1.0) + Scalar(i % 3);
+        snap.image[i] = make_int3(i % 5, 0, -1);
+        }
+
+    // particles exactly on the upper boundary are wrapped
+    snap.pos[0] = vec3<Scalar>(3.0, 0.0, -3.0);
+
+    // every rank holds an equal part of the particles, in rank order
+    unsigned int rank = exec_conf->getRank();
+    unsigned int first = n*rank/size;
+    unsigned int last = n*(rank+1)/size;
+    SnapshotParticleData<Scalar> dist_snap(last - first);
+    dist_snap.type_mapping = snap.type_mapping;
+    dist_snap.is_distributed = true;
+    for (unsigned int i = first; i < last; ++i)
+        {
+        dist_snap.pos[i-first] = snap.pos[i];
+        dist_snap.vel[i-first] = snap.vel[i];
+        dist_snap.type[i-first] = snap.type[i];
+        dist_snap.mass[i-first] = snap.mass[i];
+        dist_snap.image[i-first] = snap.image[i];
+        }
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, box.getL(), 2, 2, 2));
+
+    std::shared_ptr<ParticleData> pdata(new ParticleData(snap, box, exec_conf, decomposition));
+    std::shared_ptr<ParticleData> dist_pdata(new ParticleData(dist_snap, box, exec_conf, decomposition));
+
+    UP_ASSERT_EQUAL(dist_pdata->getNGlobal(), n);
+    UP_ASSERT_EQUAL(dist_pdata->getN(), pdata->getN());
+    UP_ASSERT_EQUAL(dist_pdata->getNTypes(), 2);
+
+    // the local particles are the same, in the same order
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_dist_pos(dist_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_dist_vel(dist_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_dist_image(dist_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_dist_tag(dist_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_dist_rtag(dist_pdata->getRTags(), access_location::host, access_mode::read);
+
+        for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+            {
+            UP_ASSERT_EQUAL(h_dist_tag.data[idx], h_tag.data[idx]);
+            UP_ASSERT_EQUAL(h_dist_rtag.data[h_dist_tag.data[idx]], idx);
+            UP_ASSERT_EQUAL(h_dist_pos.data[idx].x, h_pos.data[idx].x);
+            UP_ASSERT_EQUAL(h_dist_pos.data[idx].y, h_pos.data[idx].y);
+            UP_ASSERT_EQUAL(h_dist_pos.data[idx].z, h_pos.data[idx].z);
+            UP_ASSERT_EQUAL(__scalar_as_int(h_dist_pos.data[idx].w), __scalar_as_int(h_pos.data[idx].w));
+            UP_ASSERT_EQUAL(h_dist_vel.data[idx].x, h_vel.data[idx].x);
+            UP_ASSERT_EQUAL(h_dist_vel.data[idx].w, h_vel.data[idx].w);
+            UP_ASSERT_EQUAL(h_dist_image.data[idx].x, h_image.data[idx].x);
+            UP_ASSERT_EQUAL(h_dist_image.data[idx].z, h_image.data[idx].z);
+            }
+        }
+
+    // a distributed snapshot with particles outside of the box is rejected
+    if (rank == 3)
+        dist_snap.pos[0] = vec3<Scalar>(4.0, 0.0, 0.0);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ParticleData p(dist_snap, box, exec_conf, decomposition);});
+    }
+
 //! Communicator creator for unit tests
 std::shared_ptr<Communicator> base_class_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                          std::shared_ptr<DomainDecomposition> decomposition)
@@ -3450,6 +4050,38 @@ std::shared_ptr<Communicator> base_class_communicator_creator(std::shared_ptr<Sy
     return std::shared_ptr<Communicator>(new Communicator(sysdef, decomposition) );
     }
 
+//! Communicator creator for the single-stage ghost exchange
+std::shared_ptr<Communicator> single_stage_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                         std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    comm->setSingleStage(true);
+    return comm;
+    }
+
+//! Communicator creator for compressed ghost position updates
+std::shared_ptr<Communicator> compressed_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                         std::shared_ptr<DomainDecomposition> decomposition,
+                                                         bool single_stage)
+    {
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    comm->setSingleStage(single_stage);
+    comm->setCompressGhostUpdates(true);
+    return comm;
+    }
+
+//! Communicator creator for shared memory ghost updates
+std::shared_ptr<Communicator> shared_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                         std::shared_ptr<DomainDecomposition> decomposition,
+                                                         bool compress)
+    {
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    comm->setSingleStage(true);
+    comm->setCompressGhostUpdates(compress);
+    comm->setSharedGhostUpdates(true);
+    return comm;
+    }
+
 #ifdef ENABLE_CUDA
 std::shared_ptr<Communicator> gpu_communicator_creator(std::shared_ptr<SystemDefinition> sysdef,
                                                   std::shared_ptr<DomainDecomposition> decomposition)
@@ -3666,6 +4298,215 @@ UP_TEST( communicator_ghost_layer_per_type_test)
     test_communicator_ghosts_per_type(communicator_creator_base, exec_conf_cpu,BoxDim(2.0));
     }
 
+UP_TEST( communicator_overlap_forces_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_overlap_forces(communicator_creator_base, exec_conf_cpu);
+    }
+
+UP_TEST( communicator_single_stage_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_single = bind(single_stage_communicator_creator, _1, _2);
+
+    // ghosts across faces, edges and corners
+        {
+        BoxDim box(2.0);
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        }
+        {
+        BoxDim box(1.0,-.6,.7,.5);
+        vector<Scalar> fx(1), fy(1), fz(1);
+        fx[0] = 0.55; fy[0] = 0.44; fz[0] = 0.57;
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 make_scalar3(0.1,-0.12,0.14));
+        }
+
+    test_communicator_ghost_fields(communicator_creator_single, exec_conf_cpu);
+
+        {
+        BoxDim box(2.0);
+        std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf_cpu, box.getL()));
+        test_communicator_bonded_ghosts(communicator_creator_single, exec_conf_cpu, box, decomposition);
+        }
+
+    // compare with the staged exchange
+        {
+        BoxDim box(2.0);
+        std::shared_ptr<DomainDecomposition> decomposition_1(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        std::shared_ptr<DomainDecomposition> decomposition_2(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        test_communicator_compare(communicator_creator_base, communicator_creator_single, exec_conf_cpu, exec_conf_cpu,
+            box, decomposition_1, decomposition_2);
+        }
+
+    // pair forces computed while the ghost update is in flight
+    test_communicator_overlap_forces(communicator_creator_single, exec_conf_cpu);
+    }
+
+UP_TEST( communicator_compressed_update_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_staged = bind(compressed_communicator_creator, _1, _2, false);
+    communicator_creator communicator_creator_single = bind(compressed_communicator_creator, _1, _2, true);
+
+    // ghost positions are updated across faces, edges and corners, and wrapped across the global boundaries
+        {
+        BoxDim box(2.0);
+        test_communicator_ghosts(communicator_creator_staged,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        test_communicator_ghosts(communicator_creator_single,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        }
+        {
+        BoxDim box(1.0,-.6,.7,.5);
+        vector<Scalar> fx(1), fy(1), fz(1);
+        fx[0] = 0.55; fy[0] = 0.44; fz[0] = 0.57;
+        test_communicator_ghosts(communicator_creator_staged,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 make_scalar3(0.1,-0.12,0.14));
+        }
+
+    test_communicator_ghost_fields(communicator_creator_staged, exec_conf_cpu);
+    test_communicator_ghost_fields(communicator_creator_single, exec_conf_cpu);
+
+    // compare with full precision updates
+        {
+        BoxDim box(2.0);
+        std::shared_ptr<DomainDecomposition> decomposition_1(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        std::shared_ptr<DomainDecomposition> decomposition_2(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        test_communicator_compare(communicator_creator_base, communicator_creator_staged, exec_conf_cpu, exec_conf_cpu,
+            box, decomposition_1, decomposition_2);
+        }
+        {
+        BoxDim box(2.0);
+        std::shared_ptr<DomainDecomposition> decomposition_1(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        std::shared_ptr<DomainDecomposition> decomposition_2(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        test_communicator_compare(communicator_creator_base, communicator_creator_single, exec_conf_cpu, exec_conf_cpu,
+            box, decomposition_1, decomposition_2);
+        }
+    }
+
+//! Tests ghost updates through shared memory between ranks on the same node
+UP_TEST( communicator_shared_update_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_shared = bind(shared_communicator_creator, _1, _2, false);
+    communicator_creator communicator_creator_compressed = bind(shared_communicator_creator, _1, _2, true);
+
+    // ghosts across faces, edges and corners
+        {
+        BoxDim box(2.0);
+        test_communicator_ghosts(communicator_creator_shared,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL())),
+                                 make_scalar3(0.0,0.0,0.0));
+        }
+        {
+        BoxDim box(1.0,-.6,.7,.5);
+        vector<Scalar> fx(1), fy(1), fz(1);
+        fx[0] = 0.55; fy[0] = 0.44; fz[0] = 0.57;
+        test_communicator_ghosts(communicator_creator_compressed,
+                                 exec_conf_cpu,
+                                 box,
+                                 std::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf_cpu,box.getL(), fx, fy, fz)),
+                                 make_scalar3(0.1,-0.12,0.14));
+        }
+
+    test_communicator_ghost_fields(communicator_creator_shared, exec_conf_cpu);
+
+    // compare with messages, over many updates
+        {
+        BoxDim box(2.0);
+        std::shared_ptr<DomainDecomposition> decomposition_1(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        std::shared_ptr<DomainDecomposition> decomposition_2(new DomainDecomposition(exec_conf_cpu,box.getL()));
+        test_communicator_compare(communicator_creator_base, communicator_creator_shared, exec_conf_cpu, exec_conf_cpu,
+            box, decomposition_1, decomposition_2);
+        }
+
+    // pair forces computed while the ghost update is in flight
+    test_communicator_overlap_forces(communicator_creator_shared, exec_conf_cpu);
+    }
+
+//! Tests ghost exchange and migration with staggered domains
+UP_TEST( communicator_staggered_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_single = bind(single_stage_communicator_creator, _1, _2);
+
+    test_communicator_staggered(communicator_creator_base, exec_conf_cpu, 2, 2, 2);
+    test_communicator_staggered(communicator_creator_base, exec_conf_cpu, 2, 1, 4);
+    test_communicator_staggered(communicator_creator_base, exec_conf_cpu, 1, 4, 2);
+    test_communicator_staggered(communicator_creator_single, exec_conf_cpu, 2, 2, 2);
+    test_communicator_staggered(communicator_creator_single, exec_conf_cpu, 2, 1, 4);
+    test_communicator_staggered(communicator_creator_single, exec_conf_cpu, 1, 4, 2);
+    }
+
+//! Tests migration and ghost communication with sparse reverse-lookup tags
+UP_TEST( communicator_sparse_rtags_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_single = bind(single_stage_communicator_creator, _1, _2);
+
+    test_communicator_sparse_rtags(communicator_creator_base, exec_conf_cpu);
+    test_communicator_sparse_rtags(communicator_creator_single, exec_conf_cpu);
+    }
+
+//! Tests that particle data constructed with sparse reverse-lookup tags never allocates the dense table
+UP_TEST( sparse_rtags_initialization_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    communicator_creator communicator_creator_single = bind(single_stage_communicator_creator, _1, _2);
+
+    test_sparse_rtags_initialization(communicator_creator_base, exec_conf_cpu);
+    test_sparse_rtags_initialization(communicator_creator_single, exec_conf_cpu);
+    }
+
+//! Tests initialization from a distributed snapshot
+UP_TEST( distributed_snapshot_test)
+    {
+    if (!exec_conf_cpu)
+        exec_conf_cpu = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    test_distributed_snapshot(exec_conf_cpu);
+    }
+
 UP_SUITE_END();
 
 #ifdef ENABLE_CUDA
@@ -0,0 +1,167 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <fstream>
+
+#include <functional>
+#include <memory>
+
+#include "hoomd/md/PotentialPairDSF.h"
+#ifdef ENABLE_CUDA
+#include "hoomd/md/PotentialPairDSFGPU.h"
+#endif
+
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/Initializers.h"
+
+#include <math.h>
+
+using namespace std;
+using namespace std::placeholders;
+
+
+/*! \file test_dsf_force.cc
+    \brief Implements unit tests for PotentialPairDSF and descendants
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+//! Typedef'd PotentialPairDSF factory
+typedef std::function<std::shared_ptr<PotentialPair<EvaluatorPairDSF> > (std::shared_ptr<SystemDefinition> sysdef,
+                                                         std::shared_ptr<NeighborList> nlist)> dsfforce_creator;
+
+//! Build the DSF parameters for a given damping parameter and cutoff
+Scalar3 make_dsf_params(Scalar alpha, Scalar rcut)
+    {
+    Scalar erfc_rc = erfc(alpha*rcut);
+    Scalar v_shift = erfc_rc/rcut;
+    Scalar f_shift = erfc_rc/(rcut*rcut) + Scalar(2.0)*alpha/sqrt(Scalar(M_PI))*exp(-alpha*alpha*rcut*rcut)/rcut;
+    return make_scalar3(alpha, v_shift, f_shift);
+    }
+
+//! Test the ability of the dsf force compute to actually calculate forces and the self energy
+void dsf_force_particle_test(dsfforce_creator dsf_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // the particles are arranged on the x axis,  1   2   3
+    // such that 2 is inside the cutoff radius of 1 and 3, but 1 and 3 are outside the cutoff
+    // 3 carries a different charge to check that the charge product enters the forces
+    std::shared_ptr<SystemDefinition> sysdef_3(new SystemDefinition(3, BoxDim(1000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_3 = sysdef_3->getParticleData();
+    pdata_3->setFlags(~PDataFlags(0));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata_3->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata_3->getCharges(), access_location::host, access_mode::readwrite);
+    h_pos.data[0].x = h_pos.data[0].y = h_pos.data[0].z = 0.0;
+    h_pos.data[1].x = Scalar(1.0); h_pos.data[1].y = h_pos.data[1].z = 0.0;
+    h_pos.data[2].x = Scalar(2.0); h_pos.data[2].y = h_pos.data[2].z = 0.0;
+    h_charge.data[0] = Scalar(1.0);
+    h_charge.data[1] = Scalar(-2.0);
+    h_charge.data[2] = Scalar(0.5);
+    }
+    std::shared_ptr<NeighborListTree> nlist_3(new NeighborListTree(sysdef_3, Scalar(1.3), Scalar(3.0)));
+    std::shared_ptr<PotentialPair<EvaluatorPairDSF> > fc_3 = dsf_creator(sysdef_3, nlist_3);
+    fc_3->setRcut(0, 0, Scalar(1.3));
+    fc_3->setParams(0, 0, make_dsf_params(Scalar(0.4), Scalar(1.3)));
+
+    // compute the forces
+    fc_3->compute(0);
+
+    {
+    GlobalArray<Scalar4>& force_array_1 =  fc_3->getForceArray();
+    GlobalArray<Scalar>& virial_array_1 =  fc_3->getVirialArray();
+    unsigned int pitch = virial_array_1.getPitch();
+    ArrayHandle<Scalar4> h_force_1(force_array_1,access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_1(virial_array_1,access_location::host,access_mode::read);
+    MY_CHECK_CLOSE(h_force_1.data[0].x, 0.83571385873804, tol);
+    MY_CHECK_SMALL(h_force_1.data[0].y, tol_small);
+    MY_CHECK_SMALL(h_force_1.data[0].z, tol_small);
+    MY_CHECK_CLOSE(h_force_1.data[0].w, -0.05463488247798, tol);
+    MY_CHECK_CLOSE(Scalar(1./3.)*(h_virial_1.data[0*pitch+0]
+                                       +h_virial_1.data[3*pitch+0]
+                                       +h_virial_1.data[5*pitch+0]), -0.13928564312301, tol);
+
+    MY_CHECK_CLOSE(h_force_1.data[1].x, -0.41785692936902, tol);
+    MY_CHECK_SMALL(h_force_1.data[1].y, tol_small);
+    MY_CHECK_SMALL(h_force_1.data[1].z, tol_small);
+    MY_CHECK_CLOSE(h_force_1.data[1].w, -0.08195232371697, tol);
+    MY_CHECK_CLOSE(Scalar(1./3.)*(h_virial_1.data[0*pitch+1]
+                                       +h_virial_1.data[3*pitch+1]
+                                       +h_virial_1.data[5*pitch+1]), -0.20892846468451, tol);
+
+    MY_CHECK_CLOSE(h_force_1.data[2].x, -0.41785692936902, tol);
+    MY_CHECK_SMALL(h_force_1.data[2].y, tol_small);
+    MY_CHECK_SMALL(h_force_1.data[2].z, tol_small);
+    MY_CHECK_CLOSE(h_force_1.data[2].w, -0.02731744123899, tol);
+    MY_CHECK_CLOSE(Scalar(1./3.)*(h_virial_1.data[0*pitch+2]
+                                       +h_virial_1.data[3*pitch+2]
+                                       +h_virial_1.data[5*pitch+2]), -0.06964282156150, tol);
+    }
+
+    // the self energy is stored as external energy, and included in the logged energy
+    MY_CHECK_CLOSE(fc_3->getExternalEnergy(), -2.11788742929106, tol);
+    MY_CHECK_CLOSE(fc_3->getLogValue("pair_dsf_energy", 0), -2.28179207672500, tol);
+    }
+
+//! Test that the DSF potential and force vanish at the cutoff
+UP_TEST( EvaluatorPairDSF_cutoff )
+    {
+    Scalar rcut(2.5);
+    Scalar3 params = make_dsf_params(Scalar(0.3), rcut);
+    Scalar r = rcut*Scalar(1.0 - 1e-6);
+
+    EvaluatorPairDSF eval(r*r, rcut*rcut, params);
+    eval.setCharge(Scalar(1.0), Scalar(-1.0));
+
+    Scalar force_divr(0.0);
+    Scalar pair_eng(0.0);
+    UP_ASSERT(eval.evalForceAndEnergy(force_divr, pair_eng, false));
+    MY_CHECK_SMALL(force_divr, tol_small);
+    MY_CHECK_SMALL(pair_eng, tol_small);
+
+    // neutral particles do not interact
+    eval.setCharge(Scalar(0.0), Scalar(-1.0));
+    UP_ASSERT(!eval.evalForceAndEnergy(force_divr, pair_eng, false));
+    }
+
+//! PotentialPairDSF creator for unit tests
+std::shared_ptr<PotentialPair<EvaluatorPairDSF> > base_class_dsf_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                                        std::shared_ptr<NeighborList> nlist)
+    {
+    return std::shared_ptr<PotentialPair<EvaluatorPairDSF> >(new PotentialPairDSF(sysdef, nlist));
+    }
+
+#ifdef ENABLE_CUDA
+//! PotentialPairDSFGPU creator for unit tests
+std::shared_ptr<PotentialPair<EvaluatorPairDSF> > gpu_dsf_creator(std::shared_ptr<SystemDefinition> sysdef,
+                                                                 std::shared_ptr<NeighborList> nlist)
+    {
+    nlist->setStorageMode(NeighborList::full);
+    return std::shared_ptr<PotentialPair<EvaluatorPairDSF> >(new PotentialPairDSFGPU(sysdef, nlist));
+    }
+#endif
+
+//! test case for particle test on CPU
+UP_TEST( DSFForce_particle )
+    {
+    dsfforce_creator dsf_creator_base = bind(base_class_dsf_creator, _1, _2);
+    dsf_force_particle_test(dsf_creator_base, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_CUDA
+//! test case for particle test on GPU
+UP_TEST( DSFForceGPU_particle )
+    {
+    dsfforce_creator dsf_creator_gpu = bind(gpu_dsf_creator, _1, _2);
+    dsf_force_particle_test(dsf_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif
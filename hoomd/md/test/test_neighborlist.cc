@@ -708,6 +708,126 @@ void neighborlist_exclusion_tests(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+//! Tests that exclusions derived from the local topology match the exclusions stored by tag
+template <class NL>
+void neighborlist_topology_exclusion_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a chain of 20 particles, bonded and with angles along the chain
+    const unsigned int n = 20;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n, BoxDim(40.0), 1, 1, 1, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < n; ++i)
+            h_pos.data[i] = make_scalar4(Scalar(0.9)*Scalar(i) - Scalar(9.0), 0.0, 0.0, __int_as_scalar(0));
+        pdata->notifyParticleSort();
+        }
+
+    for (unsigned int i = 0; i < n-1; ++i)
+        sysdef->getBondData()->addBondedGroup(Bond(0, i, i+1));
+    for (unsigned int i = 0; i < n-2; ++i)
+        sysdef->getAngleData()->addBondedGroup(Angle(0, i, i+1, i+2));
+
+    std::shared_ptr<NeighborList> nlist_tag(new NL(sysdef, 3.0, 0.25));
+    nlist_tag->setRCutPair(0,0,3.0);
+    nlist_tag->setStorageMode(NeighborList::full);
+    nlist_tag->addExclusionsFromBonds();
+    nlist_tag->addExclusionsFromAngles();
+
+    std::shared_ptr<NeighborList> nlist_topo(new NL(sysdef, 3.0, 0.25));
+    nlist_topo->setRCutPair(0,0,3.0);
+    nlist_topo->setStorageMode(NeighborList::full);
+    nlist_topo->setTopologyExclusions(true);
+    UP_ASSERT(nlist_topo->getTopologyExclusions());
+    nlist_topo->addExclusionsFromBonds();
+    nlist_topo->addExclusionsFromAngles();
+
+    // duplicates are only counted once
+    nlist_tag->addExclusion(0, 1);
+    nlist_topo->addExclusion(1, 0);
+    UP_ASSERT(nlist_tag->isExcluded(1, 0));
+    UP_ASSERT(!nlist_tag->isExcluded(0, 3));
+
+    for (unsigned int size = 0; size < 6; ++size)
+        UP_ASSERT_EQUAL(nlist_tag->getNumExclusions(size), nlist_topo->getNumExclusions(size));
+    UP_ASSERT_EQUAL(nlist_topo->getNumExclusions(2), 2);
+    UP_ASSERT_EQUAL(nlist_topo->getNumExclusions(4), n-4);
+
+    nlist_tag->compute(0);
+    nlist_topo->compute(0);
+
+        {
+        ArrayHandle<unsigned int> h_n_neigh_tag(nlist_tag->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist_tag(nlist_tag->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list_tag(nlist_tag->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh_topo(nlist_topo->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist_topo(nlist_topo->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list_topo(nlist_topo->getHeadList(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            std::vector<unsigned int> nbrs_tag(h_nlist_tag.data + h_head_list_tag.data[i],
+                                               h_nlist_tag.data + h_head_list_tag.data[i] + h_n_neigh_tag.data[i]);
+            std::vector<unsigned int> nbrs_topo(h_nlist_topo.data + h_head_list_topo.data[i],
+                                                h_nlist_topo.data + h_head_list_topo.data[i] + h_n_neigh_topo.data[i]);
+            sort(nbrs_tag.begin(), nbrs_tag.end());
+            sort(nbrs_topo.begin(), nbrs_topo.end());
+            UP_ASSERT(nbrs_tag == nbrs_topo);
+
+            // only the particles three bonds away are left within the cutoff
+            unsigned int n_expected = (i >= 3) + (i+3 < n);
+            CHECK_EQUAL_UINT(h_n_neigh_topo.data[i], n_expected);
+            }
+        }
+
+    // bonds added later are excluded from the topology, but not by tag
+    sysdef->getBondData()->addBondedGroup(Bond(0, 4, 7));
+    nlist_tag->compute(1);
+    nlist_topo->compute(1);
+
+        {
+        ArrayHandle<unsigned int> h_n_neigh_tag(nlist_tag->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh_topo(nlist_topo->getNNeighArray(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_n_neigh_tag.data[4], 2);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[4], 1);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[7], 1);
+        }
+
+    // a new local order is served from the cached exclusions
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < n/2; ++i)
+            {
+            std::swap(h_pos.data[i], h_pos.data[n-1-i]);
+            std::swap(h_tag.data[i], h_tag.data[n-1-i]);
+            h_rtag.data[h_tag.data[i]] = i;
+            h_rtag.data[h_tag.data[n-1-i]] = n-1-i;
+            }
+        }
+    pdata->notifyParticleSort();
+    nlist_topo->compute(2);
+
+        {
+        ArrayHandle<unsigned int> h_n_neigh_topo(nlist_topo->getNNeighArray(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[n-1-4], 1);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[n-1-7], 1);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[n-1-10], 2);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[n-1-0], 1);
+        }
+
+    // clearing the exclusions removes the topology exclusions as well
+    nlist_topo->clearExclusions();
+    nlist_topo->compute(3);
+        {
+        ArrayHandle<unsigned int> h_n_neigh_topo(nlist_topo->getNNeighArray(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[0], 3);
+        CHECK_EQUAL_UINT(h_n_neigh_topo.data[10], 6);
+        }
+    }
+
 //! Tests the ability of the neighbor list to exclude particles from the same body
 template <class NL>
 void neighborlist_body_filter_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1263,6 +1383,11 @@ UP_TEST( NeighborListBinned_exclusion )
     {
     neighborlist_exclusion_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! topology exclusion test case for binned class
+UP_TEST( NeighborListBinned_topology_exclusion )
+    {
+    neighborlist_topology_exclusion_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! large exclusion test case for binned class
 UP_TEST( NeighborListBinned_large_ex )
     {
@@ -1377,6 +1502,11 @@ UP_TEST( NeighborListTree_exclusion )
     {
     neighborlist_exclusion_tests<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! topology exclusion test case for tree class
+UP_TEST( NeighborListTree_topology_exclusion )
+    {
+    neighborlist_topology_exclusion_tests<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! large exclusion test case for tree class
 UP_TEST( NeighborListTree_large_ex )
     {
@@ -1437,6 +1567,11 @@ UP_TEST( NeighborListGPUBinned_exclusion )
     {
     neighborlist_exclusion_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! topology exclusion test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_topology_exclusion )
+    {
+    neighborlist_topology_exclusion_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! large exclusion test case for GPUBinned class
 UP_TEST( NeighborListGPUBinned_large_ex )
     {
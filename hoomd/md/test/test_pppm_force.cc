@@ -17,6 +17,8 @@
 #endif
 
 #include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/RealFFT3D.h"
+#include "hoomd/extern/kiss_fftnd.h"
 #include "hoomd/Initializers.h"
 
 #include <math.h>
@@ -198,6 +200,142 @@ void pppm_force_particle_test_triclinic(pppmforce_creator pppm_creator, std::sha
     MY_CHECK_SMALL(h_virial.data[5*pitch+1], rough_tol);
     }
 
+//! Compute the PPPM forces on a small system of charged and uncharged particles with a given number of threads
+void pppm_force_threads_run(unsigned int num_threads, std::vector<Scalar4>& force, std::vector<Scalar>& virial,
+                            Scalar& energy)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    #ifdef ENABLE_TBB
+    exec_conf->setNumThreads(num_threads);
+    #endif
+
+    unsigned int N = 100;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(8.0, 9.0, 10.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(1.5), Scalar(0.4)));
+    std::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, N-1));
+    std::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+
+    // the same random configuration in every run, with every fourth particle uncharged
+    const BoxDim& box = pdata->getBox();
+    srand(54321);
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        Scalar3 f = make_scalar3(Scalar(rand())/Scalar(RAND_MAX),
+                                 Scalar(rand())/Scalar(RAND_MAX),
+                                 Scalar(rand())/Scalar(RAND_MAX));
+        Scalar3 pos = box.makeCoordinates(f*Scalar(0.999));
+        h_pos.data[i].x = pos.x;
+        h_pos.data[i].y = pos.y;
+        h_pos.data[i].z = pos.z;
+        h_charge.data[i] = (i % 4 == 3) ? Scalar(0.0) : ((i % 2) ? Scalar(-1.0) : Scalar(1.0));
+        }
+    }
+
+    std::shared_ptr<PPPMForceCompute> fc(new PPPMForceCompute(sysdef, nlist, group_all));
+    fc->setParams(16, 18, 20, 5, Scalar(1.5), Scalar(1.5));
+    fc->compute(0);
+
+    ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+    unsigned int pitch = fc->getVirialArray().getPitch();
+
+    force.assign(h_force.data, h_force.data + N);
+    virial.resize(6*N);
+    for (unsigned int j = 0; j < 6; ++j)
+        for (unsigned int i = 0; i < N; ++i)
+            virial[j*N+i] = h_virial.data[j*pitch+i];
+    energy = fc->getExternalEnergy();
+    }
+
+//! Compare the threaded charge assignment and force interpolation with a serial run
+void pppm_force_threads_test()
+    {
+    std::vector<Scalar4> force_serial, force_threaded;
+    std::vector<Scalar> virial_serial, virial_threaded;
+    Scalar energy_serial, energy_threaded;
+
+    // the runs are done one after the other, so that only one task scheduler is active at a time
+    pppm_force_threads_run(1, force_serial, virial_serial, energy_serial);
+    pppm_force_threads_run(4, force_threaded, virial_threaded, energy_threaded);
+
+    // the private meshes are summed in a different order, so the results only agree to rounding
+    UP_ASSERT_EQUAL(force_serial.size(), force_threaded.size());
+    for (unsigned int i = 0; i < force_serial.size(); ++i)
+        {
+        MY_CHECK_SMALL(force_threaded[i].x - force_serial[i].x, tol_small);
+        MY_CHECK_SMALL(force_threaded[i].y - force_serial[i].y, tol_small);
+        MY_CHECK_SMALL(force_threaded[i].z - force_serial[i].z, tol_small);
+
+        // uncharged particles feel no force
+        if (i % 4 == 3)
+            {
+            UP_ASSERT_EQUAL(force_threaded[i].x, Scalar(0.0));
+            UP_ASSERT_EQUAL(force_threaded[i].y, Scalar(0.0));
+            UP_ASSERT_EQUAL(force_threaded[i].z, Scalar(0.0));
+            }
+        }
+    for (unsigned int i = 0; i < virial_serial.size(); ++i)
+        MY_CHECK_SMALL(virial_threaded[i] - virial_serial[i], tol_small);
+    MY_CHECK_CLOSE(energy_threaded, energy_serial, tol_small);
+    }
+
+//! Compare RealFFT3D with a complex three-dimensional transform of the same mesh
+void real_fft_test(unsigned int nx, unsigned int ny, unsigned int nz)
+    {
+    unsigned int n = nx*ny*nz;
+
+    // a random real mesh
+    std::vector<kiss_fft_scalar> mesh(n);
+    std::vector<kiss_fft_cpx> mesh_cpx(n);
+    srand(12345);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        mesh[i] = kiss_fft_scalar(rand())/kiss_fft_scalar(RAND_MAX) - kiss_fft_scalar(0.5);
+        mesh_cpx[i].r = mesh[i];
+        mesh_cpx[i].i = kiss_fft_scalar(0.0);
+        }
+
+    // reference transform
+    int dims[3] = {(int)nz, (int)ny, (int)nx};
+    kiss_fftnd_cfg cfg = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
+    std::vector<kiss_fft_cpx> ref(n);
+    kiss_fftnd(cfg, &mesh_cpx.front(), &ref.front());
+    free(cfg);
+
+    RealFFT3D fft(nx, ny, nz);
+    unsigned int nx_cpx = nx/2+1;
+    UP_ASSERT_EQUAL(fft.getNumComplexElements(), nx_cpx*ny*nz);
+
+    std::vector<kiss_fft_cpx> half(fft.getNumComplexElements());
+    fft.forward(&mesh.front(), &half.front());
+
+    Scalar tol = 1e-4;
+    for (unsigned int kz = 0; kz < nz; ++kz)
+        for (unsigned int ky = 0; ky < ny; ++ky)
+            for (unsigned int kx = 0; kx < nx_cpx; ++kx)
+                {
+                kiss_fft_cpx a = half[kx + nx_cpx*(ky + ny*kz)];
+                kiss_fft_cpx b = ref[kx + nx*(ky + ny*kz)];
+                MY_CHECK_SMALL(a.r - b.r, tol);
+                MY_CHECK_SMALL(a.i - b.i, tol);
+                }
+
+    // the unnormalized round trip multiplies the mesh by its size
+    std::vector<kiss_fft_scalar> back(n);
+    kiss_fft_cpx *in[1] = {&half.front()};
+    kiss_fft_scalar *out[1] = {&back.front()};
+    fft.inverse(1, in, out);
+
+    for (unsigned int i = 0; i < n; ++i)
+        MY_CHECK_SMALL(back[i]/kiss_fft_scalar(n) - mesh[i], tol);
+    }
 
 //! PPPMForceCompute creator for unit tests
 std::shared_ptr<PPPMForceCompute> base_class_pppm_creator(std::shared_ptr<SystemDefinition> sysdef,
@@ -233,6 +371,20 @@ UP_TEST( PPPMForceCompute_triclinic )
     pppm_force_particle_test_triclinic(pppm_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for threaded charge assignment and force interpolation on the CPU
+UP_TEST( PPPMForceCompute_threads )
+    {
+    pppm_force_threads_test();
+    }
+
+//! test case for the local real-to-complex FFT, with even and odd mesh dimensions
+UP_TEST( RealFFT3D_compare )
+    {
+    real_fft_test(10, 15, 24);
+    real_fft_test(7, 5, 3);
+    real_fft_test(16, 16, 16);
+    }
+
 
 #ifdef ENABLE_CUDA
 //! test case for bond forces on the GPU
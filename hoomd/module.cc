@@ -14,6 +14,7 @@
 #include "Initializers.h"
 #include "GetarInitializer.h"
 #include "GSDReader.h"
+#include "Checkpoint.h"
 #include "Compute.h"
 #include "ComputeThermo.h"
 #include "CellList.h"
@@ -30,6 +31,7 @@
 #include "LogPlainTXT.h"
 #include "LogMatrix.h"
 #include "LogHDF5.h"
+#include "LogBinary.h"
 #include "CallbackAnalyzer.h"
 #include "Updater.h"
 #include "Integrator.h"
@@ -343,6 +345,7 @@ PYBIND11_MODULE(_hoomd, m)
 
     // initializers
     export_GSDReader(m);
+    export_Checkpoint(m);
     getardump::export_GetarInitializer(m);
 
     // computes
@@ -369,6 +372,7 @@ PYBIND11_MODULE(_hoomd, m)
     export_LogPlainTXT(m);
     export_LogMatrix(m);
     export_LogHDF5(m);
+    export_LogBinary(m);
     export_CallbackAnalyzer(m);
     export_ParticleGroup(m);
 
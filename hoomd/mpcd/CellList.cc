@@ -39,6 +39,13 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
     m_decomposition = m_pdata->getDomainDecomposition();
     m_num_extra = 0;
     m_cover_box = m_pdata->getBox();
+
+    // the cell communication assumes that cells of neighboring domains are aligned
+    if (m_decomposition && m_decomposition->isStaggered())
+        {
+        m_exec_conf->msg->error() << "mpcd: staggered domain decomposition is not supported" << std::endl;
+        throw std::runtime_error("Staggered domain decomposition is not supported by MPCD");
+        }
     #endif // ENABLE_MPI
 
     m_mpcd_pdata->getSortSignal().connect<mpcd::CellList, &mpcd::CellList::sort>(this);
@@ -40,6 +40,10 @@ class options:
         self.nz = None;
         self.linear = None;
         self.onelevel = None;
+        self.single_stage = None;
+        self.compress_ghosts = None;
+        self.shared_ghosts = None;
+        self.sparse_rtags = None;
         self.autotuner_enable = True;
         self.autotuner_period = 100000;
         self.single_mpi = False;
@@ -61,6 +65,10 @@ class options:
                    nz=self.nz,
                    linear=self.linear,
                    onelevel=self.onelevel,
+                   single_stage=self.single_stage,
+                   compress_ghosts=self.compress_ghosts,
+                   shared_ghosts=self.shared_ghosts,
+                   sparse_rtags=self.sparse_rtags,
                    single_mpi=self.single_mpi,
                    nthreads=self.nthreads)
         return str(tmp);
@@ -85,6 +93,10 @@ def _parse_command_line(arg_string=None):
     parser.add_option("--nz", dest="nz", help="(MPI) Number of domains along the z-direction");
     parser.add_option("--linear", dest="linear", action="store_true", default=False, help="(MPI only) Force a slab (1D) decomposition along the z-direction");
     parser.add_option("--onelevel", dest="onelevel", action="store_true", default=False, help="(MPI only) Disable two-level (node-local) decomposition");
+    parser.add_option("--single-stage", dest="single_stage", action="store_true", default=False, help="(MPI only) Exchange ghost particles with all neighboring domains in a single stage on the CPU");
+    parser.add_option("--compress-ghosts", dest="compress_ghosts", action="store_true", default=False, help="(MPI only) Send ghost position updates as single precision displacements on the CPU");
+    parser.add_option("--shared-ghosts", dest="shared_ghosts", action="store_true", default=False, help="(MPI only) Read ghost updates of ranks on the same node from shared memory on the CPU (implies --single-stage)");
+    parser.add_option("--sparse-rtags", dest="sparse_rtags", action="store_true", default=False, help="(MPI only) Store the tag lookup of local and ghost particles in a hash map instead of a global table on the CPU");
     parser.add_option("--single-mpi", dest="single_mpi", action="store_true", help="Allow single-threaded HOOMD builds in MPI jobs");
     parser.add_option("--user", dest="user", help="User options");
     parser.add_option("--nthreads", dest="nthreads", help="Number of TBB threads");
@@ -175,6 +187,10 @@ def _parse_command_line(arg_string=None):
     hoomd.context.options.nz = cmd_options.nz;
     hoomd.context.options.linear = cmd_options.linear
     hoomd.context.options.onelevel = cmd_options.onelevel
+    hoomd.context.options.single_stage = cmd_options.single_stage
+    hoomd.context.options.compress_ghosts = cmd_options.compress_ghosts
+    hoomd.context.options.shared_ghosts = cmd_options.shared_ghosts
+    hoomd.context.options.sparse_rtags = cmd_options.sparse_rtags
     hoomd.context.options.single_mpi = cmd_options.single_mpi
     hoomd.context.options.nthreads = cmd_options.nthreads
 
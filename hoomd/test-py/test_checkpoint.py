@@ -0,0 +1,137 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+import hoomd;
+import unittest
+import os
+import glob
+import numpy
+import tempfile
+
+# unit tests for dump.checkpoint and init.read_checkpoint
+class checkpoint_tests (unittest.TestCase):
+    def setUp(self):
+        context.initialize()
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.ckp');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        self.snapshot = data.make_snapshot(N=8, box=data.boxdim(Lx=10, Ly=20, Lz=30, xy=0.1), particle_types=['A', 'B'], bond_types=['b']);
+        if comm.get_rank() == 0:
+            self.snapshot.particles.position[:] = numpy.random.uniform(-4.5, 4.5, size=(8, 3));
+            self.snapshot.particles.velocity[:] = numpy.random.normal(size=(8, 3));
+            self.snapshot.particles.typeid[:] = [0, 1, 0, 1, 0, 1, 0, 1];
+            self.snapshot.particles.mass[:] = numpy.random.uniform(1, 2, size=8);
+            self.snapshot.particles.image[:] = numpy.random.randint(-3, 3, size=(8, 3));
+            self.snapshot.bonds.resize(2);
+            self.snapshot.bonds.group[:] = [[0, 1], [6, 7]];
+
+    # test that a checkpoint restores the system exactly
+    def test_round_trip(self):
+        system = init.read_snapshot(self.snapshot);
+        dump.checkpoint(filename=self.tmp_file, period=None);
+        before = system.take_snapshot(all=True, dtype='double');
+        step = get_step();
+
+        context.initialize();
+        system = init.read_checkpoint(filename=self.tmp_file);
+        self.assertEqual(get_step(), step);
+        after = system.take_snapshot(all=True, dtype='double');
+
+        if comm.get_rank() == 0:
+            numpy.testing.assert_array_equal(before.particles.position, after.particles.position);
+            numpy.testing.assert_array_equal(before.particles.velocity, after.particles.velocity);
+            numpy.testing.assert_array_equal(before.particles.mass, after.particles.mass);
+            numpy.testing.assert_array_equal(before.particles.typeid, after.particles.typeid);
+            numpy.testing.assert_array_equal(before.particles.image, after.particles.image);
+            numpy.testing.assert_array_equal(before.bonds.group, after.bonds.group);
+            self.assertEqual(after.particles.types, ['A', 'B']);
+            self.assertEqual(after.box.xy, before.box.xy);
+
+    # test periodic writes and write()
+    def test_period(self):
+        init.read_snapshot(self.snapshot);
+        ckp = dump.checkpoint(filename=self.tmp_file, period=10);
+        run(25);
+        ckp.write();
+
+        context.initialize();
+        init.read_checkpoint(filename=self.tmp_file);
+        self.assertEqual(get_step(), 25);
+
+    def tearDown(self):
+        if comm.get_rank() == 0:
+            for f in glob.glob(self.tmp_file + '*'):
+                os.remove(f);
+        comm.barrier_all();
+
+# unit tests for reading a checkpoint in a partitioned MPI run
+# The MPI test list runs this file twice with the same HOOMD_TEST_CHECKPOINT_PARTITION: first with the full
+# communicator, which writes the checkpoint, then with --nrank, which reads it back in every partition. The partitions
+# are fixed by the first context.initialize(), so writing and reading need separate runs.
+@unittest.skipIf('HOOMD_TEST_CHECKPOINT_PARTITION' not in os.environ, 'runs only in the MPI test list')
+class checkpoint_partition_tests (unittest.TestCase):
+    def setUp(self):
+        context.initialize()
+        prefix = os.environ['HOOMD_TEST_CHECKPOINT_PARTITION'];
+        self.ckp_file = prefix + '.ckp';
+        self.ref_file = prefix + '.npz';
+
+    # test that a checkpoint written by all ranks is read back exactly by a partition with fewer ranks
+    def test_partitioned_read(self):
+        if hoomd.context.options.nrank is None:
+            snapshot = data.make_snapshot(N=64, box=data.boxdim(L=20), particle_types=['A', 'B'], bond_types=['b']);
+            if comm.get_rank() == 0:
+                snapshot.particles.position[:] = numpy.random.uniform(-9.5, 9.5, size=(64, 3));
+                snapshot.particles.velocity[:] = numpy.random.normal(size=(64, 3));
+                snapshot.particles.typeid[:] = numpy.random.randint(0, 2, size=64);
+                snapshot.particles.mass[:] = numpy.random.uniform(1, 2, size=64);
+                snapshot.particles.image[:] = numpy.random.randint(-3, 3, size=(64, 3));
+                snapshot.bonds.resize(3);
+                snapshot.bonds.group[:] = [[0, 1], [17, 42], [62, 63]];
+
+            # migrate the particles to their domains before writing
+            system = init.read_snapshot(snapshot);
+            run(10);
+            dump.checkpoint(filename=self.ckp_file, period=None);
+            before = system.take_snapshot(all=True, dtype='double');
+
+            if comm.get_rank() == 0:
+                numpy.savez(self.ref_file,
+                            step=get_step(),
+                            position=before.particles.position,
+                            velocity=before.particles.velocity,
+                            mass=before.particles.mass,
+                            typeid=before.particles.typeid,
+                            image=before.particles.image,
+                            bonds=before.bonds.group);
+        else:
+            self.assertLess(comm.get_num_ranks(), hoomd.context.mpi_conf.getNRanksGlobal());
+
+            system = init.read_checkpoint(filename=self.ckp_file);
+            after = system.take_snapshot(all=True, dtype='double');
+
+            if comm.get_rank() == 0:
+                before = numpy.load(self.ref_file);
+                self.assertEqual(get_step(), int(before['step']));
+                numpy.testing.assert_array_equal(before['position'], after.particles.position);
+                numpy.testing.assert_array_equal(before['velocity'], after.particles.velocity);
+                numpy.testing.assert_array_equal(before['mass'], after.particles.mass);
+                numpy.testing.assert_array_equal(before['typeid'], after.particles.typeid);
+                numpy.testing.assert_array_equal(before['image'], after.particles.image);
+                numpy.testing.assert_array_equal(before['bonds'], after.bonds.group);
+
+            # all partitions have read the files, remove them
+            comm.barrier_all();
+            if comm.get_partition() == 0 and comm.get_rank() == 0:
+                for f in glob.glob(self.ckp_file + '*') + [self.ref_file]:
+                    os.remove(f);
+
+    def tearDown(self):
+        comm.barrier_all();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
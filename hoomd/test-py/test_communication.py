@@ -286,6 +286,30 @@ class decomposition_tests (unittest.TestCase):
             hoomd.context.options.nz = None
             hoomd.context.options.linear = None
 
+    ## Test that a staggered decomposition keeps separate cuts for every slab and column
+    def test_staggered(self):
+        if comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            box = data.boxdim(L=10)
+            boxdim = box._getBoxDim()
+
+            comm.decomposition(nx=2, ny=2, nz=2, stagger=True)
+            dd = hoomd.context.current.decomposition._make_cpp_decomposition(boxdim)
+            self.assertTrue(dd.isStaggered())
+
+            # one set of y cuts per slab along x, and one set of z cuts per column
+            self.assertEquals(len(dd.getStaggeredFractions(1)), 2*3)
+            self.assertEquals(len(dd.getStaggeredFractions(2)), 2*2*3)
+            self.assertAlmostEquals(dd.getStaggeredFractions(1)[4], 0.5)
+            self.assertAlmostEquals(dd.getStaggeredFractions(2)[10], 0.5)
+
+            # the cuts along x are always shared
+            with self.assertRaises(RuntimeError):
+                dd.getStaggeredFractions(0)
+
+            comm.decomposition(nx=2, ny=2, nz=2)
+            dd = hoomd.context.current.decomposition._make_cpp_decomposition(boxdim)
+            self.assertFalse(dd.isStaggered())
+
     ## Test that balancing fails after initialization
     def test_wrong_order(self):
         init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
@@ -418,6 +442,89 @@ class decomposition_tests (unittest.TestCase):
             with self.assertRaises(RuntimeError):
                 dd.set_params(z=0.2, nz=4)
 
+    ## Test that the single-stage ghost exchange can be selected on the command line
+    def test_single_stage(self):
+        if comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.options.single_stage = True
+            init.create_lattice(lattice.sc(a=1.5),n=[10,10,10])
+            self.assertTrue(hoomd.context.current.system.getCommunicator().getSingleStage())
+
+            from hoomd import md
+            nl = md.nlist.cell()
+            lj = md.pair.lj(r_cut=2.5, nlist=nl)
+            lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(10)
+
+            # clear out the option so it doesn't contaminate other tests
+            hoomd.context.options.single_stage = None
+            context.initialize()
+
+    ## Test that compressed ghost updates can be selected on the command line
+    def test_compress_ghosts(self):
+        if comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.options.compress_ghosts = True
+            init.create_lattice(lattice.sc(a=1.5),n=[10,10,10])
+            self.assertTrue(hoomd.context.current.system.getCommunicator().getCompressGhostUpdates())
+
+            from hoomd import md
+            nl = md.nlist.cell()
+            lj = md.pair.lj(r_cut=2.5, nlist=nl)
+            lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(10)
+
+            # clear out the option so it doesn't contaminate other tests
+            hoomd.context.options.compress_ghosts = None
+            context.initialize()
+
+    ## Test that shared memory ghost updates can be selected on the command line
+    def test_shared_ghosts(self):
+        if comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.options.shared_ghosts = True
+            init.create_lattice(lattice.sc(a=1.5),n=[10,10,10])
+            self.assertTrue(hoomd.context.current.system.getCommunicator().getSharedGhostUpdates())
+            self.assertTrue(hoomd.context.current.system.getCommunicator().getSingleStage())
+
+            from hoomd import md
+            nl = md.nlist.cell()
+            lj = md.pair.lj(r_cut=2.5, nlist=nl)
+            lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(10)
+
+            # clear out the option so it doesn't contaminate other tests
+            hoomd.context.options.shared_ghosts = None
+            context.initialize()
+
+    ## Test that sparse tag lookup can be selected on the command line
+    def test_sparse_rtags(self):
+        if comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.options.sparse_rtags = True
+            system = init.create_lattice(lattice.sc(a=1.5),n=[10,10,10])
+            self.assertTrue(hoomd.context.current.system_definition.getParticleData().getSparseRTags())
+
+            from hoomd import md
+            nl = md.nlist.cell()
+            lj = md.pair.lj(r_cut=2.5, nlist=nl)
+            lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(10)
+
+            # particles can still be accessed by tag, and snapshots are complete
+            self.assertEqual(system.particles[999].tag, 999)
+            snap = system.take_snapshot()
+            if comm.get_rank() == 0:
+                self.assertEqual(snap.particles.N, 1000)
+
+            # clear out the option so it doesn't contaminate other tests
+            hoomd.context.options.sparse_rtags = None
+            context.initialize()
+
 ## Test for MPI barriers
 class barrier_tests(unittest.TestCase):
     def test_barrier(self):
@@ -65,6 +65,21 @@ class dmp_dcd_tests (unittest.TestCase):
         if (comm.get_rank() == 0):
             os.remove(self.tmp_file)
 
+    # tests buffered and asynchronous writes
+    def test_buffered_async(self):
+        dcd = dump.dcd(filename=self.tmp_file, period=10, buffer_frames=4, async_write=True);
+        run(100)
+        dcd.flush()
+        if (comm.get_rank() == 0):
+            import struct
+            N = 100
+            with open(self.tmp_file, 'rb') as f:
+                data = f.read()
+            # 10 frames, with unit cell and x, y, z records
+            self.assertEqual(struct.unpack('I', data[8:12])[0], 10)
+            self.assertEqual(len(data), 276 + 10 * (56 + 3 * (8 + 4 * N)))
+            os.remove(self.tmp_file)
+
     # test disable/enable
     def test_enable_disable(self):
         dcd = dump.dcd(filename=self.tmp_file, period=100);
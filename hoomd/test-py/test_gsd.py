@@ -132,6 +132,73 @@ class gsd_write_tests (unittest.TestCase):
         if comm.get_rank() == 0:
             self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=1);
 
+    # tests asynchronous writes
+    def test_async_write(self):
+        g = dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, dynamic=['momentum'], async_write=True);
+        run(5);
+        g.flush();
+        snap = data.gsd_snapshot(self.tmp_file, frame=4);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
+            numpy.testing.assert_array_equal(snap.particles.velocity[0], [10, 11, 12]);
+
+    # tests asynchronous writes with truncate
+    def test_async_write_truncate(self):
+        g = dump.gsd(filename=self.tmp_file, group=group.all(), period=1, truncate=True, overwrite=True, async_write=True);
+        run(5);
+        g.write_restart();
+        data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=1);
+
+    # tests parallel writes
+    def test_parallel_write(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, dynamic=['attribute', 'momentum'], parallel_write=True);
+        run(5);
+        snap = data.gsd_snapshot(self.tmp_file, frame=4);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+    # tests that async and parallel writes cannot be combined
+    def test_async_parallel_write(self):
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1, overwrite=True, async_write=True, parallel_write=True);
+
+    # tests compressed positions and velocities
+    def test_compression(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, dynamic=['momentum'], compression=dict(position=1e-3, velocity=1e-2));
+        run(5);
+        snap = data.gsd_snapshot(self.tmp_file, frame=4);
+        if comm.get_rank() == 0:
+            numpy.testing.assert_allclose(snap.particles.position, self.snapshot.particles.position, atol=0.5e-3);
+            numpy.testing.assert_allclose(snap.particles.velocity, self.snapshot.particles.velocity, atol=0.5e-2);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+    # tests that compression and parallel writes cannot be combined
+    def test_compression_parallel_write(self):
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1, overwrite=True, parallel_write=True, compression=dict(position=1e-3));
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1, overwrite=True, compression=dict(mass=1e-3));
+
+    # tests per-category periods
+    def test_periods(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, periods=dict(momentum=2, attribute=3));
+        for i in range(5):
+            self.s.particles[0].velocity = (i, 0, 0);
+            self.s.particles[0].mass = 1 + i;
+            run(1);
+
+        for i in range(5):
+            snap = data.gsd_snapshot(self.tmp_file, frame=i);
+            if comm.get_rank() == 0:
+                # quantities not written to a frame are read from frame 0
+                self.assertEqual(snap.particles.velocity[0][0], i if i % 2 == 0 else 0);
+                self.assertEqual(snap.particles.mass[0], 1 + i if i % 3 == 0 else 1);
+
+        self.assertRaises(ValueError, dump.gsd, filename=self.tmp_file, group=group.all(), period=1, overwrite=True, periods=dict(positions=10));
+
     # test all static quantities
     def test_all_static(self):
         dump.gsd(filename=self.tmp_file, group=group.all(), period=1, static=['attribute', 'property', 'momentum', 'topology'], overwrite=True);
@@ -445,6 +512,43 @@ class gsd_read_tests (unittest.TestCase):
 
         init.read_gsd(filename=self.tmp_file, frame=-1);
 
+    # tests that the reader kept for restore_state survives when its file is truncated by a writer
+    def test_read_gsd_truncated(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=None, overwrite=True);
+        context.initialize();
+
+        init.read_gsd(filename=self.tmp_file);
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, truncate=True, overwrite=True);
+        run(2);
+
+        if comm.get_rank() == 0:
+            try:
+                hoomd.context.current.state_reader.readTypeShapesPy(0);
+            except RuntimeError:
+                pass
+
+    # tests init.read_gsd with parallel_read
+    def test_read_gsd_parallel(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=None, overwrite=True);
+        context.initialize();
+
+        system = init.read_gsd(filename=self.tmp_file, parallel_read=True);
+        snap = system.take_snapshot(all=True);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, self.snapshot.particles.N);
+            self.assertEqual(snap.particles.types, self.snapshot.particles.types);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.charge, self.snapshot.particles.charge);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.orientation, self.snapshot.particles.orientation);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.angmom, self.snapshot.particles.angmom);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+            self.assertEqual(snap.bonds.N, self.snapshot.bonds.N);
+            numpy.testing.assert_array_equal(snap.bonds.group, self.snapshot.bonds.group);
+
     def tearDown(self):
         if comm.get_rank() == 0:
             os.remove(self.tmp_file);
@@ -22,6 +22,62 @@ class load_balance_tests (unittest.TestCase):
         if hoomd.context.current.decomposition is not None:
             lb.set_params(x=True, y=True, z=True, tolerance=0.95, maxiter=1)
 
+    ## Test time-based balancing
+    def test_cost(self):
+        lb = hoomd.update.balance(cost='time', period=5)
+        if hoomd.context.current.decomposition is not None:
+            with self.assertRaises(ValueError):
+                lb.set_params(cost='energy')
+            lb.set_params(cost='particles')
+            lb.set_params(cost='time')
+
+            # the balancer measures the force computation time of the integrator
+            from hoomd import md
+            md.integrate.mode_standard(dt=0.001)
+            md.integrate.nve(group=hoomd.group.all())
+            hoomd.run(20)
+
+    ## Test that time-based balancing follows the cost of an actual pair force
+    def test_cost_pair(self):
+        if hoomd.comm.get_num_ranks() != 2 or hoomd.context.exec_conf.isCUDAEnabled():
+            return
+
+        # both halves hold 200 particles, but only the particles in the lower half have many neighbors
+        hoomd.context.initialize()
+        snap = hoomd.data.make_snapshot(N=400, box=hoomd.data.boxdim(L=20), particle_types=['A'])
+        if hoomd.comm.get_rank() == 0:
+            for i in range(200):
+                snap.particles.position[i] = (i % 5 - 2.0, (i // 5) % 5 - 2.0, -8.5 + i // 25)
+                snap.particles.position[200+i] = (2.0*(i % 10) - 9.0, 2.0*((i // 10) % 10) - 9.0, 3.0 + 4.0*(i // 100))
+        decomposition = hoomd.comm.decomposition(nx=1, ny=1, nz=2)
+        hoomd.init.read_snapshot(snap)
+
+        from hoomd import md
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=3.0, nlist=nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=0.9)
+        md.integrate.mode_standard(dt=0.0005)
+        md.integrate.nve(group=hoomd.group.all())
+
+        # the particle numbers are even, so only the measured time moves the boundary
+        hoomd.update.balance(cost='time', period=10)
+        hoomd.run(100)
+
+        # the domain of the expensive particles has shrunk
+        frac_z = decomposition.cpp_dd.getCumulativeFractions(2)
+        self.assertLess(frac_z[1], 0.5)
+
+    ## Test balancing of a staggered decomposition
+    def test_staggered(self):
+        hoomd.context.initialize()
+        snap = hoomd.data.make_snapshot(N=100, box=hoomd.data.boxdim(L=10), particle_types=['A'])
+        if hoomd.comm.get_num_ranks() > 1 and not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.comm.decomposition(nx=1, ny=1, nz=2, stagger=True)
+        hoomd.init.read_snapshot(snap)
+
+        hoomd.update.balance(period=5)
+        hoomd.run(20)
+
     def tearDown(self):
         hoomd.context.initialize()
 
@@ -0,0 +1,285 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+#include "hoomd/Checkpoint.h"
+
+using namespace std;
+
+/*! \file test_checkpoint.cc
+    \brief Implements unit tests for CheckpointWriter and CheckpointReader
+    \ingroup unit_tests
+*/
+
+//! Build a small system with values that are not exactly representable in fewer bits
+std::shared_ptr<SystemDefinition> build_system(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    BoxDim box(Scalar(10.1), Scalar(11.3), Scalar(12.7));
+    box.setTiltFactors(Scalar(0.1), Scalar(-0.2), Scalar(0.3));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(64, box, 2, 1, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar3> h_accel(pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host,
+            access_mode::readwrite);
+        ArrayHandle<Scalar4> h_angmom(pdata->getAngularMomentumArray(), access_location::host,
+            access_mode::readwrite);
+        ArrayHandle<Scalar3> h_inertia(pdata->getMomentsOfInertiaArray(), access_location::host,
+            access_mode::readwrite);
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            Scalar x = Scalar(i)/Scalar(3.0);
+            h_pos.data[i] = make_scalar4(x/Scalar(3.0) - Scalar(3.5), Scalar(1.0)/(x + Scalar(1.0)), -x/Scalar(7.0),
+                __int_as_scalar(i % 2));
+            h_vel.data[i] = make_scalar4(Scalar(0.1)*x, -Scalar(0.3)*x, x/Scalar(11.0), Scalar(1.0) + x);
+            h_accel.data[i] = make_scalar3(x/Scalar(13.0), Scalar(0.7), -x);
+            h_charge.data[i] = x/Scalar(17.0);
+            h_image.data[i] = make_int3(i % 3 - 1, i % 5 - 2, i % 7 - 3);
+            h_orientation.data[i] = make_scalar4(Scalar(1.0)/(x + Scalar(2.0)), Scalar(0.2), Scalar(0.3), x);
+            h_angmom.data[i] = make_scalar4(0, x/Scalar(19.0), Scalar(0.1), -x);
+            h_inertia.data[i] = make_scalar3(x, Scalar(2.0)*x, Scalar(1.0)/Scalar(3.0));
+            }
+        }
+
+    for (unsigned int i = 0; i + 1 < pdata->getNGlobal(); i += 2)
+        sysdef->getBondData()->addBondedGroup(Bond(0, i, i + 1));
+
+    IntegratorVariables v;
+    v.type = "nvt";
+    v.variable.push_back(Scalar(1.0)/Scalar(3.0));
+    v.variable.push_back(Scalar(-2.0)/Scalar(7.0));
+    unsigned int handle = sysdef->getIntegratorData()->registerIntegrator();
+    sysdef->getIntegratorData()->setIntegratorVariables(handle, v);
+
+    pdata->translateOrigin(make_scalar3(Scalar(0.1)/Scalar(3.0), Scalar(-0.25), Scalar(1.0)/Scalar(7.0)));
+
+    return sysdef;
+    }
+
+//! Reverse the order of the local particles
+void reverse_order(std::shared_ptr<ParticleData> pdata)
+    {
+    CheckpointParticleData local;
+    local.take(pdata);
+    unsigned int N = pdata->getN();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel(pdata->getAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation(pdata->getOrientationArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<Scalar4> h_angmom(pdata->getAngularMomentumArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<Scalar3> h_inertia(pdata->getMomentsOfInertiaArray(), access_location::host,
+            access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::overwrite);
+        RTagHandle rtag(*pdata, access_mode::readwrite);
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            unsigned int j = N - 1 - i;
+            h_pos.data[i] = local.pos[j];
+            h_vel.data[i] = local.vel[j];
+            h_accel.data[i] = local.accel[j];
+            h_charge.data[i] = local.charge[j];
+            h_image.data[i] = local.image[j];
+            h_orientation.data[i] = local.orientation[j];
+            h_angmom.data[i] = local.angmom[j];
+            h_inertia.data[i] = local.inertia[j];
+            h_tag.data[i] = local.tag[j];
+            rtag.set(local.tag[j], i);
+            }
+        }
+
+    pdata->notifyParticleSort();
+    }
+
+//! Check that two arrays are identical bit for bit
+template<class T>
+void check_identical(const std::vector<T>& a, const std::vector<T>& b)
+    {
+    UP_ASSERT_EQUAL(a.size(), b.size());
+    UP_ASSERT(a.size() == 0 || memcmp(&a[0], &b[0], a.size()*sizeof(T)) == 0);
+    }
+
+//! Test that a checkpoint restores the local arrays, bonds, box, origin and integrator variables exactly
+UP_TEST( checkpoint_round_trip )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_system(exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    reverse_order(pdata);
+
+    const string fname = "test_checkpoint.ckp";
+    std::shared_ptr<CheckpointWriter> writer(new CheckpointWriter(sysdef, fname));
+    writer->analyze(1234);
+
+    std::shared_ptr<CheckpointReader> reader(new CheckpointReader(exec_conf, fname));
+    UP_ASSERT_EQUAL(reader->getTimeStep(), (uint64_t)1234);
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot = reader->getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef2(new SystemDefinition(snapshot, exec_conf));
+    reader->restoreLocalData(sysdef2);
+    std::shared_ptr<ParticleData> pdata2 = sysdef2->getParticleData();
+
+    // particle arrays, in the saved order
+    CheckpointParticleData a, b;
+    a.take(pdata);
+    b.take(pdata2);
+    check_identical(a.pos, b.pos);
+    check_identical(a.vel, b.vel);
+    check_identical(a.accel, b.accel);
+    check_identical(a.charge, b.charge);
+    check_identical(a.diameter, b.diameter);
+    check_identical(a.image, b.image);
+    check_identical(a.body, b.body);
+    check_identical(a.orientation, b.orientation);
+    check_identical(a.angmom, b.angmom);
+    check_identical(a.inertia, b.inertia);
+    check_identical(a.tag, b.tag);
+    UP_ASSERT_EQUAL(pdata2->getNameByType(1), pdata->getNameByType(1));
+
+    // box and origin
+    const BoxDim& box = pdata->getGlobalBox();
+    const BoxDim& box2 = pdata2->getGlobalBox();
+    Scalar3 lo = box.getLo(), lo2 = box2.getLo(), hi = box.getHi(), hi2 = box2.getHi();
+    UP_ASSERT(memcmp(&lo, &lo2, sizeof(Scalar3)) == 0);
+    UP_ASSERT(memcmp(&hi, &hi2, sizeof(Scalar3)) == 0);
+    UP_ASSERT(box.getTiltFactorXY() == box2.getTiltFactorXY());
+    UP_ASSERT(box.getTiltFactorXZ() == box2.getTiltFactorXZ());
+    UP_ASSERT(box.getTiltFactorYZ() == box2.getTiltFactorYZ());
+    Scalar3 origin = pdata->getOrigin(), origin2 = pdata2->getOrigin();
+    UP_ASSERT(memcmp(&origin, &origin2, sizeof(Scalar3)) == 0);
+
+    // bonds
+    BondData::Snapshot bonds, bonds2;
+    sysdef->getBondData()->takeSnapshot(bonds);
+    sysdef2->getBondData()->takeSnapshot(bonds2);
+    check_identical(bonds.type_id, bonds2.type_id);
+    check_identical(bonds.groups, bonds2.groups);
+
+    // integrator variables
+    UP_ASSERT_EQUAL(snapshot->integrator_data.size(), (size_t)1);
+    UP_ASSERT_EQUAL(snapshot->integrator_data[0].type, string("nvt"));
+    check_identical(snapshot->integrator_data[0].variable,
+        sysdef->getIntegratorData()->getIntegratorVariables(0).variable);
+
+    remove(fname.c_str());
+    }
+
+//! Test that removed particles are renumbered consistently with their bonds
+UP_TEST( checkpoint_removed_particles )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_system(exec_conf);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // remove a bond and both of its particles
+    sysdef->getBondData()->removeBondedGroup(0);
+    pdata->removeParticle(0);
+    pdata->removeParticle(1);
+
+    const string fname = "test_checkpoint_removed.ckp";
+    CheckpointWriter(sysdef, fname).analyze(10);
+
+    CheckpointReader reader(exec_conf, fname);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot = reader.getSnapshot();
+    UP_ASSERT_EQUAL(snapshot->particle_data.size, pdata->getNGlobal());
+
+    // every bond connects the same positions as before
+    BondData::Snapshot bonds;
+    sysdef->getBondData()->takeSnapshot(bonds);
+    UP_ASSERT_EQUAL(snapshot->bond_data.size, bonds.size);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < bonds.size; i++)
+        {
+        for (unsigned int j = 0; j < 2; j++)
+            {
+            Scalar4 p = h_pos.data[h_rtag.data[bonds.groups[i].tag[j]]];
+            vec3<Scalar> p2 = snapshot->particle_data.pos[snapshot->bond_data.groups[i].tag[j]];
+            UP_ASSERT(p.x == p2.x && p.y == p2.y && p.z == p2.z);
+            }
+        }
+
+    remove(fname.c_str());
+    }
+
+//! Test that damaged files are rejected
+UP_TEST( checkpoint_errors )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef = build_system(exec_conf);
+
+    const string fname = "test_checkpoint_errors.ckp";
+    CheckpointWriter(sysdef, fname).analyze(0);
+
+    // truncate the file
+    string data;
+        {
+        ifstream f(fname.c_str(), ios_base::in | ios_base::binary);
+        data.assign(istreambuf_iterator<char>(f), istreambuf_iterator<char>());
+        }
+        {
+        ofstream f(fname.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        f.write(data.data(), data.size() - 8);
+        }
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ CheckpointReader(exec_conf, fname); });
+
+    // overwrite the magic bytes
+        {
+        ofstream f(fname.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        f.write("NOTACKPT", 8);
+        f.write(data.data() + 8, data.size() - 8);
+        }
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ CheckpointReader(exec_conf, fname); });
+
+    // header of rank 0 with zero ranks (the number of ranks follows the magic bytes, the version and the scalar size)
+        {
+        string bad = data;
+        uint32_t file_ranks = 0;
+        memcpy(&bad[16], &file_ranks, sizeof(uint32_t));
+        ofstream f(fname.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        f.write(bad.data(), bad.size());
+        }
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ CheckpointReader(exec_conf, fname); });
+
+    // header of rank 0 with a rank outside of the number of ranks
+        {
+        string bad = data;
+        uint32_t file_ranks = 2, file_rank = 2;
+        memcpy(&bad[16], &file_ranks, sizeof(uint32_t));
+        memcpy(&bad[20], &file_rank, sizeof(uint32_t));
+        ofstream f(fname.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        f.write(bad.data(), bad.size());
+        }
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ CheckpointReader(exec_conf, fname); });
+
+    remove(fname.c_str());
+    UP_ASSERT_EXCEPTION(runtime_error, [&]{ CheckpointReader(exec_conf, fname); });
+    }
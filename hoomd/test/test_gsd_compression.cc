@@ -0,0 +1,184 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+#include "hoomd/GSDCompression.h"
+
+using namespace std;
+
+/*! \file test_gsd_compression.cc
+    \brief Implements unit tests for GSDChunkEncoder and GSDChunkDecoder
+    \ingroup unit_tests
+*/
+
+//! Decode a chunk and check that it matches the input within half the precision
+void check_chunk(std::vector<int64_t>& values, const std::vector<uint8_t>& chunk, const std::vector<float>& data,
+                 double precision)
+    {
+    UP_ASSERT(GSDChunkDecoder::decode(values, (const char *)&chunk[0], chunk.size()));
+    UP_ASSERT_EQUAL(values.size(), data.size());
+    for (unsigned int i = 0; i < data.size(); i++)
+        {
+        float x = GSDChunkDecoder::dequantize(values[i], precision);
+        UP_ASSERT(std::fabs(double(x) - double(data[i])) <= precision*0.5 + std::fabs(data[i])*1e-6);
+        }
+    }
+
+//! Test that a single keyframe round trips
+UP_TEST( gsd_compression_keyframe )
+    {
+    const double precision = 1e-3;
+    std::vector<float> data;
+    for (unsigned int i = 0; i < 1000; i++)
+        data.push_back(-10.0f + 0.0213f*float(i));
+
+    GSDChunkEncoder encoder(precision);
+    std::vector<uint8_t> chunk;
+    UP_ASSERT(encoder.encode(chunk, &data[0], 250, 4, 0));
+    UP_ASSERT(chunk.size() < data.size()*sizeof(float));
+
+    GSDCompressedHeader header;
+    UP_ASSERT(GSDChunkDecoder::readHeader(header, (const char *)&chunk[0], chunk.size()));
+    UP_ASSERT_EQUAL(header.N, (uint64_t)250);
+    UP_ASSERT_EQUAL(header.M, (uint32_t)4);
+    UP_ASSERT_EQUAL(header.precision, precision);
+    UP_ASSERT_EQUAL(header.reference_frame, GSDCompressedHeader::KEYFRAME);
+
+    std::vector<int64_t> values;
+    check_chunk(values, chunk, data, precision);
+
+    // truncated data is detected
+    UP_ASSERT(!GSDChunkDecoder::decode(values, (const char *)&chunk[0], chunk.size()/2));
+    UP_ASSERT(!GSDChunkDecoder::readHeader(header, (const char *)&chunk[0], 8));
+    }
+
+//! Test a chain of delta frames and the conditions that start a new keyframe
+UP_TEST( gsd_compression_deltas )
+    {
+    const double precision = 1e-2;
+    const unsigned int period = 4;
+    std::vector<float> data(300);
+    for (unsigned int i = 0; i < data.size(); i++)
+        data[i] = float(i)*0.1f;
+
+    GSDChunkEncoder encoder(precision, period);
+    std::vector<uint8_t> chunk;
+    std::vector<int64_t> values;
+    GSDCompressedHeader header;
+
+    for (unsigned int frame = 0; frame < 10; frame++)
+        {
+        for (unsigned int i = 0; i < data.size(); i++)
+            data[i] += 0.03f*std::sin(float(i*frame));
+
+        UP_ASSERT(encoder.encode(chunk, &data[0], 100, 3, frame));
+        UP_ASSERT(GSDChunkDecoder::readHeader(header, (const char *)&chunk[0], chunk.size()));
+        if (frame % period == 0)
+            UP_ASSERT_EQUAL(header.reference_frame, GSDCompressedHeader::KEYFRAME);
+        else
+            UP_ASSERT_EQUAL(header.reference_frame, (uint64_t)frame-1);
+
+        // values holds the previous frame
+        check_chunk(values, chunk, data, precision);
+        }
+
+    // a change in size starts a keyframe
+    data.resize(150);
+    UP_ASSERT(encoder.encode(chunk, &data[0], 50, 3, 10));
+    UP_ASSERT(GSDChunkDecoder::readHeader(header, (const char *)&chunk[0], chunk.size()));
+    UP_ASSERT_EQUAL(header.reference_frame, GSDCompressedHeader::KEYFRAME);
+    check_chunk(values, chunk, data, precision);
+
+    // so does a frame index that does not increase
+    UP_ASSERT(encoder.encode(chunk, &data[0], 50, 3, 2));
+    UP_ASSERT(GSDChunkDecoder::readHeader(header, (const char *)&chunk[0], chunk.size()));
+    UP_ASSERT_EQUAL(header.reference_frame, GSDCompressedHeader::KEYFRAME);
+
+    // decoding a delta frame against values of the wrong size fails
+    UP_ASSERT(encoder.encode(chunk, &data[0], 50, 3, 3));
+    std::vector<int64_t> wrong(10);
+    UP_ASSERT(!GSDChunkDecoder::decode(wrong, (const char *)&chunk[0], chunk.size()));
+    }
+
+//! Test values that need the escape code and values that cannot be quantized
+UP_TEST( gsd_compression_escape )
+    {
+    const double precision = 1e-4;
+    std::vector<float> data(130, 0.0f);
+    data[3] = 1e6f;
+    data[70] = -3e7f;
+    data[129] = 0.5f;
+
+    GSDChunkEncoder encoder(precision);
+    std::vector<uint8_t> chunk;
+    std::vector<int64_t> values;
+    UP_ASSERT(encoder.encode(chunk, &data[0], 130, 1, 0));
+    check_chunk(values, chunk, data, precision);
+
+    // jump far away in the next (delta) frame
+    data[3] = -1e6f;
+    data[4] = 2e7f;
+    UP_ASSERT(encoder.encode(chunk, &data[0], 130, 1, 1));
+    check_chunk(values, chunk, data, precision);
+
+    data[5] = std::numeric_limits<float>::quiet_NaN();
+    UP_ASSERT(!encoder.encode(chunk, &data[0], 130, 1, 2));
+    data[5] = std::numeric_limits<float>::infinity();
+    UP_ASSERT(!encoder.encode(chunk, &data[0], 130, 1, 2));
+
+    GSDChunkEncoder fine_encoder(1e-15);
+    data[5] = 0.0f;
+    UP_ASSERT(!fine_encoder.encode(chunk, &data[0], 130, 1, 0));
+    }
+
+//! Test that decoding a range of values matches the full decode, also across delta frames
+UP_TEST( gsd_compression_range )
+    {
+    const double precision = 1e-3;
+    std::vector<float> data(3*333);
+    for (unsigned int i = 0; i < data.size(); i++)
+        data[i] = std::cos(float(i));
+
+    GSDChunkEncoder encoder(precision);
+    std::vector<uint8_t> chunk;
+    std::vector<int64_t> values;
+
+    // ranges that start and end inside of blocks, on block boundaries, and cover the last partial block
+    const uint64_t first[] = {0, 100, 64, 960, 0};
+    const uint64_t count[] = {1, 200, 128, 39, 999};
+    std::vector<int64_t> ranges[5];
+
+    for (unsigned int frame = 0; frame < 3; frame++)
+        {
+        for (unsigned int i = 0; i < data.size(); i++)
+            data[i] += 0.01f*std::sin(float(i*frame));
+
+        UP_ASSERT(encoder.encode(chunk, &data[0], 333, 3, frame));
+        check_chunk(values, chunk, data, precision);
+
+        for (unsigned int r = 0; r < 5; r++)
+            {
+            UP_ASSERT(GSDChunkDecoder::decode(ranges[r], (const char *)&chunk[0], chunk.size(), first[r], count[r]));
+            UP_ASSERT_EQUAL(ranges[r].size(), count[r]);
+            for (uint64_t i = 0; i < count[r]; i++)
+                UP_ASSERT_EQUAL(ranges[r][i], values[first[r]+i]);
+            }
+        }
+
+    // ranges out of bounds are rejected
+    std::vector<int64_t> out_of_bounds;
+    UP_ASSERT(!GSDChunkDecoder::decode(out_of_bounds, (const char *)&chunk[0], chunk.size(), 990, 10));
+    }
@@ -359,6 +359,160 @@ void test_load_balancer_ghost(std::shared_ptr<ExecutionConfiguration> exec_conf,
     UP_ASSERT_EQUAL(pdata->getOwnerRank(7), di(1,0,1));
     }
 
+template<class LB>
+void test_load_balancer_cost(std::shared_ptr<ExecutionConfiguration> exec_conf)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with 256 particles evenly spaced along z
+    const unsigned int N = 256;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N,           // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+    for (unsigned int i=0; i < N; ++i)
+        {
+        pdata->setPosition(i, make_scalar3(0.5, 0.5, -1.0 + (Scalar(i)+Scalar(0.5))*Scalar(2.0)/Scalar(N)), false);
+        }
+
+    SnapshotParticleData<Scalar> snap(N);
+    pdata->takeSnapshot(snap);
+
+    // initialize a 1x1x8 domain decomposition with 32 particles per domain
+    std::vector<Scalar> fxs, fys, fzs(7, Scalar(0.125));
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+    comm->migrateParticles();
+    UP_ASSERT_EQUAL(pdata->getN(), 32);
+
+    std::shared_ptr<LoadBalancer> lb(new LB(sysdef,decomposition));
+    lb->setCommunicator(comm);
+    lb->setCostBased(true);
+
+    // particles in the lower half of the box are three times as expensive
+    auto measure_cost = [&]()
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        double cost = 0.0;
+        for (unsigned int i=0; i < pdata->getN(); ++i)
+            cost += (h_pos.data[i].z < Scalar(0.0)) ? 3.0 : 1.0;
+        return cost;
+        };
+
+    // without a measurement, the particle numbers are balanced, and these are already even
+    lb->update(0);
+    UP_ASSERT_EQUAL(pdata->getN(), 32);
+
+    for (unsigned int t=1; t < 100; ++t)
+        {
+        comm->addComputeTime(measure_cost());
+        lb->update(t);
+        }
+
+    // the domains in the expensive half have shrunk
+    vector<Scalar> frac_z = decomposition->getCumulativeFractions(2);
+    UP_ASSERT(frac_z[4] < Scalar(0.36));
+    UP_ASSERT(frac_z[6] > Scalar(0.45) && frac_z[6] < Scalar(0.55));
+
+    // initially, the most expensive rank has a cost of 96, but the average is only 64
+    double cost = measure_cost();
+    double max_cost(0.0);
+    MPI_Allreduce(&cost, &max_cost, 1, MPI_DOUBLE, MPI_MAX, exec_conf->getMPICommunicator());
+    UP_ASSERT(max_cost < 72.0);
+    }
+
+template<class LB>
+void test_load_balancer_staggered(std::shared_ptr<ExecutionConfiguration> exec_conf)
+{
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    // create a system with 128 particles in each half of the box along x
+    const unsigned int N = 256;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N,           // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    // in the slab x < 0, three quarters of the particles are at y < 0, and in the slab x > 0 at y > 0
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+    for (unsigned int i=0; i < N; ++i)
+        {
+        unsigned int slab = i / 128;
+        unsigned int m = i % 128;
+        Scalar y = (m < 96) ? Scalar(-1.0) + (Scalar(m)+Scalar(0.5))/Scalar(96) : (Scalar(m-96)+Scalar(0.5))/Scalar(32);
+        if (slab == 1)
+            y = -y;
+        Scalar z = Scalar(-1.0) + (Scalar((37*m) % 128)+Scalar(0.5))*Scalar(2.0)/Scalar(128);
+        pdata->setPosition(i, make_scalar3(slab ? 0.5 : -0.5, y, z), false);
+        }
+
+    SnapshotParticleData<Scalar> snap(N);
+    pdata->takeSnapshot(snap);
+
+    // initialize a staggered 2x2x2 domain decomposition
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.5);
+    fys[0] = Scalar(0.5);
+    fzs[0] = Scalar(0.5);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, pdata->getBox().getL(), fxs, fys, fzs));
+    decomposition->setStaggered(true);
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+    comm->migrateParticles();
+
+    // initially, the most loaded ranks own about 48 particles, but the average is only 32
+    unsigned int max_n = pdata->getN();
+    MPI_Allreduce(MPI_IN_PLACE, &max_n, 1, MPI_UNSIGNED, MPI_MAX, exec_conf->getMPICommunicator());
+    UP_ASSERT(max_n >= 48);
+
+    std::shared_ptr<LoadBalancer> lb(new LB(sysdef,decomposition));
+    lb->setCommunicator(comm);
+
+    for (unsigned int t=0; t < 20; ++t)
+        {
+        lb->update(t);
+        }
+
+    // the cuts along y have moved in opposite directions in the two slabs
+    const vector<Scalar>& frac_y = decomposition->getStaggeredFractions(1);
+    UP_ASSERT(frac_y[1] < Scalar(0.4));
+    UP_ASSERT(frac_y[4] > Scalar(0.6));
+
+    // the local box follows the cuts of the local slab
+    uint3 grid_pos = decomposition->getGridPos();
+    UP_ASSERT_EQUAL(decomposition->getCumulativeFraction(1, 1), frac_y[grid_pos.x*3+1]);
+
+    // no particles were lost, and the load is now (nearly) balanced
+    unsigned int n_global = pdata->getN();
+    MPI_Allreduce(MPI_IN_PLACE, &n_global, 1, MPI_UNSIGNED, MPI_SUM, exec_conf->getMPICommunicator());
+    UP_ASSERT_EQUAL(n_global, N);
+
+    max_n = pdata->getN();
+    MPI_Allreduce(MPI_IN_PLACE, &max_n, 1, MPI_UNSIGNED, MPI_MAX, exec_conf->getMPICommunicator());
+    UP_ASSERT(max_n < 40);
+    }
+
 //! Tests basic particle redistribution
 UP_TEST( LoadBalancer_test_basic)
     {
@@ -395,6 +549,20 @@ UP_TEST( LoadBalancer_test_ghost)
     test_load_balancer_ghost<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests balancing of the measured compute time
+UP_TEST( LoadBalancer_test_cost)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    test_load_balancer_cost<LoadBalancer>(exec_conf);
+    }
+
+//! Tests balancing of a staggered decomposition
+UP_TEST( LoadBalancer_test_staggered)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    test_load_balancer_staggered<LoadBalancer>(exec_conf);
+    }
+
 #ifdef ENABLE_CUDA
 //! Tests basic particle redistribution on the GPU
 UP_TEST( LoadBalancerGPU_test_basic)
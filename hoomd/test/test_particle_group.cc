@@ -342,6 +342,40 @@ UP_TEST( ParticleGroup_tag_test )
     CHECK_EQUAL_UINT(tags59.getMemberTag(4), 9);
     }
 
+//! Checks that ParticleGroup can initialize from an unsorted list of tags with gaps and duplicates
+UP_TEST( ParticleGroup_tag_list_test )
+    {
+    std::shared_ptr<SystemDefinition> sysdef = create_sysdef();
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::vector<unsigned int> member_tags;
+    member_tags.push_back(9);
+    member_tags.push_back(2);
+    member_tags.push_back(1);
+    member_tags.push_back(6);
+    member_tags.push_back(3);
+    member_tags.push_back(2);
+    member_tags.push_back(8);
+
+    ParticleGroup tags(sysdef, member_tags);
+    CHECK_EQUAL_UINT(tags.getNumMembersGlobal(), 6);
+    CHECK_EQUAL_UINT(tags.getNumMembers(), 6);
+    CHECK_EQUAL_UINT(tags.getIndexArray().getNumElements(), 6);
+    CHECK_EQUAL_UINT(tags.getMemberTag(0), 1);
+    CHECK_EQUAL_UINT(tags.getMemberTag(1), 2);
+    CHECK_EQUAL_UINT(tags.getMemberTag(2), 3);
+    CHECK_EQUAL_UINT(tags.getMemberTag(3), 6);
+    CHECK_EQUAL_UINT(tags.getMemberTag(4), 8);
+    CHECK_EQUAL_UINT(tags.getMemberTag(5), 9);
+
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    for (unsigned int tag = 0; tag < 10; ++tag)
+        {
+        bool expected = (tag == 1 || tag == 2 || tag == 3 || tag == 6 || tag == 8 || tag == 9);
+        UP_ASSERT_EQUAL(tags.isMember(h_rtag.data[tag]), expected);
+        }
+    }
+
 //! Checks that ParticleGroup can initialize by cuboid
 UP_TEST( ParticleGroup_cuboid_test )
     {
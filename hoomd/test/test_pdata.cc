@@ -617,6 +617,127 @@ UP_TEST( ParticleData_test )
     UP_ASSERT(pdata_type_test.getTypeByName("test") == 1);
     }
 
+//! Test the sparse reverse-lookup map
+UP_TEST( RTagMap_test )
+    {
+    RTagMap map;
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)0);
+    UP_ASSERT_EQUAL(map.find(0), NOT_LOCAL);
+
+    // insert scattered tags, as a rank sees them after migration
+    const unsigned int n = 10000;
+    for (unsigned int i = 0; i < n; ++i)
+        map.set(i*7919, i);
+    UP_ASSERT_EQUAL(map.size(), n);
+
+    for (unsigned int i = 0; i < n; ++i)
+        UP_ASSERT_EQUAL(map.find(i*7919), i);
+    UP_ASSERT_EQUAL(map.find(1), NOT_LOCAL);
+
+    // overwrite every third entry, and remove every other entry
+    for (unsigned int i = 0; i < n; i += 3)
+        map.set(i*7919, n+i);
+    for (unsigned int i = 0; i < n; i += 2)
+        map.set(i*7919, NOT_LOCAL);
+    UP_ASSERT_EQUAL(map.size(), n/2);
+
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        unsigned int expected = (i % 2 == 0) ? NOT_LOCAL : ((i % 3 == 0) ? n+i : i);
+        UP_ASSERT_EQUAL(map.find(i*7919), expected);
+        }
+
+    // the table shrinks when most entries are removed
+    size_t mem = map.getMemoryUsage();
+    for (unsigned int i = 1; i < n-100; i += 2)
+        map.erase(i*7919);
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)50);
+    UP_ASSERT(map.getMemoryUsage() < mem/16);
+    for (unsigned int i = n-100; i < n; ++i)
+        UP_ASSERT_EQUAL(map.find(i*7919), (i % 2 == 0) ? NOT_LOCAL : ((i % 3 == 0) ? n+i : i));
+
+    map.clear();
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)0);
+    UP_ASSERT_EQUAL(map.find((n-1)*7919), NOT_LOCAL);
+    }
+
+//! Test particle data with sparse reverse-lookup tags
+UP_TEST( ParticleData_sparse_rtag_test )
+    {
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    ParticleData pdata(100, box, 1, exec_conf);
+
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        pdata.setPosition(tag, make_scalar3(-4.9 + 0.09*tag, 0.0, 0.0));
+
+    pdata.setSparseRTags(true);
+    UP_ASSERT(pdata.getSparseRTags());
+    UP_ASSERT_EQUAL(pdata.getRTagMap().size(), (unsigned int)100);
+    UP_ASSERT_EQUAL(pdata.getRTagSize(), (unsigned int)100);
+    UP_ASSERT_EQUAL(pdata.getMaximumTag(), (unsigned int)99);
+    UP_ASSERT(pdata.isTagActive(99));
+    UP_ASSERT(!pdata.isTagActive(100));
+    UP_ASSERT_EQUAL(pdata.getNthTag(42), (unsigned int)42);
+
+    // the dense table is released
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ pdata.getRTags(); });
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ pdata.addParticle(0); });
+
+    // reorder the particles, and look them up by tag
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(pdata.getTags(), access_location::host, access_mode::readwrite);
+        RTagHandle h_rtag(pdata, access_mode::readwrite);
+        for (unsigned int i = 0; i < 50; ++i)
+            {
+            std::swap(h_pos.data[i], h_pos.data[99-i]);
+            std::swap(h_tag.data[i], h_tag.data[99-i]);
+            h_rtag.set(h_tag.data[i], i);
+            h_rtag.set(h_tag.data[99-i], 99-i);
+            }
+        }
+    pdata.notifyParticleSort();
+
+    Scalar tol = Scalar(1e-6);
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        {
+        UP_ASSERT_EQUAL(pdata.getRTag(tag), 99-tag);
+        MY_CHECK_CLOSE(pdata.getPosition(tag).x, -4.9 + 0.09*tag, tol);
+        }
+
+    // snapshots are ordered by tag
+    SnapshotParticleData<Scalar> snap;
+    pdata.takeSnapshot(snap);
+    UP_ASSERT_EQUAL(snap.size, (unsigned int)100);
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        MY_CHECK_CLOSE(snap.pos[tag].x, -4.9 + 0.09*tag, tol);
+
+    // switch back to the dense table
+    pdata.setSparseRTags(false);
+    UP_ASSERT(!pdata.getSparseRTags());
+        {
+        ArrayHandle<unsigned int> h_rtag(pdata.getRTags(), access_location::host, access_mode::read);
+        UP_ASSERT_EQUAL(pdata.getRTags().size(), (unsigned int)100);
+        for (unsigned int tag = 0; tag < 100; ++tag)
+            UP_ASSERT_EQUAL(h_rtag.data[tag], 99-tag);
+        }
+    UP_ASSERT_EQUAL(pdata.getNthTag(42), (unsigned int)42);
+    UP_ASSERT_EQUAL(pdata.getRTagMap().size(), (unsigned int)0);
+
+    // constructing with sparse reverse-lookup tags never allocates the dense table
+    ParticleData pdata_sparse(snap, box, exec_conf, std::shared_ptr<DomainDecomposition>(), true);
+    UP_ASSERT(pdata_sparse.getSparseRTags());
+    UP_ASSERT_EQUAL(pdata_sparse.getRTagCapacity(), (unsigned int)0);
+    UP_ASSERT_EQUAL(pdata_sparse.getRTagMap().size(), (unsigned int)100);
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        MY_CHECK_CLOSE(pdata_sparse.getPosition(tag).x, -4.9 + 0.09*tag, tol);
+
+    pdata_sparse.initializeFromSnapshot(snap);
+    UP_ASSERT_EQUAL(pdata_sparse.getRTagCapacity(), (unsigned int)0);
+    UP_ASSERT_EQUAL(pdata_sparse.getRTagMap().size(), (unsigned int)100);
+    }
+
 //! Tests the RandomParticleInitializer class
 UP_TEST( Random_test )
     {
@@ -14,6 +14,7 @@ HOOMD_UP_MAIN();
 
 #include <math.h>
 #include "hoomd/System.h"
+#include "hoomd/Logger.h"
 
 #include <stdexcept>
 #include <string>
@@ -101,6 +102,95 @@ class DummyCompute : public Compute
         string m_name;  //!< Name of the dummy
     };
 
+//! Compute that counts how often its quantity is evaluated
+class CountingCompute : public Compute
+    {
+    public:
+        //! Constructs the compute
+        CountingCompute(std::shared_ptr<SystemDefinition> sysdef)
+                : Compute(sysdef), m_num_computes(0), m_particles_sorted(false)
+            {
+            m_pdata->getParticleSortSignal().connect<CountingCompute, &CountingCompute::setParticlesSorted>(this);
+            }
+
+        //! Destructor
+        ~CountingCompute()
+            {
+            m_pdata->getParticleSortSignal().disconnect<CountingCompute, &CountingCompute::setParticlesSorted>(this);
+            }
+
+        //! Counts the evaluations, skipping repeated calls at the same time step unless the particles were sorted
+        void compute(unsigned int timestep)
+            {
+            if (!m_particles_sorted && !shouldCompute(timestep))
+                return;
+            m_particles_sorted = false;
+            m_num_computes++;
+            }
+
+        //! Flags that the particles were sorted, as ForceCompute does
+        void setParticlesSorted()
+            {
+            m_particles_sorted = true;
+            }
+
+        //! Returns the provided log quantity
+        std::vector< std::string > getProvidedLogQuantities()
+            {
+            return std::vector< std::string >(1, "count");
+            }
+
+        //! Returns the number of evaluations
+        Scalar getLogValue(const std::string& quantity, unsigned int timestep)
+            {
+            return Scalar(m_num_computes);
+            }
+
+        unsigned int m_num_computes;    //!< Number of evaluations
+        bool m_particles_sorted;        //!< True when the particles were sorted since the last evaluation
+    };
+
+//! Tests that loggers share compute quantities within a time step
+UP_TEST( log_cache_tests )
+    {
+    std::shared_ptr< SystemDefinition > sysdef(new SystemDefinition(10, BoxDim(10)));
+    std::shared_ptr< CountingCompute > compute(new CountingCompute(sysdef));
+
+    System sys(sysdef, 0);
+    sys.addCompute(compute, "counter");
+
+    std::shared_ptr< Logger > logger1(new Logger(sysdef));
+    std::shared_ptr< Logger > logger2(new Logger(sysdef));
+    sys.registerLogger(logger1);
+    sys.registerLogger(logger2);
+    logger1->setLoggedQuantities(std::vector< std::string >(1, "count"));
+    logger2->setLoggedQuantities(std::vector< std::string >(1, "count"));
+
+    // the quantity is evaluated once per time step, however many loggers ask for it
+    logger1->analyze(5);
+    logger2->analyze(5);
+    UP_ASSERT_EQUAL(compute->m_num_computes, (unsigned int)1);
+    UP_ASSERT_EQUAL(logger2->getQuantity("count", 5, true), Scalar(1));
+
+    logger1->analyze(10);
+    logger2->analyze(10);
+    UP_ASSERT_EQUAL(compute->m_num_computes, (unsigned int)2);
+
+    // sorting the particles invalidates the shared values of the current time step
+    logger1->analyze(15);
+    sysdef->getParticleData()->notifyParticleSort();
+    logger2->analyze(15);
+    UP_ASSERT_EQUAL(compute->m_num_computes, (unsigned int)3);
+
+    // so does initializing from a snapshot
+    SnapshotParticleData<Scalar> snap(10);
+    sysdef->getParticleData()->takeSnapshot(snap);
+    logger1->analyze(20);
+    sysdef->getParticleData()->initializeFromSnapshot(snap);
+    logger2->analyze(20);
+    UP_ASSERT_EQUAL(compute->m_num_computes, (unsigned int)4);
+    }
+
 //! Tests the add, get, and set routines in System
 UP_TEST( getter_setter_tests )
     {
@@ -400,6 +400,7 @@ class balance(_updater):
         maxiter (int): Maximum number of iterations to attempt in a single step.
         period (int): Balancing will be attempted every \a period time steps
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+        cost (str): Measure of the load of a rank, either 'particles' or 'time'.
 
     Every *period* steps, the boundaries of the processor domains are adjusted to distribute the particle load close
     to evenly between them. The load imbalance is defined as the number of particles owned by a rank divided by the
@@ -424,6 +425,15 @@ class balance(_updater):
     have significantly more pair force neighbors than others, this estimate of the load imbalance may not produce the
     optimal results.
 
+    With *cost* = 'time', the load of a rank is instead the wall time it spent computing forces (including the
+    neighbor list) since the last balancing step, and the imbalance is the time of a rank divided by the average time.
+    Time spent waiting for other ranks in collective communication (the neighbor list distance check, the distributed
+    FFT of PPPM, energy reductions) is not counted.
+    The time of a rank is attributed evenly to its particles, which take their share along when they move to a
+    neighboring domain. This balances systems where the work per particle varies, e.g. dense droplets in a vapor,
+    rigid bodies, or regions with and without charges. Until forces have been computed, the particle numbers are
+    balanced. Time-based balancing is only available on the CPU.
+
     A load balancing adjustment is only performed when the maximum load imbalance exceeds a *tolerance*. The ideal load
     balance is 1.0, so setting *tolerance* less than 1.0 will force an adjustment every *period*. The load balancer
     can attempt multiple iterations of balancing every *period*, and up to *maxiter* attempts can be made. The optimal
@@ -442,7 +452,7 @@ class balance(_updater):
 
     Balancing is ignored if there is no domain decomposition available (MPI is not built or is running on a single rank).
     """
-    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0):
+    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0, cost='particles'):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -462,16 +472,16 @@ class balance(_updater):
         self.setupUpdater(period,phase)
 
         # stash arguments to metadata
-        self.metadata_fields = ['tolerance','maxiter','period','phase']
+        self.metadata_fields = ['tolerance','maxiter','period','phase','cost']
         self.period = period
         self.phase = phase
 
         # configure the parameters
         hoomd.util.quiet_status()
-        self.set_params(x,y,z,tolerance, maxiter)
+        self.set_params(x,y,z,tolerance, maxiter, cost)
         hoomd.util.unquiet_status()
 
-    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None):
+    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None, cost=None):
         R""" Change load balancing parameters.
 
         Args:
@@ -480,12 +490,14 @@ class balance(_updater):
             z (bool): If True, balance in z dimension.
             tolerance (float): Load imbalance tolerance (if <= 1.0, balance every step).
             maxiter (int): Maximum number of iterations to attempt in a single step.
+            cost (str): Measure of the load of a rank, either 'particles' or 'time'.
 
 
         Examples::
 
             balance.set_params(x=True, y=False)
             balance.set_params(tolerance=0.02, maxiter=5)
+            balance.set_params(cost='time')
         """
         hoomd.util.print_status_line()
         self.check_initialization()
@@ -502,6 +514,15 @@ class balance(_updater):
         if maxiter is not None:
             self.maxiter = maxiter
             self.cpp_updater.setMaxIterations(self.maxiter)
+        if cost is not None:
+            if cost not in ('particles', 'time'):
+                hoomd.context.msg.error("update.balance: cost must be 'particles' or 'time'\n")
+                raise ValueError("update.balance: invalid cost")
+            if cost == 'time' and hoomd.context.exec_conf.isCUDAEnabled():
+                hoomd.context.msg.warning("update.balance: time-based balancing is not available on the GPU, balancing particle numbers\n")
+                cost = 'particles'
+            self.cost = cost
+            self.cpp_updater.setCostBased(self.cost == 'time')
 
 # Global current id counter to assign updaters unique names
 _updater.cur_id = 0;